@@ -21,6 +21,7 @@ GEO_SOURCES := \
 	$(GEO_SRC_DIR)/Flat/FlatLine.cpp \
 	$(GEO_SRC_DIR)/Math.cpp \
 	$(GEO_SRC_DIR)/SimplifiedMath.cpp \
+	$(GEO_SRC_DIR)/GeoBatch.cpp \
 	$(GEO_SRC_DIR)/Quadrilateral.cpp \
 	$(GEO_SRC_DIR)/GeoPoint.cpp \
 	$(GEO_SRC_DIR)/GeoVector.cpp \
@@ -34,6 +34,8 @@ ifeq ($(HAVE_HTTP),y)
 
 LIBNET_SOURCES += \
 	$(SRC)/Net/HTTP/DownloadManager.cpp \
+	$(SRC)/Net/HTTP/DownloadState.cpp \
+	$(SRC)/Net/HTTP/ResumableDownload.cpp \
 	$(SRC)/Net/HTTP/ToFile.cpp \
 	$(SRC)/Net/HTTP/ToBuffer.cpp
 
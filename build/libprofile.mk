@@ -2,6 +2,7 @@
 
 PROFILE_SOURCES = \
 	$(SRC)/Profile/File.cpp \
+	$(SRC)/Profile/BinaryFile.cpp \
 	$(SRC)/Profile/Current.cpp \
 	$(SRC)/Profile/Map.cpp \
 	$(SRC)/Profile/StringValue.cpp \
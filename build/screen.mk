@@ -69,6 +69,7 @@ endif
 ifeq ($(FREETYPE),y)
 SCREEN_SOURCES += \
 	$(SCREEN_SRC_DIR)/FreeType/Font.cpp \
+	$(SCREEN_SRC_DIR)/FreeType/GlyphAtlas.cpp \
 	$(SCREEN_SRC_DIR)/FreeType/Init.cpp
 endif
 
@@ -97,6 +98,7 @@ SCREEN_SOURCES += \
 	$(SCREEN_SRC_DIR)/OpenGL/Bitmap.cpp \
 	$(SCREEN_SRC_DIR)/OpenGL/RawBitmap.cpp \
 	$(SCREEN_SRC_DIR)/OpenGL/Canvas.cpp \
+	$(SCREEN_SRC_DIR)/OpenGL/Batch.cpp \
 	$(SCREEN_SRC_DIR)/OpenGL/BufferCanvas.cpp \
 	$(SCREEN_SRC_DIR)/OpenGL/TopCanvas.cpp \
 	$(SCREEN_SRC_DIR)/OpenGL/SubCanvas.cpp \
@@ -174,6 +176,7 @@ SCREEN_SOURCES += \
 	$(SCREEN_SRC_DIR)/Custom/Bitmap.cpp \
 	$(SCREEN_SRC_DIR)/Custom/ResourceBitmap.cpp \
 	$(SCREEN_SRC_DIR)/Memory/Export.cpp \
+	$(SCREEN_SRC_DIR)/Memory/DamageRegion.cpp \
 	$(SCREEN_SRC_DIR)/TTY/TopCanvas.cpp \
 	$(SCREEN_SRC_DIR)/FB/TopWindow.cpp \
 	$(SCREEN_SRC_DIR)/FB/TopCanvas.cpp \
@@ -218,6 +221,7 @@ SCREEN_SOURCES += \
 	$(SCREEN_SRC_DIR)/Memory/RawBitmap.cpp \
 	$(SCREEN_SRC_DIR)/Memory/VirtualCanvas.cpp \
 	$(SCREEN_SRC_DIR)/Memory/SubCanvas.cpp \
+	$(SCREEN_SRC_DIR)/Memory/BandThreadPool.cpp \
 	$(SCREEN_SRC_DIR)/Memory/Canvas.cpp
 MEMORY_CANVAS_CPPFLAGS = -DUSE_MEMORY_CANVAS
 endif
@@ -87,6 +87,7 @@ TEST_NAMES = \
 	test_pressure \
 	test_task \
 	TestOverwritingRingBuffer \
+	TestTripleBuffer \
 	TestDateTime TestRoughTime TestWrapClock \
 	TestMath \
 	TestMathTables \
@@ -94,12 +95,21 @@ TEST_NAMES = \
 	TestUnits TestEarth TestSunEphemeris \
 	TestValidity TestUTM TestProfile \
 	TestAllocatedGrid \
+	TestGridIndex \
+	TestScanTaskPointMap \
 	TestRadixTree TestGeoBounds TestGeoClip \
+	TestAirspaceGeometryCache \
+	TestDamageRegion \
+	TestGlyphAtlas \
+	TestPolygonFillQueue \
+	TestLabelBlock \
+	TestRenderProfiler \
 	TestLogger TestGRecord TestDriver TestClimbAvCalc \
 	TestWaypointReader TestThermalBase \
-	TestFlarmNet \
-	TestColorRamp TestGeoPoint TestDiffFilter \
-	TestFileUtil TestPolars TestCSVLine TestGlidePolar \
+	TestFlarmNet TestTrafficList \
+	TestColorRamp TestGeoPoint TestGeoBatch TestDiffFilter \
+	TestFileUtil TestPolars TestCSVLine TestXMLInSitu TestDownloadState TestResumableDownload \
+	TestZipReader TestGlidePolar \
 	test_replay_task TestProjection TestFlatPoint TestFlatLine TestFlatGeoPoint \
 	TestMacCready TestOrderedTask TestAATPoint \
 	TestPlanes \
@@ -155,6 +165,12 @@ TEST_OVERWRITING_RING_BUFFER_SOURCES = \
 TEST_OVERWRITING_RING_BUFFER_DEPENDS = MATH
 $(eval $(call link-program,TestOverwritingRingBuffer,TEST_OVERWRITING_RING_BUFFER))
 
+TEST_TRIPLE_BUFFER_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTripleBuffer.cpp
+TEST_TRIPLE_BUFFER_DEPENDS = THREAD
+$(eval $(call link-program,TestTripleBuffer,TEST_TRIPLE_BUFFER))
+
 TEST_IGC_PARSER_SOURCES = \
 	$(SRC)/IGC/IGCParser.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -184,6 +200,7 @@ $(eval $(call link-program,TestMETARParser,TEST_METAR_PARSER))
 
 TEST_AIRSPACE_PARSER_SOURCES = \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Units/Descriptor.cpp \
 	$(SRC)/Units/System.cpp \
 	$(SRC)/Operation/Operation.cpp \
@@ -335,9 +352,12 @@ TEST_REPLAY_TASK_SOURCES = \
 	$(SRC)/Task/LoadFile.cpp \
 	$(SRC)/XML/Node.cpp \
 	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Entities.cpp \
 	$(SRC)/XML/Writer.cpp \
 	$(SRC)/XML/DataNode.cpp \
 	$(SRC)/XML/DataNodeXML.cpp \
+	$(SRC)/XML/StreamParser.cpp \
+	$(SRC)/XML/DataNodeInSitu.cpp \
 	$(SRC)/Atmosphere/AirDensity.cpp \
 	$(SRC)/Atmosphere/Pressure.cpp \
 	$(SRC)/IGC/IGCParser.cpp \
@@ -388,6 +408,42 @@ TEST_CSV_LINE_SOURCES = \
 TEST_CSV_LINE_DEPENDS = MATH
 $(eval $(call link-program,TestCSVLine,TEST_CSV_LINE))
 
+TEST_XML_IN_SITU_SOURCES = \
+	$(SRC)/XML/Node.cpp \
+	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Entities.cpp \
+	$(SRC)/XML/Writer.cpp \
+	$(SRC)/XML/DataNode.cpp \
+	$(SRC)/XML/DataNodeXML.cpp \
+	$(SRC)/XML/StreamParser.cpp \
+	$(SRC)/XML/DataNodeInSitu.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestXMLInSitu.cpp
+TEST_XML_IN_SITU_DEPENDS = IO OS MATH UTIL
+$(eval $(call link-program,TestXMLInSitu,TEST_XML_IN_SITU))
+
+TEST_DOWNLOAD_STATE_SOURCES = \
+	$(SRC)/Net/HTTP/DownloadState.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestDownloadState.cpp
+TEST_DOWNLOAD_STATE_DEPENDS = OS UTIL
+$(eval $(call link-program,TestDownloadState,TEST_DOWNLOAD_STATE))
+
+TEST_RESUMABLE_DOWNLOAD_SOURCES = \
+	$(SRC)/Version.cpp \
+	$(SRC)/Logger/MD5.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestResumableDownload.cpp
+TEST_RESUMABLE_DOWNLOAD_DEPENDS = LIBNET OS THREAD UTIL
+$(eval $(call link-program,TestResumableDownload,TEST_RESUMABLE_DOWNLOAD))
+
+TEST_ZIP_READER_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestZipReader.cpp
+TEST_ZIP_READER_CPPFLAGS = $(ZLIB_CPPFLAGS)
+TEST_ZIP_READER_DEPENDS = IO ZZIP OS ZLIB UTIL
+$(eval $(call link-program,TestZipReader,TEST_ZIP_READER))
+
 TEST_GEO_BOUNDS_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestGeoBounds.cpp
@@ -410,6 +466,51 @@ TEST_GEO_CLIP_SOURCES = \
 TEST_GEO_CLIP_DEPENDS = GEO MATH
 $(eval $(call link-program,TestGeoClip,TEST_GEO_CLIP))
 
+TEST_AIRSPACE_GEOMETRY_CACHE_SOURCES = \
+	$(SRC)/Renderer/AirspaceGeometryCache.cpp \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAirspaceGeometryCache.cpp
+TEST_AIRSPACE_GEOMETRY_CACHE_DEPENDS = GEO MATH UTIL
+TEST_AIRSPACE_GEOMETRY_CACHE_CPPFLAGS = $(SCREEN_CPPFLAGS)
+$(eval $(call link-program,TestAirspaceGeometryCache,TEST_AIRSPACE_GEOMETRY_CACHE))
+
+TEST_DAMAGE_REGION_SOURCES = \
+	$(SRC)/Screen/Memory/DamageRegion.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestDamageRegion.cpp
+$(eval $(call link-program,TestDamageRegion,TEST_DAMAGE_REGION))
+
+TEST_GLYPH_ATLAS_SOURCES = \
+	$(SRC)/Screen/FreeType/GlyphAtlas.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestGlyphAtlas.cpp
+$(eval $(call link-program,TestGlyphAtlas,TEST_GLYPH_ATLAS))
+
+TEST_POLYGON_FILL_QUEUE_SOURCES = \
+	$(SRC)/Screen/Memory/BandThreadPool.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestPolygonFillQueue.cpp
+TEST_POLYGON_FILL_QUEUE_DEPENDS = THREAD
+$(eval $(call link-program,TestPolygonFillQueue,TEST_POLYGON_FILL_QUEUE))
+
+TEST_LABEL_BLOCK_SOURCES = \
+	$(SRC)/Renderer/LabelBlock.cpp \
+	$(SRC)/Renderer/LabelPlacementHistory.cpp \
+	$(SRC)/Renderer/WaypointLabelList.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestLabelBlock.cpp
+TEST_LABEL_BLOCK_DEPENDS = UTIL
+$(eval $(call link-program,TestLabelBlock,TEST_LABEL_BLOCK))
+
+TEST_RENDER_PROFILER_SOURCES = \
+	$(SRC)/MapWindow/RenderProfiler.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestRenderProfiler.cpp
+TEST_RENDER_PROFILER_DEPENDS = IO OS UTIL
+$(eval $(call link-program,TestRenderProfiler,TEST_RENDER_PROFILER))
+
 TEST_CLIMB_AV_CALC_SOURCES = \
 	$(SRC)/Computer/ClimbAverageCalculator.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -417,6 +518,17 @@ TEST_CLIMB_AV_CALC_SOURCES = \
 TEST_CLIMB_AV_CALC_DEPENDS = MATH
 $(eval $(call link-program,TestClimbAvCalc,TEST_CLIMB_AV_CALC))
 
+TEST_TRAFFIC_LIST_SOURCES = \
+	$(SRC)/FLARM/FlarmId.cpp \
+	$(SRC)/FLARM/Traffic.cpp \
+	$(SRC)/FLARM/List.cpp \
+	$(SRC)/FLARM/FlarmCalculations.cpp \
+	$(SRC)/Computer/ClimbAverageCalculator.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTrafficList.cpp
+TEST_TRAFFIC_LIST_DEPENDS = MATH UTIL
+$(eval $(call link-program,TestTrafficList,TEST_TRAFFIC_LIST))
+
 TEST_PROJECTION_SOURCES = \
 	$(SRC)/Projection/Projection.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -535,6 +647,12 @@ TEST_GEO_POINT_SOURCES = \
 TEST_GEO_POINT_DEPENDS = GEO MATH
 $(eval $(call link-program,TestGeoPoint,TEST_GEO_POINT))
 
+TEST_GEO_BATCH_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestGeoBatch.cpp
+TEST_GEO_BATCH_DEPENDS = GEO MATH
+$(eval $(call link-program,TestGeoBatch,TEST_GEO_BATCH))
+
 TEST_DIFF_FILTER_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestDiffFilter.cpp
@@ -604,6 +722,18 @@ TEST_ALLOCATED_GRID_SOURCES = \
 TEST_ALLOCATED_GRID_DEPENDS = UTIL
 $(eval $(call link-program,TestAllocatedGrid,TEST_ALLOCATED_GRID))
 
+TEST_GRID_INDEX_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestGridIndex.cpp
+TEST_GRID_INDEX_DEPENDS = UTIL
+$(eval $(call link-program,TestGridIndex,TEST_GRID_INDEX))
+
+TEST_SCAN_TASK_POINT_MAP_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestScanTaskPointMap.cpp
+TEST_SCAN_TASK_POINT_MAP_DEPENDS = UTIL
+$(eval $(call link-program,TestScanTaskPointMap,TEST_SCAN_TASK_POINT_MAP))
+
 TEST_RADIX_TREE_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestRadixTree.cpp
@@ -687,6 +817,7 @@ TEST_WAY_POINT_FILE_SOURCES = \
 	$(SRC)/Waypoint/WaypointReaderFS.cpp \
 	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
 	$(SRC)/Waypoint/WaypointReaderCompeGPS.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/Factory.cpp \
 	$(SRC)/Operation/Operation.cpp \
 	$(SRC)/RadioFrequency.cpp \
@@ -730,7 +861,14 @@ DEBUG_PROGRAM_NAMES = \
 	RunWaveComputer \
 	FlightPath \
 	BenchmarkProjection \
+	BenchmarkGeoBatch \
 	BenchmarkFAITriangleSector \
+	BenchmarkFlarmTraffic \
+	BenchmarkProfile \
+	BenchmarkXML \
+	BenchmarkWaypointIndex \
+	BenchmarkDijkstra \
+	BenchmarkExport \
 	DumpTextFile DumpTextZip DumpTextInflate WriteTextFile RunTextWriter \
 	DumpHexColor \
 	RunXMLParser \
@@ -792,6 +930,7 @@ DEBUG_PROGRAM_NAMES = \
 ifeq ($(TARGET),UNIX)
 DEBUG_PROGRAM_NAMES += \
 	AnalyseFlight \
+	AnalyseFlights \
 	FeedFlyNetData
 endif
 
@@ -801,7 +940,7 @@ DEBUG_PROGRAM_NAMES += \
 endif
 
 ifeq ($(HAVE_HTTP),y)
-DEBUG_PROGRAM_NAMES += DownloadFile RunDownloadToFile RunNOAADownloader RunSkyLinesTracking RunLiveTrack24
+DEBUG_PROGRAM_NAMES += DownloadFile RunDownloadToFile RunResumableDownload RunNOAADownloader RunSkyLinesTracking RunLiveTrack24
 endif
 
 ifeq ($(TARGET_IS_LINUX),y)
@@ -816,6 +955,11 @@ ifeq ($(LUA),y)
 DEBUG_PROGRAM_NAMES += RunLua
 endif
 
+ifneq ($(OPENGL),y)
+# renders offscreen into the memory canvas, e.g. with VFB=y
+DEBUG_PROGRAM_NAMES += BenchmarkMapWindow
+endif
+
 DEBUG_PROGRAMS = $(call name-to-bin,$(DEBUG_PROGRAM_NAMES))
 
 ifeq ($(LUA),y)
@@ -897,6 +1041,36 @@ BENCHMARK_PROJECTION_DEPENDS = MATH
 BENCHMARK_PROJECTION_CPPFLAGS = $(SCREEN_CPPFLAGS)
 $(eval $(call link-program,BenchmarkProjection,BENCHMARK_PROJECTION))
 
+BENCHMARK_GEO_BATCH_SOURCES = \
+	$(TEST_SRC_DIR)/BenchmarkGeoBatch.cpp
+BENCHMARK_GEO_BATCH_DEPENDS = GEO MATH OS UTIL
+$(eval $(call link-program,BenchmarkGeoBatch,BENCHMARK_GEO_BATCH))
+
+BENCHMARK_FLARM_TRAFFIC_SOURCES = \
+	$(filter-out $(TEST_SRC_DIR)/tap.c $(TEST_SRC_DIR)/TestDriver.cpp,$(TEST_DRIVER_SOURCES)) \
+	$(SRC)/FLARM/FlarmComputer.cpp \
+	$(TEST_SRC_DIR)/BenchmarkFlarmTraffic.cpp
+BENCHMARK_FLARM_TRAFFIC_DEPENDS = $(TEST_DRIVER_DEPENDS)
+$(eval $(call link-program,BenchmarkFlarmTraffic,BENCHMARK_FLARM_TRAFFIC))
+
+BENCHMARK_PROFILE_SOURCES = \
+	$(TEST_SRC_DIR)/BenchmarkProfile.cpp
+BENCHMARK_PROFILE_DEPENDS = PROFILE MATH IO OS UTIL
+$(eval $(call link-program,BenchmarkProfile,BENCHMARK_PROFILE))
+
+BENCHMARK_XML_SOURCES = \
+	$(SRC)/XML/Node.cpp \
+	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Entities.cpp \
+	$(SRC)/XML/Writer.cpp \
+	$(SRC)/XML/DataNode.cpp \
+	$(SRC)/XML/DataNodeXML.cpp \
+	$(SRC)/XML/StreamParser.cpp \
+	$(SRC)/XML/DataNodeInSitu.cpp \
+	$(TEST_SRC_DIR)/BenchmarkXML.cpp
+BENCHMARK_XML_DEPENDS = IO OS MATH UTIL
+$(eval $(call link-program,BenchmarkXML,BENCHMARK_XML))
+
 BENCHMARK_FAI_TRIANGLE_SECTOR_SOURCES = \
 	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleSettings.cpp \
 	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleArea.cpp \
@@ -904,6 +1078,25 @@ BENCHMARK_FAI_TRIANGLE_SECTOR_SOURCES = \
 BENCHMARK_FAI_TRIANGLE_SECTOR_DEPENDS = GEO MATH
 $(eval $(call link-program,BenchmarkFAITriangleSector,BENCHMARK_FAI_TRIANGLE_SECTOR))
 
+BENCHMARK_WAYPOINT_INDEX_SOURCES = \
+	$(TEST_SRC_DIR)/BenchmarkWaypointIndex.cpp
+BENCHMARK_WAYPOINT_INDEX_DEPENDS = UTIL
+$(eval $(call link-program,BenchmarkWaypointIndex,BENCHMARK_WAYPOINT_INDEX))
+
+BENCHMARK_DIJKSTRA_SOURCES = \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(TEST_SRC_DIR)/BenchmarkDijkstra.cpp
+BENCHMARK_DIJKSTRA_DEPENDS = CONTEST TASK ROUTE GLIDE WAYPOINT GEO TIME MATH UTIL
+$(eval $(call link-program,BenchmarkDijkstra,BENCHMARK_DIJKSTRA))
+
+BENCHMARK_EXPORT_SOURCES = \
+	$(SRC)/Screen/Memory/Dither.cpp \
+	$(TEST_SRC_DIR)/BenchmarkExport.cpp
+BENCHMARK_EXPORT_DEPENDS = UTIL
+BENCHMARK_EXPORT_CPPFLAGS = $(SCREEN_CPPFLAGS)
+$(eval $(call link-program,BenchmarkExport,BENCHMARK_EXPORT))
+
 DUMP_TEXT_FILE_SOURCES = \
 	$(TEST_SRC_DIR)/DumpTextFile.cpp
 DUMP_TEXT_FILE_DEPENDS = IO OS ZZIP UTIL
@@ -922,7 +1115,7 @@ $(eval $(call link-program,ArcApprox,ARC_APPROX))
 
 DUMP_TEXT_ZIP_SOURCES = \
 	$(TEST_SRC_DIR)/DumpTextZip.cpp
-DUMP_TEXT_ZIP_DEPENDS = IO ZZIP UTIL
+DUMP_TEXT_ZIP_DEPENDS = IO ZZIP OS UTIL
 $(eval $(call link-program,DumpTextZip,DUMP_TEXT_ZIP))
 
 DUMP_TEXT_INFLATE_SOURCES = \
@@ -972,6 +1165,13 @@ RUN_DOWNLOAD_TO_FILE_SOURCES = \
 RUN_DOWNLOAD_TO_FILE_DEPENDS = LIBNET UTIL
 $(eval $(call link-program,RunDownloadToFile,RUN_DOWNLOAD_TO_FILE))
 
+RUN_RESUMABLE_DOWNLOAD_SOURCES = \
+	$(SRC)/Version.cpp \
+	$(SRC)/Logger/MD5.cpp \
+	$(TEST_SRC_DIR)/RunResumableDownload.cpp
+RUN_RESUMABLE_DOWNLOAD_DEPENDS = LIBNET OS UTIL
+$(eval $(call link-program,RunResumableDownload,RUN_RESUMABLE_DOWNLOAD))
+
 RUN_NOAA_DOWNLOADER_SOURCES = \
 	$(SRC)/Version.cpp \
 	$(SRC)/Weather/NOAADownloader.cpp \
@@ -1036,6 +1236,7 @@ $(eval $(call link-program,RunRepositoryParser,RUN_REPOSITORY_PARSER))
 RUN_XML_PARSER_SOURCES = \
 	$(SRC)/XML/Node.cpp \
 	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Entities.cpp \
 	$(SRC)/XML/Writer.cpp \
 	$(TEST_SRC_DIR)/RunXMLParser.cpp
 RUN_XML_PARSER_DEPENDS = IO OS UTIL
@@ -1629,9 +1830,12 @@ RUN_TASK_SOURCES = \
 	$(SRC)/RadioFrequency.cpp \
 	$(SRC)/XML/Node.cpp \
 	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Entities.cpp \
 	$(SRC)/XML/Writer.cpp \
 	$(SRC)/XML/DataNode.cpp \
 	$(SRC)/XML/DataNodeXML.cpp \
+	$(SRC)/XML/StreamParser.cpp \
+	$(SRC)/XML/DataNodeInSitu.cpp \
 	$(SRC)/Engine/Util/Gradient.cpp \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(TEST_SRC_DIR)/FakeTerrain.cpp \
@@ -1696,11 +1900,19 @@ ANALYSE_FLIGHT_SOURCES = \
 	$(TEST_SRC_DIR)/ContestPrinting.cpp \
 	$(TEST_SRC_DIR)/FlightPhaseJSON.cpp \
 	$(TEST_SRC_DIR)/FlightPhaseDetector.cpp \
+	$(TEST_SRC_DIR)/FlightAnalysis.cpp \
 	$(TEST_SRC_DIR)/AnalyseFlight.cpp
 ANALYSE_FLIGHT_LDADD = $(DEBUG_REPLAY_LDADD)
 ANALYSE_FLIGHT_DEPENDS = CONTEST UTIL GEO MATH TIME
 $(eval $(call link-program,AnalyseFlight,ANALYSE_FLIGHT))
 
+ANALYSE_FLIGHTS_SOURCES = \
+	$(filter-out $(TEST_SRC_DIR)/AnalyseFlight.cpp,$(ANALYSE_FLIGHT_SOURCES)) \
+	$(TEST_SRC_DIR)/AnalyseFlights.cpp
+ANALYSE_FLIGHTS_LDADD = $(DEBUG_REPLAY_LDADD)
+ANALYSE_FLIGHTS_DEPENDS = CONTEST THREAD OS UTIL GEO MATH TIME
+$(eval $(call link-program,AnalyseFlights,ANALYSE_FLIGHTS))
+
 FLIGHT_PATH_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/IGC/IGCParser.cpp \
@@ -1791,6 +2003,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Projection/CompareProjection.cpp \
 	$(SRC)/Weather/Rasp/RaspStore.cpp \
 	$(SRC)/Weather/Rasp/RaspCache.cpp \
+	$(SRC)/Weather/Rasp/RaspPrefetcher.cpp \
 	$(SRC)/Weather/Rasp/RaspRenderer.cpp \
 	$(SRC)/Weather/Rasp/RaspStyle.cpp \
 	$(SRC)/MapWindow/MapWindow.cpp \
@@ -1799,6 +2012,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/MapWindow/MapWindowGlideRange.cpp \
 	$(SRC)/Projection/MapWindowProjection.cpp \
 	$(SRC)/MapWindow/MapWindowRender.cpp \
+	$(SRC)/MapWindow/RenderProfiler.cpp \
 	$(SRC)/MapWindow/MapWindowSymbols.cpp \
 	$(SRC)/MapWindow/MapWindowContest.cpp \
 	$(SRC)/MapWindow/MapWindowTask.cpp \
@@ -1814,6 +2028,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Renderer/TaskPointRenderer.cpp \
 	$(SRC)/Renderer/AircraftRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRenderer.cpp \
+	$(SRC)/Renderer/AirspaceGeometryCache.cpp \
 	$(SRC)/Renderer/AirspaceRendererGL.cpp \
 	$(SRC)/Renderer/AirspaceRendererOther.cpp \
 	$(SRC)/Renderer/AirspaceLabelList.cpp \
@@ -1828,6 +2043,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Renderer/WaypointRenderer.cpp \
 	$(SRC)/Renderer/WaypointRendererSettings.cpp \
 	$(SRC)/Renderer/WaypointLabelList.cpp \
+	$(SRC)/Renderer/LabelPlacementHistory.cpp \
 	$(SRC)/Renderer/WindArrowRenderer.cpp \
 	$(SRC)/Renderer/WaveRenderer.cpp \
 	$(SRC)/Math/Screen.cpp \
@@ -1886,6 +2102,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Waypoint/LastUsed.cpp \
 	$(SRC)/Waypoint/WaypointFileType.cpp \
 	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
 	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
@@ -1898,6 +2115,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Compatibility/fmode.c \
 	$(SRC)/XML/Node.cpp \
 	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Entities.cpp \
 	$(SRC)/XML/Writer.cpp \
 	$(SRC)/XML/DataNode.cpp \
 	$(SRC)/XML/DataNodeXML.cpp \
@@ -1935,6 +2153,12 @@ RUN_MAP_WINDOW_DEPENDS = \
 	JASPER ZZIP UTIL GEO MATH TIME
 $(eval $(call link-program,RunMapWindow,RUN_MAP_WINDOW))
 
+BENCHMARK_MAP_WINDOW_SOURCES = \
+	$(filter-out $(TEST_SRC_DIR)/RunMapWindow.cpp,$(RUN_MAP_WINDOW_SOURCES)) \
+	$(TEST_SRC_DIR)/BenchmarkMapWindow.cpp
+BENCHMARK_MAP_WINDOW_DEPENDS = $(RUN_MAP_WINDOW_DEPENDS)
+$(eval $(call link-program,BenchmarkMapWindow,BENCHMARK_MAP_WINDOW))
+
 RUN_LIST_CONTROL_SOURCES = \
 	$(MORE_SCREEN_SOURCES) \
 	$(SRC)/Look/DialogLook.cpp \
@@ -1980,6 +2204,7 @@ RUN_NUMBER_ENTRY_SOURCES = \
 	$(SRC)/Look/CheckBoxLook.cpp \
 	$(SRC)/XML/Node.cpp \
 	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Entities.cpp \
 	$(SRC)/Units/Descriptor.cpp \
 	$(SRC)/Formatter/HexColor.cpp \
 	$(TEST_SRC_DIR)/Fonts.cpp \
@@ -2269,8 +2494,11 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Profile/Profile.cpp \
 	$(SRC)/XML/Node.cpp \
 	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Entities.cpp \
 	$(SRC)/XML/DataNode.cpp \
 	$(SRC)/XML/DataNodeXML.cpp \
+	$(SRC)/XML/StreamParser.cpp \
+	$(SRC)/XML/DataNodeInSitu.cpp \
 	$(SRC)/Dialogs/WidgetDialog.cpp \
 	$(SRC)/Dialogs/dlgAnalysis.cpp \
 	$(SRC)/Dialogs/DialogSettings.cpp \
@@ -2338,6 +2566,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
 	$(SRC)/Airspace/AirspaceGlue.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Airspace/AirspaceVisibility.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
 	$(SRC)/Renderer/AirspaceRendererSettings.cpp \
@@ -2371,6 +2600,7 @@ RUN_AIRSPACE_WARNING_DIALOG_SOURCES = \
 	$(SRC)/NMEA/FlyingState.cpp \
 	$(SRC)/XML/Node.cpp \
 	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Entities.cpp \
 	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
 	$(SRC)/Units/Units.cpp \
 	$(SRC)/Units/Settings.cpp \
@@ -2485,6 +2715,7 @@ RUN_TASK_EDITOR_DIALOG_SOURCES = \
 	$(SRC)/Formatter/Units.cpp \
 	$(SRC)/Waypoint/WaypointFileType.cpp \
 	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
@@ -2582,9 +2813,12 @@ TASK_INFO_SOURCES = \
 	$(SRC)/Task/LoadFile.cpp \
 	$(SRC)/XML/Node.cpp \
 	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Entities.cpp \
 	$(SRC)/XML/Writer.cpp \
 	$(SRC)/XML/DataNode.cpp \
 	$(SRC)/XML/DataNodeXML.cpp \
+	$(SRC)/XML/StreamParser.cpp \
+	$(SRC)/XML/DataNodeInSitu.cpp \
 	$(TEST_SRC_DIR)/TaskInfo.cpp
 TASK_INFO_DEPENDS = TASK ROUTE GLIDE WAYPOINT IO OS GEO TIME MATH UTIL
 $(eval $(call link-program,TaskInfo,TASK_INFO))
@@ -2595,9 +2829,12 @@ DUMP_TASK_FILE_SOURCES = \
 	$(SRC)/Units/System.cpp \
 	$(SRC)/XML/Node.cpp \
 	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Entities.cpp \
 	$(SRC)/XML/Writer.cpp \
 	$(SRC)/XML/DataNode.cpp \
 	$(SRC)/XML/DataNodeXML.cpp \
+	$(SRC)/XML/StreamParser.cpp \
+	$(SRC)/XML/DataNodeInSitu.cpp \
 	$(SRC)/IGC/IGCParser.cpp \
 	$(SRC)/Task/Serialiser.cpp \
 	$(SRC)/Task/Deserialiser.cpp \
@@ -0,0 +1,250 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AirspaceCache.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "IO/FileCache.hpp"
+#include "IO/CacheBuffer.hpp"
+#include "OS/Path.hpp"
+
+#include <memory>
+
+#include <string.h>
+
+namespace {
+
+struct CacheHeader {
+  static constexpr unsigned VERSION = 1;
+
+  uint32_t version;
+  uint32_t n_airspaces;
+
+  /**
+   * The number of bytes following this header.
+   */
+  uint32_t payload_size;
+
+  /**
+   * The length of the original path name, which is the first element
+   * of the payload.
+   */
+  uint32_t path_length;
+};
+
+/**
+ * The fixed-size part of an #AbstractAirspace.  It is followed by
+ * the name and the radio text, each prefixed with its length, and
+ * then by the polygon points.
+ */
+struct CachedAirspace {
+  AbstractAirspace::Shape shape;
+  AirspaceClass type;
+  AirspaceActivity days_of_operation;
+
+  AirspaceAltitude base, top;
+
+  /**
+   * Only used for #AbstractAirspace::Shape::CIRCLE.
+   */
+  GeoPoint center;
+  double radius;
+
+  /**
+   * The number of polygon points; zero for circles.
+   */
+  uint32_t n_points;
+};
+
+/**
+ * The payload is limited to this size to refuse to load garbage.
+ */
+static constexpr uint32_t MAX_PAYLOAD_SIZE = 64 * 1024 * 1024;
+
+}
+
+static void
+WriteAirspace(CacheWriter &writer, const AbstractAirspace &airspace)
+{
+  CachedAirspace cached;
+
+  /* zero-fill all implicit padding bytes (to make valgrind happy) */
+  memset((void *)&cached, 0, sizeof(cached));
+
+  cached.shape = airspace.GetShape();
+  cached.type = airspace.GetType();
+  cached.days_of_operation = airspace.GetDays();
+  cached.base = airspace.GetBase();
+  cached.top = airspace.GetTop();
+
+  if (cached.shape == AbstractAirspace::Shape::CIRCLE) {
+    const auto &circle = (const AirspaceCircle &)airspace;
+    cached.center = circle.GetCenter();
+    cached.radius = circle.GetRadius();
+  } else
+    cached.n_points = airspace.GetPoints().size();
+
+  writer.Write(cached);
+  writer.WriteString(airspace.GetName(), _tcslen(airspace.GetName()));
+  writer.WriteString(airspace.GetRadioText());
+
+  if (cached.shape == AbstractAirspace::Shape::POLYGON)
+    for (const auto &i : airspace.GetPoints())
+      writer.Write(i.GetLocation());
+}
+
+static AbstractAirspace *
+ReadAirspace(CacheReader &reader)
+{
+  CachedAirspace cached;
+  tstring name, radio;
+  if (!reader.Read(cached) ||
+      !reader.ReadString(name) ||
+      !reader.ReadString(radio))
+    return nullptr;
+
+  AbstractAirspace *airspace;
+  switch (cached.shape) {
+  case AbstractAirspace::Shape::CIRCLE:
+    airspace = new AirspaceCircle(cached.center, cached.radius);
+    break;
+
+  case AbstractAirspace::Shape::POLYGON: {
+    if (cached.n_points < 3)
+      return nullptr;
+
+    std::vector<GeoPoint> points(cached.n_points);
+    if (!reader.Read(points.data(), points.size() * sizeof(points.front())))
+      return nullptr;
+
+    airspace = new AirspacePolygon(points);
+    break;
+  }
+
+  default:
+    return nullptr;
+  }
+
+  airspace->SetProperties(std::move(name), cached.type,
+                          cached.base, cached.top);
+  airspace->SetRadio(radio);
+  airspace->SetDays(cached.days_of_operation);
+  return airspace;
+}
+
+static bool
+LoadAirspaceCache(FILE *file, Path path, Airspaces &airspaces)
+{
+  CacheHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      header.version != CacheHeader::VERSION ||
+      header.payload_size > MAX_PAYLOAD_SIZE ||
+      header.n_airspaces > header.payload_size / sizeof(CachedAirspace))
+    return false;
+
+  /* read the whole payload at once, and decode it from memory */
+  std::vector<uint8_t> buffer(header.payload_size);
+  if (fread(buffer.data(), 1, buffer.size(), file) != buffer.size())
+    return false;
+
+  CacheReader reader(buffer.data(), buffer.size());
+
+  /* the entry may have been created for a different file with the
+     same size and modification time */
+  tstring original_path;
+  if (!reader.ReadString(original_path, header.path_length) ||
+      original_path != path.c_str())
+    return false;
+
+  /* decode everything before adding anything, so a corrupt entry
+     does not leave a partial list behind */
+  std::vector<std::unique_ptr<AbstractAirspace>> list;
+  list.reserve(header.n_airspaces);
+
+  for (unsigned i = 0; i < header.n_airspaces; ++i) {
+    AbstractAirspace *airspace = ReadAirspace(reader);
+    if (airspace == nullptr)
+      return false;
+
+    list.emplace_back(airspace);
+  }
+
+  if (!reader.IsEnd())
+    return false;
+
+  for (auto &i : list)
+    airspaces.Add(i.release());
+
+  return true;
+}
+
+bool
+LoadAirspaceCache(FileCache &cache, const TCHAR *name, Path path,
+                  Airspaces &airspaces)
+{
+  FILE *file = cache.Load(name, path);
+  if (file == nullptr)
+    return false;
+
+  bool success = LoadAirspaceCache(file, path, airspaces);
+  fclose(file);
+
+  if (!success)
+    cache.Flush(name);
+
+  return success;
+}
+
+bool
+SaveAirspaceCache(FileCache &cache, const TCHAR *name, Path path,
+                  const std::vector<const AbstractAirspace *> &airspaces)
+{
+  const size_t path_length = _tcslen(path.c_str());
+
+  CacheWriter writer;
+  writer.Write(path.c_str(), path_length * sizeof(TCHAR));
+  for (const auto *airspace : airspaces)
+    WriteAirspace(writer, *airspace);
+
+  if (writer.size() > MAX_PAYLOAD_SIZE)
+    return false;
+
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+  header.version = CacheHeader::VERSION;
+  header.n_airspaces = airspaces.size();
+  header.payload_size = writer.size();
+  header.path_length = path_length;
+
+  FILE *file = cache.Save(name, path);
+  if (file == nullptr)
+    return false;
+
+  if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+      fwrite(writer.data(), 1, writer.size(), file) != writer.size()) {
+    cache.Cancel(name, file);
+    return false;
+  }
+
+  return cache.Commit(name, file);
+}
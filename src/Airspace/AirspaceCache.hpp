@@ -0,0 +1,59 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_AIRSPACE_CACHE_HPP
+#define XCSOAR_AIRSPACE_CACHE_HPP
+
+#include <vector>
+
+#include <tchar.h>
+
+class AbstractAirspace;
+class Airspaces;
+class FileCache;
+class Path;
+
+/**
+ * Load the airspaces of a file from the cache and add them to the
+ * #Airspaces object.  The entry is only used if the original file
+ * has not been modified since it was saved.
+ *
+ * @param name the name of the cache entry
+ * @param path the original airspace file
+ * @return true on success, false if there was no valid cache entry
+ */
+bool
+LoadAirspaceCache(FileCache &cache, const TCHAR *name, Path path,
+                  Airspaces &airspaces);
+
+/**
+ * Save the airspaces which were parsed from a file to the cache.
+ * Circles are saved as such, polygons with their arcs already
+ * expanded.
+ *
+ * @see LoadAirspaceCache()
+ */
+bool
+SaveAirspaceCache(FileCache &cache, const TCHAR *name, Path path,
+                  const std::vector<const AbstractAirspace *> &airspaces);
+
+#endif
@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "Airspace/AirspaceGlue.hpp"
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
 #include "Profile/ProfileKeys.hpp"
 #include "Operation/Operation.hpp"
@@ -35,6 +36,8 @@ Copyright_License {
 #include "IO/MapFile.hpp"
 #include "Profile/Profile.hpp"
 
+#include <vector>
+
 #include <string.h>
 
 static bool
@@ -57,10 +60,10 @@ try {
 
 static bool
 ParseAirspaceFile(AirspaceParser &parser,
-                  struct zzip_dir *dir, const char *path,
+                  ZipArchive &archive, const char *path,
                   OperationEnvironment &operation)
 try {
-  ZipLineReader reader(dir, path, Charset::AUTO);
+  ZipLineReader reader(archive, path, Charset::AUTO);
 
   if (!parser.Parse(reader, operation)) {
     LogFormat("Failed to parse airspace file: %s", path);
@@ -74,10 +77,39 @@ try {
   return false;
 }
 
+/**
+ * Load the airspace file from the cache, or parse it and save the
+ * result to the cache.
+ */
+static bool
+LoadAirspaceFile(Airspaces &airspaces, AirspaceParser &parser, Path path,
+                 const TCHAR *cache_name, FileCache *cache,
+                 OperationEnvironment &operation)
+{
+  if (cache == nullptr)
+    return ParseAirspaceFile(parser, path, operation);
+
+  if (LoadAirspaceCache(*cache, cache_name, path, airspaces))
+    return true;
+
+  /* the new airspaces are appended to the "pending" list, which may
+     already contain those of a previous file */
+  const size_t n_before = airspaces.GetPending().size();
+  if (!ParseAirspaceFile(parser, path, operation))
+    return false;
+
+  const auto &pending = airspaces.GetPending();
+  const std::vector<const AbstractAirspace *>
+    parsed(pending.begin() + n_before, pending.end());
+  SaveAirspaceCache(*cache, cache_name, path, parsed);
+  return true;
+}
+
 void
 ReadAirspace(Airspaces &airspaces,
              RasterTerrain *terrain,
              const AtmosphericPressure &press,
+             FileCache *cache,
              OperationEnvironment &operation)
 {
   LogFormat("ReadAirspace");
@@ -90,15 +122,17 @@ ReadAirspace(Airspaces &airspaces,
   // Read the airspace filenames from the registry
   auto path = Profile::GetPath(ProfileKeys::AirspaceFile);
   if (!path.IsNull())
-    airspace_ok |= ParseAirspaceFile(parser, path, operation);
+    airspace_ok |= LoadAirspaceFile(airspaces, parser, path,
+                                    _T("airspace-1"), cache, operation);
 
   path = Profile::GetPath(ProfileKeys::AdditionalAirspaceFile);
   if (!path.IsNull())
-    airspace_ok |= ParseAirspaceFile(parser, path, operation);
+    airspace_ok |= LoadAirspaceFile(airspaces, parser, path,
+                                    _T("airspace-2"), cache, operation);
 
   auto archive = OpenMapFile();
   if (archive)
-    airspace_ok |= ParseAirspaceFile(parser, archive->get(), "airspace.txt",
+    airspace_ok |= ParseAirspaceFile(parser, *archive, "airspace.txt",
                                      operation);
 
   if (airspace_ok) {
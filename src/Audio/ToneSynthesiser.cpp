@@ -30,28 +30,45 @@ Copyright_License {
 void
 ToneSynthesiser::SetTone(unsigned tone_hz)
 {
-  increment = ARRAY_SIZE(ISINETABLE) * tone_hz / sample_rate;
+  increment = uint32_t((uint64_t(tone_hz) << 32) / sample_rate);
+}
+
+void
+ToneSynthesiser::UpdateTable(unsigned new_volume)
+{
+  static_assert(ARRAY_SIZE(ISINETABLE) == TABLE_SIZE, "Wrong table size");
+
+  for (unsigned i = 0; i < TABLE_SIZE; ++i)
+    table[i] = ISINETABLE[i] * (32767 / 1024) * (int)new_volume / 100;
+
+  table_volume = new_volume;
 }
 
 void
 ToneSynthesiser::Synthesise(int16_t *buffer, size_t n)
 {
-  assert(angle < ARRAY_SIZE(ISINETABLE));
+  const unsigned current_volume = volume.load(std::memory_order_relaxed);
+  if (current_volume != table_volume)
+    UpdateTable(current_volume);
+
+  uint32_t p = phase;
+  const uint32_t i = increment;
 
-  for (int16_t *end = buffer + n; buffer != end; ++buffer) {
-    *buffer = ISINETABLE[angle] * (32767 / 1024) * (int)volume / 100;
-    angle = (angle + increment) & (ARRAY_SIZE(ISINETABLE) - 1);
+  for (size_t j = 0; j < n; ++j) {
+    buffer[j] = table[p >> PHASE_SHIFT];
+    p += i;
   }
+
+  phase = p;
 }
 
 unsigned
 ToneSynthesiser::ToZero() const
 {
-  assert(angle < ARRAY_SIZE(ISINETABLE));
-
-  if (angle < increment)
+  if (phase < increment || increment == 0)
     /* close enough */
     return 0;
 
-  return (ARRAY_SIZE(ISINETABLE) - angle) / increment;
+  /* the number of samples until the phase wraps around */
+  return uint32_t(0 - phase) / increment;
 }
@@ -27,14 +27,42 @@ Copyright_License {
 #include "PCMSynthesiser.hpp"
 #include "Compiler.h"
 
+#include <atomic>
+
+#include <stdint.h>
+
 /**
  * This class generates tones with a sine wave.
+ *
+ * The wave is read from a table which is pre-multiplied with the
+ * volume, indexed with the upper bits of a 32 bit fixed-point phase
+ * accumulator.  That leaves one load and one addition per sample,
+ * and gives a far better frequency resolution than an integer table
+ * step.
  */
 class ToneSynthesiser : public PCMSynthesiser {
-  unsigned volume = 100, angle = 0, increment = 0;
+  static constexpr unsigned TABLE_BITS = 12;
+  static constexpr unsigned TABLE_SIZE = 1u << TABLE_BITS;
+  static constexpr unsigned PHASE_SHIFT = 32 - TABLE_BITS;
+
+  /**
+   * The volume requested by SetVolume().  This may be modified by
+   * another thread; Synthesise() picks it up without locking.
+   */
+  std::atomic<unsigned> volume;
+
+  /**
+   * The volume which #table was calculated for.
+   */
+  unsigned table_volume = ~0u;
+
+  uint32_t phase = 0, increment = 0;
+
+  int16_t table[TABLE_SIZE];
 
 public:
-  explicit ToneSynthesiser(unsigned _sample_rate) : sample_rate(_sample_rate) {
+  explicit ToneSynthesiser(unsigned _sample_rate)
+    :volume(100), sample_rate(_sample_rate) {
   }
 
   unsigned GetSampleRate() const {
@@ -42,13 +70,14 @@ public:
   }
 
   /**
-   * Set the (software) volume of the generated tone.
+   * Set the (software) volume of the generated tone.  This method is
+   * thread-safe.
    *
    * @param _volume the new volume level, 0 indicating muted, 100
    * means full volume
    */
   void SetVolume(unsigned _volume) {
-    volume = _volume;
+    volume.store(_volume, std::memory_order_relaxed);
   }
 
   void SetTone(unsigned tone_hz);
@@ -70,8 +99,11 @@ protected:
    * Start a new period.
    */
   void Restart() {
-    angle = 0;
+    phase = 0;
   }
+
+private:
+  void UpdateTable(unsigned new_volume);
 };
 
 #endif
@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "VarioSynthesiser.hpp"
 #include "Math/FastMath.hpp"
+#include "OS/Clock.hpp"
 #include "Util/Clamp.hpp"
 
 #include <algorithm>
@@ -41,6 +42,18 @@ VarioSynthesiser::VarioToFrequency(int ivario)
     : (zero_frequency - (unsigned)(ivario * (int)(zero_frequency - min_frequency) / min_vario));
 }
 
+void
+VarioSynthesiser::Submit(unsigned frequency,
+                         unsigned _audible_count, unsigned _silence_count)
+{
+  Parameters &p = parameters.GetWriteBuffer();
+  p.frequency = frequency;
+  p.audible_count = _audible_count;
+  p.silence_count = _silence_count;
+  p.timestamp = MonotonicClockUS();
+  parameters.Publish();
+}
+
 void
 VarioSynthesiser::SetVario(double vario)
 {
@@ -50,12 +63,11 @@ VarioSynthesiser::SetVario(double vario)
 
   if (dead_band_enabled && InDeadBand(ivario)) {
     /* inside the "dead band" */
-    UnsafeSetSilence();
+    Submit(0, 0, 1);
     return;
   }
 
-  /* update the ToneSynthesiser base class */
-  SetTone(VarioToFrequency(ivario));
+  const unsigned frequency = VarioToFrequency(ivario);
 
   if (ivario > 0) {
     /* while climbing, the vario sound gets interrupted by silence
@@ -66,21 +78,11 @@ VarioSynthesiser::SetVario(double vario)
          * (max_period_ms - min_period_ms) / max_vario)
       / 1000;
 
-    silence_count = period_ms / 3;
-    audible_count = period_ms - silence_count;
-
-    /* preserve the old "_remaining" values as much as possible, to
-       avoid chopping off the previous tone */
-
-    if (audible_remaining > audible_count)
-      audible_remaining = audible_count;
-
-    if (silence_remaining > silence_count)
-      silence_remaining = silence_count;
+    const unsigned new_silence_count = period_ms / 3;
+    Submit(frequency, period_ms - new_silence_count, new_silence_count);
   } else {
     /* continuous tone while sinking */
-    audible_count = 1;
-    silence_count = 0;
+    Submit(frequency, 1, 0);
   }
 }
 
@@ -88,29 +90,70 @@ void
 VarioSynthesiser::SetSilence()
 {
   const ScopeLock protect(mutex);
-  UnsafeSetSilence();
+  Submit(0, 0, 1);
 }
 
 void
-VarioSynthesiser::UnsafeSetSilence()
+VarioSynthesiser::Apply(const Parameters &p)
 {
-  audible_count = 0;
-  silence_count = 1;
+  if (p.frequency == 0) {
+    /* silence */
+    audible_count = 0;
+    silence_count = 1;
+
+    if (audible_remaining > 0)
+      /* quit the current period as early as possible; the method
+         Synthesise() will take care for finishing the current sine
+         wave to avoid clicking noise */
+      audible_remaining = 1;
+
+    silence_remaining = 0;
+  } else {
+    /* update the ToneSynthesiser base class */
+    SetTone(p.frequency);
 
-  if (audible_remaining > 0)
-    /* quit the current period as early as possible; the method
-       Synthesise() will take care for finishing the current sine
-       wave to avoid clicking noise */
-    audible_remaining = 1;
+    audible_count = p.audible_count;
+    silence_count = p.silence_count;
 
-  silence_remaining = 0;
+    if (silence_count > 0) {
+      /* preserve the old "_remaining" values as much as possible, to
+         avoid chopping off the previous tone */
+
+      if (audible_remaining > audible_count)
+        audible_remaining = audible_count;
+
+      if (silence_remaining > silence_count)
+        silence_remaining = silence_count;
+    }
+  }
+
+  const uint64_t now = MonotonicClockUS();
+  const unsigned latency = now > p.timestamp
+    ? unsigned(std::min<uint64_t>(now - p.timestamp, 0xffffffff))
+    : 0;
+
+  latency_count.fetch_add(1, std::memory_order_relaxed);
+  latency_sum_us.fetch_add(latency, std::memory_order_relaxed);
+  if (latency > latency_max_us.load(std::memory_order_relaxed))
+    latency_max_us.store(latency, std::memory_order_relaxed);
 }
 
+VarioSynthesiser::LatencyStatistics
+VarioSynthesiser::ReadLatency()
+{
+  LatencyStatistics result;
+  result.count = latency_count.exchange(0, std::memory_order_relaxed);
+  const unsigned sum = latency_sum_us.exchange(0, std::memory_order_relaxed);
+  result.max_us = latency_max_us.exchange(0, std::memory_order_relaxed);
+  result.average_us = result.count > 0 ? sum / result.count : 0;
+  return result;
+}
 
 void
 VarioSynthesiser::Synthesise(int16_t *buffer, size_t n)
 {
-  const ScopeLock protect(mutex);
+  if (parameters.Update())
+    Apply(parameters.GetReadBuffer());
 
   assert(audible_count > 0 || silence_count > 0);
 
@@ -26,35 +26,64 @@ Copyright_License {
 
 #include "ToneSynthesiser.hpp"
 #include "Thread/Mutex.hpp"
+#include "Util/TripleBuffer.hpp"
 #include "Compiler.h"
 
+#include <atomic>
+
+#include <stdint.h>
+
 /**
  * This class generates vario sound.
+ *
+ * SetVario() and SetSilence() calculate the tone parameters and pass
+ * them to the audio thread through a lock-free #TripleBuffer;
+ * Synthesise() never locks, so a busy calculation thread cannot
+ * delay the audio callback.
  */
 class VarioSynthesiser final : public ToneSynthesiser {
+public:
   /**
-   * This mutex protects all atttributes below.  It is locked
-   * automatically by all public methods.
+   * Statistics about the time between a SetVario() / SetSilence()
+   * call and the moment Synthesise() starts generating samples with
+   * the new parameters.  This does not include the buffering in the
+   * audio driver.
    */
-  Mutex mutex;
+  struct LatencyStatistics {
+    unsigned count;
+    unsigned average_us, max_us;
+  };
 
+private:
   /**
-   * The number of audible samples in each period.
+   * The tone parameters calculated by SetVario() for the audio
+   * thread.
    */
-  size_t audible_count;
+  struct Parameters {
+    /**
+     * The tone frequency [Hz].  Zero means silence.
+     */
+    unsigned frequency;
 
-  /**
-   * The number of silent samples in each period.  If this is zero,
-   * then no silence will be generated (continuous tone).
-   */
-  size_t silence_count;
+    /**
+     * See #VarioSynthesiser::audible_count and
+     * #VarioSynthesiser::silence_count.
+     */
+    unsigned audible_count, silence_count;
+
+    /**
+     * The MonotonicClockUS() value when these parameters were
+     * submitted.
+     */
+    uint64_t timestamp;
+  };
 
   /**
-   * The number of audible/silence samples remaining in the current
-   * period.  These two attributes will be reset to the according
-   * _count value when both reach zero.
+   * This mutex protects the settings below, and the producer side of
+   * #parameters.  It is locked automatically by all public methods
+   * except Synthesise().
    */
-  size_t audible_remaining, silence_remaining;
+  Mutex mutex;
 
   bool dead_band_enabled;
 
@@ -89,15 +118,42 @@ class VarioSynthesiser final : public ToneSynthesiser {
    */
   int min_dead, max_dead;
 
+  TripleBuffer<Parameters> parameters;
+
+  /* the following attributes are owned by the audio thread, i.e. by
+     Synthesise() */
+
+  /**
+   * The number of audible samples in each period.
+   */
+  size_t audible_count;
+
+  /**
+   * The number of silent samples in each period.  If this is zero,
+   * then no silence will be generated (continuous tone).
+   */
+  size_t silence_count;
+
+  /**
+   * The number of audible/silence samples remaining in the current
+   * period.  These two attributes will be reset to the according
+   * _count value when both reach zero.
+   */
+  size_t audible_remaining, silence_remaining;
+
+  /* latency statistics, written by the audio thread */
+  std::atomic<unsigned> latency_count, latency_sum_us, latency_max_us;
+
 public:
   explicit VarioSynthesiser(unsigned sample_rate)
     :ToneSynthesiser(sample_rate),
-     audible_count(0), silence_count(1),
-     audible_remaining(0), silence_remaining(0),
      dead_band_enabled(false),
      min_frequency(200), zero_frequency(500), max_frequency(1500),
      min_period_ms(150), max_period_ms(600),
-     min_dead(-30), max_dead(10) {}
+     min_dead(-30), max_dead(10),
+     audible_count(0), silence_count(1),
+     audible_remaining(0), silence_remaining(0),
+     latency_count(0), latency_sum_us(0), latency_max_us(0) {}
 
   /**
    * Update the vario value.  This calculates a new tone frequency and
@@ -116,6 +172,7 @@ public:
    * Enable/disable the dead band silence
    */
   void SetDeadBand(bool enabled) {
+    const ScopeLock protect(mutex);
     dead_band_enabled = enabled;
   }
 
@@ -123,6 +180,7 @@ public:
    * Set the base frequencies for minimum, zero and maximum lift
    */
   void SetFrequencies(unsigned min, unsigned zero, unsigned max) {
+    const ScopeLock protect(mutex);
     min_frequency = min;
     zero_frequency = zero;
     max_frequency = max;
@@ -132,6 +190,7 @@ public:
    * Set the time periods for minimum and maximum lift
    */
   void SetPeriods(unsigned min, unsigned max) {
+    const ScopeLock protect(mutex);
     min_period_ms = min;
     max_period_ms = max;
   }
@@ -140,18 +199,34 @@ public:
    * Set the vario range of the "dead band" during which no sound is emitted
    */
   void SetDeadBandRange(double min, double max) {
+    const ScopeLock protect(mutex);
     min_dead = (int)(min * 100);
     max_dead = (int)(max * 100);
   }
 
+  /**
+   * Obtain and reset the latency statistics.  This method is
+   * thread-safe.
+   */
+  LatencyStatistics ReadLatency();
+
   /* methods from class PCMSynthesiser */
   virtual void Synthesise(int16_t *buffer, size_t n);
 
 private:
   /**
-   * Same as SetSilence(), but doesn't lock the mutex.
+   * Submit new parameters to the audio thread.
+   *
+   * Caller must lock the mutex.
+   */
+  void Submit(unsigned frequency,
+              unsigned audible_count, unsigned silence_count);
+
+  /**
+   * Apply parameters submitted by Submit().  Called by the audio
+   * thread.
    */
-  void UnsafeSetSilence();
+  void Apply(const Parameters &p);
 
   /**
    * Convert a vario value to a tone frequency.
@@ -239,6 +239,10 @@ DeviceBlackboard::Merge()
     real_data.Complement(per_device_data[i]);
   }
 
+  traffic_database.Expire(real_data.clock);
+  if (!traffic_database.IsEmpty())
+    traffic_database.CopyRelevant(real_data.flarm.traffic);
+
   real_clock.Normalise(real_data);
 
   if (replay_data.alive) {
@@ -28,6 +28,7 @@ Copyright_License {
 #include "Blackboard/ComputerSettingsBlackboard.hpp"
 #include "Device/Simulator.hpp"
 #include "Device/Features.hpp"
+#include "FLARM/List.hpp"
 #include "Thread/Mutex.hpp"
 #include "Time/WrapClock.hpp"
 
@@ -74,6 +75,13 @@ class DeviceBlackboard
    */
   NMEAInfo replay_data;
 
+  /**
+   * Traffic received from the physical devices.  It is too large to
+   * be copied into each #NMEAInfo; Merge() copies the most relevant
+   * targets into #real_data.
+   */
+  TrafficDatabase traffic_database;
+
   /**
    * Clock management for #real_data and #replay_data.
    */
@@ -109,6 +117,8 @@ public:
     return per_device_data[i];
   }
 
+  TrafficDatabase &SetTrafficDatabase() { return traffic_database; }
+
   NMEAInfo &SetSimulatorState() { return simulator_data; }
   NMEAInfo &SetReplayState() { return replay_data; }
 
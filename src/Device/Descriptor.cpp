@@ -256,6 +256,7 @@ DeviceDescriptor::OpenOnPort(DumpPort *_port, OperationEnvironment &env)
   port = _port;
 
   parser.Reset();
+  parser.SetTrafficDatabase(&device_blackboard->SetTrafficDatabase());
   parser.SetReal(!StringIsEqual(driver->name, _T("Condor")));
   if (config.IsDriver(_T("Condor")))
     parser.DisableGeoid();
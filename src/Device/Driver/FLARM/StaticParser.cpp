@@ -102,8 +102,9 @@ ReadBearing(NMEAInputLine &line, Angle &value_r)
   return true;
 }
 
-void
-ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, double clock)
+template<typename L>
+static void
+ParsePFLAAList(NMEAInputLine &line, L &flarm, double clock)
 {
   flarm.modified.Update(clock);
 
@@ -180,14 +181,11 @@ ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, double clock)
 
   FlarmTraffic *flarm_slot = flarm.FindTraffic(traffic.id);
   if (flarm_slot == nullptr) {
-    flarm_slot = flarm.AllocateTraffic();
+    flarm_slot = flarm.AllocateTraffic(traffic.id);
     if (flarm_slot == nullptr)
       // no more slots available
       return;
 
-    flarm_slot->Clear();
-    flarm_slot->id = traffic.id;
-
     flarm.new_traffic.Update(clock);
   }
 
@@ -196,3 +194,15 @@ ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, double clock)
 
   flarm_slot->Update(traffic);
 }
+
+void
+ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, double clock)
+{
+  ParsePFLAAList(line, flarm, clock);
+}
+
+void
+ParsePFLAA(NMEAInputLine &line, TrafficDatabase &flarm, double clock)
+{
+  ParsePFLAAList(line, flarm, clock);
+}
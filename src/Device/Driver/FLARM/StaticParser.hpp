@@ -29,6 +29,7 @@ struct FlarmError;
 struct FlarmVersion;
 struct FlarmStatus;
 struct TrafficList;
+struct TrafficDatabase;
 
 /**
  * Parses a PFLAE sentence (self-test results).
@@ -62,4 +63,7 @@ ParsePFLAU(NMEAInputLine &line, FlarmStatus &flarm, double clock);
 void
 ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, double clock);
 
+void
+ParsePFLAA(NMEAInputLine &line, TrafficDatabase &flarm, double clock);
+
 #endif
@@ -43,6 +43,7 @@ NMEAParser::Reset()
   real = true;
   use_geoid = true;
   last_time = 0;
+  traffic_database = nullptr;
 }
 
 bool
@@ -99,7 +100,10 @@ NMEAParser::ParseLine(const char *string, NMEAInfo &info)
     }
 
     if (StringIsEqual(type + 1, "PFLAA")) {
-      ParsePFLAA(line, info.flarm.traffic, info.clock);
+      if (traffic_database != nullptr)
+        ParsePFLAA(line, *traffic_database, info.clock);
+      else
+        ParsePFLAA(line, info.flarm.traffic, info.clock);
       return true;
     }
 
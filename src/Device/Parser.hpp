@@ -25,6 +25,7 @@ Copyright_License {
 #define XCSOAR_DEVICE_PARSER_HPP
 
 struct NMEAInfo;
+struct TrafficDatabase;
 class NMEAInputLine;
 struct GeoPoint;
 struct BrokenDate;
@@ -34,6 +35,8 @@ class NMEAParser
 {
   double last_time;
 
+  TrafficDatabase *traffic_database;
+
 public:
   bool real;
 
@@ -55,6 +58,15 @@ public:
     use_geoid = false;
   }
 
+  /**
+   * Store PFLAA traffic in the specified #TrafficDatabase instead of
+   * NMEAInfo::flarm.  The caller of ParseLine() must hold the lock
+   * which protects it.
+   */
+  void SetTrafficDatabase(TrafficDatabase *_traffic_database) {
+    traffic_database = _traffic_database;
+  }
+
   /**
    * Parses a provided NMEA String into a NMEA_INFO struct
    * @param line NMEA string
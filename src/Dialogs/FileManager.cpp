@@ -52,6 +52,8 @@ Copyright_License {
 #ifdef HAVE_DOWNLOAD_MANAGER
 #include "Repository/Glue.hpp"
 #include "ListPicker.hpp"
+#include "NumberEntry.hpp"
+#include "Profile/Profile.hpp"
 #include "Form/Button.hpp"
 #include "Net/HTTP/DownloadManager.hpp"
 #include "Event/Notify.hpp"
@@ -116,6 +118,7 @@ class ManagedFileListWidget
     DOWNLOAD,
     ADD,
     CANCEL,
+    LIMIT,
   };
 
   struct DownloadStatus {
@@ -265,6 +268,7 @@ protected:
   void Download();
   void Add();
   void Cancel();
+  void SetLimit();
 
 public:
   /* virtual methods from class Widget */
@@ -404,6 +408,10 @@ ManagedFileListWidget::CreateButtons(WidgetDialog &dialog)
     download_button = dialog.AddButton(_("Download"), *this, DOWNLOAD);
     add_button = dialog.AddButton(_("Add"), *this, ADD);
     cancel_button = dialog.AddButton(_("Cancel"), *this, CANCEL);
+#ifndef ANDROID
+    /* the Android DownloadManager has no bandwidth limit */
+    dialog.AddButton(_("Limit"), *this, LIMIT);
+#endif
   }
 #endif
 }
@@ -486,7 +494,8 @@ ManagedFileListWidget::Download()
   if (!base.IsValid())
     return;
 
-  Net::DownloadManager::Enqueue(remote_file.uri.c_str(), Path(base));
+  Net::DownloadManager::Enqueue(remote_file.uri.c_str(), Path(base),
+                                remote_file.GetMD5());
 #endif
 }
 
@@ -561,7 +570,8 @@ ManagedFileListWidget::Add()
   if (!base.IsValid())
     return;
 
-  Net::DownloadManager::Enqueue(remote_file.GetURI(), Path(base));
+  Net::DownloadManager::Enqueue(remote_file.GetURI(), Path(base),
+                                remote_file.GetMD5());
 #endif
 }
 
@@ -582,6 +592,25 @@ ManagedFileListWidget::Cancel()
 #endif
 }
 
+void
+ManagedFileListWidget::SetLimit()
+{
+#if defined(HAVE_DOWNLOAD_MANAGER) && !defined(ANDROID)
+  assert(Net::DownloadManager::IsAvailable());
+
+  unsigned limit = 0;
+  Profile::Get(ProfileKeys::DownloadBandwidthLimit, limit);
+
+  if (!NumberEntryDialog(_("Download limit (kB/s, 0 = none)"), limit, 5))
+    return;
+
+  Profile::Set(ProfileKeys::DownloadBandwidthLimit, limit);
+  Profile::Save();
+
+  Net::DownloadManager::SetBandwidthLimit(limit * 1024);
+#endif
+}
+
 void
 ManagedFileListWidget::OnAction(int id)
 {
@@ -597,6 +626,10 @@ ManagedFileListWidget::OnAction(int id)
   case CANCEL:
     Cancel();
     break;
+
+  case LIMIT:
+    SetLimit();
+    break;
   }
 }
 
@@ -34,6 +34,7 @@ Copyright_License {
 #include "LocalPath.hpp"
 #include "Profile/Map.hpp"
 #include "Profile/File.hpp"
+#include "Profile/BinaryFile.hpp"
 #include "UIGlobals.hpp"
 #include "Language/Language.hpp"
 
@@ -339,6 +340,7 @@ ProfileListWidget::DeleteClicked()
   }
 
   File::Delete(item.path);
+  File::Delete(Profile::GetBinaryPath(item.path));
   UpdateList();
 }
 
@@ -36,12 +36,15 @@ Copyright_License {
 #include "Task/TaskStore.hpp"
 #include "LocalPath.hpp"
 #include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
 #include "Language/Language.hpp"
 #include "Interface.hpp"
 #include "Screen/Canvas.hpp"
 #include "Screen/Layout.hpp"
 #include "Engine/Task/Ordered/OrderedTask.hpp"
+#include "Formatter/UserUnits.hpp"
 #include "Util/StringCompare.hxx"
+#include "Util/StaticString.hxx"
 
 #include <assert.h>
 
@@ -53,7 +56,8 @@ static unsigned task_list_serial;
 #endif
 
 class TaskListPanel final
-  : public ListWidget, private ActionListener {
+  : public ListWidget, private ActionListener,
+    private TaskStore::Listener {
   enum Buttons {
     LOAD = 100,
     RENAME,
@@ -69,6 +73,14 @@ class TaskListPanel final
   TaskStore *task_store;
   unsigned serial;
 
+  /**
+   * The item shown in the task view.  It is identified by path and
+   * name (a file may contain several tasks), because its index
+   * changes while the #TaskStore is being filled.
+   */
+  AllocatedPath shown_path = nullptr;
+  StaticString<256> shown_name;
+
   /**
    * Showing all task files?  (including *.igc, *.cup)
    */
@@ -105,6 +117,22 @@ public:
 
   void RefreshView();
 
+  /**
+   * The number of list rows: one per task, plus a "Scanning" row
+   * while the #TaskStore is still parsing files in the background.
+   */
+  gcc_pure
+  unsigned GetListLength() const {
+    return task_store->Size() + task_store->IsBusy();
+  }
+
+  /**
+   * Rescan the data directory.  The list is filled asynchronously.
+   */
+  void ScanTasks() {
+    task_store->Scan(CommonInterface::GetComputerSettings().task, more);
+  }
+
   void LoadTask();
   void DeleteTask();
   void RenameTask();
@@ -126,6 +154,9 @@ private:
   /* virtual methods from ActionListener */
   void OnAction(int id) override;
 
+  /* virtual methods from class TaskStore::Listener */
+  void OnTaskStoreChanged() override;
+
   /* virtual methods from class ListControl::Handler */
   void OnPaintItem(Canvas &canvas, const PixelRect rc, unsigned idx) override;
 
@@ -134,7 +165,7 @@ private:
   }
 
   bool CanActivateItem(unsigned index) const override {
-      return true;
+    return index < task_store->Size();
   }
 
   void OnActivateItem(unsigned index) override {
@@ -203,18 +234,79 @@ TaskListPanel::OnPaintItem(Canvas &canvas, const PixelRect rc,
   assert(DrawListIndex <= task_store->Size());
 
   const unsigned padding = Layout::GetTextPadding();
+
+  if (DrawListIndex >= task_store->Size()) {
+    /* the "Scanning" row, see GetListLength() */
+    canvas.DrawText(rc.left + padding, rc.top + padding, _("Scanning..."));
+    return;
+  }
+
   const TCHAR *name = task_store->GetName(DrawListIndex);
 
-  canvas.DrawText(rc.left + padding, rc.top + padding, name);
+  int right = rc.right - padding;
+
+  const TaskStore::Summary *summary = task_store->GetSummary(DrawListIndex);
+  if (summary != nullptr) {
+    StaticString<64> text;
+    if (summary->valid)
+      text = FormatUserDistanceSmart(summary->distance);
+    else
+      text = _("invalid");
+
+    const unsigned width = canvas.CalcTextWidth(text);
+    right -= width;
+    canvas.DrawText(right, rc.top + padding, text);
+    right -= padding;
+  }
+
+  if (right > rc.left + (int)padding)
+    canvas.DrawClippedText(rc.left + padding, rc.top + padding,
+                           right - rc.left - padding, name);
+}
+
+void
+TaskListPanel::OnTaskStoreChanged()
+{
+  /* keep the cursor on the task which is being shown while new ones
+     are being inserted */
+  ListControl &list = GetList();
+  list.SetLength(GetListLength());
+
+  if (!shown_path.IsNull()) {
+    for (unsigned i = 0, n = task_store->Size(); i < n; ++i) {
+      if (task_store->GetPath(i) == shown_path &&
+          StringIsEqual(task_store->GetName(i), shown_name)) {
+        if (i != list.GetCursorIndex())
+          list.SetCursorIndex(i);
+
+        list.Invalidate();
+        return;
+      }
+    }
+  }
+
+  /* nothing was shown yet (the list was empty), or the task has
+     disappeared: show the one at the cursor */
+  RefreshView();
+  list.Invalidate();
 }
 
 void
 TaskListPanel::RefreshView()
 {
-  GetList().SetLength(task_store->Size());
+  GetList().SetLength(GetListLength());
 
   dialog.InvalidateTaskView();
 
+  const unsigned cursor_index = GetList().GetCursorIndex();
+  if (cursor_index < task_store->Size()) {
+    shown_path = task_store->GetPath(cursor_index);
+    shown_name = task_store->GetName(cursor_index);
+  } else {
+    shown_path = nullptr;
+    shown_name.clear();
+  }
+
   const OrderedTask *ordered_task = get_cursor_task();
   dialog.ShowTaskView(ordered_task);
 
@@ -283,7 +375,7 @@ TaskListPanel::DeleteTask()
 
   File::Delete(path);
 
-  task_store->Scan(more);
+  ScanTasks();
   RefreshView();
 }
 
@@ -331,7 +423,7 @@ TaskListPanel::RenameTask()
   File::Rename(task_store->GetPath(cursor_index),
                AllocatedPath::Build(tasks_path, newname));
 
-  task_store->Scan(more);
+  ScanTasks();
   RefreshView();
 }
 
@@ -342,7 +434,7 @@ TaskListPanel::OnMoreClicked()
 
   more_button->SetCaption(more ? _("Less") : _("More"));
 
-  task_store->Scan(more);
+  ScanTasks();
   RefreshView();
 }
 
@@ -355,6 +447,7 @@ TaskListPanel::Prepare(ContainerWindow &parent, const PixelRect &rc)
   CreateButtons(buttons->GetButtonPanel());
 
   task_store = new TaskStore();
+  task_store->SetListener(this);
 
   /* mark the new TaskStore as "dirty" until the data directory really
      gets scanned */
@@ -374,7 +467,7 @@ TaskListPanel::Show(const PixelRect &rc)
   if (serial != task_list_serial) {
     serial = task_list_serial;
     // Scan XCSoarData for available tasks
-    task_store->Scan(more);
+    ScanTasks();
   }
 
   dialog.ShowTaskView(get_cursor_task());
@@ -27,6 +27,7 @@ Copyright_License {
 
 #include "MapWindow/GlueMapWindow.hpp"
 #include "Hardware/CPU.hpp"
+#include "OS/Clock.hpp"
 
 /**
  * Main loop of the DrawThread
@@ -41,7 +42,13 @@ DrawThread::Run()
   // circle until application is closed
   while (!_CheckStoppedOrSuspended()) {
     if (!pending) {
-      command_trigger.wait(mutex);
+      RenderProfiler &profiler = map.GetRenderProfiler();
+      if (profiler.IsEnabled()) {
+        const uint64_t start = MonotonicClockUS();
+        command_trigger.wait(mutex);
+        profiler.AddWaitTime(unsigned(MonotonicClockUS() - start));
+      } else
+        command_trigger.wait(mutex);
       continue;
     }
 
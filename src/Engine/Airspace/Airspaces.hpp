@@ -93,6 +93,14 @@ public:
    */
   void Add(AbstractAirspace *asp);
 
+  /**
+   * Returns the airspaces which have been added since the last
+   * Optimise() call, in the order they were added.
+   */
+  const std::deque<AbstractAirspace *> &GetPending() const {
+    return tmp_as;
+  }
+
   /**
    * Re-organise the internal airspace tree after inserting/deleting.
    * Should be called after inserting/deleting airspaces prior to performing
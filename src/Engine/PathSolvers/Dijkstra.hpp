@@ -44,6 +44,8 @@ public:
 
     unsigned value;
 
+    Edge() = default;
+
     Edge(Node _parent, unsigned _value):parent(_parent), value(_value) {}
   };
 
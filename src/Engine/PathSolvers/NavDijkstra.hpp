@@ -26,10 +26,10 @@ Copyright_License {
 
 #include "Dijkstra.hpp"
 #include "ScanTaskPoint.hpp"
+#include "ScanTaskPointMap.hpp"
 #include "SolverResult.hpp"
 #include "Compiler.h"
 
-#include <unordered_map>
 #include <assert.h>
 
 /**
@@ -44,26 +44,8 @@ class NavDijkstra {
 protected:
   static constexpr unsigned MAX_STAGES = 32;
 
-  struct DijkstraMap {
-    struct Hash {
-      std::size_t operator()(ScanTaskPoint p) const {
-        return p.Key();
-      }
-    };
-
-    struct Equal {
-      std::size_t operator()(ScanTaskPoint a, ScanTaskPoint b) const {
-        return a.Key() == b.Key();
-      }
-    };
-
-    template<typename Value>
-    struct Bind : public std::unordered_map<ScanTaskPoint, Value,
-                                            Hash, Equal> {
-    };
-  };
-
-  typedef ::Dijkstra<ScanTaskPoint, DijkstraMap> Dijkstra;
+  typedef ::Dijkstra<ScanTaskPoint,
+                     DenseScanTaskPointMap<MAX_STAGES>> Dijkstra;
 
   Dijkstra dijkstra;
 
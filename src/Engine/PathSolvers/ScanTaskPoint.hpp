@@ -35,6 +35,8 @@ class ScanTaskPoint {
   uint32_t value;
 
 public:
+  ScanTaskPoint() = default;
+
   constexpr
   ScanTaskPoint(unsigned stage_number, unsigned point_index)
     :value((stage_number << 16) | point_index) {}
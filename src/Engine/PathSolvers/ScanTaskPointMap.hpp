@@ -0,0 +1,243 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef SCAN_TASK_POINT_MAP_HPP
+#define SCAN_TASK_POINT_MAP_HPP
+
+#include "ScanTaskPoint.hpp"
+#include "Compiler.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <assert.h>
+
+/**
+ * A "MapTemplate" for class #Dijkstra which stores the nodes in a
+ * hash table.
+ */
+struct HashScanTaskPointMap {
+  struct Hash {
+    std::size_t operator()(ScanTaskPoint p) const {
+      return p.Key();
+    }
+  };
+
+  struct Equal {
+    std::size_t operator()(ScanTaskPoint a, ScanTaskPoint b) const {
+      return a.Key() == b.Key();
+    }
+  };
+
+  template<typename Value>
+  struct Bind : public std::unordered_map<ScanTaskPoint, Value,
+                                          Hash, Equal> {
+  };
+};
+
+/**
+ * A "MapTemplate" for class #Dijkstra which stores the nodes in one
+ * flat array per stage, indexed by the point index.  This exploits
+ * that the keys form a small dense grid: no hashing, no per-node
+ * allocation, and the arrays are reused by the next search.
+ *
+ * Each slot carries a generation number; a slot is only valid if
+ * it matches the map's current generation, so clear() is O(1).
+ *
+ * Iterators consist of the stage and the point index; unlike
+ * pointers, they remain valid when an array grows.
+ */
+template<unsigned MAX_STAGES>
+struct DenseScanTaskPointMap {
+  template<typename Value>
+  class Bind {
+  public:
+    typedef ScanTaskPoint key_type;
+    typedef Value mapped_type;
+
+    struct value_type {
+      ScanTaskPoint first;
+      Value second;
+    };
+
+  private:
+    struct Slot : value_type {
+      unsigned generation = 0;
+    };
+
+    typedef std::vector<Slot> SlotVector;
+
+    SlotVector stages[MAX_STAGES];
+
+    /**
+     * The generation of valid slots.  Starts at 1, because new slots
+     * are initialised with 0.
+     */
+    unsigned generation = 1;
+
+    template<typename M, typename V>
+    class Iterator {
+      friend class Bind;
+
+      M *map;
+      unsigned stage, index;
+
+      Iterator(M &_map, unsigned _stage, unsigned _index)
+        :map(&_map), stage(_stage), index(_index) {}
+
+    public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef V value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef V *pointer;
+      typedef V &reference;
+
+      /* allow conversion from iterator to const_iterator */
+      template<typename M2, typename V2>
+      Iterator(const Iterator<M2, V2> &other)
+        :map(other.map), stage(other.stage), index(other.index) {}
+
+      V &operator*() const {
+        return map->stages[stage][index];
+      }
+
+      V *operator->() const {
+        return &map->stages[stage][index];
+      }
+
+      Iterator &operator++() {
+        map->FindValid(stage, ++index);
+        return *this;
+      }
+
+      bool operator==(const Iterator &other) const {
+        return stage == other.stage && index == other.index;
+      }
+
+      bool operator!=(const Iterator &other) const {
+        return !(*this == other);
+      }
+
+      template<typename M2, typename V2>
+      friend class Iterator;
+    };
+
+  public:
+    typedef Iterator<Bind, value_type> iterator;
+    typedef Iterator<const Bind, const value_type> const_iterator;
+
+    iterator begin() {
+      unsigned stage = 0, index = 0;
+      FindValid(stage, index);
+      return iterator(*this, stage, index);
+    }
+
+    const_iterator begin() const {
+      unsigned stage = 0, index = 0;
+      FindValid(stage, index);
+      return const_iterator(*this, stage, index);
+    }
+
+    iterator end() {
+      return iterator(*this, MAX_STAGES, 0);
+    }
+
+    const_iterator end() const {
+      return const_iterator(*this, MAX_STAGES, 0);
+    }
+
+    iterator find(ScanTaskPoint key) {
+      return IsValid(key)
+        ? iterator(*this, key.GetStageNumber(), key.GetPointIndex())
+        : end();
+    }
+
+    const_iterator find(ScanTaskPoint key) const {
+      return IsValid(key)
+        ? const_iterator(*this, key.GetStageNumber(), key.GetPointIndex())
+        : end();
+    }
+
+    std::pair<iterator, bool> insert(const std::pair<ScanTaskPoint, Value> &p) {
+      const unsigned stage = p.first.GetStageNumber();
+      const unsigned index = p.first.GetPointIndex();
+      assert(stage < MAX_STAGES);
+
+      iterator i(*this, stage, index);
+
+      SlotVector &v = stages[stage];
+      if (index >= v.size())
+        /* grow geometrically, the point count of each stage is
+           usually the same in the next search */
+        v.resize(std::max<std::size_t>(index + 1, v.size() * 2));
+      else if (v[index].generation == generation)
+        return std::make_pair(i, false);
+
+      Slot &slot = v[index];
+      slot.first = p.first;
+      slot.second = p.second;
+      slot.generation = generation;
+      return std::make_pair(i, true);
+    }
+
+    void clear() {
+      if (++generation == 0) {
+        /* wraparound: invalidate all slots explicitly */
+        for (auto &v : stages)
+          for (auto &slot : v)
+            slot.generation = 0;
+
+        generation = 1;
+      }
+    }
+
+  private:
+    gcc_pure
+    bool IsValid(ScanTaskPoint key) const {
+      const unsigned stage = key.GetStageNumber();
+      const unsigned index = key.GetPointIndex();
+      assert(stage < MAX_STAGES);
+
+      const SlotVector &v = stages[stage];
+      return index < v.size() && v[index].generation == generation;
+    }
+
+    /**
+     * Advance (stage, index) to the next valid slot, or to end().
+     */
+    void FindValid(unsigned &stage, unsigned &index) const {
+      for (; stage < MAX_STAGES; ++stage, index = 0) {
+        const SlotVector &v = stages[stage];
+        for (; index < v.size(); ++index)
+          if (v[index].generation == generation)
+            return;
+      }
+
+      index = 0;
+    }
+  };
+};
+
+#endif
@@ -153,6 +153,7 @@ OrderedTask::UpdateStatsGeometry()
 void
 OrderedTask::UpdateGeometry()
 {
+  ResetSolverHints();
   UpdateStatsGeometry();
 
   if (task_points.empty())
@@ -890,6 +891,7 @@ OrderedTask::SetActiveTaskPoint(unsigned index)
 
   task_advance.SetArmed(false);
   active_task_point = index;
+  ResetSolverHints();
   force_full_update = true;
 }
 
@@ -1000,7 +1002,14 @@ OrderedTask::CalcBestMC(const AircraftState &aircraft,
   // note setting of lower limit on mc
   TaskBestMc bmc(task_points, active_task_point, aircraft,
                  task_behaviour.glide, glide_polar);
-  return bmc.search(glide_polar.GetMC(), best);
+  hint_best_mc.Apply(bmc, 0.5);
+  if (!bmc.search(glide_polar.GetMC(), best)) {
+    hint_best_mc.Reset();
+    return false;
+  }
+
+  hint_best_mc.Update(best);
+  return true;
 }
 
 
@@ -1028,7 +1037,9 @@ OrderedTask::CalcCruiseEfficiency(const AircraftState &aircraft,
   if (AllowIncrementalBoundaryStats(aircraft)) {
     TaskCruiseEfficiency bce(task_points, active_task_point, aircraft,
                              task_behaviour.glide, glide_polar);
+    hint_cruise_efficiency.Apply(bce, 0.1);
     val = bce.search(1);
+    hint_cruise_efficiency.Update(val);
     return true;
   } else {
     val = 1;
@@ -1044,7 +1055,9 @@ OrderedTask::CalcEffectiveMC(const AircraftState &aircraft,
   if (AllowIncrementalBoundaryStats(aircraft)) {
     TaskEffectiveMacCready bce(task_points, active_task_point, aircraft,
                                task_behaviour.glide, glide_polar);
+    hint_effective_mc.Apply(bce, 0.5);
     val = bce.search(glide_polar.GetMC());
+    hint_effective_mc.Update(val);
     return true;
   } else {
     val = glide_polar.GetMC();
@@ -1065,7 +1078,9 @@ OrderedTask::CalcMinTarget(const AircraftState &aircraft,
     TaskMinTarget bmt(task_points, active_task_point, aircraft,
                       task_behaviour.glide, glide_polar,
                       t_rem, taskpoint_start);
+    hint_min_target.Apply(bmt, 0.1);
     auto p = bmt.search(0);
+    hint_min_target.Update(p);
     return p;
   }
 
@@ -1123,6 +1138,7 @@ OrderedTask::Reset()
   stats.task_finished = false;
   stats.start.task_started = false;
   task_advance.Reset();
+  ResetSolverHints();
   SetActiveTaskPoint(0);
   UpdateStatsGeometry();
 }
@@ -88,6 +88,34 @@ private:
 
   StaticString<64> name;
 
+  /**
+   * The solution of a ZeroFinder based solver in the previous
+   * calculation cycle.  It changes only a little from one cycle to
+   * the next, so it is used to narrow the next search.
+   */
+  struct SolverHint {
+    double value;
+    bool defined = false;
+
+    void Reset() {
+      defined = false;
+    }
+
+    void Update(double _value) {
+      value = _value;
+      defined = true;
+    }
+
+    template<typename S>
+    void Apply(S &solver, double radius) const {
+      if (defined)
+        solver.SetHint(value, radius);
+    }
+  };
+
+  mutable SolverHint hint_best_mc, hint_cruise_efficiency, hint_effective_mc;
+  SolverHint hint_min_target;
+
 public:
   /**
    * Constructor.
@@ -487,6 +515,17 @@ private:
   gcc_pure
   bool AllowIncrementalBoundaryStats(const AircraftState &state) const;
 
+  /**
+   * Forget all solver hints; to be called when the task geometry or
+   * the active task point changes.
+   */
+  void ResetSolverHints() {
+    hint_best_mc.Reset();
+    hint_cruise_efficiency.Reset();
+    hint_effective_mc.Reset();
+    hint_min_target.Reset();
+  }
+
   bool CheckTransitionPoint(OrderedTaskPoint &point,
                             const AircraftState &state_now,
                             const AircraftState &state_last,
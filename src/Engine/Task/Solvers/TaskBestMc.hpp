@@ -80,6 +80,8 @@ public:
 
   bool search(double mc, double &result);
 
+  using ZeroFinder::SetHint;
+
 private:
 
   /**
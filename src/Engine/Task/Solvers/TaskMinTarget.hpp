@@ -91,6 +91,8 @@ public:
    */
   double search(double p);
 
+  using ZeroFinder::SetHint;
+
 private:
   void set_range(double p);
 };
@@ -73,6 +73,8 @@ public:
    * @return Value producing same travelled time
    */
   double search(double ce);
+
+  using ZeroFinder::SetHint;
 };
 
 #endif
@@ -23,11 +23,27 @@ Copyright_License {
 
 #include "FLARM/FlarmCalculations.hpp"
 
+#include <algorithm>
+
 double
 FlarmCalculations::Average30s(FlarmId id, double time, double altitude)
 {
-  ClimbAverageCalculator &item = averageCalculatorMap[id];
-  return item.GetAverage(time, altitude, 30);
+  int i = index.Find(id, items);
+  if (i < 0) {
+    if (items.size() >= MAX_ITEMS)
+      /* too many targets; don't calculate the average for this
+         one */
+      return 0;
+
+    i = items.size();
+    index.Insert(id, i);
+
+    items.emplace_back();
+    items.back().id = id;
+    items.back().calculator.Reset();
+  }
+
+  return items[i].calculator.GetAverage(time, altitude, 30);
 }
 
 void
@@ -35,11 +51,14 @@ FlarmCalculations::CleanUp(double now)
 {
   static constexpr double MAX_AGE = 60;
 
-  // Iterate through ClimbAverageCalculators and remove expired ones
-  for (auto it = averageCalculatorMap.begin(),
-       it_end = averageCalculatorMap.end(); it != it_end;)
-    if (it->second.Expired(now, MAX_AGE))
-      it = averageCalculatorMap.erase(it);
-    else
-      ++it;
+  // Remove expired ClimbAverageCalculators
+  const auto end = std::remove_if(items.begin(), items.end(),
+                                  [now](const Item &item){
+                                    return item.calculator.Expired(now,
+                                                                   MAX_AGE);
+                                  });
+  if (end != items.end()) {
+    items.erase(end, items.end());
+    index.Rebuild(items);
+  }
 }
@@ -25,17 +25,40 @@ Copyright_License {
 #define XCSOAR_FLARM_CALCULATIONS_HPP
 
 #include "FLARM/FlarmId.hpp"
+#include "FLARM/IdIndex.hpp"
 #include "Computer/ClimbAverageCalculator.hpp"
 
-#include <map>
+#include <vector>
 
 class FlarmCalculations
 {
-private:
-  typedef std::map<FlarmId, ClimbAverageCalculator> AverageCalculatorMap;
-  AverageCalculatorMap averageCalculatorMap;
+  struct Item {
+    FlarmId id;
+    ClimbAverageCalculator calculator;
+  };
+
+  /**
+   * Expired calculators are removed every second, so this is rarely
+   * much larger than the number of traffic objects.
+   */
+  static constexpr unsigned MAX_ITEMS = 512;
+
+  /**
+   * A flat array instead of a node based container, so all
+   * calculators are close to each other in memory.
+   */
+  std::vector<Item> items;
+
+  FlarmIdIndex<10> index;
+
+  static_assert(decltype(index)::SIZE >= 2 * MAX_ITEMS,
+                "Id index is too small");
 
 public:
+  FlarmCalculations() {
+    index.Clear();
+  }
+
   double Average30s(FlarmId flarmId, double curTime, double curAltitude);
 
   void CleanUp(double now);
@@ -65,6 +65,14 @@ public:
     return value < other.value;
   }
 
+  /**
+   * Calculate a hash of this id.  The upper bits are the best
+   * distributed ones (Fibonacci hashing).
+   */
+  constexpr uint32_t Hash() const {
+    return value * 2654435761u;
+  }
+
   static FlarmId Parse(const char *input, char **endptr_r);
 #ifdef _UNICODE
   static FlarmId Parse(const TCHAR *input, TCHAR **endptr_r);
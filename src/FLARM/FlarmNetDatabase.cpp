@@ -22,9 +22,83 @@ Copyright_License {
 */
 
 #include "FlarmNetDatabase.hpp"
-#include "Util/StringUtil.hpp"
+#include "OS/FileMapping.hpp"
+#include "OS/Path.hpp"
+#include "Util/StringAPI.hxx"
+
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
 
 #include <assert.h>
+#include <string.h>
+
+static_assert(sizeof(FlarmId) == sizeof(uint32_t) &&
+              std::is_trivially_copyable<FlarmId>::value,
+              "FlarmId cannot be stored in a binary file");
+static_assert(std::is_trivially_copyable<FlarmNetRecord>::value,
+              "FlarmNetRecord cannot be stored in a binary file");
+
+namespace {
+
+/**
+ * The header of the SaveBinary() format.  It is followed by the
+ * sorted ids, the callsign index and the records, each an array with
+ * #n_records elements.
+ */
+struct BinaryHeader {
+  static constexpr uint32_t MAGIC = 0x464e4442; /* "FNDB" */
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t magic;
+  uint32_t version;
+
+  /**
+   * sizeof(FlarmNetRecord), which depends on the character size.
+   */
+  uint32_t record_size;
+
+  uint32_t n_records;
+};
+
+}
+
+gcc_pure
+static int
+CompareCallSign(const FlarmNetRecord &record, const TCHAR *cn)
+{
+  return _tcscmp(record.callsign, cn);
+}
+
+FlarmNetDatabase::FlarmNetDatabase()
+{
+  SetOwned();
+}
+
+FlarmNetDatabase::~FlarmNetDatabase() {}
+
+void
+FlarmNetDatabase::SetOwned()
+{
+  assert(owned_ids.size() == owned_records.size());
+  assert(owned_callsign_index.size() == owned_records.size());
+
+  ids = owned_ids.data();
+  records = owned_records.data();
+  callsign_index = owned_callsign_index.data();
+  n_records = owned_records.size();
+}
+
+void
+FlarmNetDatabase::Clear()
+{
+  pending.clear();
+  owned_ids.clear();
+  owned_records.clear();
+  owned_callsign_index.clear();
+  mapping.reset();
+  SetOwned();
+}
 
 void
 FlarmNetDatabase::Insert(const FlarmNetRecord &record)
@@ -34,21 +108,160 @@ FlarmNetDatabase::Insert(const FlarmNetRecord &record)
     /* ignore malformed records */
     return;
 
-  map.insert(std::make_pair(id, record));
+  pending.push_back(record);
 }
 
-const FlarmNetRecord *
-FlarmNetDatabase::FindFirstRecordByCallSign(const TCHAR *cn) const
+void
+FlarmNetDatabase::Sort()
 {
-  for (const auto &i : map) {
-    assert(i.first.IsDefined());
+  /* merge with the records which are already visible */
+  if (mapping != nullptr) {
+    pending.insert(pending.begin(), records, records + n_records);
+    mapping.reset();
+  } else
+    pending.insert(pending.begin(), owned_records.begin(),
+                   owned_records.end());
+
+  std::vector<FlarmId> pending_ids;
+  pending_ids.reserve(pending.size());
+  for (const auto &record : pending)
+    pending_ids.push_back(record.GetId());
+
+  std::vector<uint32_t> order(pending.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&pending_ids](uint32_t a, uint32_t b){
+                     return pending_ids[a] < pending_ids[b];
+                   });
+
+  owned_ids.clear();
+  owned_records.clear();
+  owned_ids.reserve(order.size());
+  owned_records.reserve(order.size());
 
-    const FlarmNetRecord &record = i.second;
-    if (StringIsEqual(record.callsign, cn))
-      return &record;
+  for (uint32_t i : order) {
+    if (!owned_ids.empty() && owned_ids.back() == pending_ids[i])
+      /* duplicate id */
+      continue;
+
+    owned_ids.push_back(pending_ids[i]);
+    owned_records.push_back(pending[i]);
   }
 
-  return NULL;
+  pending.clear();
+  pending.shrink_to_fit();
+
+  owned_callsign_index.resize(owned_records.size());
+  std::iota(owned_callsign_index.begin(), owned_callsign_index.end(), 0);
+
+  /* the index is already sorted by id, which is the secondary key */
+  const auto &sorted = owned_records;
+  std::stable_sort(owned_callsign_index.begin(), owned_callsign_index.end(),
+                   [&sorted](uint32_t a, uint32_t b){
+                     return CompareCallSign(sorted[a],
+                                            sorted[b].callsign) < 0;
+                   });
+
+  SetOwned();
+}
+
+bool
+FlarmNetDatabase::SaveBinary(FILE *file) const
+{
+  assert(pending.empty());
+
+  BinaryHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = BinaryHeader::MAGIC;
+  header.version = BinaryHeader::VERSION;
+  header.record_size = sizeof(FlarmNetRecord);
+  header.n_records = n_records;
+
+  return fwrite(&header, sizeof(header), 1, file) == 1 &&
+    fwrite(ids, sizeof(*ids), n_records, file) == n_records &&
+    fwrite(callsign_index, sizeof(*callsign_index), n_records,
+           file) == n_records &&
+    fwrite(records, sizeof(*records), n_records, file) == n_records;
+}
+
+bool
+FlarmNetDatabase::LoadBinary(Path path, size_t offset)
+{
+  std::unique_ptr<FileMapping> new_mapping(new FileMapping(path));
+  if (new_mapping->error() ||
+      new_mapping->size() < offset + sizeof(BinaryHeader))
+    return false;
+
+  /* the arrays are accessed in place, so they must be aligned */
+  if (offset % alignof(uint32_t) != 0)
+    return false;
+
+  const auto *header = (const BinaryHeader *)new_mapping->at(offset);
+  if (header->magic != BinaryHeader::MAGIC ||
+      header->version != BinaryHeader::VERSION ||
+      header->record_size != sizeof(FlarmNetRecord))
+    return false;
+
+  const size_t n = header->n_records;
+  if (new_mapping->size() - offset - sizeof(*header) !=
+      n * (sizeof(FlarmId) + sizeof(uint32_t) + sizeof(FlarmNetRecord)))
+    return false;
+
+  const auto *new_ids = (const FlarmId *)(header + 1);
+  const auto *new_callsign_index = (const uint32_t *)(new_ids + n);
+  const auto *new_records = (const FlarmNetRecord *)(new_callsign_index + n);
+
+  /* don't trust the file blindly: an index out of range would crash
+     the lookups */
+  for (size_t i = 0; i < n; ++i)
+    if (new_callsign_index[i] >= n)
+      return false;
+
+  Clear();
+
+  mapping = std::move(new_mapping);
+  ids = new_ids;
+  records = new_records;
+  callsign_index = new_callsign_index;
+  n_records = n;
+  return true;
+}
+
+const FlarmNetRecord *
+FlarmNetDatabase::FindRecordById(FlarmId id) const
+{
+  const FlarmId *end = ids + n_records;
+  const FlarmId *i = std::lower_bound(ids, end, id);
+  return i != end && *i == id
+    ? &records[i - ids]
+    : NULL;
+}
+
+std::pair<const uint32_t *, const uint32_t *>
+FlarmNetDatabase::FindCallSign(const TCHAR *cn) const
+{
+  const uint32_t *end = callsign_index + n_records;
+
+  const uint32_t *first =
+    std::lower_bound(callsign_index, end, cn,
+                     [this](uint32_t i, const TCHAR *cn){
+                       return CompareCallSign(records[i], cn) < 0;
+                     });
+
+  const uint32_t *last = first;
+  while (last != end && StringIsEqual(records[*last].callsign, cn))
+    ++last;
+
+  return std::make_pair(first, last);
+}
+
+const FlarmNetRecord *
+FlarmNetDatabase::FindFirstRecordByCallSign(const TCHAR *cn) const
+{
+  const auto range = FindCallSign(cn);
+  return range.first != range.second
+    ? &records[*range.first]
+    : NULL;
 }
 
 unsigned
@@ -58,13 +271,9 @@ FlarmNetDatabase::FindRecordsByCallSign(const TCHAR *cn,
 {
   unsigned count = 0;
 
-  for (const auto &i : map) {
-    assert(i.first.IsDefined());
-
-    const FlarmNetRecord &record = i.second;
-    if (StringIsEqual(record.callsign, cn))
-      array[count++] = &record;
-  }
+  const auto range = FindCallSign(cn);
+  for (auto i = range.first; i != range.second && count < size; ++i)
+    array[count++] = &records[*i];
 
   return count;
 }
@@ -75,13 +284,9 @@ FlarmNetDatabase::FindIdsByCallSign(const TCHAR *cn, FlarmId array[],
 {
   unsigned count = 0;
 
-  for (const auto &i : map) {
-    assert(i.first.IsDefined());
-
-    const FlarmNetRecord &record = i.second;
-    if (StringIsEqual(record.callsign, cn))
-      array[count++] = i.first;
-  }
+  const auto range = FindCallSign(cn);
+  for (auto i = range.first; i != range.second && count < size; ++i)
+    array[count++] = ids[*i];
 
   return count;
 }
@@ -28,39 +28,103 @@ Copyright_License {
 #include "FlarmNetRecord.hpp"
 #include "Compiler.h"
 
-#include <map>
+#include <memory>
+#include <vector>
+
+#include <stdint.h>
+#include <stdio.h>
 #include <tchar.h>
 
+class Path;
+class FileMapping;
+
 /**
  * An in-memory representation of the FlarmNet.org database.
+ *
+ * The records are kept in an array sorted by id, with a second index
+ * sorted by callsign, so both lookups are binary searches.  The
+ * arrays are either built from records passed to Insert(), or they
+ * point into a memory-mapped binary file written by SaveBinary().
  */
 class FlarmNetDatabase {
-  typedef std::map<FlarmId, FlarmNetRecord> RecordMap;
-  RecordMap map;
+  /**
+   * Records passed to Insert(), in no particular order.  Moved to
+   * #owned_records by Sort().
+   */
+  std::vector<FlarmNetRecord> pending;
+
+  std::vector<FlarmId> owned_ids;
+  std::vector<FlarmNetRecord> owned_records;
+  std::vector<uint32_t> owned_callsign_index;
+
+  std::unique_ptr<FileMapping> mapping;
+
+  /**
+   * The ids of all records, sorted; #records has the same order.
+   */
+  const FlarmId *ids;
+
+  const FlarmNetRecord *records;
+
+  /**
+   * Positions in #records, sorted by callsign and then by id.
+   */
+  const uint32_t *callsign_index;
+
+  unsigned n_records;
 
 public:
+  FlarmNetDatabase();
+  ~FlarmNetDatabase();
+
+  FlarmNetDatabase(const FlarmNetDatabase &) = delete;
+  FlarmNetDatabase &operator=(const FlarmNetDatabase &) = delete;
+
   bool IsEmpty() const {
-    return map.empty();
+    return n_records == 0;
   }
 
-  void Clear() {
-    map.clear();
+  unsigned size() const {
+    return n_records;
   }
 
+  void Clear();
+
+  /**
+   * Add a record.  It will not be visible until Sort() is called.
+   */
   void Insert(const FlarmNetRecord &record);
 
+  /**
+   * Sort the records passed to Insert() and build the indices.  Of
+   * several records with the same id, the first one wins.
+   */
+  void Sort();
+
+  /**
+   * Write the sorted records and indices to a file, in a format
+   * which can be memory-mapped by LoadBinary().  The format depends
+   * on the build (character size), so it is only suitable for a
+   * local cache.
+   */
+  bool SaveBinary(FILE *file) const;
+
+  /**
+   * Replace the contents of this object with a file written by
+   * SaveBinary().  The file is memory-mapped, not copied.
+   *
+   * @param offset the position of the SaveBinary() data in the file
+   * @return false if the file is not usable
+   */
+  bool LoadBinary(Path path, size_t offset=0);
+
   /**
    * Finds a FLARMNetRecord object based on the given FLARM id
    * @param id FLARM id
    * @return FLARMNetRecord object
    */
   gcc_pure
-  const FlarmNetRecord *FindRecordById(FlarmId id) const {
-    auto i = map.find(id);
-    return i != map.end()
-      ? &i->second
-      : NULL;
-  }
+  const FlarmNetRecord *FindRecordById(FlarmId id) const;
 
   /**
    * Finds a FLARMNetRecord object based on the given Callsign
@@ -76,13 +140,23 @@ public:
   unsigned FindIdsByCallSign(const TCHAR *cn, FlarmId array[],
                              unsigned size) const;
 
-  RecordMap::const_iterator begin() const {
-    return map.begin();
+  const FlarmNetRecord *begin() const {
+    return records;
   }
 
-  RecordMap::const_iterator end() const {
-    return map.end();
+  const FlarmNetRecord *end() const {
+    return records + n_records;
   }
+
+private:
+  /**
+   * Find the range of #callsign_index which matches the callsign.
+   */
+  gcc_pure
+  std::pair<const uint32_t *, const uint32_t *>
+  FindCallSign(const TCHAR *cn) const;
+
+  void SetOwned();
 };
 
 #endif
@@ -30,6 +30,7 @@ Copyright_License {
 #include "MergeThread.hpp"
 #include "LocalPath.hpp"
 #include "IO/DataFile.hpp"
+#include "IO/FileCache.hpp"
 #include "IO/LineReader.hpp"
 #include "IO/FileOutputStream.hxx"
 #include "IO/BufferedOutputStream.hxx"
@@ -37,17 +38,61 @@ Copyright_License {
 #include "Profile/Current.hpp"
 #include "LogFile.hpp"
 
+static constexpr TCHAR FLARMNET_CACHE_NAME[] = _T("data.fln");
+
+static void
+SaveFLARMnetCache(FileCache &cache, Path path, const FlarmNetDatabase &db)
+{
+  FILE *file = cache.Save(FLARMNET_CACHE_NAME, path);
+  if (file == nullptr)
+    return;
+
+  if (db.SaveBinary(file))
+    cache.Commit(FLARMNET_CACHE_NAME, file);
+  else
+    cache.Cancel(FLARMNET_CACHE_NAME, file);
+}
+
+static bool
+LoadFLARMnetCache(FileCache &cache, Path path, FlarmNetDatabase &db)
+{
+  size_t offset;
+  const auto cache_path = cache.LoadPath(FLARMNET_CACHE_NAME, path, offset);
+  if (cache_path.IsNull())
+    return false;
+
+  if (!db.LoadBinary(cache_path, offset)) {
+    cache.Flush(FLARMNET_CACHE_NAME);
+    return false;
+  }
+
+  return true;
+}
+
 /**
- * Loads the FLARMnet file
+ * Loads the FLARMnet file.  A sorted binary copy is saved in the file
+ * cache, and next time, it is memory-mapped instead of parsing the
+ * text file again.
  */
 static void
 LoadFLARMnet(FlarmNetDatabase &db)
 try {
+  const auto path = LocalPath(_T("data.fln"));
+
+  if (file_cache != nullptr && LoadFLARMnetCache(*file_cache, path, db)) {
+    LogFormat("%u FLARMnet ids found in cache", db.size());
+    return;
+  }
+
   auto reader = OpenDataTextFileA(_T("data.fln"));
 
   unsigned num_records = FlarmNetReader::LoadFile(*reader, db);
-  if (num_records > 0)
+  if (num_records > 0) {
     LogFormat("%u FLARMnet ids found", num_records);
+
+    if (file_cache != nullptr)
+      SaveFLARMnetCache(*file_cache, path, db);
+  }
 } catch (const std::runtime_error &e) {
   LogError(e);
 }
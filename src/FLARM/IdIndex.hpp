@@ -0,0 +1,117 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_FLARM_ID_INDEX_HPP
+#define XCSOAR_FLARM_ID_INDEX_HPP
+
+#include "FlarmId.hpp"
+#include "Compiler.h"
+
+#include <algorithm>
+
+#include <assert.h>
+#include <stdint.h>
+
+/**
+ * A hash table (open addressing, linear probing) which maps a
+ * #FlarmId to a position in an array owned by somebody else.  The
+ * elements of that array must have an attribute called "id".
+ *
+ * Removing single entries is not supported; after removing elements
+ * from the array, call Rebuild().
+ *
+ * This class is trivial, so it can be embedded in the blackboard
+ * structures.
+ */
+template<unsigned SHIFT>
+class FlarmIdIndex {
+public:
+  static constexpr unsigned SIZE = 1u << SHIFT;
+
+  static_assert(SHIFT > 0 && SHIFT < 16, "Wrong hash table size");
+
+private:
+  /**
+   * The array position plus one; zero means the slot is empty.
+   */
+  uint16_t slots[SIZE];
+
+  static constexpr unsigned GetHome(FlarmId id) {
+    return id.Hash() >> (32 - SHIFT);
+  }
+
+  static constexpr unsigned NextSlot(unsigned i) {
+    return (i + 1) & (SIZE - 1);
+  }
+
+public:
+  void Clear() {
+    std::fill_n(slots, SIZE, 0);
+  }
+
+  /**
+   * Register a new element.  The caller must make sure that the id
+   * is not yet in the table, and that the table is never filled
+   * completely.
+   */
+  void Insert(FlarmId id, unsigned position) {
+    assert(position < SIZE);
+
+    unsigned i = GetHome(id);
+    while (slots[i] != 0)
+      i = NextSlot(i);
+
+    slots[i] = position + 1;
+  }
+
+  /**
+   * Discard the table and insert all elements of the specified array.
+   */
+  template<typename A>
+  void Rebuild(const A &array) {
+    Clear();
+
+    unsigned position = 0;
+    for (const auto &i : array)
+      Insert(i.id, position++);
+  }
+
+  /**
+   * @return the array position, or -1 if the id was not found
+   */
+  template<typename A>
+  gcc_pure
+  int Find(FlarmId id, const A &array) const {
+    for (unsigned i = GetHome(id); slots[i] != 0; i = NextSlot(i)) {
+      const unsigned position = slots[i] - 1;
+      assert(position < array.size());
+
+      if (array[position].id == id)
+        return position;
+    }
+
+    return -1;
+  }
+};
+
+#endif
@@ -23,8 +23,11 @@ Copyright_License {
 
 #include "List.hpp"
 
+#include <algorithm>
+
+template<size_t N, unsigned SHIFT>
 const FlarmTraffic *
-TrafficList::FindMaximumAlert() const
+BasicTrafficList<N, SHIFT>::FindMaximumAlert() const
 {
   const FlarmTraffic *alert = NULL;
 
@@ -40,3 +43,83 @@ TrafficList::FindMaximumAlert() const
 
   return alert;
 }
+
+template<size_t N, unsigned SHIFT>
+void
+BasicTrafficList<N, SHIFT>::SortByDistance()
+{
+  const unsigned n = list.size();
+  for (unsigned i = 0; i < n; ++i)
+    distance_order[i] = i;
+
+  std::sort(distance_order, distance_order + n,
+            [this](uint16_t a, uint16_t b){
+              return list[a].distance < list[b].distance;
+            });
+
+  distance_order_valid = true;
+}
+
+template<size_t N, unsigned SHIFT>
+const FlarmTraffic *
+BasicTrafficList<N, SHIFT>::FindNearest() const
+{
+  if (list.empty())
+    return NULL;
+
+  if (distance_order_valid)
+    return &list[distance_order[0]];
+
+  return &*std::min_element(list.begin(), list.end(),
+                            [](const FlarmTraffic &a, const FlarmTraffic &b){
+                              return a.distance < b.distance;
+                            });
+}
+
+template struct BasicTrafficList<TrafficList::MAX_COUNT, 6>;
+template struct BasicTrafficList<TrafficDatabase::MAX_COUNT, 9>;
+
+void
+TrafficDatabase::CopyRelevant(TrafficList &dest) const
+{
+  dest.Clear();
+  dest.modified = modified;
+  dest.new_traffic = new_traffic;
+
+  const unsigned n = list.size();
+  const unsigned n_dest = std::min(n, unsigned(TrafficList::MAX_COUNT));
+
+  struct Item {
+    unsigned alarm_level;
+
+    /* FlarmTraffic::distance is calculated later by FlarmComputer,
+       so use the square of the relative position */
+    double square_distance;
+
+    unsigned position;
+
+    bool operator<(const Item &other) const {
+      return alarm_level != other.alarm_level
+        ? alarm_level > other.alarm_level
+        : square_distance < other.square_distance;
+    }
+  };
+
+  Item items[MAX_COUNT];
+  for (unsigned i = 0; i < n; ++i) {
+    const FlarmTraffic &traffic = list[i];
+    items[i].alarm_level = (unsigned)traffic.alarm_level;
+    items[i].square_distance =
+      traffic.relative_north * traffic.relative_north +
+      traffic.relative_east * traffic.relative_east;
+    items[i].position = i;
+  }
+
+  if (n > n_dest)
+    std::partial_sort(items, items + n_dest, items + n);
+
+  for (unsigned i = 0; i < n_dest; ++i) {
+    const FlarmTraffic &src = list[items[i].position];
+    *dest.AllocateTraffic(src.id) = src;
+  }
+}
@@ -25,17 +25,30 @@ Copyright_License {
 #define XCSOAR_FLARM_TRAFFIC_LIST_HPP
 
 #include "Traffic.hpp"
+#include "IdIndex.hpp"
 #include "NMEA/Validity.hpp"
 #include "Util/TrivialArray.hxx"
 
 #include <type_traits>
 
+#include <assert.h>
+#include <stdint.h>
+
 /**
  * This class keeps track of the traffic objects received from a
- * FLARM.
+ * FLARM.  It is the common implementation of #TrafficList and
+ * #TrafficDatabase, which differ only in their capacity.
+ *
+ * Lookups by id use a hash table.  Do not modify the "id" attribute
+ * of an item in #list, and do not add or remove items other than with
+ * AllocateTraffic(), Expire() and Clear().
+ *
+ * @param N the maximum number of items
+ * @param SHIFT the size of the id index (log2)
  */
-struct TrafficList {
-  static constexpr size_t MAX_COUNT = 25;
+template<size_t N, unsigned SHIFT>
+struct BasicTrafficList {
+  static constexpr size_t MAX_COUNT = N;
 
   /**
    * Time stamp of the latest modification to this object.
@@ -50,32 +63,52 @@ struct TrafficList {
   /** Flarm traffic information */
   TrivialArray<FlarmTraffic, MAX_COUNT> list;
 
+  /**
+   * Maps ids to positions in #list.  It has twice as many slots as
+   * #list to keep the probe sequences short.
+   */
+  FlarmIdIndex<SHIFT> id_index;
+
+  static_assert(decltype(id_index)::SIZE >= 2 * MAX_COUNT,
+                "Id index is too small");
+
+  /**
+   * Positions in #list, sorted by FlarmTraffic::distance, nearest
+   * first.  Only valid if #distance_order_valid is set; see
+   * SortByDistance().
+   */
+  uint16_t distance_order[MAX_COUNT];
+
+  bool distance_order_valid;
+
   void Clear() {
     modified.Clear();
     new_traffic.Clear();
     list.clear();
+    id_index.Clear();
+    distance_order_valid = false;
   }
 
   bool IsEmpty() const {
     return list.empty();
   }
 
-  /**
-   * Adds data from the specified object, unless already present in
-   * this one.
-   */
-  void Complement(const TrafficList &add) {
-    if (IsEmpty() && !add.IsEmpty())
-      *this = add;
-  }
-
   void Expire(double clock) {
     modified.Expire(clock, 300);
     new_traffic.Expire(clock, 60);
 
-    for (unsigned i = list.size(); i-- > 0;)
-      if (!list[i].Refresh(clock))
+    bool removed = false;
+    for (unsigned i = list.size(); i-- > 0;) {
+      if (!list[i].Refresh(clock)) {
         list.quick_remove(i);
+        removed = true;
+      }
+    }
+
+    if (removed) {
+      id_index.Rebuild(list);
+      distance_order_valid = false;
+    }
   }
 
   unsigned GetActiveTrafficCount() const {
@@ -89,11 +122,10 @@ struct TrafficList {
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
   FlarmTraffic *FindTraffic(FlarmId id) {
-    for (auto &traffic : list)
-      if (traffic.id == id)
-        return &traffic;
-
-    return NULL;
+    const int i = id_index.Find(id, list);
+    return i >= 0
+      ? &list[i]
+      : NULL;
   }
 
   /**
@@ -103,11 +135,10 @@ struct TrafficList {
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
   const FlarmTraffic *FindTraffic(FlarmId id) const {
-    for (const auto &traffic : list)
-      if (traffic.id == id)
-        return &traffic;
-
-    return NULL;
+    const int i = id_index.Find(id, list);
+    return i >= 0
+      ? &list[i]
+      : NULL;
   }
 
   /**
@@ -139,14 +170,25 @@ struct TrafficList {
   }
 
   /**
-   * Allocates a new FLARM_TRAFFIC object from the array.
+   * Allocates a new FLARM_TRAFFIC object from the array and
+   * initialises it with the specified id.  The caller must make sure
+   * that this id is not yet in the list.
    *
    * @return the FLARM_TRAFFIC pointer, NULL if the array is full
    */
-  FlarmTraffic *AllocateTraffic() {
-    return list.full()
-      ? NULL
-      : &list.append();
+  FlarmTraffic *AllocateTraffic(FlarmId id) {
+    assert(FindTraffic(id) == NULL);
+
+    if (list.full())
+      return NULL;
+
+    id_index.Insert(id, list.size());
+    distance_order_valid = false;
+
+    FlarmTraffic &traffic = list.append();
+    traffic.Clear();
+    traffic.id = id;
+    return &traffic;
   }
 
   /**
@@ -185,13 +227,93 @@ struct TrafficList {
    * Finds the most critical alert.  Returns NULL if there is no
    * alert.
    */
+  gcc_pure
   const FlarmTraffic *FindMaximumAlert() const;
 
+  /**
+   * Sort the traffic by FlarmTraffic::distance into
+   * #distance_order.  Call this after the distances have been
+   * calculated.
+   */
+  void SortByDistance();
+
+  /**
+   * Returns the traffic nearest to the own aircraft, or NULL if the
+   * list is empty.
+   */
+  gcc_pure
+  const FlarmTraffic *FindNearest() const;
+
+  /**
+   * Invoke the visitor for each traffic which is not further away
+   * from the own aircraft than the specified range.  If
+   * SortByDistance() has been called since the last modification,
+   * the traffic is visited nearest first, and traffic out of range is
+   * not looked at.
+   */
+  template<typename V>
+  void VisitWithin(double range, V &&visitor) const {
+    if (distance_order_valid) {
+      for (unsigned i = 0, n = list.size(); i < n; ++i) {
+        const FlarmTraffic &traffic = list[distance_order[i]];
+        if (double(traffic.distance) > range)
+          break;
+
+        visitor(traffic);
+      }
+    } else {
+      for (const auto &traffic : list)
+        if (double(traffic.distance) <= range)
+          visitor(traffic);
+    }
+  }
+
   unsigned TrafficIndex(const FlarmTraffic *t) const {
     return t - list.begin();
   }
 };
 
+template<size_t N, unsigned SHIFT>
+constexpr size_t BasicTrafficList<N, SHIFT>::MAX_COUNT;
+
+/**
+ * The traffic list which is part of #NMEAInfo.  This object gets
+ * copied for each device and on each blackboard merge, so keep it
+ * small.  If there is more traffic than fits here, the
+ * #TrafficDatabase decides which targets are shown.
+ */
+struct TrafficList : BasicTrafficList<25, 6> {
+  /**
+   * Adds data from the specified object, unless already present in
+   * this one.
+   */
+  void Complement(const TrafficList &add) {
+    if (IsEmpty() && !add.IsEmpty())
+      *this = add;
+  }
+};
+
 static_assert(std::is_trivial<TrafficList>::value, "type is not trivial");
 
+/**
+ * All traffic received from the devices, for busy competition sites
+ * and for traffic feeds (e.g. OGN) which report more targets than a
+ * FLARM.  This object is too large to be part of #NMEAInfo; the
+ * #DeviceBlackboard owns one instance, the #NMEAParser writes PFLAA
+ * sentences into it, and DeviceBlackboard::Merge() copies the most
+ * relevant targets into NMEAInfo::flarm.
+ */
+struct TrafficDatabase : BasicTrafficList<256, 9> {
+  TrafficDatabase() {
+    Clear();
+  }
+
+  /**
+   * Replace the contents of the specified list with the most
+   * relevant targets: those with an alarm first, then the nearest
+   * ones.
+   */
+  void CopyRelevant(TrafficList &dest) const;
+};
+
 #endif
@@ -0,0 +1,360 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "GeoBatch.hpp"
+#include "Math.hpp"
+#include "FAISphere.hpp"
+#include "GeoPoint.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+#include <math.h>
+
+/**
+ * Temporary results are calculated in blocks of this size on the
+ * stack.
+ */
+static constexpr unsigned BLOCK_SIZE = 64;
+
+struct UnitVector {
+  double x, y, z;
+
+  explicit UnitVector(const GeoPoint &p) {
+    const auto sc_lat = p.latitude.SinCos();
+    const auto sc_lon = p.longitude.SinCos();
+    x = sc_lat.second * sc_lon.second;
+    y = sc_lat.second * sc_lon.first;
+    z = sc_lat.first;
+  }
+
+  constexpr UnitVector(double _x, double _y, double _z)
+    :x(_x), y(_y), z(_z) {}
+
+  constexpr double Dot(const UnitVector &other) const {
+    return x * other.x + y * other.y + z * other.z;
+  }
+
+  constexpr UnitVector Cross(const UnitVector &other) const {
+    return UnitVector(y * other.z - z * other.y,
+                      z * other.x - x * other.z,
+                      x * other.y - y * other.x);
+  }
+};
+
+/**
+ * Convert the result of atan2() to a bearing; unlike
+ * Angle::AsBearing(), this has no loop.
+ */
+static inline Angle
+ToBearing(double radians)
+{
+  return Angle::Radians(radians < 0
+                        ? radians + Angle::FullCircle().Radians()
+                        : radians);
+}
+
+/**
+ * Calculate the squared chord length (on the unit sphere) between
+ * #origin and each location.  This is monotonic with the distance,
+ * and does not suffer from cancellation for small distances.
+ */
+static void
+ChordSquares(const double *gcc_restrict xs, const double *gcc_restrict ys,
+             const double *gcc_restrict zs, unsigned n,
+             const UnitVector origin, double *gcc_restrict dest)
+{
+  for (unsigned i = 0; i < n; ++i) {
+    const double dx = xs[i] - origin.x;
+    const double dy = ys[i] - origin.y;
+    const double dz = zs[i] - origin.z;
+    dest[i] = dx * dx + dy * dy + dz * dz;
+  }
+}
+
+static void
+SphereDistances(const double *gcc_restrict xs, const double *gcc_restrict ys,
+                const double *gcc_restrict zs, unsigned n,
+                const UnitVector origin, double *gcc_restrict dest)
+{
+  ChordSquares(xs, ys, zs, n, origin, dest);
+
+  for (unsigned i = 0; i < n; ++i) {
+    const double half_chord = std::min(sqrt(dest[i]) / 2, 1.);
+    dest[i] = (2. * FAISphere::REARTH) * asin(half_chord);
+  }
+}
+
+static void
+SphereBearings(const double *gcc_restrict xs, const double *gcc_restrict ys,
+               const double *gcc_restrict zs, unsigned n,
+               const GeoPoint &origin, Angle *gcc_restrict dest)
+{
+  const auto sc_lat = origin.latitude.SinCos();
+  const auto sin_lat = sc_lat.first, cos_lat = sc_lat.second;
+  const auto sc_lon = origin.longitude.SinCos();
+  const auto sin_lon = sc_lon.first, cos_lon = sc_lon.second;
+
+  /* this is the formula from DistanceBearingS(), with the sine and
+     cosine of the longitude difference expanded into the unit
+     vector components */
+  for (unsigned i = 0; i < n; ++i) {
+    const double east = ys[i] * cos_lon - xs[i] * sin_lon;
+    const double north = cos_lat * zs[i] -
+      sin_lat * (xs[i] * cos_lon + ys[i] * sin_lon);
+
+    dest[i] = ToBearing(atan2(east, north));
+  }
+}
+
+/**
+ * Project the locations to a plane tangent to the origin; the result
+ * is in radians (multiply with the earth radius to get meters).
+ */
+static void
+FlatProject(const double *gcc_restrict latitudes,
+            const double *gcc_restrict longitudes, unsigned n,
+            const GeoPoint &origin,
+            double *gcc_restrict easts, double *gcc_restrict norths)
+{
+  const double lat0 = origin.latitude.Radians();
+  const double lon0 = origin.longitude.Radians();
+  const double cos_lat0 = origin.latitude.cos();
+
+  for (unsigned i = 0; i < n; ++i) {
+    double dlon = longitudes[i] - lon0;
+    dlon = dlon > M_PI
+      ? dlon - 2 * M_PI
+      : (dlon < -M_PI ? dlon + 2 * M_PI : dlon);
+
+    easts[i] = dlon * cos_lat0;
+    norths[i] = latitudes[i] - lat0;
+  }
+}
+
+void
+GeoPointBatch::clear()
+{
+  latitudes.clear();
+  longitudes.clear();
+  xs.clear();
+  ys.clear();
+  zs.clear();
+}
+
+void
+GeoPointBatch::reserve(size_type n)
+{
+  latitudes.reserve(n);
+  longitudes.reserve(n);
+  xs.reserve(n);
+  ys.reserve(n);
+  zs.reserve(n);
+}
+
+void
+GeoPointBatch::Append(const GeoPoint &location)
+{
+  assert(location.IsValid());
+
+  latitudes.push_back(location.latitude.Radians());
+  longitudes.push_back(location.longitude.Radians());
+
+  const UnitVector v(location);
+  xs.push_back(v.x);
+  ys.push_back(v.y);
+  zs.push_back(v.z);
+}
+
+GeoPoint
+GeoPointBatch::operator[](size_type i) const
+{
+  assert(i < size());
+
+  return GeoPoint(Angle::Radians(longitudes[i]),
+                  Angle::Radians(latitudes[i]));
+}
+
+void
+GeoPointBatch::DistanceBearings(const GeoPoint &origin,
+                                double *distances, Angle *bearings,
+                                GeoPrecision precision) const
+{
+  assert(origin.IsValid());
+
+  const unsigned n = size();
+
+  switch (precision) {
+  case GeoPrecision::FLAT:
+    for (unsigned start = 0; start < n; start += BLOCK_SIZE) {
+      const unsigned m = std::min(n - start, BLOCK_SIZE);
+      double easts[BLOCK_SIZE], norths[BLOCK_SIZE];
+      FlatProject(latitudes.data() + start, longitudes.data() + start, m,
+                  origin, easts, norths);
+
+      if (distances != nullptr)
+        for (unsigned i = 0; i < m; ++i)
+          distances[start + i] = FAISphere::REARTH *
+            sqrt(easts[i] * easts[i] + norths[i] * norths[i]);
+
+      if (bearings != nullptr)
+        for (unsigned i = 0; i < m; ++i)
+          bearings[start + i] = ToBearing(atan2(easts[i], norths[i]));
+    }
+
+    break;
+
+  case GeoPrecision::SPHERE:
+    if (distances != nullptr)
+      SphereDistances(xs.data(), ys.data(), zs.data(), n,
+                      UnitVector(origin), distances);
+
+    if (bearings != nullptr)
+      SphereBearings(xs.data(), ys.data(), zs.data(), n,
+                     origin, bearings);
+
+    break;
+
+  case GeoPrecision::WGS84:
+    for (unsigned i = 0; i < n; ++i)
+      ::DistanceBearing(origin, (*this)[i],
+                        distances != nullptr ? distances + i : nullptr,
+                        bearings != nullptr ? bearings + i : nullptr);
+    break;
+  }
+}
+
+void
+GeoPointBatch::ProjectedDistances(const GeoPoint &loc1, const GeoPoint &loc2,
+                                  double *distances,
+                                  GeoPrecision precision) const
+{
+  assert(loc1.IsValid());
+  assert(loc2.IsValid());
+
+  const unsigned n = size();
+
+  switch (precision) {
+  case GeoPrecision::FLAT: {
+    const double cos_lat1 = loc1.latitude.cos();
+    const double ax = (loc2.longitude - loc1.longitude).AsDelta().Radians()
+      * cos_lat1;
+    const double ay = (loc2.latitude - loc1.latitude).Radians();
+    const double a_length = sqrt(ax * ax + ay * ay);
+    if (a_length <= 0) {
+      std::fill_n(distances, n, 0.);
+      break;
+    }
+
+    const double ux = ax / a_length, uy = ay / a_length;
+
+    for (unsigned start = 0; start < n; start += BLOCK_SIZE) {
+      const unsigned m = std::min(n - start, BLOCK_SIZE);
+      double easts[BLOCK_SIZE], norths[BLOCK_SIZE];
+      FlatProject(latitudes.data() + start, longitudes.data() + start, m,
+                  loc1, easts, norths);
+
+      for (unsigned i = 0; i < m; ++i)
+        distances[start + i] = FAISphere::REARTH *
+          fabs(easts[i] * ux + norths[i] * uy);
+    }
+
+    break;
+  }
+
+  case GeoPrecision::SPHERE: {
+    const UnitVector p1(loc1), p2(loc2);
+
+    /* the normal of the great circle through loc1 and loc2 */
+    const UnitVector normal = p1.Cross(p2);
+    const double normal_length = sqrt(normal.Dot(normal));
+    if (normal_length <= 1e-12) {
+      /* coincident (or antipodal) points: there is no line */
+      std::fill_n(distances, n, 0.);
+      break;
+    }
+
+    /* the direction of the line at loc1; together with p1, this
+       spans the plane of the great circle, and the along-track angle
+       is the angle of each location's projection in that plane */
+    const UnitVector t0 = normal.Cross(p1);
+    const UnitVector t(t0.x / normal_length, t0.y / normal_length,
+                       t0.z / normal_length);
+
+    const double *gcc_restrict x = xs.data();
+    const double *gcc_restrict y = ys.data();
+    const double *gcc_restrict z = zs.data();
+
+    for (unsigned i = 0; i < n; ++i) {
+      const double along = atan2(x[i] * t.x + y[i] * t.y + z[i] * t.z,
+                                 x[i] * p1.x + y[i] * p1.y + z[i] * p1.z);
+      distances[i] = FAISphere::REARTH * fabs(along);
+    }
+
+    break;
+  }
+
+  case GeoPrecision::WGS84:
+    for (unsigned i = 0; i < n; ++i)
+      distances[i] = ::ProjectedDistance(loc1, loc2, (*this)[i]);
+    break;
+  }
+}
+
+int
+GeoPointBatch::FindNearest(const GeoPoint &origin, double range) const
+{
+  assert(origin.IsValid());
+
+  /* convert the range to a squared chord length */
+  double limit = 4;
+  if (range >= 0) {
+    const double half_angle =
+      std::min(FAISphere::EarthDistanceToAngle(range).Radians() / 2,
+               M_PI / 2);
+    limit = 4 * sin(half_angle) * sin(half_angle);
+  }
+
+  const UnitVector v(origin);
+  const unsigned n = size();
+
+  int nearest = -1;
+  double nearest_square = limit;
+
+  for (unsigned start = 0; start < n; start += BLOCK_SIZE) {
+    const unsigned m = std::min(n - start, BLOCK_SIZE);
+    double squares[BLOCK_SIZE];
+    ChordSquares(xs.data() + start, ys.data() + start, zs.data() + start,
+                 m, v, squares);
+
+    for (unsigned i = 0; i < m; ++i) {
+      if (squares[i] < nearest_square ||
+          (nearest < 0 && squares[i] <= nearest_square)) {
+        nearest = start + i;
+        nearest_square = squares[i];
+      }
+    }
+  }
+
+  return nearest;
+}
@@ -0,0 +1,146 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*! @file
+ * @brief Distance and bearing calculations for many locations at once
+ */
+
+#ifndef XCSOAR_GEO_BATCH_HPP
+#define XCSOAR_GEO_BATCH_HPP
+
+#include "Compiler.h"
+
+#include <vector>
+
+#include <stdint.h>
+
+struct GeoPoint;
+class Angle;
+
+/**
+ * Selects the earth model used by #GeoPointBatch.
+ */
+enum class GeoPrecision : uint8_t {
+  /**
+   * Equirectangular approximation around the origin (like
+   * #FlatProjection).  This is the fastest mode, but its error grows
+   * with distance and latitude; use it only for ranges up to a few
+   * dozen kilometers.
+   */
+  FLAT,
+
+  /**
+   * The FAI sphere; gives the same results as DistanceBearingS() and
+   * ProjectedDistanceS().
+   */
+  SPHERE,
+
+  /**
+   * The WGS84 ellipsoid; gives the same results as DistanceBearing()
+   * and ProjectedDistance().  This falls back to the (slow) scalar
+   * functions.
+   */
+  WGS84,
+};
+
+/**
+ * A list of locations in "structure of arrays" layout, which allows
+ * calculating distances and bearings from one origin to all of them
+ * in one pass.  The sine/cosine values needed by the spherical
+ * formulas are calculated once in Append(), which leaves only
+ * arithmetic in the loops; these are written so the compiler can
+ * vectorise them.
+ */
+class GeoPointBatch {
+  /** in radians */
+  std::vector<double> latitudes, longitudes;
+
+  /**
+   * The location as a unit vector (x points to lat=0 lon=0, z to the
+   * north pole).
+   */
+  std::vector<double> xs, ys, zs;
+
+public:
+  typedef std::vector<double>::size_type size_type;
+
+  size_type size() const {
+    return latitudes.size();
+  }
+
+  bool empty() const {
+    return latitudes.empty();
+  }
+
+  void clear();
+  void reserve(size_type n);
+
+  void Append(const GeoPoint &location);
+
+  gcc_pure
+  GeoPoint operator[](size_type i) const;
+
+  /**
+   * Calculate the distance [m] and/or the bearing from #origin to
+   * each location.
+   *
+   * @param distances an array of size() elements, or nullptr
+   * @param bearings an array of size() elements, or nullptr
+   */
+  void DistanceBearings(const GeoPoint &origin,
+                        double *distances, Angle *bearings,
+                        GeoPrecision precision=GeoPrecision::SPHERE) const;
+
+  void Distances(const GeoPoint &origin, double *distances,
+                 GeoPrecision precision=GeoPrecision::SPHERE) const {
+    DistanceBearings(origin, distances, nullptr, precision);
+  }
+
+  /**
+   * Calculate the projected distance [m] of each location along the
+   * line #loc1 - #loc2, see ProjectedDistance().  Like the scalar
+   * function, this returns the absolute value for locations behind
+   * #loc1.
+   *
+   * @param distances an array of size() elements
+   */
+  void ProjectedDistances(const GeoPoint &loc1, const GeoPoint &loc2,
+                          double *distances,
+                          GeoPrecision precision=GeoPrecision::SPHERE) const;
+
+  /**
+   * Find the location nearest to #origin (on the FAI sphere).
+   *
+   * This is a linear scan, meant for small sets which have no
+   * spatial index.  Waypoints::GetNearest() and friends don't use it,
+   * because their QuadTree needs only a few hundred nodes per query
+   * even for very large waypoint files.
+   *
+   * @param range the maximum distance [m]; negative means unlimited
+   * @return the index, or -1 if there is no location within range
+   */
+  gcc_pure
+  int FindNearest(const GeoPoint &origin, double range=-1) const;
+};
+
+#endif
@@ -0,0 +1,116 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IO_CACHE_BUFFER_HPP
+#define XCSOAR_IO_CACHE_BUFFER_HPP
+
+#include "Util/tstring.hpp"
+
+#include <vector>
+
+#include <stdint.h>
+#include <string.h>
+#include <tchar.h>
+
+/**
+ * Serialises a cache payload into a memory buffer, to be written to
+ * the #FileCache file with a single call.
+ */
+class CacheWriter {
+  std::vector<uint8_t> buffer;
+
+public:
+  size_t size() const {
+    return buffer.size();
+  }
+
+  const uint8_t *data() const {
+    return buffer.data();
+  }
+
+  void Write(const void *p, size_t length) {
+    const uint8_t *src = (const uint8_t *)p;
+    buffer.insert(buffer.end(), src, src + length);
+  }
+
+  template<typename T>
+  void Write(const T &value) {
+    Write(&value, sizeof(value));
+  }
+
+  void WriteString(const TCHAR *value, size_t length) {
+    Write(uint32_t(length));
+    Write(value, length * sizeof(*value));
+  }
+
+  void WriteString(const tstring &value) {
+    WriteString(value.data(), value.length());
+  }
+};
+
+/**
+ * Deserialises a cache payload which has been loaded into memory.
+ * All methods check the remaining size, and return false if the
+ * payload is truncated.
+ */
+class CacheReader {
+  const uint8_t *p;
+  const uint8_t *const end;
+
+public:
+  CacheReader(const uint8_t *_p, size_t size)
+    :p(_p), end(_p + size) {}
+
+  bool IsEnd() const {
+    return p == end;
+  }
+
+  bool Read(void *dest, size_t length) {
+    if (size_t(end - p) < length)
+      return false;
+
+    memcpy(dest, p, length);
+    p += length;
+    return true;
+  }
+
+  template<typename T>
+  bool Read(T &value) {
+    return Read(&value, sizeof(value));
+  }
+
+  bool ReadString(tstring &value, size_t length) {
+    if (size_t(end - p) / sizeof(TCHAR) < length)
+      return false;
+
+    value.assign((const TCHAR *)p, length);
+    p += length * sizeof(TCHAR);
+    return true;
+  }
+
+  bool ReadString(tstring &value) {
+    uint32_t length;
+    return Read(length) && ReadString(value, length);
+  }
+};
+
+#endif
@@ -160,6 +160,22 @@ FileCache::Load(const TCHAR *name, Path original_path)
   return file;
 }
 
+AllocatedPath
+FileCache::LoadPath(const TCHAR *name, Path original_path, size_t &offset_r)
+{
+  FILE *file = Load(name, original_path);
+  if (file == nullptr)
+    return nullptr;
+
+  long offset = ftell(file);
+  fclose(file);
+  if (offset < 0)
+    return nullptr;
+
+  offset_r = offset;
+  return MakeCachePath(name);
+}
+
 FILE *
 FileCache::Save(const TCHAR *name, Path original_path)
 {
@@ -45,6 +45,18 @@ public:
   void Flush(const TCHAR *name);
   FILE *Load(const TCHAR *name, Path original_path);
 
+  /**
+   * Like Load(), but instead of opening the cache file, return its
+   * path, e.g. for memory-mapping it.
+   *
+   * @param offset_r the position of the data (after the header) is
+   * returned here
+   * @return the path of the cache file, or nullptr if there is no
+   * valid cache entry
+   */
+  AllocatedPath LoadPath(const TCHAR *name, Path original_path,
+                         size_t &offset_r);
+
   FILE *Save(const TCHAR *name, Path original_path);
   bool Commit(const TCHAR *name, FILE *file);
   void Cancel(const TCHAR *name, FILE *file);
@@ -23,8 +23,11 @@ Copyright_License {
 
 #include "ZipArchive.hpp"
 #include "OS/ConvertPathName.hpp"
+#include "OS/FileMapping.hpp"
+#include "OS/ByteOrder.hpp"
 
 #include <zzip/zzip.h>
+#include <zzip/lib.h>
 
 #include <stdexcept>
 
@@ -33,6 +36,30 @@ ZipArchive::ZipArchive(Path path)
 {
   if (dir == nullptr)
     throw std::runtime_error(std::string("Failed to open ZIP archive ") + (const char *)NarrowPathName(path));
+
+  /* build the index from zziplib's copy of the central directory */
+  for (const struct zzip_dir_hdr *hdr = dir->hdr0; hdr != nullptr;) {
+    Entry entry;
+    entry.header_offset = hdr->d_off;
+    entry.compressed_size = hdr->d_csize;
+    entry.size = hdr->d_usize;
+    entry.method = hdr->d_compr;
+
+    /* like zzip_file_open(), the first entry with a given name wins */
+    index.emplace(std::string(hdr->d_name, hdr->d_namlen), entry);
+
+    if (hdr->d_reclen == 0)
+      break;
+
+    hdr = (const struct zzip_dir_hdr *)((const char *)hdr + hdr->d_reclen);
+  }
+
+  /* don't ask the kernel to read ahead the whole file; terrain
+     archives can be huge, and only small parts are needed at a
+     time */
+  mapping.reset(new FileMapping(path, false));
+  if (mapping->error())
+    mapping.reset();
 }
 
 ZipArchive::~ZipArchive()
@@ -41,11 +68,57 @@ ZipArchive::~ZipArchive()
     zzip_dir_close(dir);
 }
 
-bool
-ZipArchive::Exists(const char *name) const
+ZipArchive::ZipArchive(ZipArchive &&src)
+  :dir(src.dir), mapping(std::move(src.mapping)),
+   index(std::move(src.index))
+{
+  src.dir = nullptr;
+}
+
+ZipArchive &
+ZipArchive::operator=(ZipArchive &&src)
+{
+  std::swap(dir, src.dir);
+  std::swap(mapping, src.mapping);
+  std::swap(index, src.index);
+  return *this;
+}
+
+const ZipArchive::Entry *
+ZipArchive::Find(const char *name) const
+{
+  auto i = index.find(name);
+  return i != index.end()
+    ? &i->second
+    : nullptr;
+}
+
+ConstBuffer<void>
+ZipArchive::GetStoredData(const Entry &entry) const
 {
-  ZZIP_STAT st;
-  return zzip_dir_stat(dir, name, &st, 0) == 0;
+  /* the size of the fixed part of the local file header */
+  static constexpr size_t LOCAL_HEADER_SIZE = 30;
+
+  if (mapping == nullptr || !entry.IsStored() ||
+      entry.size != entry.compressed_size ||
+      mapping->size() < LOCAL_HEADER_SIZE ||
+      entry.header_offset > mapping->size() - LOCAL_HEADER_SIZE)
+    return nullptr;
+
+  const uint8_t *header = (const uint8_t *)mapping->at(entry.header_offset);
+  if (ReadUnalignedLE32((const uint32_t *)header) != 0x04034b50)
+    return nullptr;
+
+  /* the name and the "extra" field may differ from the central
+     directory, so their lengths must be read from the local header */
+  const size_t data_offset = size_t(entry.header_offset) + LOCAL_HEADER_SIZE
+    + ReadUnalignedLE16((const uint16_t *)(header + 26))
+    + ReadUnalignedLE16((const uint16_t *)(header + 28));
+  if (data_offset > mapping->size() ||
+      entry.size > mapping->size() - data_offset)
+    return nullptr;
+
+  return ConstBuffer<void>(mapping->at(data_offset), entry.size);
 }
 
 std::string
@@ -24,21 +24,63 @@ Copyright_License {
 #ifndef XCSOAR_IO_ZIP_ARCHIVE_HPP
 #define XCSOAR_IO_ZIP_ARCHIVE_HPP
 
+#include "Util/ConstBuffer.hxx"
 #include "Compiler.h"
 
 #include <algorithm>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <cstddef>
 
+#include <stdint.h>
+
 class Path;
+class FileMapping;
 
 /**
  * A handle to z ZIP archive file.  It is a OO wrapper for struct
  * zzip_dir.
+ *
+ * In addition to zziplib's directory, it keeps a hash index of all
+ * members, and maps the whole archive into memory (if possible), so
+ * "stored" (uncompressed) members can be accessed randomly without
+ * any system call.
  */
 class ZipArchive {
+public:
+  /**
+   * An entry of the central directory.
+   */
+  struct Entry {
+    /**
+     * The offset of the local file header within the archive.
+     */
+    uint32_t header_offset;
+
+    uint32_t compressed_size, size;
+
+    /**
+     * The compression method; 0 = stored, 8 = deflated.
+     */
+    unsigned method;
+
+    bool IsStored() const {
+      return method == 0;
+    }
+  };
+
+private:
   struct zzip_dir *dir = nullptr;
 
+  /**
+   * The whole archive mapped into memory; nullptr if mapping has
+   * failed (e.g. because the file is too large).
+   */
+  std::unique_ptr<FileMapping> mapping;
+
+  std::unordered_map<std::string, Entry> index;
+
 public:
   /**
    * Open a ZIP archive.  Throws std::runtime_error on error.
@@ -46,21 +88,36 @@ public:
   explicit ZipArchive(Path path);
   ~ZipArchive();
 
-  ZipArchive(ZipArchive &&src):dir(src.dir) {
-    src.dir = nullptr;
-  }
-
-  ZipArchive &operator=(ZipArchive &&src) {
-    std::swap(dir, src.dir);
-    return *this;
-  }
+  ZipArchive(ZipArchive &&src);
+  ZipArchive &operator=(ZipArchive &&src);
 
   struct zzip_dir *get() {
     return dir;
   }
 
   gcc_pure
-  bool Exists(const char *name) const;
+  bool Exists(const char *name) const {
+    return Find(name) != nullptr;
+  }
+
+  /**
+   * Look up a member in the index.
+   *
+   * @return the entry or nullptr if there is no such member
+   */
+  gcc_pure
+  const Entry *Find(const char *name) const;
+
+  /**
+   * Returns the contents of a "stored" member, pointing into the
+   * memory mapping.  The buffer is valid as long as this object
+   * exists.
+   *
+   * @return the contents or nullptr if the member is compressed, the
+   * archive is not mapped or the local header is malformed
+   */
+  gcc_pure
+  ConstBuffer<void> GetStoredData(const Entry &entry) const;
 
   /**
    * Obtain the next directory entry name.  Can be used to iterate
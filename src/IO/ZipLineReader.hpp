@@ -40,6 +40,9 @@ public:
   ZipLineReaderA(struct zzip_dir *dir, const char *path)
     :zip(dir, path), buffered(zip) {}
 
+  ZipLineReaderA(ZipArchive &archive, const char *path)
+    :zip(archive, path), buffered(zip) {}
+
 public:
   /* virtual methods from class NLineReader */
   char *ReadLine() override;
@@ -55,6 +58,10 @@ public:
   ZipLineReader(struct zzip_dir *dir, const char *path,
                 Charset cs=Charset::UTF8)
     :ConvertLineReader(std::make_unique<ZipLineReaderA>(dir, path), cs) {}
+
+  ZipLineReader(ZipArchive &archive, const char *path,
+                Charset cs=Charset::UTF8)
+    :ConvertLineReader(std::make_unique<ZipLineReaderA>(archive, path), cs) {}
 };
 
 #endif
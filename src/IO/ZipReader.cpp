@@ -22,16 +22,20 @@ Copyright_License {
 */
 
 #include "ZipReader.hpp"
+#include "ZipArchive.hpp"
 
 #include <zzip/util.h>
 
+#include <algorithm>
 #include <stdexcept>
 
 #include <stdio.h>
+#include <string.h>
 
-ZipReader::ZipReader(struct zzip_dir *dir, const char *path)
-  :file(zzip_open_rb(dir, path))
+static struct zzip_file *
+OpenFile(struct zzip_dir *dir, const char *path)
 {
+  auto *file = zzip_open_rb(dir, path);
   if (file == nullptr) {
     /* TODO: re-enable zziplib's error reporting, and improve this
        error message */
@@ -40,16 +44,12 @@ ZipReader::ZipReader(struct zzip_dir *dir, const char *path)
              "Failed to open '%s' from ZIP file", path);
     throw std::runtime_error(msg);
   }
-}
 
-ZipReader::~ZipReader()
-{
-  if (file != nullptr)
-    zzip_file_close(file);
+  return file;
 }
 
-uint64_t
-ZipReader::GetSize() const
+static uint64_t
+GetFileSize(struct zzip_file *file)
 {
   ZZIP_STAT st;
   return zzip_file_stat(file, &st) >= 0
@@ -57,17 +57,96 @@ ZipReader::GetSize() const
     : 0;
 }
 
-uint64_t
-ZipReader::GetPosition() const
+ZipReader::ZipReader(struct zzip_dir *dir, const char *path)
+  :file(OpenFile(dir, path)), size(GetFileSize(file))
+{
+}
+
+ZipReader::ZipReader(ZipArchive &archive, const char *path)
+{
+  const auto *entry = archive.Find(path);
+  if (entry != nullptr) {
+    const auto data = archive.GetStoredData(*entry);
+    if (!data.IsNull()) {
+      mapped = ConstBuffer<uint8_t>::FromVoid(data);
+      size = mapped.size;
+      return;
+    }
+  }
+
+  file = OpenFile(archive.get(), path);
+  size = GetFileSize(file);
+}
+
+ZipReader::~ZipReader()
+{
+  if (file != nullptr)
+    zzip_file_close(file);
+}
+
+void
+ZipReader::Seek(uint64_t offset)
 {
-  return zzip_tell(file);
+  if (offset > size)
+    throw std::runtime_error("Seek past the end of ZIP file member");
+
+  position = offset;
 }
 
 size_t
-ZipReader::Read(void *data, size_t size)
+ZipReader::Read(void *data, size_t length)
 {
-  zzip_ssize_t nbytes = zzip_file_read(file, data, size);
-  if (nbytes < 0)
-    throw std::runtime_error("Failed to read from ZIP file");
+  if (!mapped.IsNull()) {
+    const size_t nbytes = std::min<uint64_t>(length, size - position);
+    memcpy(data, mapped.data + position, nbytes);
+    position += nbytes;
+    return nbytes;
+  }
+
+  if (position < window_position ||
+      position > window_position + window_fill) {
+    /* outside of the window: let zziplib seek (this is expensive
+       for compressed members) and discard the window */
+    if (zzip_seek(file, position, SEEK_SET) < 0)
+      throw std::runtime_error("Failed to seek in ZIP file");
+
+    window_position = position;
+    window_fill = 0;
+  }
+
+  if (position == window_position + window_fill) {
+    /* the window has been consumed */
+
+    if (length >= WINDOW_SIZE) {
+      /* large read: bypass the window */
+      zzip_ssize_t nbytes = zzip_file_read(file, data, length);
+      if (nbytes < 0)
+        throw std::runtime_error("Failed to read from ZIP file");
+
+      position += nbytes;
+      window_position = position;
+      window_fill = 0;
+      return nbytes;
+    }
+
+    if (window == nullptr)
+      window.reset(new uint8_t[WINDOW_SIZE]);
+
+    zzip_ssize_t nbytes = zzip_file_read(file, window.get(), WINDOW_SIZE);
+    if (nbytes < 0)
+      throw std::runtime_error("Failed to read from ZIP file");
+
+    window_position = position;
+    window_fill = nbytes;
+  }
+
+  /* this may be a short read at the end of the window, which is
+     allowed by the Reader interface; it guarantees that a caller's
+     buffer never spans two windows, so seeking back into it is
+     cheap */
+  const size_t offset = position - window_position;
+  const size_t nbytes = std::min(length, window_fill - offset);
+  memcpy(data, window.get() + offset, nbytes);
+  position += nbytes;
   return nbytes;
 }
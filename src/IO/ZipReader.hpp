@@ -25,14 +25,54 @@ Copyright_License {
 #define XCSOAR_IO_ZIP_READER_HPP
 
 #include "Reader.hxx"
+#include "Util/ConstBuffer.hxx"
+
+#include <memory>
 
 #include <stdint.h>
 
 struct zzip_file;
 struct zzip_dir;
+class ZipArchive;
 
+/**
+ * Reads one member of a ZIP archive.
+ *
+ * If the archive is memory-mapped and the member is "stored"
+ * (uncompressed), the data is copied directly from the mapping.
+ * Otherwise, zziplib decompresses into a large read-ahead window.
+ * Seeking is lazy and cheap within the window; zziplib's expensive
+ * seek emulation (which has to inflate from the beginning of the
+ * member when going backwards) is only used when the new position is
+ * outside of it.
+ */
 class ZipReader final : public Reader {
-  struct zzip_file *const file;
+  static constexpr size_t WINDOW_SIZE = 64 * 1024;
+
+  struct zzip_file *file = nullptr;
+
+  /**
+   * The contents of a stored member within the archive's memory
+   * mapping.  If this is nullptr, #file is used.
+   */
+  ConstBuffer<uint8_t> mapped = nullptr;
+
+  /**
+   * Data decompressed by zziplib, allocated on demand.
+   */
+  std::unique_ptr<uint8_t[]> window;
+
+  /**
+   * The position of the first byte in #window within the member.
+   * The zziplib file position is always window_position+window_fill.
+   */
+  uint64_t window_position = 0;
+
+  size_t window_fill = 0;
+
+  uint64_t position = 0;
+
+  uint64_t size;
 
 public:
   /**
@@ -40,16 +80,35 @@ public:
    */
   ZipReader(struct zzip_dir *dir, const char *path);
 
+  /**
+   * Open a member using the archive's index, which allows reading
+   * stored members from the memory mapping.  The #ZipArchive must
+   * exist as long as this object.
+   *
+   * Throws std::runtime_errror on error.
+   */
+  ZipReader(ZipArchive &archive, const char *path);
+
   virtual ~ZipReader();
 
-  gcc_pure
-  uint64_t GetSize() const;
+  uint64_t GetSize() const {
+    return size;
+  }
+
+  uint64_t GetPosition() const {
+    return position;
+  }
 
-  gcc_pure
-  uint64_t GetPosition() const;
+  /**
+   * Move the read position.  This is only a cheap bookkeeping
+   * operation; the real work is done by the next Read() call.
+   *
+   * Throws std::runtime_errror if the offset is past the end.
+   */
+  void Seek(uint64_t offset);
 
   /* virtual methods from class Reader */
-  size_t Read(void *data, size_t size) override;
+  size_t Read(void *data, size_t length) override;
 };
 
 #endif
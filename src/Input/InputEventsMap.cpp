@@ -35,6 +35,12 @@ Copyright_License {
 #include "Pan.hpp"
 #include "PageActions.hpp"
 #include "Util/Clamp.hpp"
+#include "IO/FileOutputStream.hxx"
+#include "IO/BufferedOutputStream.hxx"
+#include "LocalPath.hpp"
+#include "LogFile.hpp"
+
+#include <stdexcept>
 
 // eventAutoZoom - Turn on|off|toggle AutoZoom
 // misc:
@@ -150,6 +156,48 @@ InputEvents::eventPan(const TCHAR *misc)
   XCSoarInterface::SendMapSettings(true);
 }
 
+/**
+ * This function controls the map render profiler
+ * @param misc
+ *  on             Start recording and show the statistics on the map
+ *  off            Stop recording
+ *  toggle         Toggle recording
+ *  export         Write the recorded frames to "render-trace.json"
+ *                 in the Chrome trace event format
+ */
+void
+InputEvents::eventRenderProfile(const TCHAR *misc)
+{
+  GlueMapWindow *map_window = UIGlobals::GetMap();
+  if (map_window == nullptr)
+    return;
+
+  RenderProfiler &profiler = map_window->GetRenderProfiler();
+
+  if (StringIsEqual(misc, _T("toggle")))
+    profiler.SetEnabled(!profiler.IsEnabled());
+  else if (StringIsEqual(misc, _T("on")))
+    profiler.SetEnabled(true);
+  else if (StringIsEqual(misc, _T("off")))
+    profiler.SetEnabled(false);
+  else if (StringIsEqual(misc, _T("export"))) {
+    try {
+      FileOutputStream file(LocalPath(_T("render-trace.json")));
+      BufferedOutputStream os(file);
+      profiler.ExportChromeTrace(os);
+      os.Flush();
+      file.Commit();
+      Message::AddMessage(_("Render trace saved"));
+    } catch (const std::runtime_error &e) {
+      LogError(e);
+      Message::AddMessage(_("Failed to save file."));
+    }
+    return;
+  }
+
+  map_window->QuickRedraw();
+}
+
 void
 InputEvents::sub_PanCursor(int dx, int dy)
 {
@@ -230,6 +230,11 @@ private:
   void DrawVario(Canvas &canvas, const PixelRect &rc) const;
   void DrawStallRatio(Canvas &canvas, const PixelRect &rc) const;
 
+  /**
+   * Show the statistics of #render_profiler.
+   */
+  void DrawRenderProfile(Canvas &canvas, const PixelRect &rc) const;
+
   void SwitchZoomClimb();
 
   void SaveDisplayModeScales();
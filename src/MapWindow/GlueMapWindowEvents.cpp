@@ -455,7 +455,7 @@ GlueMapWindow::Render(Canvas &canvas, const PixelRect &rc)
   MapWindow::Render(canvas, rc);
 
   if (IsNearSelf()) {
-    draw_sw.Mark("DrawGlueMisc");
+    MarkLayer("DrawGlueMisc");
     if (GetMapSettings().show_thermal_profile)
       DrawThermalBand(canvas, rc);
     DrawStallRatio(canvas, rc);
@@ -464,4 +464,9 @@ GlueMapWindow::Render(Canvas &canvas, const PixelRect &rc)
     DrawVario(canvas, rc);
     DrawGPSStatus(canvas, rc, Basic());
   }
+
+  if (render_profiler.IsEnabled()) {
+    MarkLayer("DrawRenderProfile");
+    DrawRenderProfile(canvas, rc);
+  }
 }
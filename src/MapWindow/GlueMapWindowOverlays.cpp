@@ -39,10 +39,29 @@ Copyright_License {
 #include "Util/Macros.hpp"
 #include "Util/Clamp.hpp"
 #include "Util/StringAPI.hxx"
+#include "Util/StaticString.hxx"
 #include "Look/GestureLook.hpp"
 #include "Input/InputEvents.hpp"
 #include "Renderer/MapScaleRenderer.hpp"
 
+#ifdef ENABLE_OPENGL
+#include "Screen/OpenGL/Globals.hpp"
+#endif
+
+#ifndef USE_GDI
+#include "Screen/Custom/Cache.hpp"
+#endif
+
+#ifdef USE_FREETYPE
+#include "Screen/Font.hpp"
+#endif
+
+#ifdef USE_FB
+#include "UIGlobals.hpp"
+#include "Screen/SingleWindow.hpp"
+#include "Screen/Custom/TopCanvas.hpp"
+#endif
+
 #include <stdio.h>
 
 void
@@ -427,3 +446,92 @@ GlueMapWindow::DrawStallRatio(Canvas &canvas, const PixelRect &rc) const
     canvas.DrawLine(rc.right - 1, rc.bottom - m, rc.right - 11, rc.bottom - m);
   }
 }
+
+void
+GlueMapWindow::DrawRenderProfile(Canvas &canvas, const PixelRect &rc) const
+{
+  /* show only the most expensive layers */
+  static constexpr unsigned MAX_LINES = 8;
+
+  const auto statistics = render_profiler.GetStatistics();
+  if (statistics.n_frames == 0)
+    return;
+
+  TextInBoxMode mode;
+  mode.shape = LabelShape::OUTLINED;
+
+  const Font &font = *look.overlay.overlay_font;
+  canvas.Select(font);
+
+  const unsigned padding = Layout::FastScale(4);
+  const unsigned height = font.GetHeight();
+  const int x = rc.left + padding;
+  int y = rc.top + padding;
+
+  StaticString<64> line;
+  line.Format(_T("Frame %.1f ms (max %.1f) jitter %.1f"),
+              statistics.average / 1000., statistics.maximum / 1000.,
+              statistics.jitter / 1000.);
+  TextInBox(canvas, line, x, y, mode, rc);
+  y += height;
+
+  if (statistics.average_wait > 0) {
+    line.Format(_T("Wait %.1f ms"), statistics.average_wait / 1000.);
+    TextInBox(canvas, line, x, y, mode, rc);
+    y += height;
+  }
+
+#ifdef USE_FB
+  const auto flip = UIGlobals::GetMainWindow().GetFlipStatistics();
+  if (flip.n_frames > 0) {
+    line.Format(_T("Flip %u rects %lu px (avg %llu)"),
+                flip.n_rects, flip.n_pixels,
+                flip.total_pixels / flip.n_frames);
+    TextInBox(canvas, line, x, y, mode, rc);
+    y += height;
+  }
+#endif
+
+#ifdef ENABLE_OPENGL
+  /* the map is drawn in the main thread, which also updates these
+     counters */
+  const auto &draw = OpenGL::frame_draw_statistics;
+  line.Format(_T("GL %u draw calls, %u batched"),
+              draw.draw_calls, draw.batched_primitives);
+  TextInBox(canvas, line, x, y, mode, rc);
+  y += height;
+#endif
+
+#ifndef USE_GDI
+  const auto text = TextCache::GetStatistics();
+  if (text.hits + text.misses > 0) {
+    line.Format(_T("Text cache %lu%% hits, %lu misses"),
+                text.hits * 100 / (text.hits + text.misses), text.misses);
+    TextInBox(canvas, line, x, y, mode, rc);
+    y += height;
+  }
+#endif
+
+#ifdef USE_FREETYPE
+  const auto glyphs = Font::GetGlyphStatistics();
+  if (glyphs.hits + glyphs.misses > 0) {
+    line.Format(_T("Glyphs %lu%% hits, %lu rasterised (%.1f ms)"),
+                glyphs.hits * 100 / (glyphs.hits + glyphs.misses),
+                glyphs.misses, glyphs.rasterisation_us / 1000.);
+    TextInBox(canvas, line, x, y, mode, rc);
+    y += height;
+  }
+#endif
+
+  unsigned n = 0;
+  for (const auto &layer : statistics.layers) {
+    if (n++ >= MAX_LINES)
+      break;
+
+    line.SetASCII(layer.name);
+    line.AppendFormat(_T(" %.1f ms (max %.1f)"),
+                      layer.average / 1000., layer.maximum / 1000.);
+    TextInBox(canvas, line, x, y, mode, rc);
+    y += height;
+  }
+}
@@ -27,6 +27,8 @@ Copyright_License {
 #include "Topography/CachedTopographyRenderer.hpp"
 #include "Terrain/RasterTerrain.hpp"
 #include "Weather/Rasp/RaspRenderer.hpp"
+#include "Weather/Rasp/RaspPrefetcher.hpp"
+#include "OS/SystemLoad.hpp"
 #include "Computer/GlideComputer.hpp"
 
 #ifdef ENABLE_OPENGL
@@ -137,7 +139,9 @@ MapWindow::OnPaintBuffer(Canvas &canvas)
 #endif
 
   // Render the moving map
+  render_profiler.BeginFrame();
   Render(canvas, GetClientRect());
+  render_profiler.EndFrame();
   draw_sw.Finish();
 
 #ifndef ENABLE_OPENGL
@@ -170,5 +174,10 @@ void
 MapWindow::SetRasp(const std::shared_ptr<RaspStore> &_rasp_store)
 {
   rasp_renderer.reset();
+  rasp_prefetcher.reset();
   rasp_store = _rasp_store;
+
+  if (rasp_store != nullptr)
+    rasp_prefetcher.reset(new RaspPrefetcher(*rasp_store,
+                                             SystemCPUCount()));
 }
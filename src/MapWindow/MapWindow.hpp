@@ -32,6 +32,7 @@ Copyright_License {
 #endif
 #include "Renderer/LabelBlock.hpp"
 #include "Screen/StopWatch.hpp"
+#include "RenderProfiler.hpp"
 #include "MapWindowBlackboard.hpp"
 #include "Renderer/AirspaceLabelRenderer.hpp"
 #include "Renderer/BackgroundRenderer.hpp"
@@ -49,6 +50,7 @@ class TopographyStore;
 class CachedTopographyRenderer;
 class RasterTerrain;
 class RaspStore;
+class RaspPrefetcher;
 class RaspRenderer;
 class MapOverlay;
 class Waypoints;
@@ -125,6 +127,12 @@ protected:
 
   std::shared_ptr<RaspStore> rasp_store;
 
+  /**
+   * Decodes and caches the maps of #rasp_store.  It lives as long as
+   * the store, so the cache survives switching between parameters.
+   */
+  std::unique_ptr<RaspPrefetcher> rasp_prefetcher;
+
   /**
    * The current RASP renderer.  Modifications to this pointer (but
    * not to the #RaspRenderer instance) are protected by
@@ -182,6 +190,11 @@ protected:
    */
   ScreenStopWatch draw_sw;
 
+  /**
+   * Per-layer timing of OnPaintBuffer(), enabled at runtime.
+   */
+  RenderProfiler render_profiler;
+
   friend class DrawThread;
 
 public:
@@ -189,6 +202,10 @@ public:
             const TrafficLook &traffic_look);
   virtual ~MapWindow();
 
+  RenderProfiler &GetRenderProfiler() {
+    return render_profiler;
+  }
+
   /**
    * Is the rendered map following the user's aircraft (i.e. near it)?
    */
@@ -307,6 +324,16 @@ protected:
   void DrawTerrainAbove(Canvas &canvas);
   void DrawFLARMTraffic(Canvas &canvas, PixelPoint aircraft_pos) const;
 
+  /**
+   * Start timing a new map layer, for #draw_sw and #render_profiler.
+   *
+   * @param name a string literal
+   */
+  void MarkLayer(const char *name) {
+    draw_sw.Mark(name);
+    render_profiler.Mark(name);
+  }
+
   // thread, main functions
   /**
    * Renders all the components of the moving map
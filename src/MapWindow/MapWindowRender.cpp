@@ -73,7 +73,7 @@ MapWindow::RenderRasp(Canvas &canvas)
 #ifndef ENABLE_OPENGL
     const ScopeLock protect(mutex);
 #endif
-    rasp_renderer.reset(new RaspRenderer(*rasp_store, state.map));
+    rasp_renderer.reset(new RaspRenderer(*rasp_prefetcher, state.map));
   }
 
   rasp_renderer->SetTime(state.time);
@@ -210,73 +210,76 @@ MapWindow::Render(Canvas &canvas, const PixelRect &rc)
   //////////////////////////////////////////////// items on ground
 
   // Render terrain, groundline and topography
-  draw_sw.Mark("RenderTerrain");
+  MarkLayer("RenderTerrain");
   RenderTerrain(canvas);
 
-  draw_sw.Mark("RenderRasp");
+  MarkLayer("RenderRasp");
   RenderRasp(canvas);
 
-  draw_sw.Mark("RenderTopography");
+  MarkLayer("RenderTopography");
   RenderTopography(canvas);
 
-  draw_sw.Mark("RenderOverlays");
+  MarkLayer("RenderOverlays");
   RenderOverlays(canvas);
 
-  draw_sw.Mark("DrawNOAAStations");
+  MarkLayer("DrawNOAAStations");
   RenderNOAAStations(canvas);
 
   //////////////////////////////////////////////// glide range info
 
-  draw_sw.Mark("RenderFinalGlideShading");
+  MarkLayer("RenderFinalGlideShading");
   RenderFinalGlideShading(canvas);
 
   //////////////////////////////////////////////// airspace
 
   // Render airspace
-  draw_sw.Mark("RenderAirspace");
+  MarkLayer("RenderAirspace");
   RenderAirspace(canvas);
 
   //////////////////////////////////////////////// task
 
   // Render task, waypoints
-  draw_sw.Mark("DrawContest");
+  MarkLayer("DrawContest");
   DrawContest(canvas);
 
-  draw_sw.Mark("DrawTask");
+  MarkLayer("DrawTask");
   DrawTask(canvas);
 
-  draw_sw.Mark("DrawWaypoints");
+  MarkLayer("DrawWaypoints");
   DrawWaypoints(canvas);
 
   //////////////////////////////////////////////// aircraft level items
   // Render the snail trail
+  MarkLayer("RenderTrail");
   if (basic.location_available)
     RenderTrail(canvas, aircraft_pos);
 
+  MarkLayer("DrawWaves");
   DrawWaves(canvas);
 
   // Render estimate of thermal location
+  MarkLayer("DrawThermalEstimate");
   DrawThermalEstimate(canvas);
 
   //////////////////////////////////////////////// text items
   // Render topography on top of airspace, to keep the text readable
-  draw_sw.Mark("RenderTopographyLabels");
+  MarkLayer("RenderTopographyLabels");
   RenderTopographyLabels(canvas);
 
   //////////////////////////////////////////////// navigation overlays
   // Render glide through terrain range
-  draw_sw.Mark("RenderGlide");
+  MarkLayer("RenderGlide");
   RenderGlide(canvas);
 
-  draw_sw.Mark("RenderMisc1");
+  MarkLayer("RenderMisc1");
   // Render weather/terrain max/min values
   DrawTaskOffTrackIndicator(canvas);
 
   // Render track bearing (projected track ground/air relative)
-  draw_sw.Mark("DrawTrackBearing");
+  MarkLayer("DrawTrackBearing");
   RenderTrackBearing(canvas, aircraft_pos);
 
-  draw_sw.Mark("RenderMisc2");
+  MarkLayer("RenderMisc2");
   DrawBestCruiseTrack(canvas, aircraft_pos);
 
   // Draw wind vector at aircraft
@@ -288,6 +291,7 @@ MapWindow::Render(Canvas &canvas, const PixelRect &rc)
 
   //////////////////////////////////////////////// traffic
   // Draw traffic
+  MarkLayer("DrawTraffic");
 
 #ifdef HAVE_SKYLINES_TRACKING
   DrawSkyLinesTraffic(canvas);
@@ -300,6 +304,7 @@ MapWindow::Render(Canvas &canvas, const PixelRect &rc)
 
   //////////////////////////////////////////////// own aircraft
   // Finally, draw you!
+  MarkLayer("DrawAircraft");
   if (basic.location_available)
     AircraftRenderer::Draw(canvas, GetMapSettings(), look.aircraft,
                            basic.attitude.heading - render_projection.GetScreenAngle(),
@@ -57,15 +57,22 @@ MapWindow::DrawFLARMTraffic(Canvas &canvas,
   if (projection.GetMapScale() > 7300)
     return;
 
+  // Without the own location, the target locations are unknown
+  if (!Basic().location_available)
+    return;
+
   canvas.Select(*traffic_look.font);
 
-  // Circle through the FLARM targets
-  for (auto it = flarm.list.begin(), end = flarm.list.end();
-      it != end; ++it) {
-    const FlarmTraffic &traffic = *it;
+  /* traffic further away from the aircraft than this cannot be on the
+     screen */
+  const double range =
+    Basic().location.DistanceS(projection.GetGeoScreenCenter()) +
+    projection.GetScreenDistanceMeters();
 
+  // Circle through the FLARM targets
+  flarm.VisitWithin(range, [&](const FlarmTraffic &traffic){
     if (!traffic.location_available)
-      continue;
+      return;
 
     // Save the location of the FLARM target
     GeoPoint target_loc = traffic.location;
@@ -75,7 +82,7 @@ MapWindow::DrawFLARMTraffic(Canvas &canvas,
 
     // If FLARM target not on the screen, move to the next one
     if (!projection.GeoToScreenIfVisible(target_loc, sc))
-      continue;
+      return;
 
     // Draw the name 16 points below the icon
     sc_name = sc;
@@ -113,7 +120,7 @@ MapWindow::DrawFLARMTraffic(Canvas &canvas,
     TrafficRenderer::Draw(canvas, traffic_look, traffic,
                           traffic.track - projection.GetScreenAngle(),
                           color, sc);
-  }
+  });
 }
 
 /**
@@ -0,0 +1,286 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "RenderProfiler.hpp"
+#include "IO/BufferedOutputStream.hxx"
+#include "OS/Clock.hpp"
+
+#include <algorithm>
+
+#include <string.h>
+#include <stdlib.h>
+
+#ifdef HAVE_POSIX
+#include <time.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+uint64_t
+RenderProfiler::GetThreadCPUTime()
+{
+#if defined(HAVE_POSIX) && defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) < 0)
+    return 0;
+
+  return uint64_t(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+#elif defined(_WIN32)
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!::GetThreadTimes(::GetCurrentThread(), &creation_time, &exit_time,
+                        &kernel_time, &user_time))
+    return 0;
+
+  /* FILETIME is in units of 100 ns */
+  const uint64_t kernel = kernel_time.dwLowDateTime |
+    (uint64_t(kernel_time.dwHighDateTime) << 32);
+  const uint64_t user = user_time.dwLowDateTime |
+    (uint64_t(user_time.dwHighDateTime) << 32);
+  return (kernel + user) / 10;
+#else
+  return 0;
+#endif
+}
+
+void
+RenderProfiler::SetEnabled(bool _enabled)
+{
+  if (_enabled && !IsEnabled())
+    Clear();
+
+  enabled.store(_enabled, std::memory_order_relaxed);
+}
+
+void
+RenderProfiler::Clear()
+{
+  const ScopeLock protect(mutex);
+  n_frames = next_frame = 0;
+  pending_wait = 0;
+}
+
+void
+RenderProfiler::AddWaitTime(unsigned us)
+{
+  if (!IsEnabled())
+    return;
+
+  const ScopeLock protect(mutex);
+  pending_wait += us;
+}
+
+void
+RenderProfiler::BeginFrame()
+{
+  if (IsEnabled())
+    BeginFrame(MonotonicClockUS(), GetThreadCPUTime());
+}
+
+void
+RenderProfiler::BeginFrame(uint64_t clock, uint64_t cpu)
+{
+  current.start = clock;
+  current.layers.clear();
+  frame_cpu = cpu;
+  layer_name = nullptr;
+  in_frame = true;
+}
+
+void
+RenderProfiler::FinishLayer(uint64_t clock, uint64_t cpu)
+{
+  if (layer_name == nullptr || current.layers.full())
+    return;
+
+  Layer &layer = current.layers.append();
+  layer.name = layer_name;
+  layer.offset = unsigned(layer_clock - current.start);
+  layer.duration = unsigned(clock - layer_clock);
+  layer.cpu = unsigned(cpu - layer_cpu);
+}
+
+void
+RenderProfiler::Mark(const char *name)
+{
+  if (in_frame)
+    Mark(name, MonotonicClockUS(), GetThreadCPUTime());
+}
+
+void
+RenderProfiler::Mark(const char *name, uint64_t clock, uint64_t cpu)
+{
+  if (!in_frame)
+    return;
+
+  FinishLayer(clock, cpu);
+
+  layer_name = name;
+  layer_clock = clock;
+  layer_cpu = cpu;
+}
+
+void
+RenderProfiler::EndFrame()
+{
+  if (in_frame)
+    EndFrame(MonotonicClockUS(), GetThreadCPUTime());
+}
+
+void
+RenderProfiler::EndFrame(uint64_t clock, uint64_t cpu)
+{
+  if (!in_frame)
+    return;
+
+  FinishLayer(clock, cpu);
+  in_frame = false;
+
+  current.duration = unsigned(clock - current.start);
+  current.cpu = unsigned(cpu - frame_cpu);
+
+  const ScopeLock protect(mutex);
+  current.wait = pending_wait;
+  pending_wait = 0;
+
+  frames[next_frame] = current;
+  next_frame = (next_frame + 1) % MAX_FRAMES;
+  if (n_frames < MAX_FRAMES)
+    ++n_frames;
+}
+
+RenderProfiler::Statistics
+RenderProfiler::GetStatistics() const
+{
+  Statistics s;
+  s.n_frames = 0;
+  s.average = s.maximum = s.jitter = s.average_wait = 0;
+
+  struct Sum {
+    uint64_t duration, cpu;
+  };
+  Sum sums[MAX_LAYERS];
+
+  uint64_t total = 0, jitter = 0, wait = 0;
+
+  const ScopeLock protect(mutex);
+  if (n_frames == 0)
+    return s;
+
+  /* iterate from the oldest frame to the newest one */
+  const unsigned first = (next_frame + MAX_FRAMES - n_frames) % MAX_FRAMES;
+  const Frame *previous = nullptr;
+  for (unsigned n = 0; n < n_frames; ++n) {
+    const Frame &frame = frames[(first + n) % MAX_FRAMES];
+
+    total += frame.duration;
+    wait += frame.wait;
+    s.maximum = std::max(s.maximum, frame.duration);
+    if (previous != nullptr)
+      jitter += abs(int(frame.duration) - int(previous->duration));
+    previous = &frame;
+
+    for (const auto &layer : frame.layers) {
+      auto i = std::find_if(s.layers.begin(), s.layers.end(),
+                            [&layer](const LayerStatistics &l){
+                              return strcmp(l.name, layer.name) == 0;
+                            });
+      if (i == s.layers.end()) {
+        if (s.layers.full())
+          continue;
+
+        i = &s.layers.append();
+        i->name = layer.name;
+        i->maximum = 0;
+        sums[i - s.layers.begin()] = {0, 0};
+      }
+
+      Sum &sum = sums[i - s.layers.begin()];
+      sum.duration += layer.duration;
+      sum.cpu += layer.cpu;
+      i->maximum = std::max(i->maximum, layer.duration);
+    }
+  }
+
+  s.n_frames = n_frames;
+  s.average = unsigned(total / n_frames);
+  s.average_wait = unsigned(wait / n_frames);
+  if (n_frames > 1)
+    s.jitter = unsigned(jitter / (n_frames - 1));
+
+  /* layers which are not drawn in every frame count as zero in the
+     others */
+  for (unsigned i = 0; i < s.layers.size(); ++i) {
+    s.layers[i].average = unsigned(sums[i].duration / n_frames);
+    s.layers[i].average_cpu = unsigned(sums[i].cpu / n_frames);
+  }
+
+  std::stable_sort(s.layers.begin(), s.layers.end(),
+                   [](const LayerStatistics &a, const LayerStatistics &b){
+                     return a.average > b.average;
+                   });
+
+  return s;
+}
+
+static void
+WriteTraceEvent(BufferedOutputStream &os, bool &first, const char *name,
+                uint64_t ts, unsigned duration, unsigned cpu)
+{
+  if (!first)
+    os.Write(",\n");
+  first = false;
+
+  os.Format("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+            "\"ts\":%llu,\"dur\":%u,\"args\":{\"cpu_us\":%u}}",
+            name, (unsigned long long)ts, duration, cpu);
+}
+
+void
+RenderProfiler::ExportChromeTrace(BufferedOutputStream &os) const
+{
+  os.Write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+  bool first = true;
+
+  {
+    const ScopeLock protect(mutex);
+
+    const unsigned start = (next_frame + MAX_FRAMES - n_frames) % MAX_FRAMES;
+    for (unsigned n = 0; n < n_frames; ++n) {
+      const Frame &frame = frames[(start + n) % MAX_FRAMES];
+
+      if (frame.wait > 0 && frame.wait <= frame.start)
+        WriteTraceEvent(os, first, "DrawThread wait",
+                        frame.start - frame.wait, frame.wait, 0);
+
+      WriteTraceEvent(os, first, "Frame",
+                      frame.start, frame.duration, frame.cpu);
+
+      for (const auto &layer : frame.layers)
+        WriteTraceEvent(os, first, layer.name,
+                        frame.start + layer.offset,
+                        layer.duration, layer.cpu);
+    }
+  }
+
+  os.Write("\n]}\n");
+}
@@ -0,0 +1,186 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_RENDER_PROFILER_HPP
+#define XCSOAR_RENDER_PROFILER_HPP
+
+#include "Thread/Mutex.hpp"
+#include "Util/StaticArray.hxx"
+#include "Compiler.h"
+
+#include <atomic>
+
+#include <stdint.h>
+
+class BufferedOutputStream;
+
+/**
+ * Measures how much time the map renderer spends on each layer.
+ * Unlike #ScreenStopWatch, this can be enabled at runtime.  The last
+ * #MAX_FRAMES frames are kept in a ring buffer; they can be
+ * summarised for an on-map overlay, or exported in the JSON trace
+ * event format understood by Chrome's "about:tracing" and Perfetto.
+ *
+ * BeginFrame(), Mark() and EndFrame() must be called by the thread
+ * which renders the map.  All other methods are thread-safe.
+ */
+class RenderProfiler {
+public:
+  static constexpr unsigned MAX_LAYERS = 32;
+  static constexpr unsigned MAX_FRAMES = 64;
+
+  struct Layer {
+    const char *name;
+
+    /**
+     * The start time relative to the start of the frame [us].
+     */
+    unsigned offset;
+
+    /**
+     * Wall clock and thread CPU time [us].  The CPU time is zero if
+     * the platform does not provide it.
+     */
+    unsigned duration, cpu;
+  };
+
+  struct Frame {
+    /**
+     * The start time on the monotonic clock [us].
+     */
+    uint64_t start;
+
+    unsigned duration, cpu;
+
+    /**
+     * The time the DrawThread was idle before this frame [us].
+     */
+    unsigned wait;
+
+    StaticArray<Layer, MAX_LAYERS> layers;
+  };
+
+  struct LayerStatistics {
+    const char *name;
+    unsigned average, maximum, average_cpu;
+  };
+
+  struct Statistics {
+    unsigned n_frames;
+
+    unsigned average, maximum;
+
+    /**
+     * The average difference between the durations of two
+     * consecutive frames [us].
+     */
+    unsigned jitter;
+
+    unsigned average_wait;
+
+    /**
+     * Sorted by average duration, most expensive first.
+     */
+    StaticArray<LayerStatistics, MAX_LAYERS> layers;
+  };
+
+private:
+  std::atomic<bool> enabled;
+
+  /**
+   * Protects #frames, #n_frames, #next_frame and #pending_wait.
+   */
+  mutable Mutex mutex;
+
+  Frame frames[MAX_FRAMES];
+  unsigned n_frames, next_frame;
+
+  unsigned pending_wait;
+
+  /* the frame being recorded; accessed only by the rendering
+     thread */
+  Frame current;
+  bool in_frame;
+  const char *layer_name;
+  uint64_t layer_clock, layer_cpu, frame_cpu;
+
+public:
+  RenderProfiler()
+    :enabled(false), n_frames(0), next_frame(0), pending_wait(0),
+     in_frame(false) {}
+
+  RenderProfiler(const RenderProfiler &) = delete;
+  RenderProfiler &operator=(const RenderProfiler &) = delete;
+
+  bool IsEnabled() const {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Enable or disable recording.  Enabling discards old frames.
+   */
+  void SetEnabled(bool _enabled);
+
+  void Clear();
+
+  /**
+   * Account time during which the rendering thread waited for work.
+   * It is attributed to the next frame.
+   */
+  void AddWaitTime(unsigned us);
+
+  void BeginFrame();
+  void BeginFrame(uint64_t clock, uint64_t cpu);
+
+  /**
+   * Finish the current layer (if any), and start a new one.
+   *
+   * @param name a string literal
+   */
+  void Mark(const char *name);
+  void Mark(const char *name, uint64_t clock, uint64_t cpu);
+
+  void EndFrame();
+  void EndFrame(uint64_t clock, uint64_t cpu);
+
+  gcc_pure
+  Statistics GetStatistics() const;
+
+  /**
+   * Write all recorded frames as a Chrome trace (JSON).
+   *
+   * Throws std::runtime_error on error.
+   */
+  void ExportChromeTrace(BufferedOutputStream &os) const;
+
+  /**
+   * Returns the CPU time consumed by the calling thread [us], or 0
+   * if that is not available on this platform.
+   */
+  gcc_pure
+  static uint64_t GetThreadCPUTime();
+
+private:
+  void FinishLayer(uint64_t clock, uint64_t cpu);
+};
+
+#endif
@@ -76,9 +76,15 @@ StencilMapCanvas::DrawSearchPointVector(const SearchPointVector &points)
   for (unsigned i = 0; i < size; ++i)
     screen[i] = proj.GeoToScreen(geo_points[i]);
 
-  buffer.DrawPolygon(&screen[0], size);
+  DrawPolygon(screen, size);
+}
+
+void
+StencilMapCanvas::DrawPolygon(const BulkPixelPoint *screen, unsigned size)
+{
+  buffer.DrawPolygon(screen, size);
   if (use_stencil)
-    stencil.DrawPolygon(&screen[0], size);
+    stencil.DrawPolygon(screen, size);
 }
 
 void
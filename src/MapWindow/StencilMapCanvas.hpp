@@ -26,10 +26,10 @@ Copyright_License {
 
 #ifndef ENABLE_OPENGL
 
+#include "Screen/BulkPoint.hpp"
 #include "Geo/GeoClip.hpp"
 #include "Util/AllocatedArray.hxx"
 
-struct PixelPoint;
 class Canvas;
 class Projection;
 class WindowProjection;
@@ -67,6 +67,12 @@ public:
 
   void DrawSearchPointVector(const SearchPointVector &points);
 
+  /**
+   * Draw a polygon which has already been projected to screen
+   * coordinates.
+   */
+  void DrawPolygon(const BulkPixelPoint *screen, unsigned size);
+
   void DrawCircle(const PixelPoint &center, unsigned radius);
 
   void Begin();
@@ -21,6 +21,7 @@
  */
 #include "ZeroFinder.hpp"
 
+#include <algorithm>
 #include <limits>
 
 #include <math.h>
@@ -137,30 +138,55 @@ ZeroFinder::find_zero(const double xstart)
 #ifdef INSTRUMENT_ZERO
   zero_total++;
 #endif
+  double x;
+  if (find_zero_hinted(x))
+    return x;
+
   if ((xmin<=xstart) || (xstart<=xmax) ||
       (f(xstart)> sqrt_epsilon))
-    return find_zero_actual(xstart);
+    return find_zero_actual();
 #ifdef INSTRUMENT_ZERO
   zero_skipped++;
 #endif
   return xstart;
 }
 
-inline double
-ZeroFinder::find_zero_actual(const double xstart)
+inline bool
+ZeroFinder::find_zero_hinted(double &x)
 {
-  double a, b, c; // Abscissae, descr. see above
-  double fa; // f(a)
-  double fb; // f(b)
-  double fc; // f(c)
+  if (hint_radius <= 0)
+    return false;
 
-  bool b_best = true; // b is best and last called
+  const double a = std::max(xmin, hint - hint_radius);
+  const double b = std::min(xmax, hint + hint_radius);
+  if (a >= b)
+    return false;
+
+  const double fa = f(a);
+  const double fb = f(b);
+  if ((fa > 0 && fb > 0) || (fa < 0 && fb < 0))
+    /* no sign change; the zero has moved away, or there is none */
+    return false;
+
+  x = find_zero_bracket(a, fa, b, fb);
+  return true;
+}
 
-  c = a = xmin;  
-  fc = fa = f(a);  
+inline double
+ZeroFinder::find_zero_actual()
+{
+  const double fa = f(xmin);
+  const double fb = f(xmax);
+  return find_zero_bracket(xmin, fa, xmax, fb);
+}
 
-  b = xmax;  
-  fb = f(b);
+double
+ZeroFinder::find_zero_bracket(double a, double fa, double b, double fb)
+{
+  double c = a; // Abscissae, descr. see above
+  double fc = fa; // f(c)
+
+  bool b_best = true; // b is best and last called
 
   // Main iteration loop
   for (;;) {
@@ -42,6 +42,11 @@ protected:
   /** search tolerance in x */
   const double tolerance;
 
+  /** expected location of the zero, see SetHint() */
+  double hint;
+  /** half width of the interval around #hint; zero if no hint */
+  double hint_radius = 0;
+
 public:
   /**
    * Constructor of zero finder search algorithm
@@ -65,6 +70,21 @@ public:
    */
   virtual double f(const double x) = 0;
 
+  /**
+   * Narrow the next find_zero() call: the zero is first searched for
+   * within [x-radius, x+radius], and only if f() does not change sign
+   * there, the whole range is searched.  Typically, x is the solution
+   * of the previous calculation cycle.
+   *
+   * @param x Expected location of the zero
+   * @param radius Half width of the initial search interval
+   */
+  void SetHint(double x, double radius) {
+    assert(radius > 0);
+    hint = x;
+    hint_radius = radius;
+  }
+
   /**
    * Find closest value of x that produces f(x)=0
    * Method used is a variant of a bisector search.
@@ -91,7 +111,21 @@ public:
 
 private:
   gcc_pure
-  double find_zero_actual(const double xstart);
+  double find_zero_actual();
+
+  /**
+   * Search for the zero within the interval [a,b], given f(a) and
+   * f(b) of opposite sign.
+   */
+  gcc_pure
+  double find_zero_bracket(double a, double fa, double b, double fb);
+
+  /**
+   * Attempt to bracket the zero around #hint.
+   *
+   * @return true if #x was found within the hint interval
+   */
+  bool find_zero_hinted(double &x);
 
   gcc_pure
   double find_min_actual(const double xstart);
@@ -87,13 +87,23 @@ Net::DownloadManager::Enumerate(DownloadListener &listener)
 }
 
 void
-Net::DownloadManager::Enqueue(const char *uri, Path relative_path)
+Net::DownloadManager::Enqueue(const char *uri, Path relative_path,
+                              const char *md5)
 {
   assert(download_manager != nullptr);
 
+  /* the Android DownloadManager does its own resuming; there is no
+     way to pass the digest to it */
+
   download_manager->Enqueue(Java::GetEnv(), uri, relative_path);
 }
 
+void
+Net::DownloadManager::SetBandwidthLimit(unsigned bytes_per_second)
+{
+  /* not supported by the Android DownloadManager */
+}
+
 void
 Net::DownloadManager::Cancel(Path relative_path)
 {
@@ -104,34 +114,65 @@ Net::DownloadManager::Cancel(Path relative_path)
 
 #else /* !ANDROID */
 
-#include "ToFile.hpp"
+#include "ResumableDownload.hpp"
+#include "RateLimiter.hpp"
 #include "Session.hpp"
 #include "Thread/StandbyThread.hpp"
-#include "Operation/Operation.hpp"
 #include "LocalPath.hpp"
-#include "IO/FileTransaction.hpp"
 #include "LogFile.hpp"
+#include "OS/Clock.hpp"
+#include "OS/Sleep.h"
 
 #include <string>
 #include <list>
+#include <memory>
 #include <algorithm>
 
 #include <string.h>
 
-class DownloadManagerThread final
-  : protected StandbyThread, private QuietOperationEnvironment {
+class DownloadManagerThread final : protected StandbyThread {
+  /**
+   * The maximum number of files which are downloaded at the same
+   * time.  Each of them may use several connections, see
+   * Net::ResumableDownload.
+   */
+  static constexpr unsigned MAX_PARALLEL = 2;
+
+  /**
+   * The number of attempts for each file.  After a failure, the
+   * download resumes where it stopped.
+   */
+  static constexpr unsigned MAX_ATTEMPTS = 3;
+
+  static constexpr unsigned RETRY_DELAY_MS = 2000;
+
+  static constexpr int TIMEOUT_MS = 10000;
+
   struct Item {
     std::string uri;
     AllocatedPath path_relative;
 
-    Item(const Item &other) = delete;
+    /**
+     * The expected MD5 digest; empty if unknown.
+     */
+    std::string md5;
+
+    /**
+     * The progress of this download; -1 if unknown or not yet
+     * started.
+     */
+    int64_t size = -1, position = -1;
 
-    Item(Item &&other)
-      :uri(std::move(other.uri)),
-       path_relative(std::move(other.path_relative)) {}
+    /**
+     * Is the thread currently downloading this item?
+     */
+    bool active = false;
+
+    Item(const Item &other) = delete;
 
-    Item(const char *_uri, Path _path_relative)
-      :uri(_uri), path_relative(_path_relative) {}
+    Item(const char *_uri, Path _path_relative, const char *_md5)
+      :uri(_uri), path_relative(_path_relative),
+       md5(_md5 != nullptr ? _md5 : "") {}
 
     Item &operator=(const Item &other) = delete;
 
@@ -142,19 +183,39 @@ class DownloadManagerThread final
   };
 
   /**
-   * Information about the current download, i.e. queue.front().
-   * Protected by StandbyThread::mutex.
+   * The thread's view of an active #Item.  Only accessed by the
+   * thread.
    */
-  int64_t current_size, current_position;
+  struct Download {
+    Item &item;
+
+    /**
+     * nullptr while waiting for the next attempt.
+     */
+    std::unique_ptr<Net::ResumableDownload> download;
+
+    unsigned failures = 0;
+
+    uint64_t retry_time = 0;
+
+    bool done = false, success = false;
+
+    explicit Download(Item &_item):item(_item) {}
+  };
 
   std::list<Item> queue;
 
   std::list<Net::DownloadListener *> listeners;
 
+  /**
+   * The combined bandwidth limit [bytes per second]; 0 means
+   * unlimited.
+   */
+  unsigned bandwidth_limit = 0;
+
 public:
   DownloadManagerThread()
-    :StandbyThread("DownloadMgr"),
-     current_size(-1), current_position(-1) {}
+    :StandbyThread("DownloadMgr") {}
 
   void StopAsync() {
     ScopeLock protect(mutex);
@@ -186,22 +247,14 @@ public:
   void Enumerate(Net::DownloadListener &listener) {
     ScopeLock protect(mutex);
 
-    for (auto i = queue.begin(), end = queue.end(); i != end; ++i) {
-      const Item &item = *i;
-
-      int64_t size = -1, position = -1;
-      if (i == queue.begin()) {
-        size = current_size;
-        position = current_position;
-      }
-
-      listener.OnDownloadAdded(item.path_relative, size, position);
-    }
+    for (const Item &item : queue)
+      listener.OnDownloadAdded(item.path_relative,
+                               item.size, item.position);
   }
 
-  void Enqueue(const char *uri, Path path_relative) {
+  void Enqueue(const char *uri, Path path_relative, const char *md5) {
     ScopeLock protect(mutex);
-    queue.emplace_back(uri, path_relative);
+    queue.emplace_back(uri, path_relative, md5);
 
     for (auto *listener : listeners)
       listener->OnDownloadAdded(path_relative, -1, -1);
@@ -210,6 +263,11 @@ public:
       Trigger();
   }
 
+  void SetBandwidthLimit(unsigned bytes_per_second) {
+    ScopeLock protect(mutex);
+    bandwidth_limit = bytes_per_second;
+  }
+
   void Cancel(Path relative_path) {
     ScopeLock protect(mutex);
 
@@ -217,88 +275,212 @@ public:
     if (i == queue.end())
       return;
 
-    if (i == queue.begin()) {
-      /* current download; stop the thread to cancel the current file
-         and restart the thread to continue downloading the following
-         files */
+    if (i->active) {
+      /* current download; stop the thread to cancel it, and restart
+         the thread to continue the other downloads (they resume
+         where they were interrupted) */
 
       StandbyThread::StopAsync();
       StandbyThread::WaitStopped();
 
-      if (!queue.empty())
-        Trigger();
-    } else {
-      /* queued download; simply remove it from the list */
-      queue.erase(i);
+      Net::ResumableDownload::Discard(LocalPath(relative_path));
     }
 
+    queue.erase(i);
+
+    if (!queue.empty())
+      Trigger();
+
     for (auto *listener : listeners)
       listener->OnDownloadComplete(relative_path, false);
   }
 
 private:
+  /**
+   * Start (or resume) the download.
+   */
+  void Begin(Net::Session &session, Download &download);
+
+  /**
+   * The download has failed; schedule another attempt or give up.
+   */
+  void Fail(Download &download, const std::exception &exception);
+
+  /**
+   * Wait for network activity and process it.
+   */
+  void Step(Net::Session &session, std::list<Download> &downloads,
+            Net::RateLimiter &limiter);
+
   void ProcessQueue(Net::Session &session);
   void FailQueue();
 
 protected:
   /* methods from class StandbyThread */
   void Tick() override;
+};
 
-private:
-  /* methods from class OperationEnvironment */
-  bool IsCancelled() const override {
-    ScopeLock protect(const_cast<Mutex &>(mutex));
-    return StandbyThread::IsStopped();
+void
+DownloadManagerThread::Begin(Net::Session &session, Download &download)
+{
+  const Item &item = download.item;
+
+  download.download.reset(new Net::ResumableDownload(session,
+                                                     item.uri.c_str(),
+                                                     LocalPath(item.path_relative),
+                                                     item.md5.empty()
+                                                     ? nullptr
+                                                     : item.md5.c_str()));
+
+  try {
+    download.download->Start();
+  } catch (const std::exception &exception) {
+    Fail(download, exception);
   }
+}
 
-  void SetProgressRange(unsigned range) override {
-    ScopeLock protect(mutex);
-    current_size = range;
+void
+DownloadManagerThread::Fail(Download &download,
+                            const std::exception &exception)
+{
+  LogError("Download failed", exception);
+
+  /* this saves the state for resuming */
+  download.download.reset();
+
+  if (++download.failures >= MAX_ATTEMPTS)
+    download.done = true;
+  else
+    download.retry_time = MonotonicClockMS()
+      + RETRY_DELAY_MS * download.failures;
+}
+
+void
+DownloadManagerThread::Step(Net::Session &session,
+                            std::list<Download> &downloads,
+                            Net::RateLimiter &limiter)
+{
+  const uint64_t now = MonotonicClockMS();
+
+  bool running = false;
+  for (auto &download : downloads) {
+    if (download.download == nullptr && !download.done &&
+        now >= download.retry_time)
+      Begin(session, download);
+
+    if (download.download != nullptr)
+      running = true;
   }
 
-  void SetProgressPosition(unsigned position) override {
-    ScopeLock protect(mutex);
-    current_position = position;
+  if (!running) {
+    /* all downloads are waiting for their next attempt */
+    Sleep(100);
+    return;
   }
-};
 
-static bool
-DownloadToFileTransaction(Net::Session &session,
-                          const char *url, Path path,
-                          char *md5_digest, OperationEnvironment &env)
-{
-  FileTransaction transaction(path);
-  return DownloadToFile(session, url, transaction.GetTemporaryPath(),
-                        md5_digest, env) &&
-    transaction.Commit();
+  const unsigned delay = limiter.GetDelay(now);
+  if (delay > 0) {
+    /* over the bandwidth limit: stop reading from the network for a
+       while, and let TCP flow control slow down the servers */
+    Sleep(std::min(delay, 100u));
+    return;
+  }
+
+  try {
+    session.Select(TIMEOUT_MS);
+
+    CURLMcode mcode = session.Perform();
+    if (mcode != CURLM_OK && mcode != CURLM_CALL_MULTI_PERFORM)
+      throw std::runtime_error(curl_multi_strerror(mcode));
+  } catch (const std::exception &exception) {
+    for (auto &download : downloads)
+      if (download.download != nullptr)
+        Fail(download, exception);
+    return;
+  }
+
+  for (auto &download : downloads) {
+    if (download.download == nullptr)
+      continue;
+
+    try {
+      if (download.download->Poll())
+        download.done = download.success = true;
+
+      limiter.Consume(MonotonicClockMS(), download.download->TakeReceived());
+    } catch (const Net::ResumableDownload::DigestMismatch &exception) {
+      /* downloading the same data again will not help */
+      LogError("Download failed", exception);
+      download.download.reset();
+      download.done = true;
+    } catch (const std::exception &exception) {
+      Fail(download, exception);
+    }
+  }
 }
 
 inline void
 DownloadManagerThread::ProcessQueue(Net::Session &session)
 {
-  while (!queue.empty() && !StandbyThread::IsStopped()) {
-    assert(current_size == -1);
-    assert(current_position == -1);
+  std::list<Download> downloads;
+  Net::RateLimiter limiter;
+  unsigned rate = 0;
+
+  while (!StandbyThread::IsStopped()) {
+    for (auto &item : queue) {
+      if (downloads.size() >= MAX_PARALLEL)
+        break;
+
+      if (!item.active) {
+        item.active = true;
+        item.position = 0;
+        downloads.emplace_back(item);
+      }
+    }
 
-    const Item &item = queue.front();
-    current_position = 0;
+    if (downloads.empty())
+      break;
 
-    bool success = false;
-    try {
+    if (bandwidth_limit != rate) {
+      rate = bandwidth_limit;
+      limiter.SetRate(rate, MonotonicClockMS());
+    }
+
+    {
       const ScopeUnlock unlock(mutex);
-      success = DownloadToFileTransaction(session, item.uri.c_str(),
-                                          LocalPath(item.path_relative.c_str()),
-                                          nullptr, *this);
-    } catch (const std::exception &exception) {
-      LogError(exception);
+      Step(session, downloads, limiter);
     }
 
-    current_size = current_position = -1;
-    const AllocatedPath path_relative(std::move(queue.front().path_relative));
-    queue.pop_front();
+    for (auto i = downloads.begin(); i != downloads.end();) {
+      Item &item = i->item;
 
-    for (auto *listener : listeners)
-      listener->OnDownloadComplete(path_relative, success);
+      if (i->download != nullptr) {
+        item.size = i->download->GetSize();
+        item.position = i->download->GetPosition();
+      }
+
+      if (!i->done) {
+        ++i;
+        continue;
+      }
+
+      const bool success = i->success;
+      const AllocatedPath path_relative(std::move(item.path_relative));
+      queue.remove_if([&item](const Item &other){
+          return &other == &item;
+        });
+      i = downloads.erase(i);
+
+      for (auto *listener : listeners)
+        listener->OnDownloadComplete(path_relative, success);
+    }
+  }
+
+  /* interrupted; the unfinished downloads will be resumed when the
+     thread is restarted */
+  for (auto &download : downloads) {
+    download.item.active = false;
+    download.item.size = download.item.position = -1;
   }
 }
 
@@ -387,11 +569,20 @@ Net::DownloadManager::Enumerate(DownloadListener &listener)
 }
 
 void
-Net::DownloadManager::Enqueue(const char *uri, Path relative_path)
+Net::DownloadManager::Enqueue(const char *uri, Path relative_path,
+                              const char *md5)
+{
+  assert(thread != nullptr);
+
+  thread->Enqueue(uri, relative_path, md5);
+}
+
+void
+Net::DownloadManager::SetBandwidthLimit(unsigned bytes_per_second)
 {
   assert(thread != nullptr);
 
-  thread->Enqueue(uri, relative_path);
+  thread->SetBandwidthLimit(bytes_per_second);
 }
 
 void
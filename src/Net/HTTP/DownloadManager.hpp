@@ -70,7 +70,20 @@ namespace Net {
      */
     void Enumerate(DownloadListener &listener);
 
-    void Enqueue(const char *uri, Path relative_path);
+    /**
+     * @param md5 the expected hex MD5 digest of the file; if the
+     * downloaded file does not match, the download fails (nullptr to
+     * skip verification)
+     */
+    void Enqueue(const char *uri, Path relative_path,
+                 const char *md5=nullptr);
+
+    /**
+     * Limit the combined bandwidth of all downloads.
+     *
+     * @param bytes_per_second the limit; 0 means unlimited
+     */
+    void SetBandwidthLimit(unsigned bytes_per_second);
 
     /**
      * Cancel the download.  The download may however be already
@@ -0,0 +1,143 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "DownloadState.hpp"
+#include "OS/Path.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+#include <stdio.h>
+#include <tchar.h>
+
+void
+Net::DownloadState::Plan(uint64_t _size, unsigned max_segments)
+{
+  assert(max_segments > 0);
+
+  size = _size;
+  segments.clear();
+
+  const uint64_t max_by_size = std::max<uint64_t>(size / MIN_SEGMENT_SIZE, 1);
+  const unsigned n = std::min<uint64_t>(std::min(max_segments, unsigned(MAX_SEGMENTS)),
+                                        max_by_size);
+
+  uint64_t start = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    const uint64_t end = size * (i + 1) / n;
+    segments.push_back({start, end, start});
+    start = end;
+  }
+}
+
+bool
+Net::DownloadState::IsComplete() const
+{
+  return std::all_of(segments.begin(), segments.end(),
+                     [](const Segment &s){ return s.IsComplete(); });
+}
+
+uint64_t
+Net::DownloadState::GetPosition() const
+{
+  uint64_t position = 0;
+  for (const auto &s : segments)
+    position += std::min(s.position, s.end) - s.start;
+  return position;
+}
+
+uint64_t
+Net::DownloadState::GetContiguous() const
+{
+  uint64_t contiguous = 0;
+  for (const auto &s : segments) {
+    if (s.start != contiguous)
+      break;
+
+    contiguous = std::min(s.position, s.end);
+    if (!s.IsComplete())
+      break;
+  }
+
+  return contiguous;
+}
+
+bool
+Net::DownloadState::Load(Path path)
+{
+  Clear();
+
+  FILE *file = _tfopen(path.c_str(), _T("r"));
+  if (file == nullptr)
+    return false;
+
+  unsigned long long _size;
+  unsigned n;
+  bool success = fscanf(file, "size %llu segments %u\n", &_size, &n) == 2 &&
+    n > 0 && n <= MAX_SEGMENTS;
+
+  if (success) {
+    size = _size;
+
+    uint64_t expected_start = 0;
+    for (unsigned i = 0; i < n; ++i) {
+      unsigned long long start, end, position;
+      if (fscanf(file, "%llu %llu %llu\n", &start, &end, &position) != 3 ||
+          start != expected_start || end < start || end > size ||
+          position < start || position > end) {
+        success = false;
+        break;
+      }
+
+      segments.push_back({start, end, position});
+      expected_start = end;
+    }
+
+    if (expected_start != size)
+      success = false;
+  }
+
+  fclose(file);
+
+  if (!success)
+    Clear();
+
+  return success;
+}
+
+bool
+Net::DownloadState::Save(Path path) const
+{
+  FILE *file = _tfopen(path.c_str(), _T("w"));
+  if (file == nullptr)
+    return false;
+
+  fprintf(file, "size %llu segments %u\n",
+          (unsigned long long)size, (unsigned)segments.size());
+  for (const auto &s : segments)
+    fprintf(file, "%llu %llu %llu\n",
+            (unsigned long long)s.start, (unsigned long long)s.end,
+            (unsigned long long)std::min(s.position, s.end));
+
+  return fclose(file) == 0;
+}
@@ -0,0 +1,123 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef NET_DOWNLOAD_STATE_HPP
+#define NET_DOWNLOAD_STATE_HPP
+
+#include "Util/StaticArray.hxx"
+#include "Compiler.h"
+
+#include <stdint.h>
+
+class Path;
+
+namespace Net {
+  /**
+   * Tracks which byte ranges of a file have been downloaded already.
+   * It is stored next to the partial file, so an interrupted download
+   * can be resumed with HTTP range requests.
+   */
+  struct DownloadState {
+    static constexpr unsigned MAX_SEGMENTS = 4;
+
+    /**
+     * Files are not split into segments smaller than this.
+     */
+    static constexpr uint64_t MIN_SEGMENT_SIZE = 512 * 1024;
+
+    struct Segment {
+      /**
+       * The offset of the first byte, and the offset after the last
+       * byte.
+       */
+      uint64_t start, end;
+
+      /**
+       * The offset after the last byte which has been written to the
+       * partial file.
+       */
+      uint64_t position;
+
+      bool IsComplete() const {
+        return position >= end;
+      }
+
+      uint64_t GetRemaining() const {
+        return IsComplete() ? 0 : end - position;
+      }
+    };
+
+    /**
+     * The total size of the file.
+     */
+    uint64_t size;
+
+    /**
+     * The segments, ordered by their start offset.
+     */
+    StaticArray<Segment, MAX_SEGMENTS> segments;
+
+    void Clear() {
+      size = 0;
+      segments.clear();
+    }
+
+    /**
+     * Split a file into up to #max_segments segments of (nearly) equal
+     * size.
+     */
+    void Plan(uint64_t size, unsigned max_segments);
+
+    gcc_pure
+    bool IsComplete() const;
+
+    /**
+     * Returns the number of bytes which have been downloaded.
+     */
+    gcc_pure
+    uint64_t GetPosition() const;
+
+    /**
+     * Returns the length of the file's beginning which has been
+     * downloaded without gaps.
+     */
+    gcc_pure
+    uint64_t GetContiguous() const;
+
+    /**
+     * Load the state from a file.
+     *
+     * @return false if the file does not exist or is malformed
+     */
+    bool Load(Path path);
+
+    /**
+     * Save the state to a file.
+     *
+     * @return true on success
+     */
+    bool Save(Path path) const;
+  };
+}
+
+#endif
@@ -102,6 +102,15 @@ namespace Net {
       SetOption(CURLOPT_HTTPPOST, post);
     }
 
+    /**
+     * @param value a byte range in the form "START-END" (both
+     * inclusive; END may be omitted), or nullptr to request the
+     * whole resource
+     */
+    void SetRange(const char *value) {
+      SetOption(CURLOPT_RANGE, value);
+    }
+
     template<typename T>
     bool GetInfo(CURLINFO info, T value_r) const {
       return ::curl_easy_getinfo(handle, info, value_r) == CURLE_OK;
@@ -115,6 +124,18 @@ namespace Net {
         : -1;
     }
 
+    /**
+     * @return the HTTP response status, or 0 if no response has been
+     * received yet
+     */
+    gcc_pure
+    unsigned GetResponseCode() const {
+      long value;
+      return GetInfo(CURLINFO_RESPONSE_CODE, &value)
+        ? (unsigned)value
+        : 0;
+    }
+
     bool Unpause() {
       return ::curl_easy_pause(handle, CURLPAUSE_CONT) == CURLE_OK;
     }
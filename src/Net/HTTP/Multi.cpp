@@ -62,7 +62,7 @@ Net::CurlMulti::InfoRead(const CURL *easy)
       if (msg->easy_handle == easy)
         return msg->data.result;
 
-      results.insert(std::make_pair(easy, msg->data.result));
+      results.insert(std::make_pair(msg->easy_handle, msg->data.result));
     }
   }
 
@@ -0,0 +1,106 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef NET_RATE_LIMITER_HPP
+#define NET_RATE_LIMITER_HPP
+
+#include <stdint.h>
+
+namespace Net {
+  /**
+   * A token bucket which limits the combined bandwidth of all
+   * transfers.  The caller reports the bytes it has received, and
+   * stops reading from the network for GetDelay() milliseconds.
+   *
+   * Time is passed explicitly (in milliseconds, e.g. from
+   * MonotonicClockMS()), which makes this class easy to test.
+   */
+  class RateLimiter {
+    /**
+     * The limit [bytes per second]; 0 means unlimited.
+     */
+    unsigned rate = 0;
+
+    /**
+     * The number of bytes which may be received without delay,
+     * multiplied by 1000 (to avoid rounding errors at low rates).  A
+     * negative value is a debt which must be paid off by waiting.
+     */
+    int64_t tokens = 0;
+
+    uint64_t last_time = 0;
+
+  public:
+    bool IsEnabled() const {
+      return rate > 0;
+    }
+
+    void SetRate(unsigned _rate, uint64_t now) {
+      rate = _rate;
+      tokens = 0;
+      last_time = now;
+    }
+
+    /**
+     * Account for received data.
+     */
+    void Consume(uint64_t now, uint64_t nbytes) {
+      if (!IsEnabled())
+        return;
+
+      Refill(now);
+      tokens -= int64_t(nbytes) * 1000;
+    }
+
+    /**
+     * Returns the number of milliseconds to wait before more data may
+     * be received.
+     */
+    unsigned GetDelay(uint64_t now) {
+      if (!IsEnabled())
+        return 0;
+
+      Refill(now);
+      if (tokens >= 0)
+        return 0;
+
+      return unsigned((uint64_t(-tokens) + rate - 1) / rate);
+    }
+
+  private:
+    void Refill(uint64_t now) {
+      if (now <= last_time)
+        return;
+
+      tokens += int64_t(now - last_time) * rate;
+      last_time = now;
+
+      /* allow bursts of up to 1/4 second */
+      const int64_t max_tokens = int64_t(rate) * 250;
+      if (tokens > max_tokens)
+        tokens = max_tokens;
+    }
+  };
+}
+
+#endif
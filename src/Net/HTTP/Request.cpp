@@ -78,6 +78,22 @@ Net::Request::SetRequestBody(const MultiPartFormData &body)
   handle.SetHttpPost(body.Get());
 }
 
+void
+Net::Request::SetRange(uint64_t start, int64_t end)
+{
+  assert(!submitted);
+
+  char buffer[64];
+  if (end >= 0)
+    snprintf(buffer, sizeof(buffer), "%llu-%llu",
+             (unsigned long long)start, (unsigned long long)end);
+  else
+    snprintf(buffer, sizeof(buffer), "%llu-",
+             (unsigned long long)start);
+
+  handle.SetRange(buffer);
+}
+
 size_t
 Net::Request::ResponseData(const uint8_t *ptr, size_t size)
 {
@@ -125,6 +141,22 @@ Net::Request::Send(unsigned _timeout_ms)
     SubmitResponse();
 }
 
+bool
+Net::Request::CheckFinished()
+{
+  CURLcode code = session.InfoRead(handle.GetHandle());
+  if (code == CURLE_AGAIN)
+    return false;
+
+  if (code != CURLE_OK)
+    throw std::runtime_error(curl_easy_strerror(code));
+
+  if (!submitted)
+    SubmitResponse();
+
+  return true;
+}
+
 void
 Net::Request::SubmitResponse()
 {
@@ -77,6 +77,18 @@ namespace Net {
      */
     void SetRequestBody(const MultiPartFormData &body);
 
+    /**
+     * Request only a part of the resource (HTTP range request).  This
+     * must be called before the transfer is started.  The server may
+     * ignore it and respond with the whole resource; check
+     * GetStatus() (206 means partial content).
+     *
+     * @param start the offset of the first byte
+     * @param end the offset of the last byte (inclusive); -1 means
+     * "until the end of the resource"
+     */
+    void SetRange(uint64_t start, int64_t end=-1);
+
     /**
      * Send the request to the server and receive response headers.
      * This function fails if the connection could not be established
@@ -93,6 +105,28 @@ namespace Net {
      */
     int64_t GetLength() const;
 
+    /**
+     * Returns the HTTP response status, or 0 if no response has been
+     * received yet.  May be called from the #ResponseHandler.
+     */
+    gcc_pure
+    unsigned GetStatus() const {
+      return handle.GetResponseCode();
+    }
+
+    /**
+     * Check whether the transfer has finished, without blocking.
+     * This is an alternative to Send() for callers which drive
+     * several requests at the same time with Session::Select() and
+     * Session::Perform().
+     *
+     * Throws std::runtime_error on error.
+     *
+     * @return true if the transfer has finished successfully, false
+     * if it is still running
+     */
+    bool CheckFinished();
+
     /**
      * Reads a number of bytes from the server.
      * This function must not be called before Send() !
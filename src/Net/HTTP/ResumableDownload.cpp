@@ -0,0 +1,450 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/* terrain archives may be larger than 2 GB; this makes stdio use
+   64 bit offsets on 32 bit POSIX systems (must be defined before the
+   first system header is included) */
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "ResumableDownload.hpp"
+#include "Request.hpp"
+#include "Handler.hpp"
+#include "OS/FileUtil.hpp"
+#include "Util/StringAPI.hxx"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <assert.h>
+#include <stdio.h>
+
+/**
+ * Save the state after this number of bytes has been received, to
+ * limit the amount of data which has to be downloaded again after a
+ * crash.
+ */
+static constexpr uint64_t SAVE_INTERVAL = 1024 * 1024;
+
+class Net::ResumableDownload::Transfer final : public ResponseHandler {
+  ResumableDownload &download;
+
+public:
+  /**
+   * The index in DownloadState::segments.
+   */
+  const unsigned segment;
+
+  /**
+   * Is this the first request of a new download, which determines
+   * the file size and whether the server supports range requests?
+   */
+  const bool probe;
+
+  /**
+   * Has the segment been received completely?  The request may still
+   * be running (the probe is open-ended), and will be cancelled.
+   */
+  bool done = false;
+
+  /**
+   * An error which was detected by a callback.  It is reported by
+   * Poll().
+   */
+  const char *error = nullptr;
+
+  Request request;
+
+  Transfer(ResumableDownload &_download, unsigned _segment, bool _probe)
+    :download(_download), segment(_segment), probe(_probe),
+     request(_download.session, *this, _download.uri.c_str()) {}
+
+  /* virtual methods from class Net::ResponseHandler */
+  void ResponseReceived(int64_t content_length) override {
+    if (probe)
+      download.OnProbeResponse(*this, content_length);
+    else
+      download.OnResponse(*this, content_length);
+  }
+
+  void DataReceived(const void *data, size_t length) override {
+    download.OnData(*this, data, length);
+  }
+};
+
+Net::ResumableDownload::ResumableDownload(Session &_session, const char *_uri,
+                                         Path _path, const char *md5,
+                                         unsigned _max_segments)
+  :session(_session), uri(_uri),
+   path(_path), part_path(_path + _T(".part")),
+   state_path(_path + _T(".part.state")),
+   expected_md5(md5 != nullptr ? md5 : ""),
+   max_segments(_max_segments)
+{
+  assert(max_segments > 0);
+
+  state.Clear();
+}
+
+Net::ResumableDownload::~ResumableDownload()
+{
+  /* cancel all requests before closing the file */
+  transfers.clear();
+
+  if (finished)
+    return;
+
+  if (ranges)
+    SaveState();
+
+  if (file != nullptr) {
+    fclose(file);
+
+    if (!ranges)
+      /* can't be resumed */
+      Discard();
+  }
+}
+
+int64_t
+Net::ResumableDownload::GetSize() const
+{
+  if (ranges || size_known)
+    return state.size;
+
+  return -1;
+}
+
+void
+Net::ResumableDownload::OpenFile(bool resume)
+{
+  assert(file == nullptr);
+
+  file = _tfopen(part_path.c_str(), resume ? _T("r+b") : _T("w+b"));
+  if (file == nullptr)
+    throw std::runtime_error("Failed to create file");
+}
+
+void
+Net::ResumableDownload::CloseFile()
+{
+  if (file == nullptr)
+    return;
+
+  const bool success = fclose(file) == 0;
+  file = nullptr;
+
+  if (!success)
+    throw std::runtime_error("Failed to write file");
+}
+
+void
+Net::ResumableDownload::Discard(Path path)
+{
+  File::Delete(path + _T(".part"));
+  File::Delete(path + _T(".part.state"));
+}
+
+void
+Net::ResumableDownload::SaveState()
+{
+  assert(ranges);
+
+  /* the data must be in the file before the state claims it is */
+  if (file != nullptr)
+    fflush(file);
+
+  state.Save(state_path);
+  saved_position = state.GetPosition();
+}
+
+void
+Net::ResumableDownload::Cancel()
+{
+  transfers.clear();
+  ranges = false;
+
+  if (file != nullptr) {
+    fclose(file);
+    file = nullptr;
+  }
+
+  Discard();
+}
+
+void
+Net::ResumableDownload::Abort(const char *msg)
+{
+  Cancel();
+  throw std::runtime_error(msg);
+}
+
+void
+Net::ResumableDownload::StartTransfer(unsigned segment, bool probe)
+{
+  transfers.emplace_back(new Transfer(*this, segment, probe));
+  Transfer &transfer = *transfers.back();
+
+  if (probe) {
+    /* an open-ended range: a server which supports range requests
+       responds with "206 Partial Content", which tells us that the
+       download can be split and resumed */
+    transfer.request.SetRange(0);
+  } else {
+    const auto &s = state.segments[segment];
+    transfer.request.SetRange(s.position, s.end - 1);
+  }
+}
+
+void
+Net::ResumableDownload::StartMissingTransfers()
+{
+  assert(ranges);
+
+  for (unsigned segment = 0, n = state.segments.size();
+       segment < n; ++segment) {
+    if (state.segments[segment].IsComplete())
+      continue;
+
+    if (std::none_of(transfers.begin(), transfers.end(),
+                     [segment](const std::unique_ptr<Transfer> &t){
+                       return t->segment == segment;
+                     }))
+      StartTransfer(segment, false);
+  }
+}
+
+void
+Net::ResumableDownload::Start()
+{
+  assert(transfers.empty());
+  assert(file == nullptr);
+
+  md5.Initialise();
+  hashed = 0;
+
+  if (state.Load(state_path) && File::Exists(part_path)) {
+    /* resume the previous download */
+    ranges = true;
+    OpenFile(true);
+    saved_position = state.GetPosition();
+    HashCatchUp();
+    StartMissingTransfers();
+  } else {
+    Discard();
+    state.Clear();
+    OpenFile(false);
+    StartTransfer(0, true);
+  }
+}
+
+void
+Net::ResumableDownload::OnProbeResponse(Transfer &transfer,
+                                        int64_t content_length)
+{
+  assert(transfer.probe);
+  assert(state.segments.empty());
+
+  if (transfer.request.GetStatus() == 206) {
+    if (content_length <= 0) {
+      transfer.error = "Malformed response";
+      return;
+    }
+
+    /* the probe request continues as the first segment; Poll()
+       starts the others (libcurl does not allow adding requests from
+       within a callback) */
+    ranges = true;
+    state.Plan(content_length, max_segments);
+    SaveState();
+  } else {
+    /* no range support; download the whole file in one request */
+    size_known = content_length >= 0;
+    state.Plan(size_known ? content_length : UINT64_MAX, 1);
+  }
+}
+
+void
+Net::ResumableDownload::OnResponse(Transfer &transfer,
+                                   int64_t content_length)
+{
+  assert(!transfer.probe);
+  assert(ranges);
+
+  const auto &s = state.segments[transfer.segment];
+
+  if (transfer.request.GetStatus() != 206)
+    transfer.error = "Server does not support resuming";
+  else if (content_length >= 0 &&
+           uint64_t(content_length) != s.GetRemaining())
+    /* the file on the server has probably been modified */
+    transfer.error = "Unexpected response length";
+}
+
+/**
+ * Like fseek(SEEK_SET), but with a 64 bit offset even where "long"
+ * has only 32 bits.
+ */
+static bool
+SeekFile(FILE *file, uint64_t offset)
+{
+#ifdef _WIN32
+  return _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+  static_assert(sizeof(off_t) >= sizeof(uint64_t),
+                "64 bit file offsets required");
+  return fseeko(file, off_t(offset), SEEK_SET) == 0;
+#endif
+}
+
+void
+Net::ResumableDownload::OnData(Transfer &transfer,
+                               const void *data, size_t length)
+{
+  received += length;
+
+  if (transfer.done || transfer.error != nullptr)
+    return;
+
+  auto &s = state.segments[transfer.segment];
+
+  /* discard excess data (the probe request is open-ended) */
+  const size_t n = std::min<uint64_t>(length, s.GetRemaining());
+
+  if (!SeekFile(file, s.position) ||
+      fwrite(data, 1, n, file) != n) {
+    transfer.error = "Failed to write file";
+    return;
+  }
+
+  if (!expected_md5.empty() && s.position == hashed) {
+    /* this is the next block of the contiguous beginning; hash it
+       right away, without reading it back later */
+    md5.Append(data, n);
+    hashed += n;
+  }
+
+  s.position += n;
+
+  if (ranges && s.IsComplete())
+    transfer.done = true;
+}
+
+void
+Net::ResumableDownload::HashCatchUp()
+{
+  if (expected_md5.empty())
+    return;
+
+  const uint64_t contiguous = state.GetContiguous();
+  if (hashed >= contiguous)
+    return;
+
+  if (!SeekFile(file, hashed))
+    throw std::runtime_error("Failed to read file");
+
+  uint8_t buffer[16384];
+  while (hashed < contiguous) {
+    const size_t n = fread(buffer, 1,
+                           std::min<uint64_t>(sizeof(buffer),
+                                              contiguous - hashed),
+                           file);
+    if (n == 0)
+      throw std::runtime_error("Failed to read file");
+
+    md5.Append(buffer, n);
+    hashed += n;
+  }
+}
+
+bool
+Net::ResumableDownload::Poll()
+{
+  assert(!finished);
+
+  for (auto i = transfers.begin(); i != transfers.end();) {
+    Transfer &transfer = **i;
+
+    if (transfer.error != nullptr)
+      Abort(transfer.error);
+
+    if (!transfer.done && !transfer.request.CheckFinished()) {
+      ++i;
+      continue;
+    }
+
+    if (!transfer.done) {
+      /* the response has ended; did we get everything? */
+      const auto &s = state.segments[transfer.segment];
+      if (ranges) {
+        if (!s.IsComplete())
+          throw std::runtime_error("Premature end of response");
+      } else if (size_known) {
+        if (!s.IsComplete())
+          Abort("Premature end of response");
+      } else
+        state.size = s.position;
+    }
+
+    i = transfers.erase(i);
+  }
+
+  if (ranges) {
+    StartMissingTransfers();
+    HashCatchUp();
+
+    if (state.GetPosition() >= saved_position + SAVE_INTERVAL)
+      SaveState();
+  }
+
+  if (!transfers.empty())
+    return false;
+
+  Finish();
+  return true;
+}
+
+void
+Net::ResumableDownload::Finish()
+{
+  HashCatchUp();
+  CloseFile();
+
+  if (!expected_md5.empty()) {
+    char digest[MD5::DIGEST_LENGTH + 1];
+    md5.Finalize();
+    md5.GetDigest(digest);
+
+    if (!StringIsEqualIgnoreCase(digest, expected_md5.c_str())) {
+      Cancel();
+      throw DigestMismatch();
+    }
+  }
+
+  if (!File::Replace(part_path, path))
+    throw std::runtime_error("Failed to rename file");
+
+  File::Delete(state_path);
+  finished = true;
+}
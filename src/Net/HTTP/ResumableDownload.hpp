@@ -0,0 +1,249 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef NET_RESUMABLE_DOWNLOAD_HPP
+#define NET_RESUMABLE_DOWNLOAD_HPP
+
+#include "DownloadState.hpp"
+#include "OS/Path.hpp"
+#include "Logger/MD5.hpp"
+#include "Compiler.h"
+
+#include <string>
+#include <list>
+#include <stdexcept>
+#include <memory>
+
+#include <stdint.h>
+#include <stdio.h>
+
+namespace Net {
+  class Session;
+
+  /**
+   * Downloads one file with up to DownloadState::MAX_SEGMENTS parallel
+   * HTTP range requests.  The data is written to a ".part" file, and
+   * the progress is recorded in a ".part.state" file, so an
+   * interrupted download continues where it stopped.  Servers which
+   * do not support range requests are handled as well (without
+   * segmentation and without resuming).
+   *
+   * If an MD5 digest is given, the file is verified while it is being
+   * downloaded: the contiguous beginning of the file is hashed as it
+   * grows.
+   *
+   * This class does not block.  The transfers are driven by the
+   * #Session (see Session::Select() and Session::Perform()), and the
+   * caller invokes Poll() after each Session::Perform() call.
+   */
+  class ResumableDownload {
+  public:
+    /**
+     * Thrown by Poll() when the downloaded file does not match the
+     * expected digest.  Trying again is pointless.
+     */
+    class DigestMismatch : public std::runtime_error {
+    public:
+      DigestMismatch():std::runtime_error("MD5 digest mismatch") {}
+    };
+
+  private:
+    class Transfer;
+
+    Session &session;
+
+    const std::string uri;
+
+    const AllocatedPath path, part_path, state_path;
+
+    /**
+     * The expected hex MD5 digest; empty if the file shall not be
+     * verified.
+     */
+    const std::string expected_md5;
+
+    const unsigned max_segments;
+
+    DownloadState state;
+
+    /**
+     * Does the server support range requests, i.e. is #state
+     * initialised and can the download be resumed?
+     */
+    bool ranges = false;
+
+    /**
+     * Is the file size known?  Only relevant if #ranges is false.
+     */
+    bool size_known = false;
+
+    bool finished = false;
+
+    FILE *file = nullptr;
+
+    MD5 md5;
+
+    /**
+     * The number of bytes which have been fed into #md5.
+     */
+    uint64_t hashed = 0;
+
+    /**
+     * The number of bytes received since the last TakeReceived()
+     * call.
+     */
+    uint64_t received = 0;
+
+    /**
+     * The value of DownloadState::GetPosition() when the state was
+     * last saved.
+     */
+    uint64_t saved_position = 0;
+
+    std::list<std::unique_ptr<Transfer>> transfers;
+
+  public:
+    /**
+     * @param md5 the expected hex MD5 digest of the file, or nullptr
+     * @param max_segments the maximum number of parallel requests
+     */
+    ResumableDownload(Session &session, const char *uri, Path path,
+                      const char *md5,
+                      unsigned max_segments=DownloadState::MAX_SEGMENTS);
+
+    /**
+     * Stops all transfers.  Unless the download has been finished,
+     * the state is saved, so a new #ResumableDownload for the same
+     * file continues where this one stopped.
+     */
+    ~ResumableDownload();
+
+    ResumableDownload(const ResumableDownload &) = delete;
+    ResumableDownload &operator=(const ResumableDownload &) = delete;
+
+    /**
+     * Start the transfers, resuming a previous download if possible.
+     *
+     * Throws std::runtime_error on error.
+     */
+    void Start();
+
+    /**
+     * Check the progress of the transfers, start new ones if
+     * necessary, and finish the download when all data has been
+     * received.
+     *
+     * Throws std::runtime_error on error.  If the error cannot be
+     * fixed by resuming (e.g. the digest does not match), the partial
+     * file is deleted before throwing.
+     *
+     * @return true when the file has been downloaded completely and
+     * was moved to its final path, false if the download is still
+     * running
+     */
+    bool Poll();
+
+    /**
+     * @return the size of the file, or -1 if unknown
+     */
+    gcc_pure
+    int64_t GetSize() const;
+
+    /**
+     * @return the number of bytes which have been downloaded
+     */
+    gcc_pure
+    int64_t GetPosition() const {
+      return state.GetPosition();
+    }
+
+    /**
+     * Returns the number of bytes received since the last call.  This
+     * can be used to implement bandwidth limits.
+     */
+    uint64_t TakeReceived() {
+      uint64_t result = received;
+      received = 0;
+      return result;
+    }
+
+    /**
+     * Delete the partial file and the state file.
+     */
+    void Discard() {
+      Discard(path);
+    }
+
+    /**
+     * Delete the partial file and the state file of an interrupted
+     * download, so it will not be resumed.
+     *
+     * @param path the final path of the file
+     */
+    static void Discard(Path path);
+
+  private:
+    void OpenFile(bool resume);
+    void CloseFile();
+
+    void SaveState();
+
+    void StartTransfer(unsigned segment, bool probe);
+
+    /**
+     * Start a request for each incomplete segment which does not
+     * have one.
+     */
+    void StartMissingTransfers();
+
+    /**
+     * Called by the first transfer of a new download when the
+     * response headers have been received.
+     */
+    void OnProbeResponse(Transfer &transfer, int64_t content_length);
+
+    void OnResponse(Transfer &transfer, int64_t content_length);
+    void OnData(Transfer &transfer, const void *data, size_t length);
+
+    /**
+     * Feed all contiguous data which has not been hashed yet into
+     * #md5, reading it back from the partial file.
+     */
+    void HashCatchUp();
+
+    void Finish();
+
+    /**
+     * Stop all transfers and discard the partial file.
+     */
+    void Cancel();
+
+    /**
+     * Discard the partial file and throw std::runtime_error.
+     */
+    gcc_noreturn
+    void Abort(const char *msg);
+  };
+}
+
+#endif
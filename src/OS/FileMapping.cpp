@@ -33,7 +33,7 @@ Copyright_License {
 #include <windows.h>
 #endif
 
-FileMapping::FileMapping(Path path)
+FileMapping::FileMapping(Path path, bool will_need)
   :m_data(nullptr)
 #ifndef HAVE_POSIX
   , hMapping(nullptr)
@@ -67,10 +67,13 @@ FileMapping::FileMapping(Path path)
 
   m_data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
   close(fd);
-  if (m_data == nullptr)
+  if (m_data == MAP_FAILED) {
+    m_data = nullptr;
     return;
+  }
 
-  madvise(m_data, m_size, MADV_WILLNEED);
+  if (will_need)
+    madvise(m_data, m_size, MADV_WILLNEED);
 #else /* !HAVE_POSIX */
   hFile = ::CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
                        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
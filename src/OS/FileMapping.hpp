@@ -44,7 +44,12 @@ class FileMapping {
 #endif
 
 public:
-  FileMapping(Path path);
+  /**
+   * @param will_need ask the kernel to read the whole file into the
+   * page cache right away; pass false for large files which are
+   * accessed only partially
+   */
+  FileMapping(Path path, bool will_need=true);
   ~FileMapping();
 
   /**
@@ -123,3 +123,31 @@ unsigned SystemLoadCPU()
 }
 
 #endif /* !WIN32 */
+
+#ifdef WIN32
+
+unsigned
+SystemCPUCount()
+{
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+}
+
+#else
+
+#include <unistd.h>
+
+unsigned
+SystemCPUCount()
+{
+#ifdef _SC_NPROCESSORS_ONLN
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n > 0)
+    return n;
+#endif
+
+  return 1;
+}
+
+#endif
@@ -25,4 +25,10 @@ Copyright_License {
 
 unsigned SystemLoadCPU();
 
+/**
+ * Returns the number of CPUs which are currently online.  Falls back
+ * to 1 if that cannot be determined.
+ */
+unsigned SystemCPUCount();
+
 #endif
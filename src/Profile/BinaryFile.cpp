@@ -0,0 +1,241 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "BinaryFile.hpp"
+#include "Map.hpp"
+#include "IO/FileReader.hxx"
+#include "IO/FileOutputStream.hxx"
+#include "IO/BufferedOutputStream.hxx"
+#include "OS/Path.hpp"
+#include "Util/CRC.hpp"
+
+#include <memory>
+#include <stdexcept>
+
+#include <string.h>
+
+static constexpr uint32_t BINARY_PROFILE_MAGIC = 0x50534358; /* "XCSP" */
+static constexpr uint32_t BINARY_PROFILE_VERSION = 1;
+
+struct BinaryProfileHeader {
+  uint32_t magic, version;
+
+  uint64_t text_size;
+  uint16_t text_crc, reserved;
+
+  /**
+   * The number of records which belong to the snapshot; all records
+   * after that are journal records.
+   */
+  uint32_t n_snapshot;
+};
+
+static_assert(sizeof(BinaryProfileHeader) == 24, "Wrong header size");
+
+/*
+ * Each record consists of this header, the key, the value and a
+ * CRC16 of all of these.  Neither key nor value are null-terminated.
+ */
+struct BinaryProfileRecord {
+  uint16_t key_length, value_length;
+};
+
+AllocatedPath
+Profile::GetBinaryPath(Path text_path)
+{
+  return text_path + _T(".bin");
+}
+
+Profile::FileStamp
+Profile::StampFile(Path path)
+{
+  FileReader reader(path);
+
+  FileStamp stamp{0, 0};
+
+  uint8_t buffer[4096];
+  size_t nbytes;
+  while ((nbytes = reader.Read(buffer, sizeof(buffer))) > 0) {
+    stamp.size += nbytes;
+    stamp.crc = UpdateCRC16CCITT(buffer, nbytes, stamp.crc);
+  }
+
+  return stamp;
+}
+
+/**
+ * Insert or replace a value.  Unlike ProfileMap::Set(), this does not
+ * touch the "modified" flag.  The snapshot is sorted, therefore most
+ * keys are appended at the end of the map without a lookup.
+ */
+static void
+Put(ProfileMap &map, const char *key, size_t key_length,
+    const char *value, size_t value_length)
+{
+  std::string k(key, key_length);
+  if (map.empty() || map.rbegin()->first < k) {
+    map.emplace_hint(map.end(), std::move(k),
+                     std::string(value, value_length));
+    return;
+  }
+
+  auto i = map.lower_bound(k);
+  if (i != map.end() && i->first == k)
+    i->second.assign(value, value_length);
+  else
+    map.emplace_hint(i, std::move(k), std::string(value, value_length));
+}
+
+int
+Profile::LoadBinaryFile(ProfileMap &map, Path path, FileStamp stamp)
+{
+  FileReader reader(path);
+
+  const size_t size = reader.GetSize();
+  if (size < sizeof(BinaryProfileHeader))
+    throw std::runtime_error("Binary profile is too small");
+
+  std::unique_ptr<uint8_t[]> data(new uint8_t[size]);
+  for (size_t position = 0; position < size;) {
+    size_t nbytes = reader.Read(data.get() + position, size - position);
+    if (nbytes == 0)
+      throw std::runtime_error("Premature end of file");
+
+    position += nbytes;
+  }
+
+  BinaryProfileHeader header;
+  memcpy(&header, data.get(), sizeof(header));
+  if (header.magic != BINARY_PROFILE_MAGIC ||
+      header.version != BINARY_PROFILE_VERSION)
+    throw std::runtime_error("Not a binary profile");
+
+  if (header.text_size != stamp.size || header.text_crc != stamp.crc)
+    throw std::runtime_error("Binary profile is out of date");
+
+  const uint8_t *p = data.get() + sizeof(header);
+  const uint8_t *const end = data.get() + size;
+
+  unsigned n_records = 0;
+  while (p < end) {
+    BinaryProfileRecord record;
+    if (size_t(end - p) < sizeof(record))
+      return -1;
+
+    memcpy(&record, p, sizeof(record));
+
+    const size_t record_size = sizeof(record) + record.key_length
+      + record.value_length;
+    if (size_t(end - p) < record_size + sizeof(uint16_t))
+      return -1;
+
+    uint16_t crc;
+    memcpy(&crc, p + record_size, sizeof(crc));
+    if (crc != UpdateCRC16CCITT(p, record_size, 0))
+      return -1;
+
+    const char *key = (const char *)p + sizeof(record);
+    Put(map, key, record.key_length,
+        key + record.key_length, record.value_length);
+
+    p += record_size + sizeof(crc);
+    ++n_records;
+  }
+
+  if (n_records < header.n_snapshot)
+    return -1;
+
+  return n_records - header.n_snapshot;
+}
+
+/**
+ * Serialise one record into the specified buffer.
+ *
+ * @return false if the record cannot be represented
+ */
+static bool
+AppendRecord(std::string &buffer, const std::string &key,
+             const std::string &value)
+{
+  if (key.length() > 0xffff || value.length() > 0xffff)
+    /* the text file still has it */
+    return false;
+
+  const BinaryProfileRecord record{
+    uint16_t(key.length()), uint16_t(value.length()),
+  };
+
+  const size_t start = buffer.length();
+  buffer.append((const char *)&record, sizeof(record));
+  buffer.append(key);
+  buffer.append(value);
+
+  const uint16_t crc = UpdateCRC16CCITT(buffer.data() + start,
+                                        buffer.length() - start, 0);
+  buffer.append((const char *)&crc, sizeof(crc));
+  return true;
+}
+
+void
+Profile::SaveBinaryFile(const ProfileMap &map, Path path, FileStamp stamp)
+{
+  std::string buffer;
+  unsigned n = 0;
+  for (const auto &i : map)
+    if (AppendRecord(buffer, i.first, i.second))
+      ++n;
+
+  const BinaryProfileHeader header{
+    BINARY_PROFILE_MAGIC, BINARY_PROFILE_VERSION,
+    stamp.size, stamp.crc, 0,
+    n,
+  };
+
+  FileOutputStream file(path);
+  BufferedOutputStream buffered(file);
+  buffered.Write(&header, sizeof(header));
+  buffered.Write(buffer.data(), buffer.length());
+  buffered.Flush();
+  file.Commit();
+}
+
+unsigned
+Profile::AppendBinaryFile(const ProfileMap &map,
+                          const std::set<std::string> &keys, Path path)
+{
+  std::string buffer;
+  unsigned n = 0;
+  for (const auto &key : keys) {
+    auto i = map.find(key);
+    if (i != map.end() && AppendRecord(buffer, i->first, i->second))
+      ++n;
+  }
+
+  if (buffer.empty())
+    return 0;
+
+  FileOutputStream file(path, FileOutputStream::Mode::APPEND_EXISTING);
+  file.Write(buffer.data(), buffer.length());
+  file.Commit();
+  return n;
+}
@@ -0,0 +1,114 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_PROFILE_BINARY_FILE_HPP
+#define XCSOAR_PROFILE_BINARY_FILE_HPP
+
+#include "Compiler.h"
+
+#include <set>
+#include <string>
+
+#include <stdint.h>
+
+class ProfileMap;
+class Path;
+class AllocatedPath;
+
+/*
+ * The binary profile file is a copy of the text profile file which
+ * can be loaded without parsing, followed by a journal of values
+ * which have been modified since the copy was made.  Saving a few
+ * modified values only needs to append to the journal; the text file
+ * and the binary copy are rewritten only now and then
+ * ("compaction").
+ */
+namespace Profile {
+  /**
+   * Identifies the contents of a text profile file.  It is stored in
+   * the binary file, to detect whether the text file has been
+   * modified by somebody else.  The modification time is not used,
+   * because the startup dialog touches the selected profile.
+   */
+  struct FileStamp {
+    uint64_t size;
+    uint16_t crc;
+
+    bool operator==(const FileStamp &other) const {
+      return size == other.size && crc == other.crc;
+    }
+
+    bool operator!=(const FileStamp &other) const {
+      return !(*this == other);
+    }
+  };
+
+  /**
+   * Returns the path of the binary file which belongs to the
+   * specified text profile file.
+   */
+  gcc_pure
+  AllocatedPath GetBinaryPath(Path text_path);
+
+  /**
+   * Calculate the #FileStamp of the specified text profile file.
+   *
+   * Throws std::runtime_error on error.
+   */
+  FileStamp StampFile(Path path);
+
+  /**
+   * Load a binary profile file, including its journal.
+   *
+   * Throws std::runtime_error on error, or if the file was made for
+   * a different version of the text file.
+   *
+   * @param stamp the #FileStamp of the text file
+   * @return the number of journal records, or -1 if the file ends
+   * with a damaged record (e.g. after a crash while appending); all
+   * records before it have been loaded
+   */
+  int LoadBinaryFile(ProfileMap &map, Path path, FileStamp stamp);
+
+  /**
+   * Write all values to a new binary profile file with an empty
+   * journal.
+   *
+   * Throws std::runtime_error on error.
+   */
+  void SaveBinaryFile(const ProfileMap &map, Path path, FileStamp stamp);
+
+  /**
+   * Append the specified values to the journal of an existing binary
+   * profile file, with one write() call.  Keys which do not exist in
+   * the map are ignored.
+   *
+   * Throws std::runtime_error on error.
+   *
+   * @return the number of records which were appended
+   */
+  unsigned AppendBinaryFile(const ProfileMap &map,
+                            const std::set<std::string> &keys, Path path);
+}
+
+#endif
@@ -23,14 +23,18 @@ Copyright_License {
 
 #include "File.hpp"
 #include "Map.hpp"
+#include "BinaryFile.hpp"
 #include "IO/KeyValueFileReader.hpp"
 #include "IO/FileLineReader.hpp"
 #include "IO/FileOutputStream.hxx"
 #include "IO/BufferedOutputStream.hxx"
 #include "IO/KeyValueFileWriter.hpp"
 #include "OS/Path.hpp"
+#include "OS/FileUtil.hpp"
 #include "Util/StringAPI.hxx"
 
+#include <stdexcept>
+
 void
 Profile::LoadFile(ProfileMap &map, Path path)
 {
@@ -43,6 +47,13 @@ Profile::LoadFile(ProfileMap &map, Path path)
        interface */
     if (!StringIsEqual(pair.key, "Vega", 4))
       map.Set(pair.key, pair.value);
+
+  try {
+    LoadBinaryFile(map, GetBinaryPath(path), StampFile(path));
+  } catch (const std::runtime_error &e) {
+    /* no binary copy, or it belongs to a different version of the
+       text file: the text file is all we have */
+  }
 }
 
 void
@@ -57,4 +68,6 @@ Profile::SaveFile(const ProfileMap &map, Path path)
 
   buffered.Flush();
   file.Commit();
+
+  File::Delete(GetBinaryPath(path));
 }
@@ -29,11 +29,18 @@ class Path;
 
 namespace Profile {
   /**
+   * Load a text profile file.  If there is a matching binary copy
+   * (see BinaryFile.hpp), its journal is applied, because the text
+   * file may be outdated after a crash.
+   *
    * Throws std::runtime_errror on error.
    */
   void LoadFile(ProfileMap &map, Path path);
 
 /**
+ * Write a text profile file.  Its binary copy is deleted, because it
+ * does not match the new file.
+ *
  * Throws std::runtime_errror on error.
  */
 void SaveFile(const ProfileMap &map, Path path);
@@ -37,5 +37,6 @@ ProfileMap::Set(const char *key, const char *value)
     i.first->second.assign(value);
   }
 
+  modified_keys.emplace(key);
   SetModified();
 }
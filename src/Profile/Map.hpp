@@ -28,6 +28,7 @@ Copyright_License {
 #include "Compiler.h"
 
 #include <map>
+#include <set>
 #include <string>
 
 #include <stdint.h>
@@ -43,6 +44,12 @@ template<typename T> class AllocatedString;
 class ProfileMap : public std::map<std::string, std::string> {
   bool modified;
 
+  /**
+   * The keys which have been modified since the last
+   * SetModified(false) call.
+   */
+  std::set<std::string> modified_keys;
+
 public:
   ProfileMap():modified(false) {}
 
@@ -59,6 +66,12 @@ public:
    */
   void SetModified(bool _modified=true) {
     modified = _modified;
+    if (!modified)
+      modified_keys.clear();
+  }
+
+  const std::set<std::string> &GetModifiedKeys() const {
+    return modified_keys;
   }
 
   gcc_pure
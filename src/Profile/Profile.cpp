@@ -24,6 +24,7 @@ Copyright_License {
 #include "Profile.hpp"
 #include "Map.hpp"
 #include "File.hpp"
+#include "BinaryFile.hpp"
 #include "Current.hpp"
 #include "LogFile.hpp"
 #include "Asset.hpp"
@@ -35,28 +36,83 @@ Copyright_License {
 #include "OS/FileUtil.hpp"
 #include "OS/Path.hpp"
 
+#include <stdexcept>
+
 #include <windef.h> /* for MAX_PATH */
 #include <assert.h>
 
 #define XCSPROFILE "default.prf"
 #define OLDXCSPROFILE "xcsoar-registry.prf"
 
+/**
+ * Compact the binary profile when the journal has grown beyond this
+ * number of records.
+ */
+static constexpr unsigned MAX_JOURNAL = 256;
+
 static AllocatedPath startProfileFile = nullptr;
 
+/**
+ * Is the binary file next to #startProfileFile a valid copy of the
+ * text file plus a journal which can be appended to?  If not, the
+ * next Save() call rewrites both files.
+ */
+static bool binary_valid = false;
+
+/**
+ * The number of records in the journal of the binary file.
+ */
+static unsigned journal_size = 0;
+
 Path
 Profile::GetPath()
 {
   return startProfileFile;
 }
 
+/**
+ * Attempt to load the binary copy of the profile file.
+ *
+ * @return false if there is no usable binary file
+ */
+static bool
+LoadBinary()
+{
+  binary_valid = false;
+
+  try {
+    const auto stamp = Profile::StampFile(startProfileFile);
+    const auto path = Profile::GetBinaryPath(startProfileFile);
+    int n = Profile::LoadBinaryFile(Profile::map, path, stamp);
+
+    /* if the journal is damaged, the next Save() will rewrite both
+       files */
+    binary_valid = n >= 0;
+    journal_size = n >= 0 ? n : MAX_JOURNAL;
+
+    LogFormat(_T("Loaded profile from %s"), path.c_str());
+    return true;
+  } catch (const std::runtime_error &e) {
+    /* this is not an error; the text file will be loaded instead */
+    return false;
+  }
+}
+
 void
 Profile::Load()
 {
   assert(!startProfileFile.IsNull());
 
   LogFormat("Loading profiles");
-  LoadFile(startProfileFile);
+  if (!LoadBinary())
+    LoadFile(startProfileFile);
   SetModified(false);
+
+  if (journal_size > 0)
+    /* the previous session has not compacted the binary file
+       (e.g. after a crash): bring the text file up to date now,
+       because it may be read or edited by others */
+    Compact();
 }
 
 void
@@ -81,7 +137,49 @@ Profile::Save()
     SetFiles(nullptr);
 
   assert(!startProfileFile.IsNull());
-  SaveFile(startProfileFile);
+
+  if (binary_valid && journal_size < MAX_JOURNAL) {
+    /* fast path: append only the modified values to the journal */
+    try {
+      journal_size += AppendBinaryFile(map, map.GetModifiedKeys(),
+                                       GetBinaryPath(startProfileFile));
+      SetModified(false);
+      return;
+    } catch (const std::runtime_error &e) {
+      LogError("Failed to append to binary profile", e);
+    }
+  }
+
+  Compact();
+}
+
+void
+Profile::Compact()
+{
+  if (startProfileFile.IsNull()) {
+    if (!IsModified())
+      return;
+
+    SetFiles(nullptr);
+  }
+
+  if (IsModified() || journal_size > 0) {
+    SaveFile(startProfileFile);
+    SetModified(false);
+    journal_size = 0;
+  } else if (binary_valid)
+    /* nothing to do */
+    return;
+
+  binary_valid = false;
+
+  try {
+    SaveBinaryFile(map, GetBinaryPath(startProfileFile),
+                   StampFile(startProfileFile));
+    binary_valid = true;
+  } catch (const std::runtime_error &e) {
+    LogError("Failed to save binary profile", e);
+  }
 }
 
 void
@@ -97,6 +195,8 @@ Profile::SetFiles(Path override_path)
   /* set the "modified" flag, because we are potentially saving to a
      new file now */
   SetModified(true);
+  binary_valid = false;
+  journal_size = 0;
 
   if (!override_path.IsNull()) {
     if (override_path.IsBase()) {
@@ -43,7 +43,8 @@ namespace Profile
   Path GetPath();
 
   /**
-   * Loads the profile files
+   * Loads the profile files.  The binary copy (with its journal) is
+   * preferred if it is up to date.
    */
   void Load();
   /**
@@ -52,9 +53,18 @@ namespace Profile
   void LoadFile(Path path);
 
   /**
-   * Saves the profile into the profile files
+   * Saves the profile into the profile files.  Usually, this only
+   * appends the modified values to the journal of the binary file;
+   * when the journal becomes too large, Compact() is called.
    */
   void Save();
+
+  /**
+   * Rewrite the text profile file and the binary copy, merging the
+   * journal.  Call this before exiting, to keep the text file
+   * up to date.
+   */
+  void Compact();
   /**
    * Saves the profile into the given profile file
    */
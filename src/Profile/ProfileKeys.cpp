@@ -257,6 +257,8 @@ const char PCMetPassword[] = "PCMetPassword";
 const char PCMetFtpUsername[] = "PCMetFtpUsername";
 const char PCMetFtpPassword[] = "PCMetFtpPassword";
 
+const char DownloadBandwidthLimit[] = "DownloadBandwidthLimit";
+
 const char EnableLocationMapItem[] = "EnableLocationMapItem";
 const char EnableArrivalAltitudeMapItem[] = "EnableArrivalAltitudeMapItem";
 
@@ -255,6 +255,8 @@ extern const char PCMetPassword[];
 extern const char PCMetFtpUsername[];
 extern const char PCMetFtpPassword[];
 
+extern const char DownloadBandwidthLimit[];
+
 extern const char EnableLocationMapItem[];
 extern const char EnableArrivalAltitudeMapItem[];
 
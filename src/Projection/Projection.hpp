@@ -151,6 +151,26 @@ public:
   gcc_pure
   PixelPoint GeoToScreen(const GeoPoint &g) const;
 
+  /**
+   * Like GeoToScreen(), but with a precalculated
+   * g.latitude.fastcosine().  The longitude difference between
+   * GetGeoLocation() and the point is not normalised; the caller must
+   * ensure that it is within -180..180 degrees.
+   */
+  gcc_pure
+  PixelPoint GeoToScreen(const GeoPoint &g, double cos_latitude) const {
+    assert(IsValid());
+
+    const auto p =
+      screen_rotation.Rotate(int(cos_latitude *
+                                 AngleToPixels(geo_location.longitude -
+                                               g.longitude)),
+                             (int)AngleToPixels(geo_location.latitude -
+                                                g.latitude));
+
+    return PixelPoint(screen_origin.x - p.x, screen_origin.y + p.y);
+  }
+
   /**
    * Returns the origin/rotation center in screen coordinates
    * @return The origin/rotation center in screen coordinates
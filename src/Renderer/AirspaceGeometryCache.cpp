@@ -0,0 +1,275 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AirspaceGeometryCache.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Airspace/Airspaces.hpp"
+#include "Airspace/AbstractAirspace.hpp"
+#include "Geo/SearchPointVector.hpp"
+#include "Geo/FAISphere.hpp"
+
+#include <algorithm>
+
+#include <math.h>
+
+const AirspaceGeometryCache::Level *
+AirspaceGeometryCache::Entry::FindLevel(int zoom) const
+{
+  for (const auto &level : levels)
+    if (level.zoom == zoom)
+      return &level;
+
+  return nullptr;
+}
+
+int
+AirspaceGeometryCache::CalculateZoom(double scale)
+{
+  /* floor(log2(metres per pixel)); frexp() returns a mantissa in the
+     range [0.5,1) */
+  int exponent;
+  frexp(1. / scale, &exponent);
+  return std::max(exponent - 1, MIN_LEVEL - 1);
+}
+
+void
+AirspaceGeometryCache::Begin(const Airspaces &_airspaces,
+                             const WindowProjection &_projection)
+{
+  if (&_airspaces != airspaces || _airspaces.GetSerial() != serial) {
+    Clear();
+    airspaces = &_airspaces;
+    serial = _airspaces.GetSerial();
+  }
+
+  projection = &_projection;
+  clip_bounds = _projection.GetScreenBounds().Scale(1.1);
+  clip = GeoClip(clip_bounds);
+  zoom = CalculateZoom(_projection.GetScale());
+}
+
+/**
+ * A vertex in a local flat projection [m].
+ */
+struct FlatVertex {
+  double x, y;
+};
+
+/**
+ * Calculate the squared distance of a point from a line segment.
+ */
+gcc_pure
+static double
+SegmentDistanceSquared(FlatVertex p, FlatVertex a, FlatVertex b)
+{
+  const double dx = b.x - a.x, dy = b.y - a.y;
+  const double length_squared = dx * dx + dy * dy;
+
+  double t = length_squared > 0
+    ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / length_squared
+    : 0;
+  t = std::min(std::max(t, 0.), 1.);
+
+  const double ex = a.x + t * dx - p.x, ey = a.y + t * dy - p.y;
+  return ex * ex + ey * ey;
+}
+
+void
+AirspaceGeometryCache::Simplify(std::vector<Vertex> &vertices,
+                                double tolerance)
+{
+  const unsigned n = vertices.size();
+  if (n <= 3)
+    return;
+
+  /* project relative to the first vertex, so the date line doesn't
+     matter */
+  const GeoPoint origin = vertices.front().location;
+  std::vector<FlatVertex> flat;
+  flat.reserve(n);
+  for (const auto &v : vertices)
+    flat.push_back({
+        FAISphere::AngleToEarthDistance((v.location.longitude -
+                                         origin.longitude).AsDelta()) *
+          v.cos_latitude,
+        FAISphere::AngleToEarthDistance(v.location.latitude -
+                                        origin.latitude),
+      });
+
+  /* the polygon is closed: split it at the vertex which is farthest
+     from the first one, and simplify both halves as open polylines;
+     index n refers to the first vertex again */
+  unsigned split = 0;
+  double split_distance = -1;
+  for (unsigned i = 1; i < n; ++i) {
+    const double dx = flat[i].x, dy = flat[i].y;
+    const double d = dx * dx + dy * dy;
+    if (d > split_distance) {
+      split_distance = d;
+      split = i;
+    }
+  }
+
+  std::vector<bool> keep(n, false);
+  keep[0] = keep[split] = true;
+
+  const double tolerance_squared = tolerance * tolerance;
+
+  struct Range {
+    unsigned first, last;
+  };
+
+  std::vector<Range> stack{{0, split}, {split, n}};
+  while (!stack.empty()) {
+    const Range r = stack.back();
+    stack.pop_back();
+
+    if (r.last - r.first < 2)
+      continue;
+
+    const FlatVertex a = flat[r.first], b = flat[r.last % n];
+
+    unsigned farthest = r.first;
+    double farthest_distance = tolerance_squared;
+    for (unsigned i = r.first + 1; i < r.last; ++i) {
+      const double d = SegmentDistanceSquared(flat[i], a, b);
+      if (d > farthest_distance) {
+        farthest_distance = d;
+        farthest = i;
+      }
+    }
+
+    if (farthest != r.first) {
+      keep[farthest] = true;
+      stack.push_back({r.first, farthest});
+      stack.push_back({farthest, r.last});
+    }
+  }
+
+  if (std::count(keep.begin(), keep.end(), true) < 3)
+    /* degenerate polygon; don't simplify */
+    return;
+
+  unsigned j = 0;
+  for (unsigned i = 0; i < n; ++i)
+    if (keep[i])
+      vertices[j++] = vertices[i];
+
+  vertices.resize(j);
+}
+
+AirspaceGeometryCache::Entry &
+AirspaceGeometryCache::MakeEntry(const AbstractAirspace &airspace)
+{
+  auto i = entries.find(&airspace);
+  if (i != entries.end())
+    return i->second;
+
+  Entry &entry = entries[&airspace];
+  entry.bounds = airspace.GetPoints().CalculateGeoBounds();
+
+  /* if the bounds do not wrap around and are narrower than 180
+     degrees, no longitude difference to a point on the screen can
+     exceed 180 degrees */
+  entry.simple_longitude = entry.bounds.IsValid() &&
+    entry.bounds.GetWest() <= entry.bounds.GetEast() &&
+    entry.bounds.GetEast() - entry.bounds.GetWest() < Angle::HalfCircle();
+
+  return entry;
+}
+
+const AirspaceGeometryCache::Level &
+AirspaceGeometryCache::MakeLevel(Entry &entry,
+                                 const AbstractAirspace &airspace)
+{
+  const Level *found = entry.FindLevel(zoom);
+  if (found != nullptr)
+    return *found;
+
+  if (entry.levels.size() >= MAX_LEVELS)
+    entry.levels.erase(entry.levels.begin());
+
+  entry.levels.emplace_back();
+  Level &level = entry.levels.back();
+  level.zoom = zoom;
+
+  const SearchPointVector &points = airspace.GetPoints();
+  level.vertices.reserve(points.size());
+  for (const auto &i : points) {
+    const GeoPoint &location = i.GetLocation();
+    level.vertices.push_back({location, location.latitude.fastcosine()});
+  }
+
+  if (zoom >= MIN_LEVEL)
+    /* the tolerance is between half a pixel and one pixel */
+    Simplify(level.vertices, ldexp(1., zoom));
+
+  level.vertices.shrink_to_fit();
+  return level;
+}
+
+unsigned
+AirspaceGeometryCache::Project(const AbstractAirspace &airspace,
+                               AllocatedArray<BulkPixelPoint> &dest)
+{
+  assert(projection != nullptr);
+
+  if (airspace.GetPoints().size() < 3)
+    return 0;
+
+  Entry &entry = MakeEntry(airspace);
+  if (!entry.bounds.IsValid() || !entry.bounds.Overlaps(clip_bounds))
+    return 0;
+
+  const Level &level = MakeLevel(entry, airspace);
+  const unsigned n = level.vertices.size();
+
+  if (entry.simple_longitude && clip_bounds.IsInside(entry.bounds) &&
+      (projection->GetGeoLocation().longitude -
+       entry.bounds.GetWest()).Absolute() < Angle::HalfCircle() &&
+      (projection->GetGeoLocation().longitude -
+       entry.bounds.GetEast()).Absolute() < Angle::HalfCircle()) {
+    /* completely visible: no clipping needed, and the projection
+       doesn't need trigonometry */
+    dest.GrowDiscard(n);
+    for (unsigned i = 0; i < n; ++i)
+      dest[i] = projection->GeoToScreen(level.vertices[i].location,
+                                        level.vertices[i].cos_latitude);
+    return n;
+  }
+
+  geo_points.GrowDiscard(n * 3);
+  for (unsigned i = 0; i < n; ++i)
+    geo_points[i] = level.vertices[i].location;
+
+  const unsigned size = clip.ClipPolygon(geo_points.begin(),
+                                         geo_points.begin(), n);
+  if (size < 3)
+    /* it's completely outside the screen */
+    return 0;
+
+  dest.GrowDiscard(size);
+  for (unsigned i = 0; i < size; ++i)
+    dest[i] = projection->GeoToScreen(geo_points[i]);
+
+  return size;
+}
@@ -0,0 +1,171 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_AIRSPACE_GEOMETRY_CACHE_HPP
+#define XCSOAR_AIRSPACE_GEOMETRY_CACHE_HPP
+
+#include "Screen/BulkPoint.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "Geo/GeoClip.hpp"
+#include "Util/AllocatedArray.hxx"
+#include "Util/Serial.hpp"
+#include "Compiler.h"
+
+#include <unordered_map>
+#include <vector>
+
+class Airspaces;
+class AbstractAirspace;
+class WindowProjection;
+
+/**
+ * Caches simplified airspace polygons per zoom level, so the
+ * renderers do not have to clip and project every vertex of every
+ * airspace on every frame.
+ *
+ * For each polygon, the bounds are calculated once; they are used
+ * to skip invisible airspaces quickly.  The vertices are thinned
+ * with the Douglas-Peucker algorithm to a tolerance which is below
+ * one pixel at the current map scale; the zoom level is rounded to
+ * a power of two, so the cache remains valid while the user pans,
+ * rotates or zooms slightly.
+ *
+ * A polygon which is completely inside the clipping rectangle is
+ * projected directly from the cached vertices, with the latitude
+ * cosine already known.  Others are clipped first, just like
+ * MapCanvas::PreparePolygon() does.
+ *
+ * The cache is flushed automatically when the #Airspaces object or
+ * its serial changes.  This class is not thread-safe.
+ */
+class AirspaceGeometryCache {
+public:
+  struct Vertex {
+    GeoPoint location;
+
+    /**
+     * The value of location.latitude.fastcosine(), for
+     * Projection::GeoToScreen().
+     */
+    double cos_latitude;
+  };
+
+private:
+  /**
+   * Do not keep more than this number of zoom levels per airspace.
+   */
+  static constexpr unsigned MAX_LEVELS = 4;
+
+  /**
+   * Below this zoom level (log2 of metres per pixel), polygons are
+   * not simplified.
+   */
+  static constexpr int MIN_LEVEL = 0;
+
+  struct Level {
+    int zoom;
+    std::vector<Vertex> vertices;
+  };
+
+  struct Entry {
+    GeoBounds bounds;
+
+    /**
+     * Can the polygon be projected without normalising the longitude
+     * difference?  This is false if the polygon crosses the date line.
+     */
+    bool simple_longitude;
+
+    std::vector<Level> levels;
+
+    gcc_pure
+    const Level *FindLevel(int zoom) const;
+  };
+
+  const Airspaces *airspaces = nullptr;
+  Serial serial;
+
+  std::unordered_map<const AbstractAirspace *, Entry> entries;
+
+  /* per-frame state, initialised by Begin() */
+  const WindowProjection *projection = nullptr;
+  GeoBounds clip_bounds;
+  GeoClip clip;
+  int zoom;
+
+  AllocatedArray<GeoPoint> geo_points;
+
+public:
+  AirspaceGeometryCache()
+    :clip_bounds(GeoBounds::Invalid()) {}
+
+  AirspaceGeometryCache(const AirspaceGeometryCache &) = delete;
+  AirspaceGeometryCache &operator=(const AirspaceGeometryCache &) = delete;
+
+  void Clear() {
+    entries.clear();
+  }
+
+  /**
+   * Prepare for drawing a new frame.  Flushes the cache if the
+   * #Airspaces object has been modified since the last call.
+   *
+   * @param projection the projection used for this frame; the
+   * reference must remain valid until the frame is finished
+   */
+  void Begin(const Airspaces &airspaces, const WindowProjection &projection);
+
+  /**
+   * Project the (simplified) polygon of the specified airspace to
+   * screen coordinates.  Begin() must have been called before.
+   *
+   * @param dest a buffer which will be enlarged as necessary
+   * @return the number of points written to #dest; if less than 3,
+   * the polygon is not visible
+   */
+  unsigned Project(const AbstractAirspace &airspace,
+                   AllocatedArray<BulkPixelPoint> &dest);
+
+  /**
+   * Thin out a polygon with the Douglas-Peucker algorithm.  The
+   * distances are calculated in a local flat projection.
+   *
+   * @param tolerance the maximum distance of a removed vertex from
+   * the simplified outline [m]
+   */
+  static void Simplify(std::vector<Vertex> &vertices, double tolerance);
+
+  /**
+   * Calculate the zoom level for the specified map scale.
+   *
+   * @param scale the map scale [px/m]
+   */
+  gcc_const
+  static int CalculateZoom(double scale);
+
+private:
+  Entry &MakeEntry(const AbstractAirspace &airspace);
+
+  const Level &MakeLevel(Entry &entry, const AbstractAirspace &airspace);
+};
+
+#endif
@@ -77,6 +77,8 @@ AirspaceRenderer::Draw(Canvas &canvas,
   if (airspaces == nullptr || airspaces->IsEmpty())
     return;
 
+  geometry_cache.Begin(*airspaces, projection);
+
   DrawInternal(canvas,
 #ifndef ENABLE_OPENGL
                stencil_canvas,
@@ -24,6 +24,7 @@ Copyright_License {
 #ifndef XCSOAR_AIRSPACE_RENDERER_HPP
 #define XCSOAR_AIRSPACE_RENDERER_HPP
 
+#include "AirspaceGeometryCache.hpp"
 #include "Util/StaticArray.hxx"
 #include "Geo/GeoPoint.hpp"
 
@@ -52,6 +53,12 @@ class AirspaceRenderer
 
   StaticArray<GeoPoint,32> intersections;
 
+  /**
+   * Simplified polygons for the current zoom level, shared by all
+   * drawing passes.
+   */
+  AirspaceGeometryCache geometry_cache;
+
 #ifndef ENABLE_OPENGL
   /**
    * This object caches the airspace fill.  This avoids drawing it
@@ -96,6 +103,7 @@ public:
   }
 
   void Flush() {
+    geometry_cache.Clear();
 #ifndef ENABLE_OPENGL
     fill_cache.Invalidate();
 #endif
@@ -119,7 +127,7 @@ private:
   void DrawOutline(Canvas &canvas,
                    const WindowProjection &projection,
                    const AirspaceRendererSettings &settings,
-                   const AirspacePredicate &visible) const;
+                   const AirspacePredicate &visible);
 #endif
 
   void DrawInternal(Canvas &canvas,
@@ -50,14 +50,19 @@ class AirspaceVisitorMap final
 {
   const AirspaceLook &look;
   const AirspaceWarningCopy &warnings;
+  AirspaceGeometryCache &geometry_cache;
+
+  AllocatedArray<BulkPixelPoint> screen_points;
 
 public:
   AirspaceVisitorMap(StencilMapCanvas &_helper,
                      const AirspaceWarningCopy &_warnings,
                      const AirspaceRendererSettings &_settings,
-                     const AirspaceLook &_airspace_look)
+                     const AirspaceLook &_airspace_look,
+                     AirspaceGeometryCache &_geometry_cache)
     :StencilMapCanvas(_helper),
-     look(_airspace_look), warnings(_warnings)
+     look(_airspace_look), warnings(_warnings),
+     geometry_cache(_geometry_cache)
   {
     switch (settings.fill_mode) {
     case AirspaceRendererSettings::FillMode::DEFAULT:
@@ -80,7 +85,9 @@ private:
   }
 
   void VisitPolygon(const AirspacePolygon &airspace) {
-    DrawSearchPointVector(airspace.GetPoints());
+    const unsigned size = geometry_cache.Project(airspace, screen_points);
+    if (size >= 3)
+      DrawPolygon(screen_points.begin(), size);
   }
 
 public:
@@ -155,14 +162,16 @@ class AirspaceOutlineRenderer final
 {
   const AirspaceLook &look;
   const AirspaceRendererSettings &settings;
+  AirspaceGeometryCache &geometry_cache;
 
 public:
   AirspaceOutlineRenderer(Canvas &_canvas, const WindowProjection &_projection,
                           const AirspaceLook &_look,
-                          const AirspaceRendererSettings &_settings)
+                          const AirspaceRendererSettings &_settings,
+                          AirspaceGeometryCache &_geometry_cache)
     :MapCanvas(_canvas, _projection,
                _projection.GetScreenBounds().Scale(1.1)),
-     look(_look), settings(_settings)
+     look(_look), settings(_settings), geometry_cache(_geometry_cache)
   {
     if (settings.black_outline)
       canvas.SelectBlackPen();
@@ -190,7 +199,9 @@ private:
   }
 
   void VisitPolygon(const AirspacePolygon &airspace) {
-    DrawPolygon(airspace.GetPoints());
+    num_raster_points = geometry_cache.Project(airspace, raster_points);
+    if (num_raster_points >= 3)
+      DrawPrepared();
   }
 
 public:
@@ -220,7 +231,7 @@ AirspaceRenderer::DrawFill(Canvas &buffer_canvas, Canvas &stencil_canvas,
   StencilMapCanvas helper(buffer_canvas, stencil_canvas, projection,
                           settings);
   AirspaceVisitorMap v(helper, awc, settings,
-                       look);
+                       look, geometry_cache);
 
   // JMW TODO wasteful to draw twice, can't it be drawn once?
   // we are using two draws so borders go on top of everything
@@ -228,10 +239,18 @@ AirspaceRenderer::DrawFill(Canvas &buffer_canvas, Canvas &stencil_canvas,
   const auto range =
     airspaces->QueryWithinRange(projection.GetGeoScreenCenter(),
                                 projection.GetScreenDistanceMeters());
-  for (const auto &i : range) {
-    const AbstractAirspace &airspace = i.GetAirspace();
-    if (visible(airspace))
-      v.Visit(airspace);
+
+  {
+#ifdef USE_MEMORY_CANVAS
+    /* rasterise the airspace areas on multiple threads */
+    const ScopeCanvasBatch batch(buffer_canvas);
+#endif
+
+    for (const auto &i : range) {
+      const AbstractAirspace &airspace = i.GetAirspace();
+      if (visible(airspace))
+        v.Visit(airspace);
+    }
   }
 
   return v.Commit();
@@ -274,13 +293,14 @@ inline void
 AirspaceRenderer::DrawOutline(Canvas &canvas,
                               const WindowProjection &projection,
                               const AirspaceRendererSettings &settings,
-                              const AirspacePredicate &visible) const
+                              const AirspacePredicate &visible)
 {
   const auto range =
     airspaces->QueryWithinRange(projection.GetGeoScreenCenter(),
                                 projection.GetScreenDistanceMeters());
 
-  AirspaceOutlineRenderer outline_renderer(canvas, projection, look, settings);
+  AirspaceOutlineRenderer outline_renderer(canvas, projection, look, settings,
+                                           geometry_cache);
   for (const auto &i : range) {
     const AbstractAirspace &airspace = i.GetAirspace();
     if (visible(airspace))
@@ -41,27 +41,43 @@ LabelBlock::Bucket::Check(const PixelRect rc) const
 
 void LabelBlock::reset()
 {
-  for (unsigned i = 0; i < BUCKET_COUNT; ++i)
+  for (unsigned i = 0; i < HASH_SIZE; ++i)
     buckets[i].Clear();
 }
 
 bool LabelBlock::check(const PixelRect rc)
 {
-  unsigned top = rc.top >> BUCKET_SHIFT;
-  unsigned bottom = rc.bottom >> BUCKET_SHIFT;
+  const int left = GetCell(rc.left), right = GetCell(rc.right);
+  const int top = GetCell(rc.top), bottom = GetCell(rc.bottom);
 
-  if (top >= BUCKET_COUNT)
-    top = BUCKET_COUNT - 1;
+  /* a huge rectangle would touch every bucket anyway; limit the
+     number of iterations */
+  const bool huge = unsigned(right - left + 1) * unsigned(bottom - top + 1)
+    > HASH_SIZE;
 
-  if (bottom < BUCKET_COUNT && !buckets[bottom].Check(rc))
-    return false;
+  if (huge) {
+    for (unsigned i = 0; i < HASH_SIZE; ++i)
+      if (!buckets[i].Check(rc))
+        return false;
+  } else {
+    for (int y = top; y <= bottom; ++y)
+      for (int x = left; x <= right; ++x)
+        if (!buckets[Hash(x, y)].Check(rc))
+          return false;
+  }
 
-  if (top < bottom && !buckets[top].Check(rc))
-    return false;
-
-  buckets[top].Add(rc);
-  if (bottom < BUCKET_COUNT && top != bottom)
-    buckets[bottom].Add(rc);
+  if (huge) {
+    for (unsigned i = 0; i < HASH_SIZE; ++i)
+      buckets[i].Add(rc);
+  } else {
+    for (int y = top; y <= bottom; ++y)
+      for (int x = left; x <= right; ++x) {
+        Bucket &bucket = buckets[Hash(x, y)];
+        /* two cells of this rectangle may share a bucket */
+        if (bucket.Check(rc))
+          bucket.Add(rc);
+      }
+  }
 
   return true;
 }
@@ -30,24 +30,29 @@ Copyright_License {
 
 /**
  * Simple code to prevent text writing over map city names.
+ *
+ * The rectangles are stored in a spatial hash: the screen is divided
+ * into square cells, and each rectangle is added to the buckets of
+ * all cells it touches.  A hit test therefore only needs to look at
+ * the rectangles near it.
  */
 class LabelBlock {
 #if defined(HAVE_GLES)
   /* embedded (Android or Windows CE) */
-  static constexpr unsigned SCREEN_HEIGHT = 2048;
-  static constexpr unsigned BUCKET_SIZE = 64;
+  static constexpr unsigned HASH_SIZE = 128;
 #else
   /* desktop, screen may be huge, lots of memory */
-  static constexpr unsigned SCREEN_HEIGHT = 4096;
-  static constexpr unsigned BUCKET_SIZE = 64;
+  static constexpr unsigned HASH_SIZE = 256;
 #endif
-  static constexpr unsigned BUCKET_SHIFT = 7;
-  static constexpr unsigned BUCKET_HEIGHT = 1 << BUCKET_SHIFT;
-  static constexpr unsigned BUCKET_COUNT = SCREEN_HEIGHT / BUCKET_HEIGHT;
+  static constexpr unsigned BUCKET_SIZE = 32;
+  static constexpr unsigned CELL_SHIFT = 7;
+
+  static_assert((HASH_SIZE & (HASH_SIZE - 1)) == 0,
+                "HASH_SIZE must be a power of two");
 
   /**
-   * A bucket is responsible for hit tests in one horizontal section
-   * of the screen.
+   * A bucket is responsible for hit tests in the cells which are
+   * mapped to it by the hash function.
    */
   class Bucket {
     typedef StaticArray<PixelRect, BUCKET_SIZE> BlockArray;
@@ -65,7 +70,17 @@ class LabelBlock {
     }
   };
 
-  Bucket buckets[BUCKET_COUNT];
+  Bucket buckets[HASH_SIZE];
+
+  static constexpr int GetCell(int coordinate) {
+    /* arithmetic shift: rounds towards negative infinity */
+    return coordinate >> CELL_SHIFT;
+  }
+
+  static constexpr unsigned Hash(int x, int y) {
+    return (unsigned(x) * 73856093u ^ unsigned(y) * 19349663u)
+      & (HASH_SIZE - 1);
+  }
 
 public:
   bool check(const PixelRect rc);
@@ -0,0 +1,59 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "LabelPlacementHistory.hpp"
+
+#include <stdlib.h>
+
+bool
+LabelPlacementHistory::IsStable(unsigned id, PixelPoint position) const
+{
+  auto i = items.find(id);
+  if (i == items.end())
+    return false;
+
+  const Item &item = i->second;
+  return item.visible &&
+    abs(position.x - item.position.x) <= STABLE_DISTANCE &&
+    abs(position.y - item.position.y) <= STABLE_DISTANCE;
+}
+
+void
+LabelPlacementHistory::Store(unsigned id, PixelPoint position, bool visible)
+{
+  Item &item = items[id];
+  item.position = position;
+  item.visible = visible;
+  item.current = true;
+}
+
+void
+LabelPlacementHistory::Commit()
+{
+  for (auto i = items.begin(); i != items.end();) {
+    if (i->second.current) {
+      i->second.current = false;
+      ++i;
+    } else
+      i = items.erase(i);
+  }
+}
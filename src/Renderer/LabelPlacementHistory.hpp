@@ -0,0 +1,84 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_LABEL_PLACEMENT_HISTORY_HPP
+#define XCSOAR_LABEL_PLACEMENT_HISTORY_HPP
+
+#include "Screen/Point.hpp"
+#include "Compiler.h"
+
+#include <unordered_map>
+
+/**
+ * Remembers which map labels were drawn in the previous frame, so
+ * the next frame can prefer them over other labels of the same
+ * class.  This avoids labels of similar priority taking turns
+ * (flickering) while the map is panned.  All labels are still
+ * placed again in each frame.
+ *
+ * Labels are identified by a caller-defined number, e.g. the
+ * waypoint id.
+ */
+class LabelPlacementHistory {
+  /**
+   * A label which moved more than this number of pixels (in either
+   * direction) since the last frame is placed like a new one.
+   */
+  static constexpr int STABLE_DISTANCE = 16;
+
+  struct Item {
+    PixelPoint position;
+    bool visible;
+
+    /**
+     * Was this item stored during the current frame?
+     */
+    bool current;
+  };
+
+  std::unordered_map<unsigned, Item> items;
+
+public:
+  void Clear() {
+    items.clear();
+  }
+
+  /**
+   * Was the specified label drawn in the previous frame, at
+   * (approximately) the same position?
+   */
+  gcc_pure
+  bool IsStable(unsigned id, PixelPoint position) const;
+
+  /**
+   * Record the placement decision for a label in the current frame.
+   */
+  void Store(unsigned id, PixelPoint position, bool visible);
+
+  /**
+   * Finish the current frame: forget all labels which were not
+   * stored since the last call.
+   */
+  void Commit();
+};
+
+#endif
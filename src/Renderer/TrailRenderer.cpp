@@ -142,6 +142,12 @@ TrailRenderer::Draw(Canvas &canvas, const TraceComputer &trace_computer,
 
   const GeoBounds bounds = projection.GetScreenBounds().Scale(4);
 
+#ifdef ENABLE_OPENGL
+  /* one draw call for all trail segments instead of one per
+     segment */
+  const ScopeCanvasBatch batch(canvas);
+#endif
+
   PixelPoint last_point(0, 0);
   bool last_valid = false;
   for (auto it = trace.begin(), end = trace.end(); it != end; ++it) {
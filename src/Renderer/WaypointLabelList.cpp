@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "WaypointLabelList.hpp"
+#include "LabelPlacementHistory.hpp"
 #include "Util/StringUtil.hpp"
 #include "Util/Macros.hpp"
 
@@ -58,6 +59,12 @@ MapWaypointLabelListCompare(const WaypointLabelList::Label &e1,
   if (!e1.isWatchedWaypoint && e2.isWatchedWaypoint)
     return false;
 
+  if (e1.stable && !e2.stable)
+    return true;
+
+  if (!e1.stable && e2.stable)
+    return false;
+
   if (e1.AltArivalAGL > e2.AltArivalAGL)
     return true;
 
@@ -68,7 +75,7 @@ MapWaypointLabelListCompare(const WaypointLabelList::Label &e1,
 }
 
 void
-WaypointLabelList::Add(const TCHAR *Name, int X, int Y,
+WaypointLabelList::Add(unsigned id, const TCHAR *Name, int X, int Y,
                        TextInBoxMode Mode, bool bold,
                        int AltArivalAGL, bool inTask,
                        bool isLandable, bool isAirport, bool isWatchedWaypoint)
@@ -82,6 +89,7 @@ WaypointLabelList::Add(const TCHAR *Name, int X, int Y,
 
   auto &l = labels.append();
 
+  l.id = id;
   CopyString(l.Name, Name, ARRAY_SIZE(l.Name));
   l.Pos.x = X;
   l.Pos.y = Y;
@@ -92,6 +100,14 @@ WaypointLabelList::Add(const TCHAR *Name, int X, int Y,
   l.isLandable = isLandable;
   l.isAirport  = isAirport;
   l.isWatchedWaypoint = isWatchedWaypoint;
+  l.stable = false;
+}
+
+void
+WaypointLabelList::UpdateStable(const LabelPlacementHistory &history)
+{
+  for (auto &l : labels)
+    l.stable = history.IsStable(l.id, l.Pos);
 }
 
 void
@@ -32,9 +32,16 @@ Copyright_License {
 
 #include <tchar.h>
 
+class LabelPlacementHistory;
+
 class WaypointLabelList : private NonCopyable {
 public:
   struct Label{
+    /**
+     * The waypoint id, for #LabelPlacementHistory.
+     */
+    unsigned id;
+
     TCHAR Name[NAME_SIZE+1];
     PixelPoint Pos;
     TextInBoxMode Mode;
@@ -44,6 +51,13 @@ public:
     bool isAirport;
     bool isWatchedWaypoint;
     bool bold;
+
+    /**
+     * Was this label visible at about the same position in the
+     * previous frame?  Such labels are preferred over others of the
+     * same class.
+     */
+    bool stable;
   };
 
 protected:
@@ -55,11 +69,17 @@ public:
   WaypointLabelList(unsigned _width, unsigned _height)
     :width(_width), height(_height) {}
 
-  void Add(const TCHAR *name, int x, int y,
+  void Add(unsigned id, const TCHAR *name, int x, int y,
            TextInBoxMode Mode, bool bold,
            int AltArivalAGL,
            bool inTask, bool isLandable, bool isAirport,
            bool isWatchedWaypoint);
+
+  /**
+   * Update the "stable" flag of all labels.
+   */
+  void UpdateStable(const LabelPlacementHistory &history);
+
   void Sort();
 
   const Label *begin() const {
@@ -344,7 +344,8 @@ protected:
       // make space for the green circle
       sc.x += 5;
 
-    labels.Add(buffer, sc.x + 5, sc.y, text_mode, bold, vwp.reach.direct,
+    labels.Add(way_point.id, buffer, sc.x + 5, sc.y, text_mode, bold,
+               vwp.reach.direct,
                vwp.in_task, way_point.IsLandable(), way_point.IsAirport(),
                watchedWaypoint);
   }
@@ -441,16 +442,23 @@ static void
 MapWaypointLabelRender(Canvas &canvas, unsigned width, unsigned height,
                        LabelBlock &label_block,
                        WaypointLabelList &labels,
+                       LabelPlacementHistory &history,
                        const WaypointLook &look)
 {
+  /* labels which were visible in the last frame win over others of
+     the same class; this keeps the placement stable while panning */
+  labels.UpdateStable(history);
   labels.Sort();
 
   for (const auto &l : labels) {
     canvas.Select(l.bold ? *look.bold_font : *look.font);
 
-    TextInBox(canvas, l.Name, l.Pos.x, l.Pos.y, l.Mode,
-              width, height, &label_block);
+    const bool visible = TextInBox(canvas, l.Name, l.Pos.x, l.Pos.y, l.Mode,
+                                   width, height, &label_block);
+    history.Store(l.id, l.Pos, visible);
   }
+
+  history.Commit();
 }
 
 void
@@ -488,10 +496,17 @@ WaypointRenderer::render(Canvas &canvas, LabelBlock &label_block,
 
   v.Calculate(route_planner, polar_settings, task_behaviour, calculated);
 
-  v.Draw(canvas);
+  {
+#ifdef ENABLE_OPENGL
+    /* collect the vector symbols of all waypoints */
+    const ScopeCanvasBatch batch(canvas);
+#endif
+
+    v.Draw(canvas);
+  }
 
   MapWaypointLabelRender(canvas,
                          projection.GetScreenWidth(),
                          projection.GetScreenHeight(),
-                         label_block, v.labels, look);
+                         label_block, v.labels, label_history, look);
 }
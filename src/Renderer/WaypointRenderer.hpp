@@ -24,6 +24,7 @@ Copyright_License {
 #ifndef XCSOAR_WAY_POINT_RENDERER_HPP
 #define XCSOAR_WAY_POINT_RENDERER_HPP
 
+#include "LabelPlacementHistory.hpp"
 #include "Util/NonCopyable.hpp"
 
 struct WaypointRendererSettings;
@@ -47,6 +48,8 @@ class WaypointRenderer : private NonCopyable {
 
   const WaypointLook &look;
 
+  LabelPlacementHistory label_history;
+
 public:
   enum Reachability
   {
@@ -62,6 +65,7 @@ public:
 
   void set_way_points(const Waypoints *_way_points) {
     way_points = _way_points;
+    label_history.Clear();
   }
 
   void render(Canvas &canvas, LabelBlock &label_block,
@@ -43,6 +43,11 @@ struct AvailableFile {
    */
   std::string uri;
 
+  /**
+   * The hex MD5 digest of the file.  Empty if unknown.
+   */
+  std::string md5;
+
   /**
    * A short symbolic name for the area.  Empty means this file is
    * global.
@@ -62,6 +67,7 @@ struct AvailableFile {
   void Clear() {
     name.clear();
     uri.clear();
+    md5.clear();
     area.clear();
     type = FileType::UNKNOWN;
   }
@@ -74,6 +80,13 @@ struct AvailableFile {
     return uri.c_str();
   }
 
+  /**
+   * @return the MD5 digest or nullptr if unknown
+   */
+  const char *GetMD5() const {
+    return md5.empty() ? nullptr : md5.c_str();
+  }
+
   const char *GetArea() const {
     return area;
   }
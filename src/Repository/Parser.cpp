@@ -85,6 +85,8 @@ ParseFileRepository(FileRepository &repository, NLineReader &reader)
       /* ignore */
     } else if (StringIsEqual(name, "uri")) {
       file.uri.assign(value);
+    } else if (StringIsEqual(name, "md5")) {
+      file.md5.assign(value);
     } else if (StringIsEqual(name, "area")) {
       file.area = value;
     } else if (StringIsEqual(name, "type")) {
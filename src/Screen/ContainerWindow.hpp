@@ -99,6 +99,12 @@ public:
    */
   void InvalidateChild(const Window &child);
 
+  /**
+   * Like InvalidateChild(), but only the specified rectangle
+   * (relative to this window) has changed.
+   */
+  void InvalidateChildArea(const Window &child, const PixelRect &rc);
+
   void BringChildToTop(Window &child) {
     children.BringToTop(child);
     InvalidateChild(child);
@@ -196,6 +196,8 @@ static Mutex text_cache_mutex;
 static Cache<TextCacheKey, PixelSize, 1024u, TextCacheKey::Hash> size_cache;
 static Cache<TextCacheKey, RenderedText, 256u, TextCacheKey::Hash> text_cache;
 
+static TextCache::Statistics statistics;
+
 PixelSize
 TextCache::GetSize(const Font &font, const char *text)
 {
@@ -269,8 +271,12 @@ TextCache::Get(const Font &font, const char *text)
 #endif
 
   const RenderedText *cached = text_cache.Get(key);
-  if (cached != nullptr)
+  if (cached != nullptr) {
+    ++statistics.hits;
     return *cached;
+  }
+
+  ++statistics.misses;
 
   /* render the text into a OpenGL texture */
 
@@ -340,3 +346,13 @@ TextCache::Flush()
   size_cache.Clear();
   text_cache.Clear();
 }
+
+TextCache::Statistics
+TextCache::GetStatistics()
+{
+#ifndef ENABLE_OPENGL
+  const ScopeLock protect(text_cache_mutex);
+#endif
+
+  return statistics;
+}
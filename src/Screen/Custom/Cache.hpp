@@ -47,6 +47,19 @@ namespace TextCache {
   };
 #endif
 
+  struct Statistics {
+    /**
+     * Number of Get() calls which found a rendered string in the
+     * cache.
+     */
+    unsigned long hits;
+
+    /**
+     * Number of Get() calls which had to compose a new string.
+     */
+    unsigned long misses;
+  };
+
   gcc_pure
   PixelSize GetSize(const Font &font, const char *text);
 
@@ -57,6 +70,9 @@ namespace TextCache {
   Result Get(const Font &font, const char *text);
 
   void Flush();
+
+  gcc_pure
+  Statistics GetStatistics();
 };
 
 #endif
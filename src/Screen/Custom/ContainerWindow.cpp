@@ -258,11 +258,18 @@ ContainerWindow::EventChildAt(PixelPoint p)
 
 void
 ContainerWindow::InvalidateChild(const Window &child)
+{
+  InvalidateChildArea(child, child.GetPosition());
+}
+
+void
+ContainerWindow::InvalidateChildArea(const Window &child,
+                                     const PixelRect &rc)
 {
   AssertThread();
 
   if (!children.IsCovered(child))
-    Invalidate();
+    InvalidateArea(rc);
 }
 
 void
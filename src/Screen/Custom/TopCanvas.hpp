@@ -68,12 +68,34 @@ struct _XDisplay;
 #include "../Memory/Dither.hpp"
 #endif
 
+#ifdef USE_FB
+#include "../Memory/DamageRegion.hpp"
+#include "Thread/Mutex.hpp"
+#endif
+
 #include <stdint.h>
 
 #ifdef SOFTWARE_ROTATE_DISPLAY
 enum class DisplayOrientation : uint8_t;
 #endif
 
+#ifdef USE_FB
+struct FlipStatistics {
+  /**
+   * The number of rectangles and pixels copied to the frame buffer
+   * by the last TopCanvas::Flip().
+   */
+  unsigned n_rects;
+  unsigned long n_pixels;
+
+  /**
+   * Totals since the TopCanvas was created.
+   */
+  unsigned long n_frames;
+  unsigned long long total_pixels;
+};
+#endif
+
 struct SDL_Surface;
 struct SDL_Window;
 struct SDL_Renderer;
@@ -172,6 +194,19 @@ class TopCanvas
   unsigned map_pitch, map_bpp;
 
   uint32_t epd_update_marker;
+
+  /**
+   * The parts of #buffer which have changed since the last Flip().
+   */
+  DamageRegion damage;
+
+  /**
+   * Protects #flip_statistics, which is read by other threads (e.g.
+   * for the render profile overlay drawn by the DrawThread).
+   */
+  mutable Mutex flip_statistics_mutex;
+
+  FlipStatistics flip_statistics;
 #endif
 
 #ifdef KOBO
@@ -195,7 +230,8 @@ public:
 #ifdef USE_TTY
     tty_fd(-1),
 #endif
-    fd(-1), map(nullptr)
+    fd(-1), map(nullptr),
+    flip_statistics({0, 0, 0, 0})
 #ifdef KOBO
     , enable_dither(true)
 #endif
@@ -296,6 +332,31 @@ public:
 
   void Flip();
 
+#ifdef USE_FB
+  /**
+   * Mark a rectangle of the buffer as changed, to be copied to the
+   * frame buffer by the next Flip().
+   */
+  void Invalidate(PixelRect rc);
+
+  /**
+   * Mark the whole buffer as changed.
+   */
+  void InvalidateAll() {
+    Invalidate(GetRect());
+  }
+
+  /**
+   * Obtain a snapshot of the Flip() statistics.  This method is
+   * thread-safe.
+   */
+  gcc_pure
+  FlipStatistics GetFlipStatistics() const {
+    const ScopeLock protect(flip_statistics_mutex);
+    return flip_statistics;
+  }
+#endif
+
 #ifdef KOBO
   /**
    * Wait until the screen update is complete.
@@ -316,6 +377,10 @@ private:
   void SetupViewport(PixelSize native_size);
 #endif
 
+#ifdef USE_FB
+  void CopyToFrameBuffer(PixelRect rc);
+#endif
+
 #ifdef USE_GLX
   void InitGLX(_XDisplay *x_display);
   void CreateGLX(_XDisplay *x_display,
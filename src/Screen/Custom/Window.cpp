@@ -186,6 +186,24 @@ Window::Invalidate()
     parent->InvalidateChild(*this);
 }
 
+void
+Window::InvalidateArea(const PixelRect &rc)
+{
+  AssertThread();
+  assert(IsDefined());
+
+  if (parent == nullptr) {
+    Invalidate();
+    return;
+  }
+
+  if (visible) {
+    PixelRect parent_rc = rc;
+    parent_rc.Offset(position.x, position.y);
+    parent->InvalidateChildArea(*this, parent_rc);
+  }
+}
+
 void
 Window::Show()
 {
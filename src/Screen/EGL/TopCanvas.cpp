@@ -317,6 +317,8 @@ TopCanvas::Flip()
     exit(EXIT_FAILURE);
   }
 
+  OpenGL::FinishFrameStatistics();
+
 #ifdef MESA_KMS
   gbm_bo *new_bo = gbm_surface_lock_front_buffer(native_window);
 
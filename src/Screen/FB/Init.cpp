@@ -26,6 +26,7 @@ Copyright_License {
 #include "Event/Queue.hpp"
 #include "Screen/Debug.hpp"
 #include "Screen/Font.hpp"
+#include "Screen/Canvas.hpp"
 #include "DisplayOrientation.hpp"
 #include "Asset.hpp"
 
@@ -52,6 +53,7 @@ ScreenGlobalInit::~ScreenGlobalInit()
   delete event_queue;
   event_queue = nullptr;
 
+  Canvas::Deinitialise();
   Font::Deinitialise();
 
   ScreenDeinitialized();
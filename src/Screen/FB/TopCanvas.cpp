@@ -269,6 +269,11 @@ TopCanvas::CheckResize(const PixelSize new_native_size)
 
   buffer.Free();
   buffer.Allocate(new_size.cx, new_size.cy);
+
+#ifdef USE_FB
+  damage.Clear();
+#endif
+
   return true;
 }
 
@@ -283,10 +288,37 @@ TopCanvas::Unlock()
 {
 }
 
+#ifdef USE_FB
+
 void
-TopCanvas::Flip()
+TopCanvas::Invalidate(PixelRect rc)
 {
-#ifdef USE_FB
+  /* clip to the screen */
+  rc.left = std::max(rc.left, 0);
+  rc.top = std::max(rc.top, 0);
+  rc.right = std::min(rc.right, int(buffer.width));
+  rc.bottom = std::min(rc.bottom, int(buffer.height));
+
+  damage.Add(rc);
+}
+
+/**
+ * Copy one rectangle of the buffer to the frame buffer.
+ */
+inline void
+TopCanvas::CopyToFrameBuffer(PixelRect rc)
+{
+#if defined(GREYSCALE) && defined(DITHER) && !defined(KOBO)
+  if (map_bpp == 4) {
+    /* CopyFromGreyscale() expands the dithered pixels in place,
+       which works only with whole rows */
+    rc.left = 0;
+    rc.right = buffer.width;
+  }
+#endif
+
+  const auto src = buffer.At(rc.left, rc.top);
+  void *dest = (uint8_t *)map + rc.top * map_pitch + rc.left * map_bpp;
 
 #ifdef GREYSCALE
   CopyFromGreyscale(
@@ -296,22 +328,20 @@ TopCanvas::Flip()
 #ifdef KOBO
                     enable_dither,
 #endif
-                    map, map_pitch, map_bpp,
-                    buffer);
+                    dest, map_pitch, map_bpp,
+                    {src, buffer.pitch, rc.GetWidth(), rc.GetHeight()});
 #else
-  CopyFromBGRA(map, map_pitch, map_bpp, buffer);
+  CopyFromBGRA(dest, map_pitch, map_bpp,
+               {src, buffer.pitch, rc.GetWidth(), rc.GetHeight()});
 #endif
 
-
 #ifdef KOBO
-  if (frame_sync)
-    Wait();
-
   epd_update_marker++;
 
   struct mxcfb_update_data epd_update_data = {
     {
-      0, 0, buffer.width, buffer.height
+      uint32_t(rc.top), uint32_t(rc.left),
+      rc.GetWidth(), rc.GetHeight()
     },
 
     uint32_t(enable_dither &&
@@ -328,7 +358,39 @@ TopCanvas::Flip()
 
   ioctl(fd, MXCFB_SEND_UPDATE, &epd_update_data);
 #endif
+}
+
+#endif
+
+void
+TopCanvas::Flip()
+{
+#ifdef USE_FB
+  if (damage.IsEmpty())
+    /* nothing was reported; the caller may have drawn directly on
+       the Canvas returned by Lock(), so copy everything */
+    InvalidateAll();
+
+#ifdef KOBO
+  if (frame_sync)
+    Wait();
+#endif
+
+  unsigned long n_pixels = 0;
+  for (const PixelRect &rc : damage) {
+    CopyToFrameBuffer(rc);
+    n_pixels += (unsigned long)rc.GetWidth() * rc.GetHeight();
+  }
+
+  {
+    const ScopeLock protect(flip_statistics_mutex);
+    flip_statistics.n_rects = damage.size();
+    flip_statistics.n_pixels = n_pixels;
+    ++flip_statistics.n_frames;
+    flip_statistics.total_pixels += n_pixels;
+  }
 
+  damage.Clear();
 #endif /* USE_FB */
 }
 
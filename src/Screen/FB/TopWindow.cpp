@@ -46,14 +46,40 @@ TopWindow::CheckResize()
     Resize(screen->GetSize());
 }
 
+FlipStatistics
+TopWindow::GetFlipStatistics() const
+{
+  assert(screen != nullptr);
+
+  return screen->GetFlipStatistics();
+}
+
 #endif
 
 void
 TopWindow::Invalidate()
 {
   invalidated = true;
+
+#ifdef USE_FB
+  if (screen != nullptr)
+    screen->InvalidateAll();
+#endif
+}
+
+#ifdef USE_FB
+
+void
+TopWindow::InvalidateArea(const PixelRect &rc)
+{
+  invalidated = true;
+
+  if (screen != nullptr)
+    screen->Invalidate(rc);
 }
 
+#endif
+
 #ifdef KOBO
 void
 TopWindow::OnDestroy()
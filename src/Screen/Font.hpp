@@ -28,6 +28,8 @@ Copyright_License {
 #include "Compiler.h"
 
 #ifdef USE_FREETYPE
+#include "Screen/FreeType/GlyphAtlas.hpp"
+
 typedef struct FT_FaceRec_ *FT_Face;
 #endif
 
@@ -75,6 +77,12 @@ public:
    */
   static void Initialise();
   static void Deinitialise();
+
+  /**
+   * Obtain a snapshot of the glyph cache statistics.
+   */
+  gcc_pure
+  static GlyphAtlas::Statistics GetGlyphStatistics();
 #endif
 
 public:
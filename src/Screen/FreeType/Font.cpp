@@ -26,8 +26,10 @@ Copyright_License {
 #include "Screen/Custom/Files.hpp"
 #include "Look/FontDescription.hpp"
 #include "Init.hpp"
+#include "GlyphAtlas.hpp"
 #include "Asset.hpp"
 #include "OS/Path.hpp"
+#include "OS/Clock.hpp"
 
 #ifndef ENABLE_OPENGL
 #include "Thread/Mutex.hpp"
@@ -59,6 +61,19 @@ Copyright_License {
 static Mutex freetype_mutex;
 #endif
 
+/**
+ * All glyphs rendered so far.  Protected by #freetype_mutex.
+ */
+static GlyphAtlas glyph_atlas;
+
+#ifdef KOBO
+/**
+ * The value of FreeType::mono when the glyphs in #glyph_atlas were
+ * rendered.
+ */
+static bool glyph_atlas_mono;
+#endif
+
 static FT_Int32 load_flags = FT_LOAD_DEFAULT;
 static FT_Render_Mode render_mode = FT_RENDER_MODE_NORMAL;
 
@@ -125,6 +140,7 @@ Font::Initialise()
 void
 Font::Deinitialise()
 {
+  glyph_atlas.Clear();
   FreeType::Deinitialise();
 }
 
@@ -221,6 +237,13 @@ Font::Destroy()
 
   assert(IsScreenInitialized());
 
+  {
+#ifndef ENABLE_OPENGL
+    const ScopeLock protect(freetype_mutex);
+#endif
+    glyph_atlas.Remove(face);
+  }
+
   ::FT_Done_Face(face);
   face = nullptr;
 }
@@ -244,6 +267,100 @@ ForEachChar(const TCHAR *text, F &&f)
     }
 }
 
+static void
+ConvertMono(unsigned char *dest, const unsigned char *src, unsigned n)
+{
+  for (; n >= 8; n -= 8, ++src) {
+    for (unsigned i = 0x80; i != 0; i >>= 1)
+      *dest++ = (*src & i) ? 0xff : 0x00;
+  }
+
+  for (unsigned i = 0x80; n > 0; i >>= 1, --n)
+    *dest++ = (*src & i) ? 0xff : 0x00;
+}
+
+static void
+ConvertMono(FT_Bitmap &dest, const FT_Bitmap &src)
+{
+  dest = src;
+  dest.pitch = dest.width;
+  dest.buffer = new unsigned char[dest.pitch * dest.rows];
+
+  unsigned char *d = dest.buffer, *s = src.buffer;
+  for (unsigned y = 0; y < unsigned(dest.rows);
+       ++y, d += dest.pitch, s += src.pitch)
+    ConvertMono(d, s, dest.width);
+}
+
+/**
+ * Rasterise a glyph and add it to #glyph_atlas.  The caller must
+ * hold #freetype_mutex.
+ */
+static const GlyphAtlas::Glyph &
+RasteriseGlyph(const FT_Face face, unsigned ch)
+{
+  const uint64_t start = MonotonicClockUS();
+
+  GlyphAtlas::Glyph glyph;
+  glyph.index = 0;
+  glyph.bearing_x = glyph.bearing_y = 0;
+  glyph.width = glyph.advance = 0;
+  glyph.bitmap_width = glyph.bitmap_height = 0;
+
+  const FT_UInt i = FT_Get_Char_Index(face, ch);
+  if (i == 0 || FT_Load_Glyph(face, i, load_flags) != 0)
+    /* remember that this glyph is missing */
+    return *glyph_atlas.Add(face, ch, glyph, nullptr, 0,
+                            MonotonicClockUS() - start);
+
+  const FT_GlyphSlot slot = face->glyph;
+  const FT_Glyph_Metrics &metrics = slot->metrics;
+
+  glyph.index = i;
+  glyph.bearing_x = FT_FLOOR(metrics.horiBearingX);
+  glyph.bearing_y = FT_FLOOR(metrics.horiBearingY);
+  glyph.width = FT_CEIL(metrics.width);
+  glyph.advance = FT_CEIL(metrics.horiAdvance);
+
+  if (FT_Render_Glyph(slot, render_mode) != 0)
+    return *glyph_atlas.Add(face, ch, glyph, nullptr, 0,
+                            MonotonicClockUS() - start);
+
+  if (IsMono()) {
+    /* with anti-aliasing disabled, FreeType writes each pixel in one
+       bit; hack: convert it to 1 byte per pixel */
+    FT_Bitmap bitmap;
+    ConvertMono(bitmap, slot->bitmap);
+    glyph.bitmap_width = bitmap.width;
+    glyph.bitmap_height = bitmap.rows;
+    const auto &result = *glyph_atlas.Add(face, ch, glyph,
+                                          bitmap.buffer, bitmap.pitch,
+                                          MonotonicClockUS() - start);
+    delete[] bitmap.buffer;
+    return result;
+  } else {
+    const FT_Bitmap &bitmap = slot->bitmap;
+    glyph.bitmap_width = bitmap.width;
+    glyph.bitmap_height = bitmap.rows;
+    return *glyph_atlas.Add(face, ch, glyph, bitmap.buffer, bitmap.pitch,
+                            MonotonicClockUS() - start);
+  }
+}
+
+/**
+ * Look up a glyph in #glyph_atlas, rasterising it on the first use.
+ * The caller must hold #freetype_mutex.
+ */
+static const GlyphAtlas::Glyph &
+GetGlyph(const FT_Face face, unsigned ch)
+{
+  const GlyphAtlas::Glyph *glyph = glyph_atlas.Lookup(face, ch);
+  if (glyph != nullptr)
+    return *glyph;
+
+  return RasteriseGlyph(face, ch);
+}
+
 template<typename T, typename F>
 static void
 ForEachGlyph(const FT_Face face, unsigned ascent_height, T &&text,
@@ -258,20 +375,23 @@ ForEachGlyph(const FT_Face face, unsigned ascent_height, T &&text,
   const ScopeLock protect(freetype_mutex);
 #endif
 
+#ifdef KOBO
+  if (glyph_atlas_mono != IsMono()) {
+    /* the rendering mode has been switched at runtime; all cached
+       bitmaps are obsolete */
+    glyph_atlas.Clear();
+    glyph_atlas_mono = IsMono();
+  }
+#endif
+
   ForEachChar(std::forward<T>(text),
               [face, ascent_height, &f, use_kerning,
                &x, &prev_index](unsigned ch){
-      const FT_UInt i = FT_Get_Char_Index(face, ch);
+      const GlyphAtlas::Glyph &glyph = GetGlyph(face, ch);
+      const unsigned i = glyph.index;
       if (i == 0)
         return;
 
-      const FT_Error error = FT_Load_Glyph(face, i, load_flags);
-      if (error)
-        return;
-
-      const FT_GlyphSlot glyph = face->glyph;
-      const FT_Glyph_Metrics &metrics = glyph->metrics;
-
       if (use_kerning) {
         if (prev_index != 0 && i != 0) {
           FT_Vector delta;
@@ -283,11 +403,9 @@ ForEachGlyph(const FT_Face face, unsigned ascent_height, T &&text,
         prev_index = i;
       }
 
-      f(x + FT_FLOOR(metrics.horiBearingX),
-        ascent_height - FT_FLOOR(metrics.horiBearingY),
-        glyph);
+      f(x + glyph.bearing_x, ascent_height - glyph.bearing_y, glyph);
 
-      x += FT_CEIL(metrics.horiAdvance);
+      x += glyph.advance;
     });
 }
 
@@ -297,10 +415,9 @@ Font::TextSize(const TCHAR *text) const
   int maxx = 0;
 
   ForEachGlyph(face, ascent_height, text,
-               [&maxx](int x, int y, const FT_GlyphSlot glyph){
-      const FT_Glyph_Metrics &metrics = glyph->metrics;
-      const int glyph_minx = FT_FLOOR(metrics.horiBearingX);
-      const int glyph_maxx = glyph_minx + FT_CEIL(metrics.width);
+               [&maxx](int x, int y, const GlyphAtlas::Glyph &glyph){
+      const int glyph_minx = glyph.bearing_x;
+      const int glyph_maxx = glyph_minx + glyph.width;
 
       int z = x + glyph_maxx;
       if (z > maxx)
@@ -320,11 +437,14 @@ MixLine(uint8_t *dest, const uint8_t *src, size_t n)
 
 static void
 RenderGlyph(uint8_t *buffer, unsigned buffer_width, unsigned buffer_height,
-            const FT_Bitmap &bitmap, int x, int y)
+            const GlyphAtlas::Glyph &glyph, int x, int y)
 {
-  const uint8_t *src = (const uint8_t *)bitmap.buffer;
-  int width = bitmap.width, height = bitmap.rows;
-  int pitch = bitmap.pitch;
+  const uint8_t *src = glyph.pixels;
+  if (src == nullptr)
+    return;
+
+  int width = glyph.bitmap_width, height = glyph.bitmap_height;
+  int pitch = glyph.pitch;
 
   if (x < 0) {
     src -= x;
@@ -356,50 +476,6 @@ RenderGlyph(uint8_t *buffer, unsigned buffer_width, unsigned buffer_height,
     MixLine(buffer, src, width);
 }
 
-static void
-ConvertMono(unsigned char *dest, const unsigned char *src, unsigned n)
-{
-  for (; n >= 8; n -= 8, ++src) {
-    for (unsigned i = 0x80; i != 0; i >>= 1)
-      *dest++ = (*src & i) ? 0xff : 0x00;
-  }
-
-  for (unsigned i = 0x80; n > 0; i >>= 1, --n)
-    *dest++ = (*src & i) ? 0xff : 0x00;
-}
-
-static void
-ConvertMono(FT_Bitmap &dest, const FT_Bitmap &src)
-{
-  dest = src;
-  dest.pitch = dest.width;
-  dest.buffer = new unsigned char[dest.pitch * dest.rows];
-
-  unsigned char *d = dest.buffer, *s = src.buffer;
-  for (unsigned y = 0; y < unsigned(dest.rows);
-       ++y, d += dest.pitch, s += src.pitch)
-    ConvertMono(d, s, dest.width);
-}
-
-static void
-RenderGlyph(uint8_t *buffer, size_t width, size_t height,
-            FT_GlyphSlot glyph, int x, int y)
-{
-  FT_Error error = FT_Render_Glyph(glyph, render_mode);
-  if (error)
-    return;
-
-  if (IsMono()) {
-    /* with anti-aliasing disabled, FreeType writes each pixel in one
-       bit; hack: convert it to 1 byte per pixel and then render it */
-    FT_Bitmap bitmap;
-    ConvertMono(bitmap, glyph->bitmap);
-    RenderGlyph(buffer, width, height, bitmap, x, y);
-    delete[] bitmap.buffer;
-  } else
-    RenderGlyph(buffer, width, height, glyph->bitmap, x, y);
-}
-
 void
 Font::Render(const TCHAR *text, const PixelSize size, void *_buffer) const
 {
@@ -407,8 +483,18 @@ Font::Render(const TCHAR *text, const PixelSize size, void *_buffer) const
   std::fill_n(buffer, BufferSize(size), 0);
 
   ForEachGlyph(face, ascent_height, text,
-               [size, buffer](int x, int y, const FT_GlyphSlot glyph){
+               [size, buffer](int x, int y, const GlyphAtlas::Glyph &glyph){
       RenderGlyph(buffer, size.cx, size.cy, glyph,
                   x, y);
     });
 }
+
+GlyphAtlas::Statistics
+Font::GetGlyphStatistics()
+{
+#ifndef ENABLE_OPENGL
+  const ScopeLock protect(freetype_mutex);
+#endif
+
+  return glyph_atlas.GetStatistics();
+}
@@ -0,0 +1,141 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "GlyphAtlas.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+#include <string.h>
+
+GlyphAtlas::GlyphAtlas()
+  :shelf_y(0), shelf_height(0), cursor_x(PAGE_WIDTH)
+{
+  statistics = Statistics();
+}
+
+const GlyphAtlas::Glyph *
+GlyphAtlas::Lookup(const void *font, unsigned ch)
+{
+  auto i = map.find(Key{font, ch});
+  if (i == map.end())
+    return nullptr;
+
+  ++statistics.hits;
+  return &i->second;
+}
+
+uint8_t *
+GlyphAtlas::Allocate(unsigned width, unsigned height)
+{
+  assert(width <= PAGE_WIDTH);
+  assert(height <= PAGE_HEIGHT);
+
+  if (cursor_x + width > PAGE_WIDTH) {
+    /* start a new shelf */
+    shelf_y += shelf_height;
+    shelf_height = 0;
+    cursor_x = 0;
+  }
+
+  if (pages.empty() || shelf_y + height > PAGE_HEIGHT) {
+    /* start a new page */
+    if (pages.size() >= MAX_PAGES)
+      return nullptr;
+
+    pages.emplace_back(new uint8_t[PAGE_WIDTH * PAGE_HEIGHT]);
+    shelf_y = 0;
+    shelf_height = 0;
+    cursor_x = 0;
+  }
+
+  uint8_t *p = pages.back().get() + shelf_y * PAGE_WIDTH + cursor_x;
+  cursor_x += width;
+  shelf_height = std::max(shelf_height, height);
+  return p;
+}
+
+const GlyphAtlas::Glyph *
+GlyphAtlas::Add(const void *font, unsigned ch, const Glyph &glyph,
+                const uint8_t *src, unsigned src_pitch,
+                unsigned rasterisation_us)
+{
+  ++statistics.misses;
+  statistics.rasterisation_us += rasterisation_us;
+
+  const unsigned width = glyph.bitmap_width, height = glyph.bitmap_height;
+
+  uint8_t *dest = nullptr;
+  unsigned dest_pitch = 0;
+
+  if (width > 0 && height > 0) {
+    if (width > PAGE_WIDTH || height > PAGE_HEIGHT) {
+      oversized.emplace_front(new uint8_t[width * height]);
+      dest = oversized.front().get();
+      dest_pitch = width;
+    } else {
+      dest = Allocate(width, height);
+      if (dest == nullptr) {
+        /* the atlas is full: start over */
+        Clear();
+        ++statistics.flushes;
+
+        dest = Allocate(width, height);
+        assert(dest != nullptr);
+      }
+
+      dest_pitch = PAGE_WIDTH;
+    }
+
+    uint8_t *d = dest;
+    for (unsigned y = 0; y < height; ++y, d += dest_pitch, src += src_pitch)
+      memcpy(d, src, width);
+  }
+
+  Glyph &g = map[Key{font, ch}];
+  g = glyph;
+  g.pixels = dest;
+  g.pitch = dest_pitch;
+  return &g;
+}
+
+void
+GlyphAtlas::Remove(const void *font)
+{
+  for (auto i = map.begin(); i != map.end();) {
+    if (i->first.font == font)
+      i = map.erase(i);
+    else
+      ++i;
+  }
+}
+
+void
+GlyphAtlas::Clear()
+{
+  map.clear();
+  pages.clear();
+  oversized.clear();
+  shelf_y = 0;
+  shelf_height = 0;
+  cursor_x = PAGE_WIDTH;
+}
@@ -0,0 +1,215 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_SCREEN_FREETYPE_GLYPH_ATLAS_HPP
+#define XCSOAR_SCREEN_FREETYPE_GLYPH_ATLAS_HPP
+
+#include "Compiler.h"
+
+#include <unordered_map>
+#include <forward_list>
+#include <vector>
+#include <memory>
+
+#include <stdint.h>
+
+/**
+ * A cache of rasterised glyphs.  Each glyph of a font (i.e. of a
+ * face loaded at a certain pixel size) is rendered only once; its
+ * 8 bit alpha bitmap is copied into a shared atlas, and strings are
+ * composed from these bitmaps later.
+ *
+ * The bitmaps are packed into fixed-size pages with a simple shelf
+ * allocator.  When all pages are full, the whole atlas is flushed;
+ * the working set of an XCSoar screen is small enough that this is
+ * rare.
+ *
+ * This class is not thread-safe.
+ */
+class GlyphAtlas {
+public:
+  static constexpr unsigned PAGE_WIDTH = 256, PAGE_HEIGHT = 256;
+  static constexpr unsigned MAX_PAGES = 16;
+
+  struct Glyph {
+    /**
+     * The glyph index within the font.  Zero means the font does
+     * not have a glyph for this character; such "negative" entries
+     * are cached, too.
+     */
+    unsigned index;
+
+    /**
+     * The floor of the horizontal and vertical bearing [pixels].
+     */
+    int bearing_x, bearing_y;
+
+    /**
+     * The rounded-up glyph width and advance [pixels].
+     */
+    int width, advance;
+
+    /**
+     * The size of the bitmap [pixels].
+     */
+    unsigned bitmap_width, bitmap_height;
+
+    /**
+     * Pointer to the first row of the bitmap; nullptr if the bitmap
+     * is empty.
+     */
+    const uint8_t *pixels;
+
+    /**
+     * The distance between two rows of #pixels [bytes].
+     */
+    unsigned pitch;
+  };
+
+  struct Statistics {
+    /**
+     * Number of lookups which found the glyph in the atlas.
+     */
+    unsigned long hits;
+
+    /**
+     * Number of glyphs which had to be rasterised.
+     */
+    unsigned long misses;
+
+    /**
+     * Number of times the atlas was flushed because it was full.
+     */
+    unsigned long flushes;
+
+    /**
+     * Accumulated time spent rasterising glyphs [microseconds].
+     */
+    uint64_t rasterisation_us;
+
+    /**
+     * Number of glyphs currently in the atlas.
+     */
+    unsigned glyphs;
+
+    /**
+     * Number of allocated pages.
+     */
+    unsigned pages;
+  };
+
+private:
+  struct Key {
+    const void *font;
+    unsigned ch;
+
+    bool operator==(const Key &other) const {
+      return font == other.font && ch == other.ch;
+    }
+
+    struct Hash {
+      gcc_pure
+      size_t operator()(const Key &key) const {
+        return (size_t)key.font ^ (size_t(key.ch) * 31u);
+      }
+    };
+  };
+
+  typedef std::unordered_map<Key, Glyph, Key::Hash> Map;
+  Map map;
+
+  std::vector<std::unique_ptr<uint8_t[]>> pages;
+
+  /**
+   * Bitmaps which do not fit into a page are allocated separately.
+   */
+  std::forward_list<std::unique_ptr<uint8_t[]>> oversized;
+
+  /**
+   * The allocation cursor within the last page: the top of the
+   * current shelf, its height and the left edge of the free space
+   * on that shelf.
+   */
+  unsigned shelf_y, shelf_height, cursor_x;
+
+  Statistics statistics;
+
+public:
+  GlyphAtlas();
+
+  GlyphAtlas(const GlyphAtlas &) = delete;
+  GlyphAtlas &operator=(const GlyphAtlas &) = delete;
+
+  /**
+   * Look up a glyph.  Returns nullptr if it has not been added yet.
+   * The returned pointer is valid until the next Add(), Remove() or
+   * Clear() call.
+   */
+  const Glyph *Lookup(const void *font, unsigned ch);
+
+  /**
+   * Add a glyph to the atlas, copying the bitmap.
+   *
+   * @param glyph the glyph's metrics; the #pixels and #pitch
+   * attributes are ignored
+   * @param src the rasterised 8 bit alpha bitmap of size
+   * bitmap_width * bitmap_height
+   * @param src_pitch the distance between two rows of #src [bytes]
+   * @param rasterisation_us the time it took to rasterise this glyph
+   * @return the new atlas entry
+   */
+  const Glyph *Add(const void *font, unsigned ch, const Glyph &glyph,
+                   const uint8_t *src, unsigned src_pitch,
+                   unsigned rasterisation_us=0);
+
+  /**
+   * Remove all glyphs of the specified font, e.g. because it is
+   * being destroyed.  Its atlas space will be reclaimed by the next
+   * Clear().
+   */
+  void Remove(const void *font);
+
+  /**
+   * Remove all glyphs and free all pages.
+   */
+  void Clear();
+
+  gcc_pure
+  Statistics GetStatistics() const {
+    Statistics result = statistics;
+    result.glyphs = map.size();
+    result.pages = pages.size();
+    return result;
+  }
+
+private:
+  /**
+   * Allocate space for a bitmap in the last page, adding a new page
+   * if necessary.
+   *
+   * @return a pointer to the top left pixel or nullptr if all pages
+   * are full
+   */
+  uint8_t *Allocate(unsigned width, unsigned height);
+};
+
+#endif
@@ -82,4 +82,6 @@ void
 TopCanvas::Flip()
 {
   glXSwapBuffers(x_display, glx_window);
+
+  OpenGL::FinishFrameStatistics();
 }
@@ -114,6 +114,8 @@ MaskedIcon::Draw(Canvas &canvas, PixelPoint p) const
   p -= origin;
 
 #ifdef ENABLE_OPENGL
+  canvas.FlushBatch();
+
 #ifdef USE_GLSL
   OpenGL::texture_shader->Use();
 #else
@@ -148,6 +150,8 @@ MaskedIcon::Draw(Canvas &canvas, const PixelRect &rc, bool inverse) const
   const PixelPoint position = rc.CenteredTopLeft(size);
 
 #ifdef ENABLE_OPENGL
+  canvas.FlushBatch();
+
 #ifdef USE_GLSL
   if (inverse)
     OpenGL::invert_shader->Use();
@@ -0,0 +1,112 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "BandThreadPool.hpp"
+
+#include <assert.h>
+
+BandThreadPool::BandThreadPool(unsigned n_bands)
+{
+  assert(n_bands > 0);
+
+  workers.reserve(n_bands - 1);
+  for (unsigned band = 1; band < n_bands; ++band) {
+    std::unique_ptr<Worker> worker(new Worker(*this, band));
+    if (!worker->Start())
+      break;
+
+    workers.emplace_back(std::move(worker));
+  }
+}
+
+BandThreadPool::~BandThreadPool()
+{
+  mutex.Lock();
+  quit = true;
+  work_cond.broadcast();
+  mutex.Unlock();
+
+  for (auto &worker : workers)
+    worker->Join();
+}
+
+void
+BandThreadPool::Run(const Job &_job)
+{
+  const unsigned n_bands = GetBandCount();
+
+  mutex.Lock();
+  if (busy || n_bands == 1) {
+    mutex.Unlock();
+
+    for (unsigned band = 0; band < n_bands; ++band)
+      _job(band, n_bands);
+    return;
+  }
+
+  busy = true;
+  job = &_job;
+  job_bands = n_bands;
+  pending = workers.size();
+  ++generation;
+  work_cond.broadcast();
+  mutex.Unlock();
+
+  _job(0, n_bands);
+
+  mutex.Lock();
+  while (pending > 0)
+    done_cond.wait(mutex);
+
+  job = nullptr;
+  busy = false;
+  mutex.Unlock();
+}
+
+void
+BandThreadPool::WorkerRun(unsigned band)
+{
+  const ScopeLock protect(mutex);
+
+  /* generation 0 means "no job yet" */
+  unsigned seen = 0;
+  while (true) {
+    while (!quit && generation == seen)
+      work_cond.wait(mutex);
+
+    if (quit)
+      break;
+
+    seen = generation;
+
+    {
+      const Job &f = *job;
+      const unsigned n_bands = job_bands;
+      const ScopeUnlock unlock(mutex);
+      f(band, n_bands);
+    }
+
+    assert(pending > 0);
+    if (--pending == 0)
+      done_cond.signal();
+  }
+}
@@ -0,0 +1,135 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_SCREEN_MEMORY_BAND_THREAD_POOL_HPP
+#define XCSOAR_SCREEN_MEMORY_BAND_THREAD_POOL_HPP
+
+#include "Thread/Thread.hpp"
+#include "Thread/Mutex.hpp"
+#include "Thread/Cond.hxx"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * A set of persistent worker threads which render horizontal bands
+ * of an image buffer in parallel.  Run() invokes a function once for
+ * each band; the calling thread renders band 0 itself.
+ */
+class BandThreadPool {
+public:
+  typedef std::function<void(unsigned band, unsigned n_bands)> Job;
+
+private:
+  class Worker final : public Thread {
+    BandThreadPool &pool;
+    const unsigned band;
+
+  public:
+    Worker(BandThreadPool &_pool, unsigned _band)
+      :Thread("BandRenderer"), pool(_pool), band(_band) {}
+
+  protected:
+    /* virtual methods from class Thread */
+    void Run() override {
+      pool.WorkerRun(band);
+    }
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  /**
+   * Protects all attributes below.
+   */
+  Mutex mutex;
+
+  /**
+   * Signalled when a new job is available or when the pool is being
+   * stopped.
+   */
+  Cond work_cond;
+
+  /**
+   * Signalled by the last worker which has finished its band.
+   */
+  Cond done_cond;
+
+  const Job *job = nullptr;
+
+  /**
+   * The number of bands of the current job.
+   */
+  unsigned job_bands = 0;
+
+  /**
+   * Incremented for each job; workers use it to detect new work.
+   */
+  unsigned generation = 0;
+
+  /**
+   * The number of workers which have not yet finished the current
+   * job.
+   */
+  unsigned pending = 0;
+
+  /**
+   * Is a job currently being executed?  Only one caller may use the
+   * workers at a time.
+   */
+  bool busy = false;
+
+  bool quit = false;
+
+public:
+  /**
+   * Start the worker threads.
+   *
+   * @param n_bands the number of bands, i.e. the number of worker
+   * threads plus one (for the calling thread)
+   */
+  explicit BandThreadPool(unsigned n_bands);
+
+  /**
+   * Stop and join all worker threads.
+   */
+  ~BandThreadPool();
+
+  BandThreadPool(const BandThreadPool &) = delete;
+  BandThreadPool &operator=(const BandThreadPool &) = delete;
+
+  unsigned GetBandCount() const {
+    return workers.size() + 1;
+  }
+
+  /**
+   * Invoke the job for each band and wait for all of them to finish.
+   * If another thread is currently using the pool, all bands are
+   * processed by the calling thread instead.
+   */
+  void Run(const Job &job);
+
+private:
+  void WorkerRun(unsigned band);
+};
+
+#endif
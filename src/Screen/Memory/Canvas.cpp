@@ -26,8 +26,12 @@ Copyright_License {
 #include "Screen/Util.hpp"
 #include "Optimised.hpp"
 #include "RasterCanvas.hpp"
+#include "PolygonFillQueue.hpp"
+#include "BandThreadPool.hpp"
 #include "Screen/Custom/Cache.hpp"
 #include "Math/Angle.hpp"
+#include "OS/SystemLoad.hpp"
+#include "Thread/Mutex.hpp"
 
 #ifdef __ARM_NEON__
 #include "NEON.hpp"
@@ -59,10 +63,76 @@ public:
   }
 };
 
+/**
+ * The worker threads used by Canvas::DrawBatch().  Created on demand.
+ */
+static BandThreadPool *band_thread_pool;
+static Mutex band_thread_pool_mutex;
+
+/**
+ * The maximum number of bands (and threads) for batched polygon
+ * fills.
+ */
+static constexpr unsigned MAX_BANDS = 8;
+
+static BandThreadPool *
+GetBandThreadPool()
+{
+  const ScopeLock protect(band_thread_pool_mutex);
+
+  if (band_thread_pool == nullptr) {
+    const unsigned n_bands = std::min(SystemCPUCount(), MAX_BANDS);
+    if (n_bands < 2)
+      return nullptr;
+
+    band_thread_pool = new BandThreadPool(n_bands);
+  }
+
+  return band_thread_pool;
+}
+
+void
+Canvas::Deinitialise()
+{
+  const ScopeLock protect(band_thread_pool_mutex);
+
+  delete band_thread_pool;
+  band_thread_pool = nullptr;
+}
+
+void
+Canvas::BeginBatch()
+{
+  assert(batch == nullptr);
+
+  batch = new PolygonFillQueue<ActivePixelTraits>();
+}
+
+void
+Canvas::DrawBatch() const
+{
+  assert(batch != nullptr);
+
+  if (!batch->IsEmpty())
+    batch->Draw(buffer, GetBandThreadPool());
+}
+
+void
+Canvas::EndBatch()
+{
+  assert(batch != nullptr);
+
+  DrawBatch();
+  delete batch;
+  batch = nullptr;
+}
+
 void
 Canvas::DrawOutlineRectangle(int left, int top, int right, int bottom,
                              Color color)
 {
+  FlushBatch();
+
   SDLRasterCanvas canvas(buffer);
   canvas.DrawRectangle(left, top, right, bottom,
                        canvas.Import(color));
@@ -72,6 +142,8 @@ void
 Canvas::DrawFilledRectangle(int left, int top, int right, int bottom,
                             Color color)
 {
+  FlushBatch();
+
   if (left >= right || top >= bottom)
     return;
 
@@ -83,6 +155,8 @@ Canvas::DrawFilledRectangle(int left, int top, int right, int bottom,
 void
 Canvas::InvertRectangle(PixelRect r)
 {
+  FlushBatch();
+
   if (r.IsEmpty())
     return;
 
@@ -106,6 +180,8 @@ DrawPolyline(Canvas &canvas, PixelOperations operations, const Pen &pen,
 void
 Canvas::DrawPolyline(const BulkPixelPoint *p, unsigned cPoints)
 {
+  FlushBatch();
+
   SDLRasterCanvas canvas(buffer);
   ::DrawPolyline(canvas, ActivePixelTraits(), pen,
                  p, cPoints, false);
@@ -117,6 +193,18 @@ Canvas::DrawPolygon(const BulkPixelPoint *lppt, unsigned cPoints)
   if (brush.IsHollow() && !pen.IsDefined())
     return;
 
+  if (batch != nullptr) {
+    if (!IsPenOverBrush()) {
+      const Color color = brush.GetColor();
+      batch->Add(lppt, cPoints, SDLRasterCanvas::Import(color),
+                 color.IsOpaque() ? 0xff : color.Alpha());
+      return;
+    }
+
+    /* the outline is not batched */
+    DrawBatch();
+  }
+
   SDLRasterCanvas canvas(buffer);
 
   if (!brush.IsHollow()) {
@@ -136,6 +224,8 @@ Canvas::DrawPolygon(const BulkPixelPoint *lppt, unsigned cPoints)
 void
 Canvas::DrawHLine(int x1, int x2, int y, Color color)
 {
+  FlushBatch();
+
   SDLRasterCanvas canvas(buffer);
   canvas.DrawHLine(x1, x2, y, canvas.Import(color));
 }
@@ -143,6 +233,8 @@ Canvas::DrawHLine(int x1, int x2, int y, Color color)
 void
 Canvas::DrawLine(int ax, int ay, int bx, int by)
 {
+  FlushBatch();
+
   const unsigned thickness = pen.GetWidth();
   const unsigned mask = pen.GetMask();
 
@@ -159,6 +251,8 @@ Canvas::DrawLine(int ax, int ay, int bx, int by)
 void
 Canvas::DrawCircle(int x, int y, unsigned radius)
 {
+  FlushBatch();
+
   SDLRasterCanvas canvas(buffer);
 
   if (!brush.IsHollow()) {
@@ -188,6 +282,8 @@ void
 Canvas::DrawSegment(PixelPoint center, unsigned radius,
                     Angle start, Angle end, bool horizon)
 {
+  FlushBatch();
+
   ::Segment(*this, center, radius, start, end, horizon);
 }
 
@@ -196,6 +292,8 @@ Canvas::DrawAnnulus(PixelPoint center,
                     unsigned small_radius, unsigned big_radius,
                     Angle start, Angle end)
 {
+  FlushBatch();
+
   assert(IsDefined());
 
   ::Annulus(*this, center, big_radius, start, end, small_radius);
@@ -206,6 +304,8 @@ Canvas::DrawKeyhole(PixelPoint center,
                     unsigned small_radius, unsigned big_radius,
                     Angle start, Angle end)
 {
+  FlushBatch();
+
   assert(IsDefined());
 
   ::KeyHole(*this, center, big_radius, start, end, small_radius);
@@ -215,6 +315,8 @@ void
 Canvas::DrawArc(PixelPoint center, unsigned radius,
                 Angle start, Angle end)
 {
+  FlushBatch();
+
   assert(IsDefined());
 
   ::Arc(*this, center, radius, start, end);
@@ -294,6 +396,8 @@ CopyTextRectangle(SDLRasterCanvas &canvas, int x, int y,
 void
 Canvas::DrawText(int x, int y, const TCHAR *text)
 {
+  FlushBatch();
+
   assert(text != nullptr);
 #ifndef UNICODE
   assert(ValidateUTF8(text));
@@ -312,6 +416,8 @@ Canvas::DrawText(int x, int y, const TCHAR *text)
 void
 Canvas::DrawTransparentText(int x, int y, const TCHAR *text)
 {
+  FlushBatch();
+
   assert(text != nullptr);
 #ifndef UNICODE
   assert(ValidateUTF8(text));
@@ -330,6 +436,8 @@ Canvas::DrawTransparentText(int x, int y, const TCHAR *text)
 void
 Canvas::DrawClippedText(int x, int y, const PixelRect &rc, const TCHAR *text)
 {
+  FlushBatch();
+
   // TODO: implement full clipping
   if (rc.right > x)
     DrawClippedText(x, y, rc.right - x, text);
@@ -338,6 +446,8 @@ Canvas::DrawClippedText(int x, int y, const PixelRect &rc, const TCHAR *text)
 void
 Canvas::DrawClippedText(int x, int y, unsigned width, const TCHAR *text)
 {
+  FlushBatch();
+
   assert(text != nullptr);
 #ifndef UNICODE
   assert(ValidateUTF8(text));
@@ -384,6 +494,8 @@ Canvas::Copy(int dest_x, int dest_y,
              unsigned dest_width, unsigned dest_height,
              ConstImageBuffer src, int src_x, int src_y)
 {
+  FlushBatch();
+
   if (!Clip(dest_x, dest_width, GetWidth(), src_x) ||
       !Clip(dest_y, dest_height, GetHeight(), src_y))
     return;
@@ -396,12 +508,16 @@ Canvas::Copy(int dest_x, int dest_y,
 void
 Canvas::Copy(const Canvas &src, int src_x, int src_y)
 {
+  FlushBatch();
+
   Copy(0, 0, src.GetWidth(), src.GetHeight(), src, src_x, src_y);
 }
 
 void
 Canvas::Copy(const Canvas &src)
 {
+  FlushBatch();
+
   Copy(src, 0, 0);
 }
 
@@ -410,6 +526,8 @@ Canvas::Copy(int dest_x, int dest_y,
              unsigned dest_width, unsigned dest_height,
              const Bitmap &src, int src_x, int src_y)
 {
+  FlushBatch();
+
   Copy(dest_x, dest_y, dest_width, dest_height,
        src.GetNative(), src_x, src_y);
 }
@@ -417,6 +535,8 @@ Canvas::Copy(int dest_x, int dest_y,
 void
 Canvas::Copy(const Bitmap &_src)
 {
+  FlushBatch();
+
   ConstImageBuffer src = _src.GetNative();
 
   Copy(0, 0, src.width, src.height, src, 0, 0);
@@ -427,6 +547,10 @@ Canvas::CopyTransparentWhite(int dest_x, int dest_y,
                              unsigned dest_width, unsigned dest_height,
                              const Canvas &src, int src_x, int src_y)
 {
+  FlushBatch();
+
+  src.FlushBatch();
+
   if (!Clip(dest_x, dest_width, GetWidth(), src_x) ||
       !Clip(dest_y, dest_height, GetHeight(), src_y))
     return;
@@ -444,6 +568,8 @@ Canvas::StretchTransparentWhite(int dest_x, int dest_y,
                                 ConstImageBuffer src, int src_x, int src_y,
                                 unsigned src_width, unsigned src_height)
 {
+  FlushBatch();
+
   if (!Clip(dest_x, dest_width, GetWidth(), src_x) ||
       !Clip(dest_y, dest_height, GetHeight(), src_y))
     return;
@@ -458,6 +584,8 @@ Canvas::StretchTransparentWhite(int dest_x, int dest_y,
 void
 Canvas::StretchNot(const Bitmap &_src)
 {
+  FlushBatch();
+
   assert(_src.IsDefined());
 
   ConstImageBuffer src = _src.GetNative();
@@ -481,6 +609,8 @@ Canvas::Stretch(int dest_x, int dest_y,
                 int src_x, int src_y,
                 unsigned src_width, unsigned src_height)
 {
+  FlushBatch();
+
   assert(dest_width < 0x4000);
   assert(dest_height < 0x4000);
 
@@ -505,6 +635,8 @@ Canvas::Stretch(const Canvas &src,
                 int src_x, int src_y,
                 unsigned src_width, unsigned src_height)
 {
+  FlushBatch();
+
   // XXX
   Stretch(0, 0, GetWidth(), GetHeight(),
           src, src_x, src_y, src_width, src_height);
@@ -517,6 +649,8 @@ Canvas::Stretch(int dest_x, int dest_y,
                 int src_x, int src_y,
                 unsigned src_width, unsigned src_height)
 {
+  FlushBatch();
+
   assert(IsDefined());
   assert(src.IsDefined());
 
@@ -530,6 +664,8 @@ Canvas::Stretch(int dest_x, int dest_y,
                 unsigned dest_width, unsigned dest_height,
                 const Bitmap &_src)
 {
+  FlushBatch();
+
   assert(IsDefined());
   assert(_src.IsDefined());
 
@@ -546,6 +682,8 @@ Canvas::StretchMono(int dest_x, int dest_y,
                     unsigned src_width, unsigned src_height,
                     Color fg_color, Color bg_color)
 {
+  FlushBatch();
+
   assert(IsDefined());
   assert(dest_width < 0x4000);
   assert(dest_height < 0x4000);
@@ -571,6 +709,8 @@ Canvas::CopyNot(int dest_x, int dest_y,
                 unsigned dest_width, unsigned dest_height,
                 ConstImageBuffer src, int src_x, int src_y)
 {
+  FlushBatch();
+
   SDLRasterCanvas canvas(buffer);
 
   canvas.CopyRectangle(dest_x, dest_y, dest_width, dest_height,
@@ -583,6 +723,8 @@ Canvas::CopyOr(int dest_x, int dest_y,
                unsigned dest_width, unsigned dest_height,
                ConstImageBuffer src, int src_x, int src_y)
 {
+  FlushBatch();
+
   SDLRasterCanvas canvas(buffer);
 
   canvas.CopyRectangle(dest_x, dest_y, dest_width, dest_height,
@@ -595,6 +737,8 @@ Canvas::CopyNotOr(int dest_x, int dest_y,
                   unsigned dest_width, unsigned dest_height,
                   ConstImageBuffer src, int src_x, int src_y)
 {
+  FlushBatch();
+
   SDLRasterCanvas canvas(buffer);
 
   canvas.CopyRectangle(dest_x, dest_y, dest_width, dest_height,
@@ -607,6 +751,8 @@ Canvas::CopyNotOr(int dest_x, int dest_y,
                   unsigned dest_width, unsigned dest_height,
                   const Bitmap &src, int src_x, int src_y)
 {
+  FlushBatch();
+
   assert(src.IsDefined());
 
   CopyNotOr(dest_x, dest_y, dest_width, dest_height,
@@ -618,6 +764,8 @@ Canvas::CopyAnd(int dest_x, int dest_y,
                 unsigned dest_width, unsigned dest_height,
                 ConstImageBuffer src, int src_x, int src_y)
 {
+  FlushBatch();
+
   SDLRasterCanvas canvas(buffer);
 
   canvas.CopyRectangle(dest_x, dest_y, dest_width, dest_height,
@@ -630,6 +778,8 @@ Canvas::CopyNot(int dest_x, int dest_y,
                 unsigned dest_width, unsigned dest_height,
                 const Bitmap &src, int src_x, int src_y)
 {
+  FlushBatch();
+
   assert(src.IsDefined());
 
   CopyNot(dest_x, dest_y, dest_width, dest_height,
@@ -641,6 +791,8 @@ Canvas::CopyOr(int dest_x, int dest_y,
                unsigned dest_width, unsigned dest_height,
                const Bitmap &src, int src_x, int src_y)
 {
+  FlushBatch();
+
   assert(src.IsDefined());
 
   CopyOr(dest_x, dest_y, dest_width, dest_height,
@@ -652,6 +804,8 @@ Canvas::CopyAnd(int dest_x, int dest_y,
                 unsigned dest_width, unsigned dest_height,
                 const Bitmap &src, int src_x, int src_y)
 {
+  FlushBatch();
+
   assert(src.IsDefined());
 
   CopyAnd(dest_x, dest_y, dest_width, dest_height,
@@ -661,6 +815,8 @@ Canvas::CopyAnd(int dest_x, int dest_y,
 void
 Canvas::CopyAnd(const Bitmap &src)
 {
+  FlushBatch();
+
   CopyAnd(0, 0, GetWidth(), GetHeight(),
           src.GetNative(), 0, 0);
 }
@@ -671,6 +827,8 @@ Canvas::DrawRoundRectangle(int left, int top,
                            unsigned ellipse_width,
                            unsigned ellipse_height)
 {
+  FlushBatch();
+
   unsigned radius = std::min(ellipse_width, ellipse_height) / 2u;
   ::RoundRect(*this, left, top, right, bottom, radius);
 }
@@ -683,6 +841,8 @@ Canvas::AlphaBlend(int dest_x, int dest_y,
                    unsigned src_width, unsigned src_height,
                    uint8_t alpha)
 {
+  FlushBatch();
+
   // TODO: support scaling
 
   SDLRasterCanvas canvas(buffer);
@@ -702,6 +862,9 @@ Canvas::AlphaBlend(int dest_x, int dest_y,
                    unsigned src_width, unsigned src_height,
                    uint8_t alpha)
 {
+  FlushBatch();
+  src.FlushBatch();
+
   AlphaBlend(dest_x, dest_y, dest_width, dest_height,
              src.buffer,
              src_x, src_y, src_width, src_height,
@@ -716,6 +879,8 @@ Canvas::AlphaBlendNotWhite(int dest_x, int dest_y,
                            unsigned src_width, unsigned src_height,
                            uint8_t alpha)
 {
+  FlushBatch();
+
   // TODO: support scaling
 
   SDLRasterCanvas canvas(buffer);
@@ -737,6 +902,9 @@ Canvas::AlphaBlendNotWhite(int dest_x, int dest_y,
                            unsigned src_width, unsigned src_height,
                            uint8_t alpha)
 {
+  FlushBatch();
+  src.FlushBatch();
+
   AlphaBlendNotWhite(dest_x, dest_y, dest_width, dest_height,
                      src.buffer,
                      src_x, src_y, src_width, src_height,
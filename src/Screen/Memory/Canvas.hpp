@@ -46,6 +46,7 @@ Copyright_License {
 
 class Angle;
 class Bitmap;
+template<typename PixelTraits> class PolygonFillQueue;
 
 /**
  * Base drawable canvas class
@@ -67,6 +68,13 @@ protected:
     OPAQUE, TRANSPARENT
   } background_mode = OPAQUE;
 
+  /**
+   * If not nullptr, then batching is enabled, and filled polygons
+   * are collected here instead of being drawn immediately.  See
+   * BeginBatch().
+   */
+  PolygonFillQueue<ActivePixelTraits> *batch = nullptr;
+
 public:
   Canvas()
     :buffer(WritableImageBuffer<ActivePixelTraits>::Empty()) {}
@@ -78,7 +86,44 @@ public:
     buffer = _buffer;
   }
 
+  /**
+   * Stop the worker threads used by FlushBatch().
+   */
+  static void Deinitialise();
+
+  /**
+   * Enable batching: polygons filled without an outline are
+   * collected and rasterised by FlushBatch() or EndBatch(), in
+   * horizontal bands on several threads if the area is large
+   * enough.  All other drawing methods flush the batch first.
+   *
+   * While batching, this canvas must not be used as the source of a
+   * copy without calling FlushBatch() first, and its buffer must not
+   * be accessed by another #Canvas (e.g. #SubCanvas).
+   */
+  void BeginBatch();
+
+  /**
+   * Draw all polygons collected so far.  No-op if batching is
+   * disabled.
+   */
+  void FlushBatch() const {
+    if (batch != nullptr)
+      DrawBatch();
+  }
+
+  /**
+   * Flush and disable batching.
+   */
+  void EndBatch();
+
+  bool IsBatching() const {
+    return batch != nullptr;
+  }
+
 protected:
+  void DrawBatch() const;
+
   /**
    * Returns true if the outline should be drawn after the area has
    * been filled.  As an optimization, this function returns false if
@@ -355,6 +400,7 @@ public:
 
   void Copy(int dest_x, int dest_y, unsigned dest_width, unsigned dest_height,
             const Canvas &src, int src_x, int src_y) {
+    src.FlushBatch();
     Copy(dest_x, dest_y, dest_width, dest_height,
          src.buffer, src_x, src_y);
   }
@@ -392,6 +438,7 @@ public:
                const Canvas &src,
                int src_x, int src_y,
                unsigned src_width, unsigned src_height) {
+    src.FlushBatch();
     Stretch(dest_x, dest_y, dest_width, dest_height,
             src.buffer, src_x, src_y, src_width, src_height);
   }
@@ -434,6 +481,7 @@ public:
   void CopyOr(int dest_x, int dest_y,
               unsigned dest_width, unsigned dest_height,
               const Canvas &src, int src_x, int src_y) {
+    src.FlushBatch();
     CopyOr(dest_x, dest_y, dest_width, dest_height,
            src.buffer, src_x, src_y);
   }
@@ -461,11 +509,13 @@ public:
   void CopyAnd(int dest_x, int dest_y,
                unsigned dest_width, unsigned dest_height,
                const Canvas &src, int src_x, int src_y) {
+    src.FlushBatch();
     CopyAnd(dest_x, dest_y, dest_width, dest_height,
             src.buffer, src_x, src_y);
   }
 
   void CopyAnd(const Canvas &src) {
+    src.FlushBatch();
     CopyAnd(0, 0, src.GetWidth(), src.GetHeight(),
             src.buffer, 0, 0);
   }
@@ -513,4 +563,24 @@ public:
                           uint8_t alpha);
 };
 
+/**
+ * Enables batching (see Canvas::BeginBatch()) for the lifetime of
+ * this object.
+ */
+class ScopeCanvasBatch {
+  Canvas &canvas;
+
+public:
+  explicit ScopeCanvasBatch(Canvas &_canvas):canvas(_canvas) {
+    canvas.BeginBatch();
+  }
+
+  ~ScopeCanvasBatch() {
+    canvas.EndBatch();
+  }
+
+  ScopeCanvasBatch(const ScopeCanvasBatch &) = delete;
+  ScopeCanvasBatch &operator=(const ScopeCanvasBatch &) = delete;
+};
+
 #endif
@@ -0,0 +1,102 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "DamageRegion.hpp"
+
+#include <algorithm>
+
+static constexpr unsigned long
+Area(const PixelRect &rc)
+{
+  return (unsigned long)rc.GetWidth() * rc.GetHeight();
+}
+
+static PixelRect
+Union(const PixelRect &a, const PixelRect &b)
+{
+  return PixelRect(std::min(a.left, b.left), std::min(a.top, b.top),
+                   std::max(a.right, b.right), std::max(a.bottom, b.bottom));
+}
+
+/**
+ * Do the two rectangles overlap or touch?
+ */
+static constexpr bool
+Adjacent(const PixelRect &a, const PixelRect &b)
+{
+  return a.left <= b.right && b.left <= a.right &&
+    a.top <= b.bottom && b.top <= a.bottom;
+}
+
+void
+DamageRegion::Add(PixelRect rc)
+{
+  if (rc.IsEmpty())
+    return;
+
+  /* merge with all rectangles which overlap the new one; repeat
+     until nothing changes, because the merged rectangle may now
+     overlap others */
+  for (unsigned i = 0; i < rects.size();) {
+    if (rects[i].Contains(rc))
+      return;
+
+    if (Adjacent(rects[i], rc)) {
+      rc = Union(rects[i], rc);
+      rects.quick_remove(i);
+      i = 0;
+    } else
+      ++i;
+  }
+
+  if (rects.full()) {
+    /* no room: merge with the rectangle which grows least */
+    unsigned best = 0;
+    unsigned long best_growth = ~0ul;
+    for (unsigned i = 0; i < rects.size(); ++i) {
+      const unsigned long growth = Area(Union(rects[i], rc))
+        - Area(rects[i]) - Area(rc);
+      if (growth < best_growth) {
+        best = i;
+        best_growth = growth;
+      }
+    }
+
+    rc = Union(rects[best], rc);
+    rects.quick_remove(best);
+
+    /* the merged rectangle may overlap others */
+    Add(rc);
+    return;
+  }
+
+  rects.append(rc);
+}
+
+unsigned long
+DamageRegion::GetArea() const
+{
+  unsigned long area = 0;
+  for (const auto &rc : rects)
+    area += Area(rc);
+  return area;
+}
@@ -0,0 +1,78 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_SCREEN_MEMORY_DAMAGE_REGION_HPP
+#define XCSOAR_SCREEN_MEMORY_DAMAGE_REGION_HPP
+
+#include "Screen/Point.hpp"
+#include "Util/TrivialArray.hxx"
+#include "Compiler.h"
+
+/**
+ * Collects the rectangles of the screen which have changed since the
+ * last update.  Overlapping rectangles are merged, and the number of
+ * rectangles is limited, so the caller only has a few (but not too
+ * large) areas to copy to the display.
+ */
+class DamageRegion {
+  static constexpr unsigned MAX_RECTS = 8;
+
+  typedef TrivialArray<PixelRect, MAX_RECTS> Array;
+
+  Array rects;
+
+public:
+  typedef Array::const_iterator const_iterator;
+
+  bool IsEmpty() const {
+    return rects.empty();
+  }
+
+  void Clear() {
+    rects.clear();
+  }
+
+  /**
+   * Add a rectangle.  It must be clipped to the screen already.
+   */
+  void Add(PixelRect rc);
+
+  const_iterator begin() const {
+    return rects.begin();
+  }
+
+  const_iterator end() const {
+    return rects.end();
+  }
+
+  unsigned size() const {
+    return rects.size();
+  }
+
+  /**
+   * Returns the number of pixels in all rectangles.
+   */
+  gcc_pure
+  unsigned long GetArea() const;
+};
+
+#endif
@@ -53,13 +53,13 @@ Dither::DitherGreyscale(const uint8_t *gcc_restrict src,
     for (unsigned column = 0; column < width; ++column) {
       ErrorDistType bwPix = e0 + src[column];
 
-      uint8_t color = 0;
-      if (bwPix >= 128) {
-        --color;
-	bwPix -= 255;
-      }
+      /* threshold without a branch: the mask is 0 (black) or -1
+         (white); the branch was mispredicted on nearly every pixel
+         of a half-tone area */
+      const ErrorDistType mask = -ErrorDistType(bwPix >= 128);
+      bwPix -= mask & 0xff;
 
-      dest[column] = color;
+      dest[column] = uint8_t(mask);
 
       /* modify the error distribution buffer */
 
@@ -72,24 +72,25 @@ CopyFromGreyscale(
 
 #ifdef DITHER
 
-  dither.DitherGreyscale(src_pixels, src.pitch,
-                         (uint8_t *)dest_pixels,
-                         dest_pitch,
-                         width, height);
-
 #ifndef KOBO
   if (dest_bpp == 4) {
-    const unsigned n_pixels = (dest_pitch / dest_bpp)
-      * height;
-    int32_t *d = (int32_t *)dest_pixels + n_pixels;
-    const int8_t *end = (int8_t *)dest_pixels;
-    const int8_t *s = end + n_pixels;
-
-    while (s != end)
-      *--d = *--s;
+    /* dither into the beginning of the destination with a pitch of
+       one byte per pixel, and expand to 32 bit pixels in place */
+    dither.DitherGreyscale(src_pixels, src.pitch,
+                           (uint8_t *)dest_pixels,
+                           dest_pitch / dest_bpp,
+                           width, height);
+
+    ExpandGreyscaleToRGB8(dest_pixels, (dest_pitch / dest_bpp) * height);
+    return;
   }
 #endif
 
+  dither.DitherGreyscale(src_pixels, src.pitch,
+                         (uint8_t *)dest_pixels,
+                         dest_pitch,
+                         width, height);
+
 #else
 
   const unsigned src_pitch = src.pitch;
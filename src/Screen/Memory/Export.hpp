@@ -34,6 +34,16 @@ class Dither;
 template<typename PixelTraits>
 struct ConstImageBuffer;
 
+#ifdef __ARM_NEON__
+#include "NEON.hpp"
+#define HAVE_OPTIMISED_EXPORT
+typedef NEONExportOperations OptimisedExportOperations;
+#elif defined(__SSE2__)
+#include "SSE2.hpp"
+#define HAVE_OPTIMISED_EXPORT
+typedef SSE2ExportOperations OptimisedExportOperations;
+#endif
+
 static inline uint32_t
 GreyscaleToRGB8(Luminosity8 luminosity)
 {
@@ -43,14 +53,28 @@ GreyscaleToRGB8(Luminosity8 luminosity)
 }
 
 static inline void
-CopyGreyscaleToRGB8(uint32_t *gcc_restrict dest,
-                     const Luminosity8 *gcc_restrict src,
-                     unsigned width)
+PortableCopyGreyscaleToRGB8(uint32_t *gcc_restrict dest,
+                            const Luminosity8 *gcc_restrict src,
+                            unsigned width)
 {
   for (unsigned i = 0; i < width; ++i)
     *dest++ = GreyscaleToRGB8(*src++);
 }
 
+static inline void
+CopyGreyscaleToRGB8(uint32_t *gcc_restrict dest,
+                    const Luminosity8 *gcc_restrict src,
+                    unsigned width)
+{
+#ifdef HAVE_OPTIMISED_EXPORT
+  constexpr unsigned N = OptimisedExportOperations::GREYSCALE_BLOCK;
+  for (; width >= N; width -= N, dest += N, src += N)
+    OptimisedExportOperations::GreyscaleToRGB8(dest, (const uint8_t *)src);
+#endif
+
+  PortableCopyGreyscaleToRGB8(dest, src, width);
+}
+
 static inline RGB565Color
 GreyscaleToRGB565(Luminosity8 luminosity)
 {
@@ -59,13 +83,28 @@ GreyscaleToRGB565(Luminosity8 luminosity)
   return RGB565Color(value, value, value);
 }
 
+static inline void
+PortableCopyGreyscaleToRGB565(RGB565Color *gcc_restrict dest,
+                              const Luminosity8 *gcc_restrict src,
+                              unsigned width)
+{
+  for (unsigned i = 0; i < width; ++i)
+    *dest++ = GreyscaleToRGB565(*src++);
+}
+
 static inline void
 CopyGreyscaleToRGB565(RGB565Color *gcc_restrict dest,
                       const Luminosity8 *gcc_restrict src,
                       unsigned width)
 {
-  for (unsigned i = 0; i < width; ++i)
-    *dest++ = GreyscaleToRGB565(*src++);
+#ifdef HAVE_OPTIMISED_EXPORT
+  constexpr unsigned N = OptimisedExportOperations::GREYSCALE_BLOCK;
+  for (; width >= N; width -= N, dest += N, src += N)
+    OptimisedExportOperations::GreyscaleToRGB565((uint16_t *)dest,
+                                                 (const uint8_t *)src);
+#endif
+
+  PortableCopyGreyscaleToRGB565(dest, src, width);
 }
 
 static constexpr inline RGB565Color
@@ -75,12 +114,50 @@ ToRGB565(BGRA8Color c)
 }
 
 static inline void
-BGRAToRGB565(RGB565Color *dest, const BGRA8Color *src, unsigned n)
+PortableBGRAToRGB565(RGB565Color *dest, const BGRA8Color *src, unsigned n)
 {
   for (unsigned i = 0; i < n; ++i)
     dest[i] = ToRGB565(src[i]);
 }
 
+static inline void
+BGRAToRGB565(RGB565Color *dest, const BGRA8Color *src, unsigned n)
+{
+#ifdef HAVE_OPTIMISED_EXPORT
+  constexpr unsigned N = OptimisedExportOperations::BGRA_BLOCK;
+  for (; n >= N; n -= N, dest += N, src += N)
+    OptimisedExportOperations::BGRAToRGB565((uint16_t *)dest,
+                                            (const uint32_t *)src);
+#endif
+
+  PortableBGRAToRGB565(dest, src, n);
+}
+
+/**
+ * Expand 8 bit greyscale pixels to 32 bit in place.  The buffer
+ * must be large enough for the 32 bit pixels.  Works from the end
+ * backwards, so no source pixel is overwritten before it has been
+ * read.
+ */
+static inline void
+ExpandGreyscaleToRGB8(void *pixels, unsigned n)
+{
+  uint32_t *d = (uint32_t *)pixels + n;
+  const Luminosity8 *s = (const Luminosity8 *)pixels + n;
+
+#ifdef HAVE_OPTIMISED_EXPORT
+  constexpr unsigned N = OptimisedExportOperations::GREYSCALE_BLOCK;
+  for (; n >= N; n -= N) {
+    d -= N;
+    s -= N;
+    OptimisedExportOperations::GreyscaleToRGB8(d, (const uint8_t *)s);
+  }
+#endif
+
+  while (n-- > 0)
+    *--d = GreyscaleToRGB8(*--s);
+}
+
 #ifdef GREYSCALE
 
 void
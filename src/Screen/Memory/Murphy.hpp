@@ -28,6 +28,7 @@ Copyright_License {
 
 #include <algorithm>
 
+#include <assert.h>
 #include <math.h>
 #include <stdint.h>
 
@@ -203,4 +203,61 @@ struct NEONBytesTwice {
   }
 };
 
+/**
+ * Pixel format conversions for exporting the frame buffer, using ARM
+ * NEON instructions.  Each method converts one block of pixels.
+ * Source and destination may overlap: the source block is read
+ * completely before the destination is written.
+ */
+struct NEONExportOperations {
+  static constexpr unsigned GREYSCALE_BLOCK = 16;
+  static constexpr unsigned BGRA_BLOCK = 8;
+
+  /**
+   * Convert 16 greyscale pixels to 32 bit pixels with all four
+   * channels set to the luminosity.
+   */
+  gcc_always_inline
+  static void GreyscaleToRGB8(uint32_t *p, const uint8_t *q) {
+    const uint8x16_t v = vld1q_u8(q);
+    const uint8x16x4_t v4 = {{ v, v, v, v }};
+
+    /* vst4 interleaves the four parts */
+    vst4q_u8((uint8_t *)p, v4);
+  }
+
+  /**
+   * Pack 8 pixels to RGB565.
+   */
+  gcc_always_inline
+  static uint16x8_t ToRGB565(uint8x8_t r, uint8x8_t g, uint8x8_t b) {
+    uint16x8_t result = vshll_n_u8(r, 8);
+    result = vsriq_n_u16(result, vshll_n_u8(g, 8), 5);
+    return vsriq_n_u16(result, vshll_n_u8(b, 8), 11);
+  }
+
+  /**
+   * Convert 16 greyscale pixels to RGB565.
+   */
+  gcc_always_inline
+  static void GreyscaleToRGB565(uint16_t *p, const uint8_t *q) {
+    const uint8x16_t v = vld1q_u8(q);
+    const uint8x8_t lo = vget_low_u8(v), hi = vget_high_u8(v);
+
+    vst1q_u16(p, ToRGB565(lo, lo, lo));
+    vst1q_u16(p + 8, ToRGB565(hi, hi, hi));
+  }
+
+  /**
+   * Convert 8 BGRA pixels to RGB565.
+   */
+  gcc_always_inline
+  static void BGRAToRGB565(uint16_t *p, const uint32_t *q) {
+    /* vld4 de-interleaves the channels: B, G, R, A */
+    const uint8x8x4_t v = vld4_u8((const uint8_t *)q);
+
+    vst1q_u16(p, ToRGB565(v.val[2], v.val[1], v.val[0]));
+  }
+};
+
 #endif
@@ -0,0 +1,200 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_SCREEN_MEMORY_POLYGON_FILL_QUEUE_HPP
+#define XCSOAR_SCREEN_MEMORY_POLYGON_FILL_QUEUE_HPP
+
+#include "Screen/Point.hpp"
+#include "PixelTraits.hpp"
+#include "RasterCanvas.hpp"
+#include "Optimised.hpp"
+#include "BandThreadPool.hpp"
+#include "Buffer.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <assert.h>
+#include <stdint.h>
+
+/**
+ * A list of filled polygons which are rasterised later, optionally
+ * on several threads.  Each thread renders all polygons, in the
+ * original order, into its own horizontal band of the buffer, so the
+ * result is identical to drawing them one after another.
+ */
+template<typename PixelTraits>
+class PolygonFillQueue {
+  typedef typename PixelTraits::color_type color_type;
+
+  struct Command {
+    /**
+     * The position of the first vertex in #points.
+     */
+    unsigned offset;
+
+    unsigned n;
+
+    /**
+     * The bounding box of this polygon.
+     */
+    int min_x, min_y, max_x, max_y;
+
+    color_type color;
+
+    /**
+     * The opacity; 0xff means opaque.
+     */
+    uint8_t alpha;
+  };
+
+  std::vector<PixelPoint> points;
+  std::vector<Command> commands;
+
+public:
+  /**
+   * The estimated number of pixels below which Draw() does not bother
+   * to use worker threads.
+   */
+  static constexpr unsigned PARALLEL_THRESHOLD = 256 * 256;
+
+  bool IsEmpty() const {
+    return commands.empty();
+  }
+
+  void Clear() {
+    points.clear();
+    commands.clear();
+  }
+
+  template<typename P>
+  void Add(const P *src, unsigned n, color_type color, uint8_t alpha=0xff) {
+    if (n < 3)
+      return;
+
+    Command c;
+    c.offset = points.size();
+    c.n = n;
+    c.min_x = c.max_x = src[0].x;
+    c.min_y = c.max_y = src[0].y;
+    c.color = color;
+    c.alpha = alpha;
+
+    for (unsigned i = 0; i < n; ++i) {
+      const PixelPoint p = src[i];
+      c.min_x = std::min<int>(c.min_x, p.x);
+      c.max_x = std::max<int>(c.max_x, p.x);
+      c.min_y = std::min<int>(c.min_y, p.y);
+      c.max_y = std::max<int>(c.max_y, p.y);
+      points.push_back(p);
+    }
+
+    commands.push_back(c);
+  }
+
+  /**
+   * Rasterise all polygons into the specified buffer, but only the
+   * rows [top, bottom).
+   *
+   * @param translated a scratch buffer for the translated vertices
+   */
+  void DrawBand(WritableImageBuffer<PixelTraits> buffer,
+                unsigned top, unsigned bottom,
+                std::vector<PixelPoint> &translated) const {
+    assert(top <= bottom);
+    assert(bottom <= buffer.height);
+
+    if (top == bottom)
+      return;
+
+    /* the band is a view on a portion of the buffer; the vertices
+       are translated into its coordinate system, and RasterCanvas
+       clips at its edges */
+    WritableImageBuffer<PixelTraits> band = buffer;
+    band.data = buffer.At(0, top);
+    band.height = bottom - top;
+
+    RasterCanvas<PixelTraits> canvas(band);
+
+    for (const auto &c : commands) {
+      if (c.max_y < int(top) || c.min_y >= int(bottom))
+        continue;
+
+      const PixelPoint *src = points.data() + c.offset;
+      const PixelPoint *p = src;
+      if (top > 0) {
+        translated.resize(c.n);
+        for (unsigned i = 0; i < c.n; ++i)
+          translated[i] = PixelPoint(src[i].x, src[i].y - int(top));
+        p = translated.data();
+      }
+
+      if (c.alpha == 0xff)
+        canvas.FillPolygon(p, c.n, c.color);
+      else
+        canvas.FillPolygon(p, c.n, c.color,
+                           AlphaPixelOperations<PixelTraits>(c.alpha));
+    }
+  }
+
+  /**
+   * Estimate the number of pixels covered by all polygons, clipped to
+   * the buffer.
+   */
+  gcc_pure
+  unsigned long EstimateArea(unsigned width, unsigned height) const {
+    unsigned long area = 0;
+    for (const auto &c : commands) {
+      const int x1 = std::max(c.min_x, 0), x2 = std::min(c.max_x, int(width));
+      const int y1 = std::max(c.min_y, 0), y2 = std::min(c.max_y, int(height));
+      if (x1 < x2 && y1 < y2)
+        area += (unsigned long)(x2 - x1) * (unsigned long)(y2 - y1);
+    }
+
+    return area;
+  }
+
+  /**
+   * Rasterise all polygons and clear the queue.
+   *
+   * @param pool the worker threads; nullptr to draw everything on
+   * the calling thread
+   */
+  void Draw(WritableImageBuffer<PixelTraits> buffer, BandThreadPool *pool) {
+    if (pool != nullptr && pool->GetBandCount() > 1 &&
+        EstimateArea(buffer.width, buffer.height) >= PARALLEL_THRESHOLD) {
+      pool->Run([this, buffer](unsigned band, unsigned n_bands){
+          const unsigned top = buffer.height * band / n_bands;
+          const unsigned bottom = buffer.height * (band + 1) / n_bands;
+          std::vector<PixelPoint> translated;
+          DrawBand(buffer, top, bottom, translated);
+        });
+    } else {
+      std::vector<PixelPoint> translated;
+      DrawBand(buffer, 0, buffer.height, translated);
+    }
+
+    Clear();
+  }
+};
+
+#endif
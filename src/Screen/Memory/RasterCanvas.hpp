@@ -515,11 +515,18 @@ public:
     // sort array by y value (top best), then x value (left best)
     std::sort(edge_start, edge_end, BresenhamIterator::CompareVerticalHorizontal);
 
+    /* only scan the rows inside the buffer; edges above it are
+       advanced to the first visible row */
+    const int first_y = std::max(miny, 0);
+    const int last_y = std::min(maxy, int(buffer.height) - 1);
+
     // perform scans
 
-    for (int y = miny; y <= maxy; y++) {
+    for (int y = first_y; y <= last_y; y++) {
 
-      bool changed = false;
+      /* on the first row, the edges may have been advanced by more
+         than one step; always re-sort them */
+      bool changed = y == first_y && first_y > miny;
 
       // advance active items
       int x = -1;
@@ -592,8 +599,10 @@ public:
         maxy = points[i].y;
     }
 
-    // Draw, scanning y
-    for (int y = miny; y <= maxy; y++) {
+    // Draw, scanning y (only the rows inside the buffer)
+    const int first_y = std::max(miny, 0);
+    const int last_y = std::min(maxy, int(buffer.height) - 1);
+    for (int y = first_y; y <= last_y; y++) {
       unsigned n_ints = 0;
       for (unsigned i = 0; i < n; i++) {
         unsigned ind1, ind2;
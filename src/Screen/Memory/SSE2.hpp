@@ -0,0 +1,130 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_SCREEN_SSE2_HPP
+#define XCSOAR_SCREEN_SSE2_HPP
+
+#include "Compiler.h"
+
+#ifndef __SSE2__
+#error SSE2 required
+#endif
+
+#include <emmintrin.h>
+
+#include <stdint.h>
+
+#if CLANG_OR_GCC_VERSION(4,8)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-align"
+#endif
+
+/**
+ * Pixel format conversions for exporting the frame buffer, using
+ * Intel SSE2 instructions.  Each method converts one block of
+ * pixels.  Source and destination may overlap: the source block is
+ * read completely before the destination is written.
+ */
+struct SSE2ExportOperations {
+  static constexpr unsigned GREYSCALE_BLOCK = 16;
+  static constexpr unsigned BGRA_BLOCK = 8;
+
+  /**
+   * Convert 16 greyscale pixels to 32 bit pixels with all four
+   * channels set to the luminosity.
+   */
+  gcc_always_inline
+  static void GreyscaleToRGB8(uint32_t *p, const uint8_t *q) {
+    const __m128i v = _mm_loadu_si128((const __m128i *)q);
+    const __m128i lo = _mm_unpacklo_epi8(v, v);
+    const __m128i hi = _mm_unpackhi_epi8(v, v);
+
+    _mm_storeu_si128((__m128i *)p, _mm_unpacklo_epi16(lo, lo));
+    _mm_storeu_si128((__m128i *)p + 1, _mm_unpackhi_epi16(lo, lo));
+    _mm_storeu_si128((__m128i *)p + 2, _mm_unpacklo_epi16(hi, hi));
+    _mm_storeu_si128((__m128i *)p + 3, _mm_unpackhi_epi16(hi, hi));
+  }
+
+  /**
+   * Convert 8 greyscale pixels (in the lower 8 bits of each 16 bit
+   * lane) to RGB565.
+   */
+  gcc_always_inline
+  static __m128i GreyscaleToRGB565(__m128i v) {
+    const __m128i r = _mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0xf8)), 8);
+    const __m128i g = _mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0xfc)), 3);
+    const __m128i b = _mm_srli_epi16(v, 3);
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+  }
+
+  /**
+   * Convert 16 greyscale pixels to RGB565.
+   */
+  gcc_always_inline
+  static void GreyscaleToRGB565(uint16_t *p, const uint8_t *q) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i v = _mm_loadu_si128((const __m128i *)q);
+    const __m128i lo = GreyscaleToRGB565(_mm_unpacklo_epi8(v, zero));
+    const __m128i hi = GreyscaleToRGB565(_mm_unpackhi_epi8(v, zero));
+
+    _mm_storeu_si128((__m128i *)p, lo);
+    _mm_storeu_si128((__m128i *)p + 1, hi);
+  }
+
+  /**
+   * Convert 4 BGRA pixels to RGB565 in the lower 16 bits of each 32
+   * bit lane.
+   */
+  gcc_always_inline
+  static __m128i BGRAToRGB565(__m128i v) {
+    const __m128i r = _mm_and_si128(_mm_srli_epi32(v, 8),
+                                    _mm_set1_epi32(0xf800));
+    const __m128i g = _mm_and_si128(_mm_srli_epi32(v, 5),
+                                    _mm_set1_epi32(0x07e0));
+    const __m128i b = _mm_and_si128(_mm_srli_epi32(v, 3),
+                                    _mm_set1_epi32(0x001f));
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+  }
+
+  /**
+   * Convert 8 BGRA pixels to RGB565.
+   */
+  gcc_always_inline
+  static void BGRAToRGB565(uint16_t *p, const uint32_t *q) {
+    const __m128i a = BGRAToRGB565(_mm_loadu_si128((const __m128i *)q));
+    const __m128i b = BGRAToRGB565(_mm_loadu_si128((const __m128i *)q + 1));
+
+    /* SSE2 has only a signed 32->16 bit pack; move the values into
+       the signed range and back to avoid saturation */
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16(-0x8000);
+    const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias32),
+                                           _mm_sub_epi32(b, bias32));
+    _mm_storeu_si128((__m128i *)p, _mm_xor_si128(packed, bias16));
+  }
+};
+
+#if CLANG_OR_GCC_VERSION(4,8)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
@@ -0,0 +1,205 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Batch.hpp"
+#include "BulkPoint.hpp"
+#include "VertexPointer.hpp"
+#include "Shapes.hpp"
+#include "Globals.hpp"
+#include "Math/FastTrig.hpp"
+
+void
+GLDrawBatch::Prepare(Mode _mode, unsigned _line_width, unsigned n)
+{
+  if (_mode != mode || _line_width != line_width ||
+      vertices.size() + n > MAX_VERTICES) {
+    Flush();
+    mode = _mode;
+    line_width = _line_width;
+  }
+
+  ++OpenGL::draw_statistics.batched_primitives;
+}
+
+void
+GLDrawBatch::Flush()
+{
+  if (vertices.empty())
+    return;
+
+  const ScopeVertexPointer vp(vertices.data());
+  const ScopeColorPointer cp(colors.data());
+
+  if (mode == Mode::LINES) {
+#if defined(HAVE_GLES) && !defined(HAVE_GLES2)
+    glLineWidthx(line_width << 16);
+#else
+    glLineWidth(line_width);
+#endif
+
+    OpenGL::DrawArrays(GL_LINES, 0, vertices.size());
+  } else
+    OpenGL::DrawArrays(GL_TRIANGLES, 0, vertices.size());
+
+  vertices.clear();
+  colors.clear();
+  mode = Mode::NONE;
+}
+
+void
+GLDrawBatch::AddRectangle(int left, int top, int right, int bottom,
+                          Color color)
+{
+  Prepare(Mode::TRIANGLES, 6);
+
+  Push(left, top, color);
+  Push(right, top, color);
+  Push(left, bottom, color);
+
+  Push(right, top, color);
+  Push(right, bottom, color);
+  Push(left, bottom, color);
+}
+
+void
+GLDrawBatch::AddTriangles(const BulkPixelPoint *points,
+                          const GLushort *indices, unsigned n_indices,
+                          Color color)
+{
+  Prepare(Mode::TRIANGLES, n_indices);
+
+  for (unsigned i = 0; i < n_indices; ++i)
+    Push(points[indices[i]], color);
+}
+
+void
+GLDrawBatch::AddTriangleFan(const BulkPixelPoint *points, unsigned n,
+                            Color color)
+{
+  if (n < 3)
+    return;
+
+  Prepare(Mode::TRIANGLES, (n - 2) * 3);
+
+  for (unsigned i = 2; i < n; ++i) {
+    Push(points[0], color);
+    Push(points[i - 1], color);
+    Push(points[i], color);
+  }
+}
+
+void
+GLDrawBatch::AddTriangleStrip(const BulkPixelPoint *points, unsigned n,
+                              Color color)
+{
+  if (n < 3)
+    return;
+
+  Prepare(Mode::TRIANGLES, (n - 2) * 3);
+
+  for (unsigned i = 2; i < n; ++i) {
+    Push(points[i - 2], color);
+    Push(points[i - 1], color);
+    Push(points[i], color);
+  }
+}
+
+/**
+ * Calculate a vertex of the circle approximation used by
+ * OpenGL::circle_buffer.
+ */
+static FloatPoint2D
+CirclePoint(int x, int y, unsigned radius, unsigned i, unsigned n)
+{
+  const unsigned angle = i * (INT_ANGLE_RANGE / n);
+  const float dx = ISINETABLE[(angle + 1024) & INT_ANGLE_MASK] / 1024.;
+  const float dy = ISINETABLE[angle & INT_ANGLE_MASK] / 1024.;
+  return FloatPoint2D(x + dx * radius, y + dy * radius);
+}
+
+gcc_const
+static unsigned
+CircleSize(unsigned radius)
+{
+  return radius < 16
+    ? OpenGL::SMALL_CIRCLE_SIZE
+    : OpenGL::CIRCLE_SIZE;
+}
+
+void
+GLDrawBatch::AddCircle(int x, int y, unsigned radius, Color color)
+{
+  const unsigned n = CircleSize(radius);
+
+  Prepare(Mode::TRIANGLES, (n - 2) * 3);
+
+  const FloatPoint2D first = CirclePoint(x, y, radius, 0, n);
+  FloatPoint2D previous = CirclePoint(x, y, radius, 1, n);
+  for (unsigned i = 2; i < n; ++i) {
+    const FloatPoint2D current = CirclePoint(x, y, radius, i, n);
+    Push(first, color);
+    Push(previous, color);
+    Push(current, color);
+    previous = current;
+  }
+}
+
+void
+GLDrawBatch::AddLineStrip(const BulkPixelPoint *points, unsigned n,
+                          bool loop, unsigned width, Color color)
+{
+  if (n < 2)
+    return;
+
+  Prepare(Mode::LINES, width, (n - 1 + loop) * 2);
+
+  for (unsigned i = 1; i < n; ++i) {
+    Push(points[i - 1], color);
+    Push(points[i], color);
+  }
+
+  if (loop && n > 2) {
+    Push(points[n - 1], color);
+    Push(points[0], color);
+  }
+}
+
+void
+GLDrawBatch::AddCircleOutline(int x, int y, unsigned radius,
+                              unsigned width, Color color)
+{
+  const unsigned n = CircleSize(radius);
+
+  Prepare(Mode::LINES, width, n * 2);
+
+  const FloatPoint2D first = CirclePoint(x, y, radius, 0, n);
+  FloatPoint2D previous = first;
+  for (unsigned i = 1; i < n; ++i) {
+    const FloatPoint2D current = CirclePoint(x, y, radius, i, n);
+    Push(previous, color);
+    Push(current, color);
+    previous = current;
+  }
+
+  Push(previous, color);
+  Push(first, color);
+}
@@ -0,0 +1,140 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_SCREEN_OPENGL_BATCH_HPP
+#define XCSOAR_SCREEN_OPENGL_BATCH_HPP
+
+#include "Color.hpp"
+#include "System.hpp"
+#include "Math/Point2D.hpp"
+
+#include <vector>
+
+#include <stdint.h>
+
+struct BulkPixelPoint;
+
+/**
+ * Collects solid primitives drawn by #Canvas and submits them with as
+ * few draw calls as possible.  Each vertex carries its own color, so
+ * primitives drawn with different pens and brushes share one draw
+ * call; only a change of the primitive type (triangles or lines) or
+ * of the line width ends a batch.
+ *
+ * Everything is converted to independent triangles or lines, so
+ * strips, fans and loops from different calls can be concatenated.
+ */
+class GLDrawBatch {
+  /**
+   * Flush automatically when this many vertices have been collected.
+   */
+  static constexpr unsigned MAX_VERTICES = 16384;
+
+  enum class Mode : uint8_t {
+    NONE,
+    TRIANGLES,
+    LINES,
+  };
+
+  Mode mode = Mode::NONE;
+
+  /**
+   * The line width of #Mode::LINES.
+   */
+  unsigned line_width;
+
+  std::vector<FloatPoint2D> vertices;
+  std::vector<Color> colors;
+
+public:
+  bool IsEmpty() const {
+    return vertices.empty();
+  }
+
+  /**
+   * Draw all collected primitives.  The caller is responsible for
+   * selecting the solid shader (if GLSL is used).
+   */
+  void Flush();
+
+  /**
+   * Add a filled rectangle.
+   */
+  void AddRectangle(int left, int top, int right, int bottom, Color color);
+
+  /**
+   * Add a list of triangles given by vertex indices (see
+   * PolygonToTriangles()).
+   */
+  void AddTriangles(const BulkPixelPoint *points,
+                    const GLushort *indices, unsigned n_indices,
+                    Color color);
+
+  void AddTriangleFan(const BulkPixelPoint *points, unsigned n,
+                      Color color);
+
+  void AddTriangleStrip(const BulkPixelPoint *points, unsigned n,
+                        Color color);
+
+  /**
+   * Add a filled circle, using the same number of vertices as
+   * Canvas::DrawCircle().
+   */
+  void AddCircle(int x, int y, unsigned radius, Color color);
+
+  /**
+   * Add a thin line strip.
+   *
+   * @param loop connect the last point with the first one
+   */
+  void AddLineStrip(const BulkPixelPoint *points, unsigned n, bool loop,
+                    unsigned width, Color color);
+
+  /**
+   * Add a thin circle outline.
+   */
+  void AddCircleOutline(int x, int y, unsigned radius,
+                        unsigned width, Color color);
+
+private:
+  /**
+   * Make room for #n more vertices of the specified kind, flushing
+   * the batch if it is incompatible or full.
+   */
+  void Prepare(Mode _mode, unsigned _line_width, unsigned n);
+
+  void Prepare(Mode _mode, unsigned n) {
+    Prepare(_mode, 0, n);
+  }
+
+  void Push(float x, float y, Color color) {
+    vertices.emplace_back(x, y);
+    colors.push_back(color);
+  }
+
+  template<typename P>
+  void Push(const P &p, Color color) {
+    Push(p.x, p.y, color);
+  }
+};
+
+#endif
@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "Canvas.hpp"
+#include "Batch.hpp"
 #include "Triangulate.hpp"
 #include "Globals.hpp"
 #include "Texture.hpp"
@@ -61,6 +62,50 @@ Copyright_License {
 
 AllocatedArray<BulkPixelPoint> Canvas::vertex_buffer;
 
+/**
+ * The batch used by the Canvas which has called BeginBatch().
+ */
+static GLDrawBatch shared_batch;
+
+void
+Canvas::BeginBatch()
+{
+  assert(batch == nullptr);
+  assert(shared_batch.IsEmpty());
+
+  batch = &shared_batch;
+}
+
+void
+Canvas::FlushBatch() const
+{
+  if (batch == nullptr || batch->IsEmpty())
+    return;
+
+#ifdef USE_GLSL
+  OpenGL::solid_shader->Use();
+#endif
+
+  batch->Flush();
+}
+
+void
+Canvas::EndBatch()
+{
+  FlushBatch();
+  batch = nullptr;
+}
+
+/**
+ * Can lines drawn with this pen be added to a #GLDrawBatch?
+ */
+gcc_pure
+static bool
+IsBatchable(const Pen &pen)
+{
+  return pen.IsDefined() && pen.IsSolid();
+}
+
 void
 Canvas::InvertRectangle(PixelRect r)
 {
@@ -71,6 +116,8 @@ Canvas::InvertRectangle(PixelRect r)
    *
    */
 
+  FlushBatch();
+
   glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_FALSE); // Make sure alpha channel is not damaged
 
   glEnable(GL_BLEND);
@@ -78,7 +125,7 @@ Canvas::InvertRectangle(PixelRect r)
 
   const Color cwhite(0xff, 0xff, 0xff); // Draw color white (source channel of blender)
 
-  DrawFilledRectangle(r, cwhite);
+  FillRectangleGL(r.left, r.top, r.right, r.bottom, cwhite);
 
   glDisable(GL_BLEND);
   glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
@@ -87,6 +134,18 @@ Canvas::InvertRectangle(PixelRect r)
 void
 Canvas::DrawFilledRectangle(int left, int top, int right, int bottom,
                             const Color color)
+{
+  if (batch != nullptr) {
+    batch->AddRectangle(left, top, right, bottom, color);
+    return;
+  }
+
+  FillRectangleGL(left, top, right, bottom, color);
+}
+
+void
+Canvas::FillRectangleGL(int left, int top, int right, int bottom,
+                        const Color color)
 {
 #ifdef USE_GLSL
   OpenGL::solid_shader->Use();
@@ -103,8 +162,9 @@ Canvas::DrawFilledRectangle(int left, int top, int right, int bottom,
   };
 
   const ScopeVertexPointer vp(vertices);
-  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  OpenGL::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 #else
+  ++OpenGL::draw_statistics.draw_calls;
   glRecti(left, top, right, bottom);
 #endif
 }
@@ -112,6 +172,8 @@ Canvas::DrawFilledRectangle(int left, int top, int right, int bottom,
 void
 Canvas::OutlineRectangleGL(int left, int top, int right, int bottom)
 {
+  FlushBatch();
+
   const ExactPixelPoint vertices[] = {
     PixelPoint{left, top},
     PixelPoint{right, top},
@@ -120,23 +182,27 @@ Canvas::OutlineRectangleGL(int left, int top, int right, int bottom)
   };
 
   const ScopeVertexPointer vp(vertices);
-  glDrawArrays(GL_LINE_LOOP, 0, 4);
+  OpenGL::DrawArrays(GL_LINE_LOOP, 0, 4);
 }
 
 void
 Canvas::FadeToWhite(GLubyte alpha)
 {
+  FlushBatch();
+
   const ScopeAlphaBlend alpha_blend;
   const Color color(0xff, 0xff, 0xff, alpha);
-  Clear(color);
+  FillRectangleGL(0, 0, GetWidth(), GetHeight(), color);
 }
 
 void
 Canvas::FadeToWhite(PixelRect rc, GLubyte alpha)
 {
+  FlushBatch();
+
   const ScopeAlphaBlend alpha_blend;
   const Color color(0xff, 0xff, 0xff, alpha);
-  DrawFilledRectangle(rc.left, rc.right, rc.right, rc.bottom, color);
+  FillRectangleGL(rc.left, rc.right, rc.right, rc.bottom, color);
 }
 
 void
@@ -161,6 +227,16 @@ Canvas::DrawRaisedEdge(PixelRect &rc)
 void
 Canvas::DrawPolyline(const BulkPixelPoint *points, unsigned num_points)
 {
+  if (batch != nullptr) {
+    if (IsBatchable(pen)) {
+      batch->AddLineStrip(points, num_points, false,
+                          pen.GetWidth(), pen.GetColor());
+      return;
+    }
+
+    FlushBatch();
+  }
+
 #ifdef USE_GLSL
   OpenGL::solid_shader->Use();
 #endif
@@ -168,7 +244,7 @@ Canvas::DrawPolyline(const BulkPixelPoint *points, unsigned num_points)
   pen.Bind();
 
   const ScopeVertexPointer vp(points);
-  glDrawArrays(GL_LINE_STRIP, 0, num_points);
+  OpenGL::DrawArrays(GL_LINE_STRIP, 0, num_points);
 
   pen.Unbind();
 }
@@ -179,6 +255,15 @@ Canvas::DrawPolygon(const BulkPixelPoint *points, unsigned num_points)
   if (brush.IsHollow() && !pen.IsDefined())
     return;
 
+  if (batch != nullptr) {
+    if (!IsPenOverBrush() || IsBatchable(pen)) {
+      BatchPolygon(points, num_points, false);
+      return;
+    }
+
+    FlushBatch();
+  }
+
 #ifdef USE_GLSL
   OpenGL::solid_shader->Use();
 #endif
@@ -192,7 +277,7 @@ Canvas::DrawPolygon(const BulkPixelPoint *points, unsigned num_points)
     unsigned idx_count = PolygonToTriangles(points, num_points,
                                             triangle_buffer);
     if (idx_count > 0)
-      glDrawElements(GL_TRIANGLES, idx_count, GL_UNSIGNED_SHORT,
+      OpenGL::DrawElements(GL_TRIANGLES, idx_count, GL_UNSIGNED_SHORT,
                      triangle_buffer.begin());
   }
 
@@ -200,13 +285,13 @@ Canvas::DrawPolygon(const BulkPixelPoint *points, unsigned num_points)
     pen.Bind();
 
     if (pen.GetWidth() <= 2) {
-      glDrawArrays(GL_LINE_LOOP, 0, num_points);
+      OpenGL::DrawArrays(GL_LINE_LOOP, 0, num_points);
     } else {
       unsigned vertices = LineToTriangles(points, num_points, vertex_buffer,
                                           pen.GetWidth(), true);
       if (vertices > 0) {
         vp.Update(vertex_buffer.begin());
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, vertices);
+        OpenGL::DrawArrays(GL_TRIANGLE_STRIP, 0, vertices);
       }
     }
 
@@ -214,12 +299,53 @@ Canvas::DrawPolygon(const BulkPixelPoint *points, unsigned num_points)
   }
 }
 
+void
+Canvas::BatchPolygon(const BulkPixelPoint *points, unsigned num_points,
+                     bool fan)
+{
+  assert(batch != nullptr);
+
+  if (!brush.IsHollow() && num_points >= 3) {
+    if (fan) {
+      batch->AddTriangleFan(points, num_points, brush.GetColor());
+    } else {
+      static AllocatedArray<GLushort> triangle_buffer;
+      unsigned idx_count = PolygonToTriangles(points, num_points,
+                                              triangle_buffer);
+      if (idx_count > 0)
+        batch->AddTriangles(points, triangle_buffer.begin(), idx_count,
+                            brush.GetColor());
+    }
+  }
+
+  if (IsPenOverBrush()) {
+    if (pen.GetWidth() <= 2) {
+      batch->AddLineStrip(points, num_points, true,
+                          pen.GetWidth(), pen.GetColor());
+    } else {
+      unsigned vertices = LineToTriangles(points, num_points, vertex_buffer,
+                                          pen.GetWidth(), true);
+      batch->AddTriangleStrip(vertex_buffer.begin(), vertices,
+                              pen.GetColor());
+    }
+  }
+}
+
 void
 Canvas::DrawTriangleFan(const BulkPixelPoint *points, unsigned num_points)
 {
   if (brush.IsHollow() && !pen.IsDefined())
     return;
 
+  if (batch != nullptr) {
+    if (!IsPenOverBrush() || IsBatchable(pen)) {
+      BatchPolygon(points, num_points, true);
+      return;
+    }
+
+    FlushBatch();
+  }
+
 #ifdef USE_GLSL
   OpenGL::solid_shader->Use();
 #endif
@@ -228,20 +354,20 @@ Canvas::DrawTriangleFan(const BulkPixelPoint *points, unsigned num_points)
 
   if (!brush.IsHollow() && num_points >= 3) {
     brush.Bind();
-    glDrawArrays(GL_TRIANGLE_FAN, 0, num_points);
+    OpenGL::DrawArrays(GL_TRIANGLE_FAN, 0, num_points);
   }
 
   if (IsPenOverBrush()) {
     pen.Bind();
 
     if (pen.GetWidth() <= 2) {
-      glDrawArrays(GL_LINE_LOOP, 0, num_points);
+      OpenGL::DrawArrays(GL_LINE_LOOP, 0, num_points);
     } else {
       unsigned vertices = LineToTriangles(points, num_points, vertex_buffer,
                                           pen.GetWidth(), true);
       if (vertices > 0) {
         vp.Update(vertex_buffer.begin());
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, vertices);
+        OpenGL::DrawArrays(GL_TRIANGLE_STRIP, 0, vertices);
       }
     }
 
@@ -252,6 +378,8 @@ Canvas::DrawTriangleFan(const BulkPixelPoint *points, unsigned num_points)
 void
 Canvas::DrawHLine(int x1, int x2, int y, Color color)
 {
+  FlushBatch();
+
   color.Bind();
 
   const BulkPixelPoint v[] = {
@@ -260,25 +388,35 @@ Canvas::DrawHLine(int x1, int x2, int y, Color color)
   };
 
   const ScopeVertexPointer vp(v);
-  glDrawArrays(GL_LINE_STRIP, 0, ARRAY_SIZE(v));
+  OpenGL::DrawArrays(GL_LINE_STRIP, 0, ARRAY_SIZE(v));
 }
 
 void
 Canvas::DrawLine(int ax, int ay, int bx, int by)
 {
+  const BulkPixelPoint v[] = {
+    { GLvalue(ax), GLvalue(ay) },
+    { GLvalue(bx), GLvalue(by) },
+  };
+
+  if (batch != nullptr) {
+    if (IsBatchable(pen)) {
+      batch->AddLineStrip(v, ARRAY_SIZE(v), false,
+                          pen.GetWidth(), pen.GetColor());
+      return;
+    }
+
+    FlushBatch();
+  }
+
 #ifdef USE_GLSL
   OpenGL::solid_shader->Use();
 #endif
 
   pen.Bind();
 
-  const BulkPixelPoint v[] = {
-    { GLvalue(ax), GLvalue(ay) },
-    { GLvalue(bx), GLvalue(by) },
-  };
-
   const ScopeVertexPointer vp(v);
-  glDrawArrays(GL_LINE_STRIP, 0, ARRAY_SIZE(v));
+  OpenGL::DrawArrays(GL_LINE_STRIP, 0, ARRAY_SIZE(v));
 
   pen.Unbind();
 }
@@ -286,6 +424,8 @@ Canvas::DrawLine(int ax, int ay, int bx, int by)
 void
 Canvas::DrawExactLine(int ax, int ay, int bx, int by)
 {
+  FlushBatch();
+
 #ifdef USE_GLSL
   OpenGL::solid_shader->Use();
 #endif
@@ -298,7 +438,7 @@ Canvas::DrawExactLine(int ax, int ay, int bx, int by)
   };
 
   const ScopeVertexPointer vp(v);
-  glDrawArrays(GL_LINE_STRIP, 0, ARRAY_SIZE(v));
+  OpenGL::DrawArrays(GL_LINE_STRIP, 0, ARRAY_SIZE(v));
 
   pen.Unbind();
 }
@@ -310,23 +450,38 @@ Canvas::DrawExactLine(int ax, int ay, int bx, int by)
 void
 Canvas::DrawLinePiece(const PixelPoint a, const PixelPoint b)
 {
+  const BulkPixelPoint v[] = { {a.x, a.y}, {b.x, b.y} };
+
+  if (batch != nullptr) {
+    if (IsBatchable(pen)) {
+      if (pen.GetWidth() > 2) {
+        unsigned strip_len = LineToTriangles(v, 2, vertex_buffer,
+                                             pen.GetWidth(), false, true);
+        batch->AddTriangleStrip(vertex_buffer.begin(), strip_len,
+                                pen.GetColor());
+      } else
+        batch->AddLineStrip(v, 2, false, pen.GetWidth(), pen.GetColor());
+      return;
+    }
+
+    FlushBatch();
+  }
+
 #ifdef USE_GLSL
   OpenGL::solid_shader->Use();
 #endif
 
   pen.Bind();
-
-  const BulkPixelPoint v[] = { {a.x, a.y}, {b.x, b.y} };
   if (pen.GetWidth() > 2) {
     unsigned strip_len = LineToTriangles(v, 2, vertex_buffer, pen.GetWidth(),
                                          false, true);
     if (strip_len > 0) {
       const ScopeVertexPointer vp(vertex_buffer.begin());
-      glDrawArrays(GL_TRIANGLE_STRIP, 0, strip_len);
+      OpenGL::DrawArrays(GL_TRIANGLE_STRIP, 0, strip_len);
     }
   } else {
     const ScopeVertexPointer vp(v);
-    glDrawArrays(GL_LINE_STRIP, 0, 2);
+    OpenGL::DrawArrays(GL_LINE_STRIP, 0, 2);
   }
 
   pen.Unbind();
@@ -335,20 +490,30 @@ Canvas::DrawLinePiece(const PixelPoint a, const PixelPoint b)
 void
 Canvas::DrawTwoLines(int ax, int ay, int bx, int by, int cx, int cy)
 {
-#ifdef USE_GLSL
-  OpenGL::solid_shader->Use();
-#endif
-
-  pen.Bind();
-
   const BulkPixelPoint v[] = {
     { GLvalue(ax), GLvalue(ay) },
     { GLvalue(bx), GLvalue(by) },
     { GLvalue(cx), GLvalue(cy) },
   };
 
+  if (batch != nullptr) {
+    if (IsBatchable(pen)) {
+      batch->AddLineStrip(v, ARRAY_SIZE(v), false,
+                          pen.GetWidth(), pen.GetColor());
+      return;
+    }
+
+    FlushBatch();
+  }
+
+#ifdef USE_GLSL
+  OpenGL::solid_shader->Use();
+#endif
+
+  pen.Bind();
+
   const ScopeVertexPointer vp(v);
-  glDrawArrays(GL_LINE_STRIP, 0, ARRAY_SIZE(v));
+  OpenGL::DrawArrays(GL_LINE_STRIP, 0, ARRAY_SIZE(v));
 
   pen.Unbind();
 }
@@ -356,6 +521,8 @@ Canvas::DrawTwoLines(int ax, int ay, int bx, int by, int cx, int cy)
 void
 Canvas::DrawTwoLinesExact(int ax, int ay, int bx, int by, int cx, int cy)
 {
+  FlushBatch();
+
 #ifdef USE_GLSL
   OpenGL::solid_shader->Use();
 #endif
@@ -369,7 +536,7 @@ Canvas::DrawTwoLinesExact(int ax, int ay, int bx, int by, int cx, int cy)
   };
 
   const ScopeVertexPointer vp(v);
-  glDrawArrays(GL_LINE_STRIP, 0, ARRAY_SIZE(v));
+  OpenGL::DrawArrays(GL_LINE_STRIP, 0, ARRAY_SIZE(v));
 
   pen.Unbind();
 }
@@ -377,6 +544,21 @@ Canvas::DrawTwoLinesExact(int ax, int ay, int bx, int by, int cx, int cy)
 void
 Canvas::DrawCircle(int x, int y, unsigned radius)
 {
+  if (batch != nullptr) {
+    if (!IsPenOverBrush() ||
+        (IsBatchable(pen) && pen.GetWidth() <= 2)) {
+      if (!brush.IsHollow())
+        batch->AddCircle(x, y, radius, brush.GetColor());
+
+      if (IsPenOverBrush())
+        batch->AddCircleOutline(x, y, radius,
+                                pen.GetWidth(), pen.GetColor());
+      return;
+    }
+
+    FlushBatch();
+  }
+
 #ifdef USE_GLSL
   OpenGL::solid_shader->Use();
 #endif
@@ -389,11 +571,11 @@ Canvas::DrawCircle(int x, int y, unsigned radius)
     if (!brush.IsHollow()) {
       vertices.BindInnerCircle(vp);
       brush.Bind();
-      glDrawArrays(GL_TRIANGLE_FAN, 0, vertices.CIRCLE_SIZE);
+      OpenGL::DrawArrays(GL_TRIANGLE_FAN, 0, vertices.CIRCLE_SIZE);
     }
     vertices.Bind(vp);
     pen.Bind();
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, vertices.SIZE);
+    OpenGL::DrawArrays(GL_TRIANGLE_STRIP, 0, vertices.SIZE);
     pen.Unbind();
   } else {
     GLFallbackArrayBuffer &buffer = radius < 16
@@ -427,12 +609,12 @@ Canvas::DrawCircle(int x, int y, unsigned radius)
 
     if (!brush.IsHollow()) {
       brush.Bind();
-      glDrawArrays(GL_TRIANGLE_FAN, 0, n);
+      OpenGL::DrawArrays(GL_TRIANGLE_FAN, 0, n);
     }
 
     if (IsPenOverBrush()) {
       pen.Bind();
-      glDrawArrays(GL_LINE_LOOP, 0, n);
+      OpenGL::DrawArrays(GL_LINE_LOOP, 0, n);
       pen.Unbind();
     }
 
@@ -512,6 +694,8 @@ Canvas::DrawAnnulus(PixelPoint center,
     return;
   }
 
+  FlushBatch();
+
   ScopeVertexPointer vp;
   GLDonutVertices vertices(center.x, center.y, small_radius, big_radius);
 
@@ -524,11 +708,11 @@ Canvas::DrawAnnulus(PixelPoint center,
     vertices.Bind(vp);
 
     if (istart > iend) {
-      glDrawArrays(GL_TRIANGLE_STRIP, istart,
+      OpenGL::DrawArrays(GL_TRIANGLE_STRIP, istart,
                    GLDonutVertices::MAX_ANGLE - istart + 2);
-      glDrawArrays(GL_TRIANGLE_STRIP, 0, iend + 2);
+      OpenGL::DrawArrays(GL_TRIANGLE_STRIP, 0, iend + 2);
     } else {
-      glDrawArrays(GL_TRIANGLE_STRIP, istart, iend - istart + 2);
+      OpenGL::DrawArrays(GL_TRIANGLE_STRIP, istart, iend - istart + 2);
     }
   }
 
@@ -539,8 +723,8 @@ Canvas::DrawAnnulus(PixelPoint center,
       if (brush.IsHollow())
         vertices.Bind(vp);
 
-      glDrawArrays(GL_LINE_STRIP, istart, 2);
-      glDrawArrays(GL_LINE_STRIP, iend, 2);
+      OpenGL::DrawArrays(GL_LINE_STRIP, istart, 2);
+      OpenGL::DrawArrays(GL_LINE_STRIP, iend, 2);
     }
 
     const unsigned pstart = istart / 2;
@@ -548,20 +732,20 @@ Canvas::DrawAnnulus(PixelPoint center,
 
     vertices.BindInnerCircle(vp);
     if (pstart < pend) {
-      glDrawArrays(GL_LINE_STRIP, pstart, pend - pstart + 1);
+      OpenGL::DrawArrays(GL_LINE_STRIP, pstart, pend - pstart + 1);
     } else {
-      glDrawArrays(GL_LINE_STRIP, pstart,
+      OpenGL::DrawArrays(GL_LINE_STRIP, pstart,
                    GLDonutVertices::CIRCLE_SIZE - pstart + 1);
-      glDrawArrays(GL_LINE_STRIP, 0, pend + 1);
+      OpenGL::DrawArrays(GL_LINE_STRIP, 0, pend + 1);
     }
 
     vertices.BindOuterCircle(vp);
     if (pstart < pend) {
-      glDrawArrays(GL_LINE_STRIP, pstart, pend - pstart + 1);
+      OpenGL::DrawArrays(GL_LINE_STRIP, pstart, pend - pstart + 1);
     } else {
-      glDrawArrays(GL_LINE_STRIP, pstart,
+      OpenGL::DrawArrays(GL_LINE_STRIP, pstart,
                    GLDonutVertices::CIRCLE_SIZE - pstart + 1);
-      glDrawArrays(GL_LINE_STRIP, 0, pend + 1);
+      OpenGL::DrawArrays(GL_LINE_STRIP, 0, pend + 1);
     }
 
     pen.Unbind();
@@ -643,6 +827,8 @@ PrepareColoredAlphaTexture(Color color)
 void
 Canvas::DrawText(int x, int y, const TCHAR *text)
 {
+  FlushBatch();
+
   assert(text != nullptr);
 #ifdef UNICODE
   const WideToUTF8Converter text2(text);
@@ -663,9 +849,9 @@ Canvas::DrawText(int x, int y, const TCHAR *text)
     return;
 
   if (background_mode == OPAQUE)
-    DrawFilledRectangle(x, y,
-                        x + texture->GetWidth(), y + texture->GetHeight(),
-                        background_color);
+    FillRectangleGL(x, y,
+                    x + texture->GetWidth(), y + texture->GetHeight(),
+                    background_color);
 
   PrepareColoredAlphaTexture(text_color);
 
@@ -682,6 +868,8 @@ Canvas::DrawText(int x, int y, const TCHAR *text)
 void
 Canvas::DrawTransparentText(int x, int y, const TCHAR *text)
 {
+  FlushBatch();
+
   assert(text != nullptr);
 #ifdef UNICODE
   const WideToUTF8Converter text2(text);
@@ -718,6 +906,8 @@ Canvas::DrawClippedText(int x, int y,
                         unsigned width, unsigned height,
                         const TCHAR *text)
 {
+  FlushBatch();
+
   assert(text != nullptr);
 #ifdef UNICODE
   const WideToUTF8Converter text2(text);
@@ -762,6 +952,8 @@ Canvas::Stretch(int dest_x, int dest_y,
                 int src_x, int src_y,
                 unsigned src_width, unsigned src_height)
 {
+  FlushBatch();
+
 #ifdef HAVE_GLES
   assert(offset == OpenGL::translate);
 #endif
@@ -803,6 +995,8 @@ Canvas::Copy(const Bitmap &src)
 void
 Canvas::StretchNot(const Bitmap &src)
 {
+  FlushBatch();
+
   assert(src.IsDefined());
 
 #ifdef USE_GLSL
@@ -834,6 +1028,8 @@ Canvas::Stretch(int dest_x, int dest_y,
                 const Bitmap &src, int src_x, int src_y,
                 unsigned src_width, unsigned src_height)
 {
+  FlushBatch();
+
 #ifdef HAVE_GLES
   assert(offset == OpenGL::translate);
 #endif
@@ -859,6 +1055,8 @@ Canvas::Stretch(int dest_x, int dest_y,
                 unsigned dest_width, unsigned dest_height,
                 const Bitmap &src)
 {
+  FlushBatch();
+
 #ifdef HAVE_GLES
   assert(offset == OpenGL::translate);
 #endif
@@ -887,6 +1085,8 @@ Canvas::StretchMono(int dest_x, int dest_y,
                     unsigned src_width, unsigned src_height,
                     Color fg_color, Color bg_color)
 {
+  FlushBatch();
+
   /* note that this implementation ignores the background color; it is
      not mandatory, and we can assume that the background is already
      set; it is only being passed to this function because the GDI
@@ -926,6 +1126,8 @@ Canvas::StretchMono(int dest_x, int dest_y,
 void
 Canvas::CopyToTexture(GLTexture &texture, PixelRect src_rc) const
 {
+  FlushBatch();
+
 #ifdef HAVE_GLES
   assert(offset == OpenGL::translate);
 #endif
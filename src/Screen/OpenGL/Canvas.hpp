@@ -55,6 +55,7 @@ Copyright_License {
 class Angle;
 class Bitmap;
 class GLTexture;
+class GLDrawBatch;
 template<class T> class AllocatedArray;
 
 /**
@@ -82,6 +83,13 @@ protected:
    */
   static AllocatedArray<BulkPixelPoint> vertex_buffer;
 
+  /**
+   * If not nullptr, then batching is enabled, and solid primitives
+   * are collected here instead of being drawn immediately.  See
+   * BeginBatch().
+   */
+  GLDrawBatch *batch = nullptr;
+
 public:
   Canvas() = default;
   Canvas(PixelSize _size):size(_size) {}
@@ -93,7 +101,47 @@ public:
     size = _size;
   }
 
+  /**
+   * Enable batching: lines, polygons, triangle fans, filled
+   * rectangles and circles drawn with a solid pen/brush are collected
+   * and submitted with as few draw calls as possible by
+   * FlushBatch() or EndBatch().  All other drawing methods flush the
+   * batch first.
+   *
+   * While batching, the caller must not modify OpenGL state
+   * (blending, scissor, stencil, translation) directly without
+   * calling FlushBatch() first.  Only one Canvas may batch at a time.
+   */
+  void BeginBatch();
+
+  /**
+   * Draw all primitives collected so far.  No-op if batching is
+   * disabled.
+   */
+  void FlushBatch() const;
+
+  /**
+   * Flush and disable batching.
+   */
+  void EndBatch();
+
+  bool IsBatching() const {
+    return batch != nullptr;
+  }
+
 protected:
+  /**
+   * Draw a filled rectangle immediately, bypassing the batch.
+   */
+  void FillRectangleGL(int left, int top, int right, int bottom,
+                       const Color color);
+
+  /**
+   * Add a polygon or triangle fan to the batch.
+   */
+  void BatchPolygon(const BulkPixelPoint *points, unsigned num_points,
+                    bool fan);
+
   /**
    * Returns true if the outline should be drawn after the area has
    * been filled.  As an optimization, this function returns false if
@@ -221,6 +269,7 @@ public:
   void OutlineRectangleGL(int left, int top, int right, int bottom);
 
   void DrawOutlineRectangle(int left, int top, int right, int bottom) {
+    FlushBatch();
     pen.Bind();
     OutlineRectangleGL(left, top, right, bottom);
     pen.Unbind();
@@ -228,6 +277,7 @@ public:
 
   void DrawOutlineRectangle(int left, int top, int right, int bottom,
                             Color color) {
+    FlushBatch();
     color.Bind();
 #if defined(HAVE_GLES) && !defined(HAVE_GLES2)
     glLineWidthx(1 << 16);
@@ -452,4 +502,24 @@ public:
   void CopyToTexture(GLTexture &texture, PixelRect src_rc) const;
 };
 
+/**
+ * Enables batching (see Canvas::BeginBatch()) for the lifetime of
+ * this object.
+ */
+class ScopeCanvasBatch {
+  Canvas &canvas;
+
+public:
+  explicit ScopeCanvasBatch(Canvas &_canvas):canvas(_canvas) {
+    canvas.BeginBatch();
+  }
+
+  ~ScopeCanvasBatch() {
+    canvas.EndBatch();
+  }
+
+  ScopeCanvasBatch(const ScopeCanvasBatch &) = delete;
+  ScopeCanvasBatch &operator=(const ScopeCanvasBatch &) = delete;
+};
+
 #endif
@@ -56,6 +56,8 @@ namespace OpenGL {
   glm::mat4 projection_matrix;
 #endif
 
+  DrawStatistics draw_statistics, frame_draw_statistics;
+
 #ifndef NDEBUG
   pthread_t thread;
 #endif
@@ -125,6 +125,64 @@ namespace OpenGL {
 #ifdef USE_GLSL
   extern glm::mat4 projection_matrix;
 #endif
+
+  /**
+   * Counters for the drawing done by #Canvas and #GLTexture.
+   */
+  struct DrawStatistics {
+    /**
+     * The number of glDrawArrays()/glDrawElements() calls.
+     */
+    unsigned draw_calls;
+
+    /**
+     * The number of primitives collected by #GLDrawBatch.  Each of
+     * them would have been at least one draw call without batching.
+     */
+    unsigned batched_primitives;
+  };
+
+  /**
+   * The counters of the frame currently being drawn.
+   */
+  extern DrawStatistics draw_statistics;
+
+  /**
+   * The counters of the last complete frame.
+   */
+  extern DrawStatistics frame_draw_statistics;
+
+  /**
+   * Move #draw_statistics to #frame_draw_statistics and reset it.
+   * Called by TopCanvas::Flip().
+   */
+  static inline void
+  FinishFrameStatistics()
+  {
+    frame_draw_statistics = draw_statistics;
+    draw_statistics = DrawStatistics();
+  }
+
+  /**
+   * Wrapper for glDrawArrays() which updates #draw_statistics.
+   */
+  static inline void
+  DrawArrays(GLenum mode, GLint first, GLsizei count)
+  {
+    ++draw_statistics.draw_calls;
+    glDrawArrays(mode, first, count);
+  }
+
+  /**
+   * Wrapper for glDrawElements() which updates #draw_statistics.
+   */
+  static inline void
+  DrawElements(GLenum mode, GLsizei count, GLenum type,
+               const GLvoid *indices)
+  {
+    ++draw_statistics.draw_calls;
+    glDrawElements(mode, count, type, indices);
+  }
 };
 
 #endif
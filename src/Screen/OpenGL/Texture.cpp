@@ -185,6 +185,7 @@ GLTexture::DrawOES(PixelRect dest, PixelRect src) const
 
   /* glDrawTexiOES() circumvents the projection settings, thus we must
      roll our own translation */
+  ++OpenGL::draw_statistics.draw_calls;
   glDrawTexiOES(OpenGL::translate.x + dest.left,
                 OpenGL::viewport_size.y - OpenGL::translate.y - dest.bottom,
                 0, dest.GetWidth(), dest.GetHeight());
@@ -233,7 +234,7 @@ GLTexture::Draw(PixelRect dest, PixelRect src) const
   glTexCoordPointer(2, GL_FLOAT, 0, coord);
 #endif
 
-  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  OpenGL::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
 #ifdef USE_GLSL
   glDisableVertexAttribArray(OpenGL::Attribute::TEXCOORD);
@@ -254,6 +255,7 @@ GLTexture::DrawFlippedOES(PixelRect dest, PixelRect src) const
 
   /* glDrawTexiOES() circumvents the projection settings, thus we must
      roll our own translation */
+  ++OpenGL::draw_statistics.draw_calls;
   glDrawTexiOES(OpenGL::translate.x + dest.left,
                 OpenGL::viewport_size.y - OpenGL::translate.y - dest.bottom,
                 0, dest.GetWidth(), dest.GetHeight());
@@ -302,7 +304,7 @@ GLTexture::DrawFlipped(PixelRect dest, PixelRect src) const
   glTexCoordPointer(2, GL_FLOAT, 0, coord);
 #endif
 
-  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  OpenGL::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
 #ifdef USE_GLSL
   glDisableVertexAttribArray(OpenGL::Attribute::TEXCOORD);
@@ -232,6 +232,17 @@ public:
     if ((style == DASH1) || (style == DASH2) || (style == DASH3)) {
       glDisable(GL_LINE_STIPPLE);
     }
+#endif
+  }
+
+  /**
+   * Does this pen draw solid lines, i.e. without glLineStipple()?
+   */
+  bool IsSolid() const {
+#ifdef HAVE_GLES
+    return true;
+#else
+    return style != DASH1 && style != DASH2 && style != DASH3;
 #endif
   }
 #endif /* OPENGL */
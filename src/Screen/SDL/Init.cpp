@@ -30,6 +30,8 @@ Copyright_License {
 
 #ifdef ENABLE_OPENGL
 #include "Screen/OpenGL/Init.hpp"
+#else
+#include "Screen/Canvas.hpp"
 #endif
 
 #include <SDL.h>
@@ -84,6 +86,8 @@ ScreenGlobalInit::~ScreenGlobalInit()
 
 #ifdef ENABLE_OPENGL
   OpenGL::Deinitialise();
+#else
+  Canvas::Deinitialise();
 #endif
 
   Font::Deinitialise();
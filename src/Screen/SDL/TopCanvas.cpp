@@ -28,6 +28,7 @@ Copyright_License {
 
 #ifdef ENABLE_OPENGL
 #include "Screen/OpenGL/Init.hpp"
+#include "Screen/OpenGL/Globals.hpp"
 #include "Screen/OpenGL/Features.hpp"
 #include "Math/Point2D.hpp"
 #else
@@ -280,6 +281,8 @@ TopCanvas::Flip()
 {
 #ifdef ENABLE_OPENGL
   ::SDL_GL_SwapWindow(window);
+
+  OpenGL::FinishFrameStatistics();
 #else
 
 #ifdef GREYSCALE
@@ -57,6 +57,10 @@ enum class DisplayOrientation : uint8_t;
 class TopCanvas;
 #endif
 
+#ifdef USE_FB
+struct FlipStatistics;
+#endif
+
 #ifdef USE_X11
 #define Font X11Font
 #define Window X11Window
@@ -218,6 +222,15 @@ public:
   void CheckResize() {}
 #endif
 
+#ifdef USE_FB
+  /**
+   * Obtain a snapshot of the TopCanvas::Flip() statistics.  This
+   * method is thread-safe.
+   */
+  gcc_pure
+  FlipStatistics GetFlipStatistics() const;
+#endif
+
 #if !defined(USE_WINUSER) && !defined(ENABLE_SDL)
 #if defined(ANDROID) || defined(USE_FB) || defined(USE_EGL) || defined(USE_GLX) || defined(USE_VFB)
   void SetCaption(gcc_unused const TCHAR *caption) {}
@@ -265,6 +278,10 @@ public:
 #ifndef USE_WINUSER
   void Invalidate() override;
 
+#ifdef USE_FB
+  void InvalidateArea(const PixelRect &rc) override;
+#endif
+
 protected:
   void Expose();
 
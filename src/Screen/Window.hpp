@@ -336,6 +336,9 @@ public:
     AssertThread();
 
 #ifndef USE_WINUSER
+    /* the old location needs to be redrawn as well */
+    Invalidate();
+
     position = { left, top };
     Invalidate();
 #else
@@ -420,6 +423,9 @@ public:
     if (width == GetWidth() && height == GetHeight())
       return;
 
+    /* the old area needs to be redrawn if the window shrinks */
+    Invalidate();
+
     size = { width, height };
 
     Invalidate();
@@ -806,6 +812,13 @@ public:
 
 #ifndef USE_WINUSER
   virtual void Invalidate();
+
+  /**
+   * Like Invalidate(), but only the specified rectangle (relative to
+   * this window) has changed.  Platforms which can update parts of
+   * the screen use this to limit the area they copy to the display.
+   */
+  virtual void InvalidateArea(const PixelRect &rc);
 #else /* USE_WINUSER */
   HDC BeginPaint(PAINTSTRUCT *ps) {
     AssertThread();
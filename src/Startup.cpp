@@ -260,6 +260,14 @@ Startup()
   if (!LoadProfile())
     return false;
 
+#ifdef HAVE_DOWNLOAD_MANAGER
+  if (Net::DownloadManager::IsAvailable()) {
+    unsigned limit = 0;
+    Profile::Get(ProfileKeys::DownloadBandwidthLimit, limit);
+    Net::DownloadManager::SetBandwidthLimit(limit * 1024);
+  }
+#endif
+
   operation.SetText(_("Initialising"));
 
   /* create XCSoarData on the first start */
@@ -335,7 +343,7 @@ Startup()
   LoadConfiguredTopography(*topography, operation);
 
   // Read the waypoint files
-  WaypointGlue::LoadWaypoints(way_points, terrain, operation);
+  WaypointGlue::LoadWaypoints(way_points, terrain, file_cache, operation);
 
   // Read and parse the airfield info file
   WaypointDetails::ReadFileFromProfile(way_points, operation);
@@ -357,7 +365,7 @@ Startup()
 
   // Reads the airspace files
   ReadAirspace(airspace_database, terrain, computer_settings.pressure,
-               operation);
+               file_cache, operation);
 
   {
     const AircraftState aircraft_state =
@@ -527,7 +535,7 @@ Shutdown()
 
   // Save settings to profile
   operation.SetText(_("Shutdown, saving profile..."));
-  Profile::Save();
+  Profile::Compact();
 
   operation.SetText(_("Shutdown, please wait..."));
 
@@ -22,15 +22,11 @@
 
 #include "LoadFile.hpp"
 #include "Deserialiser.hpp"
-#include "XML/Node.hpp"
-#include "XML/DataNodeXML.hpp"
+#include "XML/DataNodeInSitu.hpp"
 #include "XML/Parser.hpp"
 #include "Engine/Task/Ordered/OrderedTask.hpp"
 #include "OS/Path.hpp"
-#include "Util/StringUtil.hpp"
-#include "Util/StringAPI.hxx"
-
-#include <memory>
+#include "Util/tstring.hpp"
 
 #include <tchar.h>
 
@@ -38,17 +34,18 @@ OrderedTask *
 LoadTask(Path path, const TaskBehaviour &task_behaviour,
          const Waypoints *waypoints)
 {
-  // Load root node
-  std::unique_ptr<XMLNode> xml_root(XML::ParseFile(path));
-  if (!xml_root)
+  tstring buffer;
+  if (!XML::ReadFile(path, buffer))
     return nullptr;
 
-  const ConstDataNodeXML root(*xml_root);
-
-  // Check if root node is a <Task> node
-  if (!StringIsEqual(root.GetName(), _T("Task")))
+  /* parse in place, without building a DOM; this fails early if
+     the root node is not a <Task> node */
+  XMLInSituTree tree;
+  if (!tree.Parse(&buffer[0], _T("Task")))
     return nullptr;
 
+  const ConstDataNodeInSitu root(tree);
+
   // Create a blank task
   OrderedTask *task = new OrderedTask(task_behaviour);
 
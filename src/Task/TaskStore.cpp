@@ -24,68 +24,237 @@ Copyright_License {
 #include "Task/TaskStore.hpp"
 #include "Task/TaskFile.hpp"
 #include "Engine/Task/Ordered/OrderedTask.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
 #include "Components.hpp"
+#include "Thread/Thread.hpp"
 #include "OS/FileUtil.hpp"
 #include "OS/Path.hpp"
+#include "OS/SystemLoad.hpp"
 #include "LocalPath.hpp"
 #include "Language/Language.hpp"
 
 #include <algorithm>
 #include <memory>
+#include <map>
+
+#include <stdint.h>
+
+namespace {
+
+/**
+ * The parsed contents of one task file, remembered across Scan()
+ * calls (and across #TaskStore instances).
+ */
+struct CachedFile {
+  uint64_t mtime, size;
+
+  struct Task {
+    tstring name;
+    unsigned index;
+    bool has_summary;
+    TaskStore::Summary summary;
+  };
+
+  std::vector<Task> tasks;
+
+  gcc_pure
+  bool IsUpToDate(uint64_t _mtime, uint64_t _size) const {
+    return mtime == _mtime && size == _size;
+  }
+};
+
+}
+
+static Mutex cache_mutex;
+static std::map<tstring, CachedFile> cache;
+
+/**
+ * Look up the file in the cache, and append its tasks to the
+ * specified vector.
+ *
+ * @return false if the file is not in the cache or has been modified
+ */
+static bool
+LookupCache(Path path, TaskStore::ItemVector &dest)
+{
+  const uint64_t mtime = File::GetLastModification(path);
+  const uint64_t size = File::GetSize(path);
+
+  const ScopeLock protect(cache_mutex);
+
+  auto i = cache.find(path.c_str());
+  if (i == cache.end())
+    return false;
+
+  if (!i->second.IsUpToDate(mtime, size)) {
+    cache.erase(i);
+    return false;
+  }
+
+  for (const auto &task : i->second.tasks) {
+    dest.emplace_back(path, task.name.c_str(), task.index);
+    dest.back().has_summary = task.has_summary;
+    dest.back().summary = task.summary;
+  }
+
+  return true;
+}
+
+static void
+StoreCache(Path path, uint64_t mtime, uint64_t size,
+           const TaskStore::ItemVector &items)
+{
+  CachedFile file;
+  file.mtime = mtime;
+  file.size = size;
+
+  file.tasks.reserve(items.size());
+  for (const auto &item : items)
+    file.tasks.push_back({item.task_name, item.task_index,
+                          item.has_summary, item.summary});
+
+  const ScopeLock protect(cache_mutex);
+  cache[path.c_str()] = std::move(file);
+}
 
 class TaskFileVisitor: public File::Visitor
 {
 private:
   TaskStore::ItemVector &store;
+  std::list<AllocatedPath> &queue;
 
 public:
-  TaskFileVisitor(TaskStore::ItemVector &_store):
-    store(_store) {}
+  TaskFileVisitor(TaskStore::ItemVector &_store,
+                  std::list<AllocatedPath> &_queue):
+    store(_store), queue(_queue) {}
 
   void Visit(Path path, Path base_name) override {
-    // Create a TaskFile instance to determine how many
-    // tasks are inside of this task file
-    std::unique_ptr<TaskFile> task_file(TaskFile::Create(path));
-    if (!task_file)
-      return;
-
-    // Count the tasks in the task file
-    unsigned count = task_file->Count();
-    // For each task in the task file
-    for (unsigned i = 0; i < count; i++) {
-      // Copy base name of the file into task name
-      StaticString<256> name(base_name.c_str());
-
-      // If the task file holds more than one task
-      const TCHAR *saved_name = task_file->GetName(i);
-      if (saved_name != nullptr) {
-        name += _T(": ");
-        name += saved_name;
-      } else if (count > 1) {
-        // .. append " - Task #[n]" suffix to the task name
-        name.AppendFormat(_T(": %s #%d"), _("Task"), i + 1);
-      }
-
-      // Add the task to the TaskStore
-      store.emplace_back(path, name.empty() ? path.c_str() : name, i);
-    }
+    if (!LookupCache(path, store))
+      queue.emplace_back(path);
   }
 };
 
+class TaskStore::Worker final : public Thread {
+  TaskStore &store;
+
+public:
+  explicit Worker(TaskStore &_store)
+    :Thread("TaskStore"), store(_store) {}
+
+protected:
+  /* virtual methods from class Thread */
+  void Run() override {
+    SetIdlePriority();
+    store.Run();
+  }
+};
+
+TaskStore::TaskStore() = default;
+
+TaskStore::~TaskStore()
+{
+  {
+    const ScopeLock protect(mutex);
+    stop = true;
+    cond.broadcast();
+  }
+
+  for (auto &worker : workers)
+    worker->Join();
+}
+
+TaskStore::ItemVector
+TaskStore::LoadFile(Path path, const TaskBehaviour &task_behaviour)
+{
+  ItemVector items;
+
+  // Create a TaskFile instance to determine how many
+  // tasks are inside of this task file
+  std::unique_ptr<TaskFile> task_file(TaskFile::Create(path));
+  if (!task_file)
+    return items;
+
+  const Path base_name = path.GetBase();
+
+  /* the global waypoint database must not be accessed from this
+     thread; the task files contain all the waypoints needed for the
+     summary */
+  const Waypoints no_waypoints;
+
+  // Count the tasks in the task file
+  unsigned count = task_file->Count();
+  // For each task in the task file
+  for (unsigned i = 0; i < count; i++) {
+    // Copy base name of the file into task name
+    StaticString<256> name(base_name.c_str());
+
+    // If the task file holds more than one task
+    const TCHAR *saved_name = task_file->GetName(i);
+    if (saved_name != nullptr) {
+      name += _T(": ");
+      name += saved_name;
+    } else if (count > 1) {
+      // .. append " - Task #[n]" suffix to the task name
+      name.AppendFormat(_T(": %s #%d"), _("Task"), i + 1);
+    }
+
+    items.emplace_back(path, name.empty() ? path.c_str() : name, i);
+    Item &item = items.back();
+
+    std::unique_ptr<OrderedTask> task(task_file->GetTask(task_behaviour,
+                                                         &no_waypoints, i));
+    if (task) {
+      task->UpdateGeometry();
+
+      item.has_summary = true;
+      item.summary.distance = task->GetStats().distance_nominal;
+      item.summary.type = task->GetFactoryType();
+      item.summary.valid = task->CheckTask();
+    }
+  }
+
+  return items;
+}
+
+void
+TaskStore::StartWorkers()
+{
+  const unsigned n_threads = std::min(SystemCPUCount(), MAX_THREADS);
+  workers.reserve(n_threads);
+
+  for (unsigned i = 0; i < n_threads; ++i) {
+    workers.emplace_back(new Worker(*this));
+    if (!workers.back()->Start()) {
+      workers.pop_back();
+      break;
+    }
+  }
+}
+
 void
 TaskStore::Clear()
 {
+  {
+    const ScopeLock protect(mutex);
+    ++generation;
+    queue.clear();
+    pending.clear();
+  }
+
+  ClearNotification();
+
   // clear entries first
   store.erase(store.begin(), store.end());
 }
 
 void
-TaskStore::Scan(bool extra)
+TaskStore::Scan(const TaskBehaviour &_task_behaviour, bool extra)
 {
   Clear();
 
   // scan files
-  TaskFileVisitor tfv(store);
+  std::list<AllocatedPath> files;
+  TaskFileVisitor tfv(store, files);
   VisitDataFiles(_T("*.tsk"), tfv);
 
   if (extra) {
@@ -94,6 +263,102 @@ TaskStore::Scan(bool extra)
   }
 
   std::sort(store.begin(), store.end());
+
+  if (files.empty())
+    return;
+
+  if (workers.empty())
+    StartWorkers();
+
+  if (workers.empty()) {
+    /* no threads available: fall back to parsing everything right
+       here */
+    for (const auto &path : files) {
+      for (auto &item : LoadFile(path, _task_behaviour))
+        store.emplace_back(std::move(item));
+    }
+
+    std::sort(store.begin(), store.end());
+    return;
+  }
+
+  const ScopeLock protect(mutex);
+  task_behaviour = _task_behaviour;
+  queue = std::move(files);
+  cond.broadcast();
+}
+
+bool
+TaskStore::IsBusy() const
+{
+  const ScopeLock protect(mutex);
+  return !queue.empty() || busy > 0 || !pending.empty();
+}
+
+void
+TaskStore::Run()
+{
+  const ScopeLock protect(mutex);
+
+  while (!stop) {
+    if (queue.empty()) {
+      cond.wait(mutex);
+      continue;
+    }
+
+    const AllocatedPath path = std::move(queue.front());
+    queue.pop_front();
+
+    const unsigned my_generation = generation;
+    const TaskBehaviour my_task_behaviour = task_behaviour;
+    ++busy;
+
+    ItemVector items;
+
+    {
+      const ScopeUnlock unlock(mutex);
+
+      const uint64_t mtime = File::GetLastModification(path);
+      const uint64_t size = File::GetSize(path);
+      items = LoadFile(path, my_task_behaviour);
+      StoreCache(path, mtime, size, items);
+    }
+
+    --busy;
+
+    if (generation != my_generation)
+      continue;
+
+    for (auto &item : items)
+      pending.emplace_back(std::move(item));
+
+    /* notify the listener about the new items, and about the end of
+       the scan, even if the last file contained no task */
+    if (!items.empty() || (queue.empty() && busy == 0))
+      SendNotification();
+  }
+}
+
+void
+TaskStore::OnNotification()
+{
+  ItemVector items;
+
+  {
+    const ScopeLock protect(mutex);
+    items = std::move(pending);
+    pending.clear();
+  }
+
+  const auto middle = store.size();
+  for (auto &item : items)
+    store.emplace_back(std::move(item));
+
+  std::sort(store.begin() + middle, store.end());
+  std::inplace_merge(store.begin(), store.begin() + middle, store.end());
+
+  if (listener != nullptr)
+    listener->OnTaskStoreChanged();
 }
 
 TaskStore::Item::~Item()
@@ -27,18 +27,53 @@ Copyright_License {
 #include "Compiler.h"
 #include "OS/Path.hpp"
 #include "Util/tstring.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "Engine/Task/Factory/TaskFactoryType.hpp"
+#include "Event/Notify.hpp"
+#include "Thread/Mutex.hpp"
+#include "Thread/Cond.hxx"
 
+#include <memory>
+#include <list>
 #include <vector>
 
-struct TaskBehaviour;
 class OrderedTask;
 
 /**
- * Class to load multiple tasks on demand, e.g. for browsing
+ * Class to load multiple tasks on demand, e.g. for browsing.
+ *
+ * Scan() only lists the task files; they are parsed by background
+ * threads, which add the tasks found in them to the store (with a
+ * short #Summary) one file at a time.  The #Listener is notified in
+ * the main thread whenever the list has changed.  Summaries are
+ * cached by file name, modification time and size, so scanning the
+ * same directory again is cheap.
  */
-class TaskStore 
+class TaskStore final : private Notify
 {
 public:
+  /**
+   * The maximum number of background threads.
+   */
+  static constexpr unsigned MAX_THREADS = 4;
+
+  /**
+   * A few attributes of a task which are cheap to display in a list.
+   */
+  struct Summary {
+    /**
+     * The nominal distance [m].
+     */
+    double distance;
+
+    TaskFactoryType type;
+
+    /**
+     * Did OrderedTask::CheckTask() succeed?
+     */
+    bool valid;
+  };
+
   struct Item
   {
     tstring task_name;
@@ -47,6 +82,14 @@ public:
     OrderedTask* task;
     bool valid;
 
+    /**
+     * Is #summary initialised?  It is not if the task could not be
+     * loaded.
+     */
+    bool has_summary;
+
+    Summary summary;
+
     Item(Path the_filename,
          tstring::const_pointer _task_name,
          unsigned _task_index = 0)
@@ -54,7 +97,8 @@ public:
        filename(the_filename),
        task_index(_task_index),
        task(nullptr),
-       valid(true) {}
+       valid(true),
+       has_summary(false) {}
 
     ~Item();
 
@@ -81,26 +125,101 @@ public:
 
   typedef std::vector<TaskStore::Item> ItemVector;
 
+  class Listener {
+  public:
+    /**
+     * New items have been added to the store, or the background scan
+     * has finished (see IsBusy()).  Item indexes may have changed.
+     * This method runs in the main thread.
+     */
+    virtual void OnTaskStoreChanged() = 0;
+  };
+
 private:
+  class Worker;
+
   /**
-   * Internal task storage
+   * Internal task storage.  Only accessed by the main thread.
    */
   ItemVector store;
 
+  Listener *listener = nullptr;
+
+  /**
+   * Protects all attributes below.
+   */
+  mutable Mutex mutex;
+
+  /**
+   * Signalled when a file was queued, and on shutdown.
+   */
+  Cond cond;
+
+  /**
+   * Incremented by each Scan() and Clear(); results of older scans
+   * are discarded.
+   */
+  unsigned generation = 0;
+
+  /**
+   * The task behaviour used by the background threads to construct
+   * tasks.
+   */
+  TaskBehaviour task_behaviour;
+
+  /**
+   * Files which have not been parsed yet.
+   */
+  std::list<AllocatedPath> queue;
+
+  /**
+   * Items which have been parsed by a #Worker, but have not yet been
+   * moved to #store by OnNotification().
+   */
+  ItemVector pending;
+
+  /**
+   * The number of workers which are currently parsing a file.
+   */
+  unsigned busy = 0;
+
+  bool stop = false;
+
+  std::vector<std::unique_ptr<Worker>> workers;
+
 public:
+  TaskStore();
+  ~TaskStore();
+
+  TaskStore(const TaskStore &) = delete;
+  TaskStore &operator=(const TaskStore &) = delete;
+
+  void SetListener(Listener *_listener) {
+    listener = _listener;
+  }
+
   /**
-   * Scan the XCSoarData folder for .tsk files and add them to the TaskStore
+   * Scan the XCSoarData folder for .tsk files and add them to the
+   * TaskStore.  Files which are in the cache are added immediately,
+   * the others are parsed in the background.
    *
    * @param extra scan all "extra" (non-XCSoar) task files, e.g. *.cup
    * and task declarations from *.igc
    */
-  void Scan(bool extra=false);
+  void Scan(const TaskBehaviour &task_behaviour, bool extra=false);
 
   /**
-   * Clear all the tasks from the TaskStore
+   * Clear all the tasks from the TaskStore, and cancel pending
+   * background work.
    */
   void Clear();
 
+  /**
+   * Are there files which have not been parsed yet?
+   */
+  gcc_pure
+  bool IsBusy() const;
+
   /**
    * Return the number of tasks in the TaskStore
    * @return The number of tasks in the TaskStore
@@ -128,6 +247,16 @@ public:
   gcc_pure
   Path GetPath(unsigned index) const;
 
+  /**
+   * Return the summary of the task defined by the given index
+   * @return the summary or nullptr if the task could not be loaded
+   */
+  gcc_pure
+  const Summary *GetSummary(unsigned index) const {
+    const Item &item = store[index];
+    return item.has_summary ? &item.summary : nullptr;
+  }
+
   /**
    * Return the task defined by the given index
    * @param index TaskStore index of the desired Task
@@ -135,6 +264,23 @@ public:
    */
   const OrderedTask *GetTask(unsigned index,
                              const TaskBehaviour &task_behaviour);
+
+  /**
+   * Parse one task file and return all tasks in it (with their
+   * summaries).  This method is thread-safe.
+   */
+  static ItemVector LoadFile(Path path, const TaskBehaviour &task_behaviour);
+
+private:
+  void StartWorkers();
+
+  /**
+   * The main loop of a #Worker.
+   */
+  void Run();
+
+  /* virtual methods from class Notify */
+  void OnNotification() override;
 };
 
 #endif
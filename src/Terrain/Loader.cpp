@@ -238,9 +238,9 @@ LoadJPG2000(jas_stream_t *in, void *loader)
 }
 
 inline bool
-TerrainLoader::LoadJPG2000(struct zzip_dir *dir, const char *path)
+TerrainLoader::LoadJPG2000(ZipArchive &archive, const char *path)
 {
-  const auto in = OpenJasperZzipStream(dir, path);
+  const auto in = OpenJasperZzipStream(archive, path);
   if (in == nullptr)
     return false;
 
@@ -253,12 +253,12 @@ TerrainLoader::LoadJPG2000(struct zzip_dir *dir, const char *path)
 
 static bool
 LoadWorldFile(RasterTileCache &tile_cache,
-              struct zzip_dir *dir, const char *path)
+              ZipArchive &archive, const char *path)
 {
   if (path == nullptr)
     return false;
 
-  const auto new_bounds = LoadWorldFile(dir, path, tile_cache.GetWidth(),
+  const auto new_bounds = LoadWorldFile(archive, path, tile_cache.GetWidth(),
                                         tile_cache.GetHeight());
   bool success = new_bounds.IsValid();
   if (success)
@@ -267,19 +267,19 @@ LoadWorldFile(RasterTileCache &tile_cache,
 }
 
 inline bool
-TerrainLoader::LoadOverview(struct zzip_dir *dir,
+TerrainLoader::LoadOverview(ZipArchive &archive,
                             const char *path, const char *world_file)
 {
   assert(scan_overview);
 
   raster_tile_cache.Reset();
 
-  bool success = LoadJPG2000(dir, path);
+  bool success = LoadJPG2000(archive, path);
 
   /* if we loaded the JPG2000 file successfully, but no bounds were
      obtained from there, try to load the world file "terrain.j2w" */
   if (success && !raster_tile_cache.bounds.IsValid() &&
-      !LoadWorldFile(raster_tile_cache, dir, world_file))
+      !LoadWorldFile(raster_tile_cache, archive, world_file))
     /* that failed: without bounds, we can't do anything; give up,
        discard the whole file */
     success = false;
@@ -291,7 +291,7 @@ TerrainLoader::LoadOverview(struct zzip_dir *dir,
 }
 
 bool
-LoadTerrainOverview(struct zzip_dir *dir,
+LoadTerrainOverview(ZipArchive &archive,
                     const char *path, const char *world_file,
                     RasterTileCache &raster_tile_cache,
                     bool all,
@@ -301,11 +301,11 @@ LoadTerrainOverview(struct zzip_dir *dir,
   SharedMutex mutex;
 
   TerrainLoader loader(mutex, raster_tile_cache, true, all, env);
-  return loader.LoadOverview(dir, path, world_file);
+  return loader.LoadOverview(archive, path, world_file);
 }
 
 inline bool
-TerrainLoader::UpdateTiles(struct zzip_dir *dir, const char *path,
+TerrainLoader::UpdateTiles(ZipArchive &archive, const char *path,
                            int x, int y, unsigned radius)
 {
   assert(!scan_overview);
@@ -314,13 +314,13 @@ TerrainLoader::UpdateTiles(struct zzip_dir *dir, const char *path,
     /* nothing to do */
     return true;
 
-  bool success = LoadJPG2000(dir, path);
+  bool success = LoadJPG2000(archive, path);
   raster_tile_cache.FinishTileUpdate();
   return success;
 }
 
 bool
-UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+UpdateTerrainTiles(ZipArchive &archive, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
                    int x, int y, unsigned radius)
 {
@@ -329,18 +329,18 @@ UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
 
   NullOperationEnvironment env;
   TerrainLoader loader(mutex, raster_tile_cache, false, true, env);
-  return loader.UpdateTiles(dir, path, x, y, radius);
+  return loader.UpdateTiles(archive, path, x, y, radius);
 }
 
 bool
-UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+UpdateTerrainTiles(ZipArchive &archive, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
                    const RasterProjection &projection,
                    const GeoPoint &location, double radius)
 {
   const auto raster_location = projection.ProjectCoarse(location);
 
-  return UpdateTerrainTiles(dir, path, raster_tile_cache, mutex,
+  return UpdateTerrainTiles(archive, path, raster_tile_cache, mutex,
                             raster_location.x, raster_location.y,
                             projection.DistancePixelsCoarse(radius));
 }
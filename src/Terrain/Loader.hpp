@@ -26,7 +26,7 @@ Copyright_License {
 
 #include "Thread/SharedMutex.hpp"
 
-struct zzip_dir;
+class ZipArchive;
 struct GeoPoint;
 class RasterTileCache;
 class RasterProjection;
@@ -55,9 +55,9 @@ public:
      scan_tiles(!_scan_overview || _scan_all),
      env(_env) {}
 
-  bool LoadOverview(struct zzip_dir *dir,
+  bool LoadOverview(ZipArchive &archive,
                     const char *path, const char *world_file);
-  bool UpdateTiles(struct zzip_dir *dir, const char *path,
+  bool UpdateTiles(ZipArchive &archive, const char *path,
                    int x, int y, unsigned radius);
 
   /* callback methods for libjasper (via jas_rtc.cpp) */
@@ -79,7 +79,7 @@ public:
                    const struct jas_matrix &m);
 
 private:
-  bool LoadJPG2000(struct zzip_dir *dir, const char *path);
+  bool LoadJPG2000(ZipArchive &archive, const char *path);
   void ParseBounds(const char *data);
 };
 
@@ -89,48 +89,48 @@ private:
  * small RASP files only.
  */
 bool
-LoadTerrainOverview(struct zzip_dir *dir,
+LoadTerrainOverview(ZipArchive &archive,
                     const char *path, const char *world_file,
                     RasterTileCache &raster_tile_cache,
                     bool all,
                     OperationEnvironment &env);
 
 static inline bool
-LoadTerrainOverview(struct zzip_dir *dir,
+LoadTerrainOverview(ZipArchive &archive,
                     RasterTileCache &tile_cache,
                     OperationEnvironment &env)
 {
-  return LoadTerrainOverview(dir, "terrain.jp2", "terrain.j2w",
+  return LoadTerrainOverview(archive, "terrain.jp2", "terrain.j2w",
                              tile_cache, false, env);
 }
 
 bool
-UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+UpdateTerrainTiles(ZipArchive &archive, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
                    int x, int y, unsigned radius);
 
 static inline bool
-UpdateTerrainTiles(struct zzip_dir *dir,
+UpdateTerrainTiles(ZipArchive &archive,
                    RasterTileCache &tile_cache, SharedMutex &mutex,
                    int x, int y, unsigned radius)
 {
-  return UpdateTerrainTiles(dir, "terrain.jp2", tile_cache, mutex,
+  return UpdateTerrainTiles(archive, "terrain.jp2", tile_cache, mutex,
                             x, y, radius);
 }
 
 bool
-UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+UpdateTerrainTiles(ZipArchive &archive, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
                    const RasterProjection &projection,
                    const GeoPoint &location, double radius);
 
 static inline bool
-UpdateTerrainTiles(struct zzip_dir *dir,
+UpdateTerrainTiles(ZipArchive &archive,
                    RasterTileCache &tile_cache, SharedMutex &mutex,
                    const RasterProjection &projection,
                    const GeoPoint &location, double radius)
 {
-  return UpdateTerrainTiles(dir, "terrain.jp2", tile_cache, mutex,
+  return UpdateTerrainTiles(archive, "terrain.jp2", tile_cache, mutex,
                             projection, location, radius);
 }
 
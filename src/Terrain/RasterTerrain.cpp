@@ -70,7 +70,7 @@ RasterTerrain::Load(Path path, FileCache *cache,
   if (LoadCache(cache, path))
     return true;
 
-  if (!LoadTerrainOverview(archive.get(), map.GetTileCache(), operation))
+  if (!LoadTerrainOverview(archive, map.GetTileCache(), operation))
     return false;
 
   map.UpdateProjection();
@@ -107,7 +107,7 @@ RasterTerrain::UpdateTiles(const GeoPoint &location, double radius)
   if (!tile_cache.IsValid())
     return false;
 
-  UpdateTerrainTiles(archive.get(), tile_cache, mutex,
+  UpdateTerrainTiles(archive, tile_cache, mutex,
                      map.GetProjection(), location, radius);
   return map.IsDirty();
 }
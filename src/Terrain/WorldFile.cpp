@@ -83,20 +83,20 @@ ReadWorldFile(NLineReader &reader, WorldFileData &data)
 }
 
 static bool
-ReadWorldFile(struct zzip_dir *dir, const char *path, WorldFileData &data)
+ReadWorldFile(ZipArchive &archive, const char *path, WorldFileData &data)
 try {
-  ZipLineReaderA reader(dir, path);
+  ZipLineReaderA reader(archive, path);
   return ReadWorldFile(reader, data);
 } catch (const std::runtime_error &e) {
   return false;
 }
 
 GeoBounds
-LoadWorldFile(struct zzip_dir *dir, const char *path,
+LoadWorldFile(ZipArchive &archive, const char *path,
               unsigned width, unsigned height)
 {
   WorldFileData data;
-  if (!ReadWorldFile(dir, path, data) ||
+  if (!ReadWorldFile(archive, path, data) ||
       /* we don't support rotation */
       data.IsRotated())
     return GeoBounds::Invalid();
@@ -22,15 +22,22 @@ Copyright_License {
 */
 
 #include "ZzipStream.hpp"
+#include "IO/ZipReader.hpp"
 
-#include <zzip/util.h>
+#include <stdexcept>
+
+#include <stdio.h>
 
 static int
 jas_zzip_read(jas_stream_obj_t *obj, char *buf, int cnt)
 {
-  const auto f = (struct zzip_file *)obj;
+  auto &reader = *(ZipReader *)obj;
 
-  return zzip_fread(buf, 1, cnt, f);
+  try {
+    return reader.Read(buf, cnt);
+  } catch (const std::runtime_error &) {
+    return -1;
+  }
 }
 
 static int
@@ -42,17 +49,47 @@ jas_zzip_write(jas_stream_obj_t *obj, char *buf, int cnt)
 static long
 jas_zzip_seek(jas_stream_obj_t *obj, long offset, int origin)
 {
-  const auto f = (struct zzip_file *)obj;
+  auto &reader = *(ZipReader *)obj;
+
+  /* libjasper discards its buffer before seeking, and compensates
+     with a negative relative offset; ZipReader::Seek() is cheap
+     enough to handle that, and moving to the end (which is how
+     jas_stream_length() works) doesn't decompress anything */
+  long base;
+  switch (origin) {
+  case SEEK_SET:
+    base = 0;
+    break;
+
+  case SEEK_CUR:
+    base = reader.GetPosition();
+    break;
+
+  case SEEK_END:
+    base = reader.GetSize();
+    break;
+
+  default:
+    return -1;
+  }
+
+  if (offset < -base)
+    return -1;
 
-  return zzip_seek(f, offset, origin);
+  try {
+    reader.Seek(base + offset);
+  } catch (const std::runtime_error &) {
+    return -1;
+  }
+
+  return base + offset;
 }
 
 static int
 jas_zzip_close(jas_stream_obj_t *obj)
 {
-  const auto f = (struct zzip_file *)obj;
-
-  return zzip_file_close(f);
+  delete (ZipReader *)obj;
+  return 0;
 }
 
 static constexpr jas_stream_ops_t zzip_stream_ops = {
@@ -63,20 +100,23 @@ static constexpr jas_stream_ops_t zzip_stream_ops = {
 };
 
 jas_stream_t *
-OpenJasperZzipStream(struct zzip_dir *dir, const char *path)
+OpenJasperZzipStream(ZipArchive &archive, const char *path)
 {
-  const auto f = zzip_open_rb(dir, path);
-  if (f == nullptr)
+  ZipReader *reader;
+  try {
+    reader = new ZipReader(archive, path);
+  } catch (const std::runtime_error &) {
     return nullptr;
+  }
 
   jas_stream_t *stream = jas_stream_create();
   if (stream == nullptr) {
-    zzip_file_close(f);
+    delete reader;
     return nullptr;
   }
 
   stream->openmode_ = JAS_STREAM_READ|JAS_STREAM_BINARY;
-  stream->obj_ = f;
+  stream->obj_ = reader;
   stream->ops_ = const_cast<jas_stream_ops_t *>(&zzip_stream_ops);
 
   /* By default, use full buffering for this type of stream. */
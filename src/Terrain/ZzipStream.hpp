@@ -26,9 +26,17 @@ Copyright_License {
 
 #include "jasper/jas_stream.h"
 
-struct zzip_dir;
-
+class ZipArchive;
+
+/**
+ * Open a member of a ZIP archive as a libjasper stream.  It is backed
+ * by a #ZipReader, which makes libjasper's (mostly short) relative
+ * seeks cheap.  The #ZipArchive must exist until the stream is
+ * closed.
+ *
+ * @return the stream or nullptr on error
+ */
 jas_stream_t *
-OpenJasperZzipStream(struct zzip_dir *dir, const char *path);
+OpenJasperZzipStream(ZipArchive &archive, const char *path);
 
 #endif
@@ -270,6 +270,11 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 #endif
 #endif
 
+#ifdef USE_MEMORY_CANVAS
+  /* rasterise the filled areas on multiple threads */
+  const ScopeCanvasBatch batch(canvas);
+#endif
+
   for (const XShape *shape_p : visible_shapes) {
     const XShape &shape = *shape_p;
 
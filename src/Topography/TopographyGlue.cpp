@@ -43,7 +43,7 @@ try {
   if (!archive)
     return false;
 
-  ZipLineReaderA reader(archive->get(), "topology.tpl");
+  ZipLineReaderA reader(*archive, "topology.tpl");
   store.Load(operation, reader, nullptr, archive->get());
   return true;
 } catch (const std::runtime_error &e) {
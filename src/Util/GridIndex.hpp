@@ -0,0 +1,576 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef GRID_INDEX_HPP
+#define GRID_INDEX_HPP
+
+#include "Compiler.h"
+
+#include <vector>
+#include <utility>
+#include <limits>
+#include <algorithm>
+
+#include <assert.h>
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * A spatial index for points on a plane, implemented as a uniform
+ * grid with contiguous buckets.  It is an alternative to #QuadTree
+ * with a more cache friendly memory layout: all values are stored in
+ * one array, sorted by grid cell, and a second array holds the first
+ * index of each cell.
+ *
+ * Optimise() bulk-loads the grid with a counting sort, which is O(n).
+ * Values added afterwards are appended to an unsorted "pending" tail
+ * which is scanned linearly by all queries; once the tail grows
+ * beyond a fraction of the sorted part, the grid is rebuilt
+ * automatically.  Therefore, unlike #QuadTree, the index never
+ * needs to be flattened, and all queries are valid at any time.
+ *
+ * Values are copied around when the grid is rebuilt, so T should be
+ * cheap to copy or move (e.g. a pointer).
+ *
+ * The Accessor class must provide GetX() and GetY() methods, like
+ * the one passed to #QuadTree.  The bounds API of #QuadTree
+ * (HaveBounds(), IsWithinBounds(), Flatten(), ClearBounds()) is not
+ * implemented, so this class is not a drop-in replacement for it.
+ */
+template<typename T, typename Accessor>
+class GridIndex {
+public:
+  typedef int position_type;
+
+  /**
+   * Distances and square distances.  The square distance between two
+   * #position_type values does not fit into 32 bits.
+   */
+  typedef uint64_t distance_type;
+
+  typedef typename std::vector<T>::const_iterator const_iterator;
+
+  /**
+   * The average number of values per cell after Optimise().
+   */
+  static constexpr unsigned BUCKET_SIZE = 4;
+
+  /**
+   * The grid is rebuilt when the pending tail contains more than
+   * this number of values, or more than 1/PENDING_DIVISOR of the
+   * sorted values, whichever is larger.
+   */
+  static constexpr unsigned MIN_PENDING = 64;
+  static constexpr unsigned PENDING_DIVISOR = 64;
+
+  static constexpr distance_type MAX_DISTANCE =
+    std::numeric_limits<distance_type>::max();
+
+  /**
+   * The largest value which can be squared without overflow.
+   */
+  static constexpr distance_type MAX_SQUARE_ROOT = 0xffffffff;
+
+  /**
+   * Returns the square of the specified distance, saturating at
+   * #MAX_DISTANCE.
+   */
+  constexpr
+  static distance_type Square(distance_type x) {
+    return x > MAX_SQUARE_ROOT
+      ? MAX_DISTANCE
+      : x * x;
+  }
+
+  /**
+   * Returns the sum of two square distances, saturating at
+   * #MAX_DISTANCE.
+   */
+  constexpr
+  static distance_type SquareSum(distance_type a, distance_type b) {
+    return a > MAX_DISTANCE - b
+      ? MAX_DISTANCE
+      : a + b;
+  }
+
+  constexpr
+  static distance_type Difference(position_type a, position_type b) {
+    return a < b
+      ? distance_type((int64_t)b - a)
+      : distance_type((int64_t)a - b);
+  }
+
+  /**
+   * A location on the plane.
+   */
+  struct Point {
+    position_type x, y;
+
+    constexpr
+    Point(position_type _x, position_type _y):x(_x), y(_y) {}
+
+    constexpr
+    distance_type SquareDistanceTo(const Point &other) const {
+      return SquareSum(Square(Difference(other.x, x)),
+                       Square(Difference(other.y, y)));
+    }
+  };
+
+  constexpr
+  static Point GetPosition(const T &value) {
+    return Point(Accessor().GetX(value), Accessor().GetY(value));
+  }
+
+private:
+  /**
+   * All values; [0, n_sorted) are sorted by cell, the rest is the
+   * unsorted pending tail.
+   */
+  std::vector<T> values;
+  unsigned n_sorted = 0;
+
+  /**
+   * Index of the first value of each cell in #values, plus one
+   * trailing element which equals #n_sorted.
+   */
+  std::vector<unsigned> cell_start;
+
+  /**
+   * The lower left corner of the grid.
+   */
+  position_type left = 0, top = 0;
+
+  /**
+   * The width and height of one cell.
+   */
+  uint64_t cell_size = 1;
+
+  unsigned columns = 0, rows = 0;
+
+public:
+  GridIndex() = default;
+  GridIndex(const GridIndex &) = delete;
+
+  bool IsEmpty() const {
+    return values.empty();
+  }
+
+  gcc_pure
+  unsigned size() const {
+    return values.size();
+  }
+
+  /**
+   * Returns the number of values which have not yet been sorted into
+   * the grid.
+   */
+  gcc_pure
+  unsigned GetPendingSize() const {
+    return values.size() - n_sorted;
+  }
+
+  const_iterator begin() const {
+    return values.begin();
+  }
+
+  const_iterator end() const {
+    return values.end();
+  }
+
+  void clear() {
+    values.clear();
+    cell_start.clear();
+    n_sorted = 0;
+    columns = rows = 0;
+  }
+
+  /**
+   * Reserve memory for the given number of values, to avoid
+   * reallocation during a bulk load.
+   */
+  void reserve(unsigned n) {
+    values.reserve(n);
+  }
+
+  /**
+   * Add a value.  It is immediately visible to all queries.
+   */
+  template<typename U>
+  void Add(U &&value) {
+    values.emplace_back(std::forward<U>(value));
+
+    if (GetPendingSize() > GetMaxPending())
+      Optimise();
+  }
+
+  /**
+   * Add a value without the automatic rebuild.  Use this for bulk
+   * loading, and call Optimise() at the end.
+   */
+  template<typename U>
+  void AddQuick(U &&value) {
+    values.emplace_back(std::forward<U>(value));
+  }
+
+  /**
+   * Rescan the bounds and sort all values into the grid.
+   */
+  void Optimise() {
+    if (values.empty()) {
+      clear();
+      return;
+    }
+
+    ScanGeometry();
+
+    const unsigned n_cells = columns * rows;
+    cell_start.assign(n_cells + 1, 0);
+
+    std::vector<unsigned> cells;
+    cells.reserve(values.size());
+    for (const auto &i : values) {
+      const unsigned cell = GetCell(GetPosition(i));
+      cells.push_back(cell);
+      ++cell_start[cell + 1];
+    }
+
+    for (unsigned i = 0; i < n_cells; ++i)
+      cell_start[i + 1] += cell_start[i];
+
+    std::vector<unsigned> fill(cell_start.begin(), cell_start.end() - 1);
+    std::vector<T> sorted(values.size());
+    for (unsigned i = 0, n = values.size(); i < n; ++i)
+      sorted[fill[cells[i]]++] = std::move(values[i]);
+
+    values.swap(sorted);
+    n_sorted = values.size();
+  }
+
+  /**
+   * Remove one value.
+   */
+  void erase(const_iterator it) {
+    const unsigned i = it - values.begin();
+    assert(i < values.size());
+
+    if (i >= n_sorted) {
+      values.erase(values.begin() + i);
+      return;
+    }
+
+    const unsigned cell = GetCell(GetPosition(values[i]));
+    values.erase(values.begin() + i);
+    --n_sorted;
+
+    for (unsigned c = cell + 1, n = cell_start.size(); c < n; ++c)
+      --cell_start[c];
+  }
+
+  /**
+   * Erase all values that match the specified predicate.
+   */
+  template<class P>
+  void EraseIf(const P &predicate) {
+    const auto sorted_end = std::remove_if(values.begin(),
+                                           values.begin() + n_sorted,
+                                           predicate);
+    const auto end = std::remove_if(values.begin() + n_sorted,
+                                    values.end(), predicate);
+    const unsigned new_sorted = sorted_end - values.begin();
+    values.erase(std::move(values.begin() + n_sorted, end, sorted_end),
+                 values.end());
+
+    if (new_sorted != n_sorted) {
+      n_sorted = new_sorted;
+      RecountCells();
+    }
+  }
+
+  /**
+   * Replace the value, and reposition it in the grid if its position
+   * has been modified.
+   */
+  template<typename U>
+  void Replace(const_iterator it, U &&value) {
+    const unsigned i = it - values.begin();
+    assert(i < values.size());
+
+    const Point new_position = GetPosition(value);
+    if (i >= n_sorted ||
+        (IsInsideGrid(new_position) &&
+         GetCell(GetPosition(values[i])) == GetCell(new_position))) {
+      values[i] = std::forward<U>(value);
+      return;
+    }
+
+    erase(it);
+    Add(std::forward<U>(value));
+  }
+
+  /**
+   * Find the nearest value matching the predicate within the given
+   * range.
+   *
+   * @return an iterator to the value (or end()) and the square
+   * distance
+   */
+  template<class P>
+  gcc_pure
+  std::pair<const_iterator, distance_type>
+  FindNearestIf(const Point location, distance_type range,
+                const P &predicate) const {
+    const T *nearest = nullptr;
+    distance_type nearest_square_distance = Square(range);
+
+    for (unsigned i = n_sorted, n = values.size(); i < n; ++i)
+      CheckNearest(values[i], location, predicate,
+                   nearest, nearest_square_distance);
+
+    if (n_sorted > 0) {
+      const int cx = ClampColumn(location.x), cy = ClampRow(location.y);
+      const bool inside = IsInsideGrid(location);
+      const int max_ring = std::min<int>(GetCellRange(range) + 1,
+                                         std::max(columns, rows));
+
+      for (int ring = 0; ring <= max_ring; ++ring) {
+        /* all cells of this ring are at least (ring-1) cells away from
+           the location; stop as soon as they cannot contain a
+           nearer value */
+        if (inside && ring > 1) {
+          const distance_type min_distance =
+            (distance_type)(ring - 1) * cell_size;
+          if (Square(min_distance) > nearest_square_distance)
+            break;
+        }
+
+        for (int y = cy - ring; y <= cy + ring; ++y) {
+          if (y < 0 || y >= (int)rows)
+            continue;
+
+          const int step = y == cy - ring || y == cy + ring
+            ? 1
+            : 2 * ring;
+          for (int x = cx - ring; x <= cx + ring; x += std::max(step, 1)) {
+            if (x < 0 || x >= (int)columns)
+              continue;
+
+            if (GetCellSquareDistance(x, y, location) > nearest_square_distance)
+              continue;
+
+            const unsigned cell = y * columns + x;
+            for (unsigned i = cell_start[cell], end = cell_start[cell + 1];
+                 i < end; ++i)
+              CheckNearest(values[i], location, predicate,
+                           nearest, nearest_square_distance);
+          }
+        }
+      }
+    }
+
+    return std::make_pair(nearest != nullptr
+                          ? values.begin() + (nearest - values.data())
+                          : values.end(),
+                          nearest_square_distance);
+  }
+
+  gcc_pure
+  std::pair<const_iterator, distance_type>
+  FindNearest(const Point location, distance_type range) const {
+    return FindNearestIf(location, range, [](const T &){ return true; });
+  }
+
+  /**
+   * Invoke the visitor for each value within the given (circular)
+   * range.
+   */
+  template<class V>
+  void VisitWithinRange(const Point location, distance_type range,
+                        V &visitor) const {
+    const distance_type square_range = Square(range);
+
+    if (n_sorted > 0) {
+      const int cell_range = GetCellRange(range);
+      const int x0 = std::max(ColumnOf(location.x) - cell_range, 0);
+      const int x1 = std::min(ColumnOf(location.x) + cell_range,
+                              (int)columns - 1);
+      const int y0 = std::max(RowOf(location.y) - cell_range, 0);
+      const int y1 = std::min(RowOf(location.y) + cell_range,
+                              (int)rows - 1);
+
+      for (int y = y0; y <= y1; ++y) {
+        /* the cells of one row are adjacent in #values */
+        const unsigned begin = cell_start[y * columns + x0];
+        const unsigned end = cell_start[y * columns + x1 + 1];
+        for (unsigned i = begin; i < end; ++i)
+          if (GetPosition(values[i]).SquareDistanceTo(location) <= square_range)
+            visitor((const T &)values[i]);
+      }
+    }
+
+    for (unsigned i = n_sorted, n = values.size(); i < n; ++i)
+      if (GetPosition(values[i]).SquareDistanceTo(location) <= square_range)
+        visitor((const T &)values[i]);
+  }
+
+private:
+  unsigned GetMaxPending() const {
+    return std::max(unsigned(MIN_PENDING), n_sorted / PENDING_DIVISOR);
+  }
+
+  /**
+   * Calculate the grid origin, the cell size and the number of
+   * columns/rows from the bounds of all values.
+   */
+  void ScanGeometry() {
+    assert(!values.empty());
+
+    Point first = GetPosition(values.front());
+    position_type right = first.x, bottom = first.y;
+    left = first.x;
+    top = first.y;
+
+    for (const auto &i : values) {
+      const Point p = GetPosition(i);
+      left = std::min(left, p.x);
+      right = std::max(right, p.x);
+      top = std::min(top, p.y);
+      bottom = std::max(bottom, p.y);
+    }
+
+    const uint64_t width = (int64_t)right - left;
+    const uint64_t height = (int64_t)bottom - top;
+    const uint64_t max_cells =
+      std::max<uint64_t>(values.size() / BUCKET_SIZE, 1);
+
+    /* start with the cell size for a square grid and grow it until
+       the cell count fits (the bounds may be far from square) */
+    cell_size = std::max<uint64_t>(sqrt((double)(width + 1) * (height + 1)
+                                        / max_cells), 1);
+    while ((width / cell_size + 1) * (height / cell_size + 1) > max_cells)
+      cell_size += (cell_size + 7) / 8;
+
+    columns = width / cell_size + 1;
+    rows = height / cell_size + 1;
+  }
+
+  /**
+   * Rebuild #cell_start after values have been removed from the
+   * sorted part.
+   */
+  void RecountCells() {
+    std::fill(cell_start.begin(), cell_start.end(), 0);
+    for (unsigned i = 0; i < n_sorted; ++i)
+      ++cell_start[GetCell(GetPosition(values[i])) + 1];
+
+    for (unsigned i = 0, n = cell_start.size() - 1; i < n; ++i)
+      cell_start[i + 1] += cell_start[i];
+  }
+
+  gcc_pure
+  int ColumnOf(position_type x) const {
+    return x < left
+      ? -1
+      : (int)std::min<uint64_t>((uint64_t)((int64_t)x - left) / cell_size,
+                                columns);
+  }
+
+  gcc_pure
+  int RowOf(position_type y) const {
+    return y < top
+      ? -1
+      : (int)std::min<uint64_t>((uint64_t)((int64_t)y - top) / cell_size,
+                                rows);
+  }
+
+  gcc_pure
+  int ClampColumn(position_type x) const {
+    return std::min(std::max(ColumnOf(x), 0), (int)columns - 1);
+  }
+
+  gcc_pure
+  int ClampRow(position_type y) const {
+    return std::min(std::max(RowOf(y), 0), (int)rows - 1);
+  }
+
+  gcc_pure
+  bool IsInsideGrid(const Point p) const {
+    const int x = ColumnOf(p.x), y = RowOf(p.y);
+    return x >= 0 && x < (int)columns && y >= 0 && y < (int)rows;
+  }
+
+  /**
+   * Returns the cell index of a position inside the grid bounds.
+   */
+  gcc_pure
+  unsigned GetCell(const Point p) const {
+    assert(IsInsideGrid(p));
+
+    return RowOf(p.y) * columns + ColumnOf(p.x);
+  }
+
+  /**
+   * How many cells does the given distance span (rounded up)?
+   */
+  gcc_pure
+  int GetCellRange(distance_type range) const {
+    return std::min<uint64_t>((uint64_t)range / cell_size + 1,
+                              std::numeric_limits<int>::max() / 2);
+  }
+
+  /**
+   * Calculate the minimum square distance of a cell to the specified
+   * point.
+   */
+  gcc_pure
+  distance_type GetCellSquareDistance(int x, int y, const Point p) const {
+    const int64_t cell_left = left + x * (int64_t)cell_size;
+    const int64_t cell_right = cell_left + (int64_t)cell_size - 1;
+    const int64_t cell_top = top + y * (int64_t)cell_size;
+    const int64_t cell_bottom = cell_top + (int64_t)cell_size - 1;
+
+    const distance_type dx = p.x < cell_left
+      ? cell_left - p.x
+      : (p.x > cell_right ? p.x - cell_right : 0);
+    const distance_type dy = p.y < cell_top
+      ? cell_top - p.y
+      : (p.y > cell_bottom ? p.y - cell_bottom : 0);
+
+    return SquareSum(Square(dx), Square(dy));
+  }
+
+  template<class P>
+  static void CheckNearest(const T &value, const Point location,
+                           const P &predicate, const T *&nearest,
+                           distance_type &nearest_square_distance) {
+    if (!predicate(value))
+      return;
+
+    const distance_type square_distance =
+      GetPosition(value).SquareDistanceTo(location);
+    if (square_distance <= nearest_square_distance) {
+      nearest_square_distance = square_distance;
+      nearest = &value;
+    }
+  }
+};
+
+#endif
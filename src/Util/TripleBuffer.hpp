@@ -0,0 +1,109 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TRIPLE_BUFFER_HPP
+#define XCSOAR_TRIPLE_BUFFER_HPP
+
+#include <atomic>
+
+/**
+ * Passes the most recent value of a #T from one producer thread to
+ * one consumer thread without locking; neither side ever waits.
+ * Intermediate values which the consumer has not picked up are
+ * overwritten.
+ *
+ * There are three buffers: the producer owns one ("back"), the
+ * consumer owns one ("front"), and the third one ("middle") is
+ * exchanged atomically.
+ */
+template<typename T>
+class TripleBuffer {
+  static constexpr unsigned INDEX_MASK = 0x3;
+
+  /**
+   * This flag in #middle means that the middle buffer contains a
+   * value which the consumer has not seen yet.
+   */
+  static constexpr unsigned DIRTY = 0x4;
+
+  T buffers[3];
+
+  std::atomic<unsigned> middle;
+
+  /**
+   * Owned by the producer.
+   */
+  unsigned back = 0;
+
+  /**
+   * Owned by the consumer.
+   */
+  unsigned front = 1;
+
+public:
+  TripleBuffer():middle(2) {}
+
+  TripleBuffer(const TripleBuffer &) = delete;
+  TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+  /**
+   * Returns the buffer which may be filled by the producer.  Its
+   * contents are undefined.
+   */
+  T &GetWriteBuffer() {
+    return buffers[back];
+  }
+
+  /**
+   * Publish the buffer returned by GetWriteBuffer().  To be called by
+   * the producer.
+   */
+  void Publish() {
+    back = middle.exchange(back | DIRTY, std::memory_order_acq_rel)
+      & INDEX_MASK;
+  }
+
+  /**
+   * Check for a new value, and make it available to GetReadBuffer().
+   * To be called by the consumer.
+   *
+   * @return true if a new value was published since the last call
+   */
+  bool Update() {
+    if ((middle.load(std::memory_order_relaxed) & DIRTY) == 0)
+      return false;
+
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+    return true;
+  }
+
+  /**
+   * Returns the value which was obtained by the last successful
+   * Update() call.  To be called by the consumer.
+   */
+  const T &GetReadBuffer() const {
+    return buffers[front];
+  }
+};
+
+#endif
@@ -0,0 +1,265 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "WaypointCache.hpp"
+#include "Engine/Waypoint/Waypoint.hpp"
+#include "IO/FileCache.hpp"
+#include "IO/CacheBuffer.hpp"
+#include "OS/Path.hpp"
+
+#include <iterator>
+
+#include <string.h>
+
+namespace {
+
+struct CacheHeader {
+  static constexpr unsigned VERSION = 1;
+
+  uint32_t version;
+  uint32_t n_waypoints;
+
+  uint64_t terrain_stamp;
+
+  /**
+   * The number of bytes following this header.
+   */
+  uint32_t payload_size;
+
+  /**
+   * The length of the original path name, which is the first element
+   * of the payload.
+   */
+  uint32_t path_length;
+};
+
+/**
+ * The fixed-size part of a #Waypoint.  It is followed by the name,
+ * comment, details and the file lists, each string prefixed with its
+ * length.
+ */
+struct CachedWaypoint {
+  GeoPoint location;
+  double elevation;
+  Runway runway;
+  RadioFrequency radio_frequency;
+  uint32_t original_id;
+  Waypoint::Type type;
+  Waypoint::Flags flags;
+  WaypointOrigin origin;
+  uint16_t n_files_embed, n_files_external;
+};
+
+/**
+ * The payload is limited to this size to refuse to load garbage.
+ */
+static constexpr uint32_t MAX_PAYLOAD_SIZE = 64 * 1024 * 1024;
+
+}
+
+static void
+WriteFileList(CacheWriter &writer, const std::forward_list<tstring> &list)
+{
+  for (const auto &i : list)
+    writer.WriteString(i);
+}
+
+static uint16_t
+CountFileList(const std::forward_list<tstring> &list)
+{
+  return std::distance(list.begin(), list.end());
+}
+
+static void
+WriteWaypoint(CacheWriter &writer, const Waypoint &waypoint)
+{
+  CachedWaypoint cached;
+
+  /* zero-fill all implicit padding bytes (to make valgrind happy) */
+  memset(&cached, 0, sizeof(cached));
+
+  cached.location = waypoint.location;
+  cached.elevation = waypoint.elevation;
+  cached.runway = waypoint.runway;
+  cached.radio_frequency = waypoint.radio_frequency;
+  cached.original_id = waypoint.original_id;
+  cached.type = waypoint.type;
+  cached.flags = waypoint.flags;
+  cached.origin = waypoint.origin;
+  cached.n_files_embed = CountFileList(waypoint.files_embed);
+#ifdef HAVE_RUN_FILE
+  cached.n_files_external = CountFileList(waypoint.files_external);
+#endif
+
+  writer.Write(cached);
+  writer.WriteString(waypoint.name);
+  writer.WriteString(waypoint.comment);
+  writer.WriteString(waypoint.details);
+  WriteFileList(writer, waypoint.files_embed);
+#ifdef HAVE_RUN_FILE
+  WriteFileList(writer, waypoint.files_external);
+#endif
+}
+
+static bool
+ReadFileList(CacheReader &reader, std::forward_list<tstring> &list,
+             unsigned n)
+{
+  list.clear();
+
+  auto i = list.before_begin();
+  for (unsigned j = 0; j < n; ++j) {
+    i = list.emplace_after(i);
+    if (!reader.ReadString(*i))
+      return false;
+  }
+
+  return true;
+}
+
+static bool
+ReadWaypoint(CacheReader &reader, Waypoint &waypoint)
+{
+  CachedWaypoint cached;
+  if (!reader.Read(cached) ||
+      !reader.ReadString(waypoint.name) ||
+      !reader.ReadString(waypoint.comment) ||
+      !reader.ReadString(waypoint.details) ||
+      !ReadFileList(reader, waypoint.files_embed, cached.n_files_embed))
+    return false;
+
+#ifdef HAVE_RUN_FILE
+  if (!ReadFileList(reader, waypoint.files_external,
+                    cached.n_files_external))
+    return false;
+#else
+  if (cached.n_files_external > 0)
+    return false;
+#endif
+
+  waypoint.location = cached.location;
+  waypoint.elevation = cached.elevation;
+  waypoint.runway = cached.runway;
+  waypoint.radio_frequency = cached.radio_frequency;
+  waypoint.original_id = cached.original_id;
+  waypoint.type = cached.type;
+  waypoint.flags = cached.flags;
+  waypoint.origin = cached.origin;
+  return true;
+}
+
+static bool
+LoadWaypointCache(FILE *file, Path path, uint64_t terrain_stamp,
+                  std::vector<Waypoint> &waypoints)
+{
+  CacheHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      header.version != CacheHeader::VERSION ||
+      header.terrain_stamp != terrain_stamp ||
+      header.payload_size > MAX_PAYLOAD_SIZE ||
+      header.n_waypoints > header.payload_size / sizeof(CachedWaypoint))
+    return false;
+
+  /* read the whole payload at once, and decode it from memory */
+  std::vector<uint8_t> buffer(header.payload_size);
+  if (fread(buffer.data(), 1, buffer.size(), file) != buffer.size())
+    return false;
+
+  CacheReader reader(buffer.data(), buffer.size());
+
+  /* the entry may have been created for a different file with the
+     same size and modification time */
+  tstring original_path;
+  if (!reader.ReadString(original_path, header.path_length) ||
+      original_path != path.c_str())
+    return false;
+
+  const size_t old_size = waypoints.size();
+  waypoints.resize(old_size + header.n_waypoints);
+
+  for (size_t i = old_size; i < waypoints.size(); ++i) {
+    if (!ReadWaypoint(reader, waypoints[i])) {
+      waypoints.resize(old_size);
+      return false;
+    }
+  }
+
+  if (!reader.IsEnd()) {
+    waypoints.resize(old_size);
+    return false;
+  }
+
+  return true;
+}
+
+bool
+LoadWaypointCache(FileCache &cache, const TCHAR *name, Path path,
+                  uint64_t terrain_stamp, std::vector<Waypoint> &waypoints)
+{
+  FILE *file = cache.Load(name, path);
+  if (file == nullptr)
+    return false;
+
+  bool success = LoadWaypointCache(file, path, terrain_stamp, waypoints);
+  fclose(file);
+
+  if (!success)
+    cache.Flush(name);
+
+  return success;
+}
+
+bool
+SaveWaypointCache(FileCache &cache, const TCHAR *name, Path path,
+                  uint64_t terrain_stamp,
+                  const std::vector<Waypoint> &waypoints)
+{
+  const size_t path_length = _tcslen(path.c_str());
+
+  CacheWriter writer;
+  writer.Write(path.c_str(), path_length * sizeof(TCHAR));
+  for (const auto &waypoint : waypoints)
+    WriteWaypoint(writer, waypoint);
+
+  if (writer.size() > MAX_PAYLOAD_SIZE)
+    return false;
+
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+  header.version = CacheHeader::VERSION;
+  header.n_waypoints = waypoints.size();
+  header.terrain_stamp = terrain_stamp;
+  header.payload_size = writer.size();
+  header.path_length = path_length;
+
+  FILE *file = cache.Save(name, path);
+  if (file == nullptr)
+    return false;
+
+  if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+      fwrite(writer.data(), 1, writer.size(), file) != writer.size()) {
+    cache.Cancel(name, file);
+    return false;
+  }
+
+  return cache.Commit(name, file);
+}
@@ -0,0 +1,60 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_WAYPOINT_CACHE_HPP
+#define XCSOAR_WAYPOINT_CACHE_HPP
+
+#include <vector>
+
+#include <stdint.h>
+#include <tchar.h>
+
+struct Waypoint;
+class FileCache;
+class Path;
+
+/**
+ * Load a parsed waypoint file from the cache.  The entry is only used
+ * if the original file has not been modified since it was saved.
+ *
+ * @param name the name of the cache entry
+ * @param path the original waypoint file
+ * @param terrain_stamp identifies the terrain which was used to look
+ * up missing elevations (0 if there was none); the entry is discarded
+ * if it was created with a different one
+ * @return true on success, false if there was no valid cache entry
+ */
+bool
+LoadWaypointCache(FileCache &cache, const TCHAR *name, Path path,
+                  uint64_t terrain_stamp, std::vector<Waypoint> &waypoints);
+
+/**
+ * Save a parsed waypoint file to the cache.
+ *
+ * @see LoadWaypointCache()
+ */
+bool
+SaveWaypointCache(FileCache &cache, const TCHAR *name, Path path,
+                  uint64_t terrain_stamp,
+                  const std::vector<Waypoint> &waypoints);
+
+#endif
@@ -28,51 +28,80 @@ Copyright_License {
 #include "LogFile.hpp"
 #include "Waypoint/Waypoints.hpp"
 #include "WaypointReader.hpp"
+#include "WaypointCache.hpp"
 #include "Language/Language.hpp"
 #include "LocalPath.hpp"
 #include "Operation/Operation.hpp"
 #include "OS/Path.hpp"
 #include "IO/MapFile.hpp"
 #include "IO/ZipArchive.hpp"
+#include "OS/FileUtil.hpp"
+
+#include <vector>
+
+/**
+ * Returns a value which identifies the terrain file, to invalidate
+ * cached waypoint elevations which were looked up in a different one.
+ */
+static uint64_t
+GetTerrainStamp(const RasterTerrain *terrain)
+{
+  if (terrain == nullptr)
+    return 0;
+
+  const auto path = Profile::GetPath(ProfileKeys::MapFile);
+  if (path.IsNull())
+    return 1;
+
+  return (File::GetLastModification(path) * 31 + File::GetSize(path)) | 1;
+}
 
 static bool
 LoadWaypointFile(Waypoints &waypoints, Path path,
                  WaypointFileType file_type,
-                 WaypointOrigin origin,
-                 const RasterTerrain *terrain, OperationEnvironment &operation)
+                 WaypointOrigin origin, const TCHAR *cache_name,
+                 const RasterTerrain *terrain, FileCache *cache,
+                 OperationEnvironment &operation)
 {
-  if (!ReadWaypointFile(path, file_type, waypoints,
-                        WaypointFactory(origin, terrain),
-                        operation)) {
-    LogFormat(_T("Failed to read waypoint file: %s"), path.c_str());
-    return false;
+  const uint64_t terrain_stamp = GetTerrainStamp(terrain);
+
+  std::vector<Waypoint> list;
+  if (cache == nullptr ||
+      !LoadWaypointCache(*cache, cache_name, path, terrain_stamp, list)) {
+    if (!ReadWaypointFile(path, file_type, list,
+                          WaypointFactory(origin, terrain),
+                          operation)) {
+      LogFormat(_T("Failed to read waypoint file: %s"), path.c_str());
+      return false;
+    }
+
+    if (cache != nullptr)
+      SaveWaypointCache(*cache, cache_name, path, terrain_stamp, list);
   }
 
+  for (auto &waypoint : list)
+    waypoints.Append(std::move(waypoint));
+
   return true;
 }
 
 static bool
 LoadWaypointFile(Waypoints &waypoints, Path path,
-                 WaypointOrigin origin,
-                 const RasterTerrain *terrain, OperationEnvironment &operation)
+                 WaypointOrigin origin, const TCHAR *cache_name,
+                 const RasterTerrain *terrain, FileCache *cache,
+                 OperationEnvironment &operation)
 {
-  if (!ReadWaypointFile(path, waypoints,
-                        WaypointFactory(origin, terrain),
-                        operation)) {
-    LogFormat(_T("Failed to read waypoint file: %s"), path.c_str());
-    return false;
-  }
-
-  return true;
+  return LoadWaypointFile(waypoints, path, DetermineWaypointFileType(path),
+                          origin, cache_name, terrain, cache, operation);
 }
 
 static bool
-LoadWaypointFile(Waypoints &waypoints, struct zzip_dir *dir, const char *path,
+LoadWaypointFile(Waypoints &waypoints, ZipArchive &archive, const char *path,
                  WaypointFileType file_type,
                  WaypointOrigin origin,
                  const RasterTerrain *terrain, OperationEnvironment &operation)
 {
-  if (!ReadWaypointFile(dir, path, file_type, waypoints,
+  if (!ReadWaypointFile(archive, path, file_type, waypoints,
                         WaypointFactory(origin, terrain),
                         operation)) {
     LogFormat("Failed to read waypoint file: %s", path);
@@ -85,6 +114,7 @@ LoadWaypointFile(Waypoints &waypoints, struct zzip_dir *dir, const char *path,
 bool
 WaypointGlue::LoadWaypoints(Waypoints &way_points,
                             const RasterTerrain *terrain,
+                            FileCache *cache,
                             OperationEnvironment &operation)
 {
   LogFormat("ReadWaypoints");
@@ -97,25 +127,26 @@ WaypointGlue::LoadWaypoints(Waypoints &way_points,
 
   LoadWaypointFile(way_points, LocalPath(_T("user.cup")),
                    WaypointFileType::SEEYOU,
-                   WaypointOrigin::USER, terrain, operation);
+                   WaypointOrigin::USER, _T("waypoints-user"),
+                   terrain, cache, operation);
 
   // ### FIRST FILE ###
   auto path = Profile::GetPath(ProfileKeys::WaypointFile);
   if (!path.IsNull())
     found |= LoadWaypointFile(way_points, path, WaypointOrigin::PRIMARY,
-                              terrain, operation);
+                              _T("waypoints-1"), terrain, cache, operation);
 
   // ### SECOND FILE ###
   path = Profile::GetPath(ProfileKeys::AdditionalWaypointFile);
   if (!path.IsNull())
     found |= LoadWaypointFile(way_points, path, WaypointOrigin::ADDITIONAL,
-                              terrain, operation);
+                              _T("waypoints-2"), terrain, cache, operation);
 
   // ### WATCHED WAYPOINT/THIRD FILE ###
   path = Profile::GetPath(ProfileKeys::WatchedWaypointFile);
   if (!path.IsNull())
     found |= LoadWaypointFile(way_points, path, WaypointOrigin::WATCHED,
-                              terrain, operation);
+                              _T("waypoints-3"), terrain, cache, operation);
 
   // ### MAP/FOURTH FILE ###
 
@@ -123,12 +154,12 @@ WaypointGlue::LoadWaypoints(Waypoints &way_points,
   if (!found) {
     auto archive = OpenMapFile();
     if (archive) {
-      found |= LoadWaypointFile(way_points, archive->get(), "waypoints.xcw",
+      found |= LoadWaypointFile(way_points, *archive, "waypoints.xcw",
                                 WaypointFileType::WINPILOT,
                                 WaypointOrigin::MAP,
                                 terrain, operation);
 
-      found |= LoadWaypointFile(way_points, archive->get(), "waypoints.cup",
+      found |= LoadWaypointFile(way_points, *archive, "waypoints.cup",
                                 WaypointFileType::SEEYOU,
                                 WaypointOrigin::MAP,
                                 terrain, operation);
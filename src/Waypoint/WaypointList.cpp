@@ -23,8 +23,10 @@ Copyright_License {
 
 #include "WaypointList.hpp"
 #include "Waypoint/Waypoint.hpp"
+#include "Geo/GeoBatch.hpp"
 
 #include <algorithm>
+#include <numeric>
 
 void
 WaypointListItem::ResetVector()
@@ -41,19 +43,30 @@ WaypointListItem::GetVector(const GeoPoint &location) const
   return vec;
 }
 
-class WaypointDistanceCompare
+void
+WaypointList::SortByDistance(const GeoPoint &location)
 {
-  const GeoPoint &location;
+  /* calculate all distances in one batch on the FAI sphere; that is
+     good enough for sorting, and the (expensive) WGS84 vectors are
+     calculated later only for the items which are displayed */
+  GeoPointBatch batch;
+  batch.reserve(size());
+  for (const auto &i : *this)
+    batch.Append(i.waypoint->location);
+
+  std::vector<double> distances(size());
+  batch.Distances(location, distances.data());
 
-public:
-  WaypointDistanceCompare(const GeoPoint &_location):location(_location) {}
+  std::vector<unsigned> order(size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::sort(order.begin(), order.end(), [&distances](unsigned a, unsigned b){
+      return distances[a] < distances[b];
+    });
 
-  bool operator()(const WaypointListItem &a,
-                  const WaypointListItem &b) const {
-    return a.GetVector(location).distance < b.GetVector(location).distance;
-  }
-};
+  WaypointList sorted;
+  sorted.reserve(size());
+  for (unsigned i : order)
+    sorted.push_back(std::move((*this)[i]));
 
-void WaypointList::SortByDistance(const GeoPoint &location) {
-  std::sort(begin(), end(), WaypointDistanceCompare(location));
+  swap(sorted);
 }
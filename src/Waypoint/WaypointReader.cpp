@@ -80,6 +80,24 @@ try {
   return false;
 }
 
+bool
+ReadWaypointFile(Path path, WaypointFileType file_type,
+                 std::vector<Waypoint> &waypoints,
+                 WaypointFactory factory, OperationEnvironment &operation,
+                 unsigned max_threads)
+try {
+  std::unique_ptr<WaypointReaderBase> reader(CreateWaypointReader(file_type,
+                                                                  factory));
+  if (!reader)
+    return false;
+
+  FileLineReader line_reader(path, Charset::AUTO);
+  reader->ParseParallel(waypoints, line_reader, operation, max_threads);
+  return true;
+} catch (const std::runtime_error &) {
+  return false;
+}
+
 bool
 ReadWaypointFile(Path path, Waypoints &way_points,
                  WaypointFactory factory, OperationEnvironment &operation)
@@ -89,7 +107,7 @@ ReadWaypointFile(Path path, Waypoints &way_points,
 }
 
 bool
-ReadWaypointFile(struct zzip_dir *dir, const char *path,
+ReadWaypointFile(ZipArchive &archive, const char *path,
                  WaypointFileType file_type, Waypoints &way_points,
                  WaypointFactory factory, OperationEnvironment &operation)
 try {
@@ -98,7 +116,7 @@ try {
   if (!reader)
     return false;
 
-  ZipLineReader line_reader(dir, path, Charset::AUTO);
+  ZipLineReader line_reader(archive, path, Charset::AUTO);
   reader->Parse(way_points, line_reader, operation);
   return true;
 } catch (const std::runtime_error &e) {
@@ -25,10 +25,13 @@ Copyright_License {
 #ifndef WAYPOINT_READER_HPP
 #define WAYPOINT_READER_HPP
 
+#include <vector>
+
 #include <stdint.h>
 
 enum class WaypointFileType: uint8_t;
-struct zzip_dir;
+struct Waypoint;
+class ZipArchive;
 class Path;
 class Waypoints;
 class WaypointFactory;
@@ -43,8 +46,20 @@ bool
 ReadWaypointFile(Path path, Waypoints &way_points,
                  WaypointFactory factory, OperationEnvironment &operation);
 
+/**
+ * Parse the waypoint file into a list (without adding it to a
+ * #Waypoints instance).  Large files are parsed on multiple threads.
+ *
+ * @param max_threads see WaypointReaderBase::ParseParallel()
+ */
+bool
+ReadWaypointFile(Path path, WaypointFileType file_type,
+                 std::vector<Waypoint> &waypoints,
+                 WaypointFactory factory, OperationEnvironment &operation,
+                 unsigned max_threads=0);
+
 bool
-ReadWaypointFile(struct zzip_dir *dir, const char *path,
+ReadWaypointFile(ZipArchive &archive, const char *path,
                  WaypointFileType file_type, Waypoints &way_points,
                  WaypointFactory factory, OperationEnvironment &operation);
 
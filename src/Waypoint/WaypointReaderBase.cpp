@@ -22,8 +22,51 @@ Copyright_License {
 */
 
 #include "WaypointReaderBase.hpp"
+#include "Waypoint/Waypoints.hpp"
 #include "Operation/Operation.hpp"
 #include "IO/LineReader.hpp"
+#include "Thread/Thread.hpp"
+#include "OS/SystemLoad.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+
+#include <stdint.h>
+
+/**
+ * Parses one chunk of lines on a separate thread, with its own copy of
+ * the reader.
+ */
+class WaypointReaderBase::ParserThread final : public Thread {
+  const std::unique_ptr<WaypointReaderBase> reader;
+
+  const TCHAR *const*const lines;
+  const unsigned n_lines;
+
+  std::vector<Waypoint> waypoints;
+
+public:
+  ParserThread(WaypointReaderBase *_reader,
+               const TCHAR *const*_lines, unsigned _n_lines)
+    :Thread("WaypointParser"),
+     reader(_reader), lines(_lines), n_lines(_n_lines) {}
+
+  std::vector<Waypoint> &GetWaypoints() {
+    return waypoints;
+  }
+
+  void Parse() {
+    for (unsigned i = 0; i < n_lines; ++i)
+      reader->ParseLine(lines[i], waypoints);
+  }
+
+protected:
+  /* virtual methods from class Thread */
+  void Run() override {
+    Parse();
+  }
+};
 
 void
 WaypointReaderBase::Parse(Waypoints &way_points, TLineReader &reader,
@@ -32,13 +75,114 @@ WaypointReaderBase::Parse(Waypoints &way_points, TLineReader &reader,
   const long filesize = std::max(reader.GetSize(), 1l);
   operation.SetProgressRange(100);
 
+  std::vector<Waypoint> parsed;
+
   // Read through the lines of the file
   TCHAR *line;
   for (unsigned i = 0; (line = reader.ReadLine()) != nullptr; i++) {
     // and parse them
-    ParseLine(line, way_points);
+    ParseLine(line, parsed);
+
+    for (auto &waypoint : parsed)
+      way_points.Append(std::move(waypoint));
+    parsed.clear();
 
     if ((i & 0x3f) == 0)
       operation.SetProgressPosition(reader.Tell() * 100 / filesize);
   }
 }
+
+void
+WaypointReaderBase::ParseParallel(std::vector<Waypoint> &waypoints,
+                                  TLineReader &reader,
+                                  OperationEnvironment &operation,
+                                  unsigned max_threads)
+{
+  const long filesize = std::max(reader.GetSize(), 1l);
+  operation.SetProgressRange(100);
+
+  /* load the whole file into one buffer; the line pointers are
+     resolved after the buffer has stopped growing */
+  std::vector<TCHAR> buffer;
+  std::vector<size_t> offsets;
+  buffer.reserve(filesize);
+
+  TCHAR *line;
+  for (unsigned i = 0; (line = reader.ReadLine()) != nullptr; i++) {
+    offsets.push_back(buffer.size());
+    buffer.insert(buffer.end(), line, line + _tcslen(line) + 1);
+
+    if ((i & 0x3f) == 0)
+      operation.SetProgressPosition(reader.Tell() * 100 / filesize);
+  }
+
+  const unsigned n_lines = offsets.size();
+  std::vector<const TCHAR *> lines;
+  lines.reserve(n_lines);
+  for (const auto offset : offsets)
+    lines.push_back(buffer.data() + offset);
+
+  const unsigned n_chunks = max_threads > 0
+    ? std::min(max_threads, n_lines)
+    : std::min(SystemCPUCount(), n_lines / MIN_CHUNK_LINES);
+
+  if (n_chunks <= 1) {
+    for (const auto i : lines)
+      ParseLine(i, waypoints);
+    return;
+  }
+
+  /* the first chunk is parsed by the calling thread, with a copy of
+     the initial state */
+  ParserThread first(Clone(), lines.data(), n_lines / n_chunks);
+
+  std::vector<std::unique_ptr<ParserThread>> threads;
+  threads.reserve(n_chunks - 1);
+
+  std::vector<Waypoint> discard;
+  unsigned begin = 0;
+  for (unsigned chunk = 1; chunk < n_chunks; ++chunk) {
+    const unsigned end = uint64_t(n_lines) * chunk / n_chunks;
+
+    /* walk this reader's state up to the start of the next chunk */
+    for (unsigned i = begin; i < end; ++i) {
+      if (IsStateLine(lines[i])) {
+        ParseLine(lines[i], discard);
+        discard.clear();
+      }
+    }
+
+    const unsigned next_end = uint64_t(n_lines) * (chunk + 1) / n_chunks;
+    threads.emplace_back(new ParserThread(Clone(), lines.data() + end,
+                                          next_end - end));
+    ParserThread &thread = *threads.back();
+    if (!thread.Start())
+      thread.Parse();
+
+    begin = end;
+  }
+
+  first.Parse();
+  waypoints.reserve(waypoints.size() + first.GetWaypoints().size() *
+                    n_chunks);
+  std::move(first.GetWaypoints().begin(), first.GetWaypoints().end(),
+            std::back_inserter(waypoints));
+
+  for (auto &thread : threads) {
+    if (thread->IsDefined())
+      thread->Join();
+
+    auto &chunk_waypoints = thread->GetWaypoints();
+    std::move(chunk_waypoints.begin(), chunk_waypoints.end(),
+              std::back_inserter(waypoints));
+  }
+
+  /* bring this reader's state to the end of the file, just like
+     Parse() would */
+  for (unsigned i = begin; i < n_lines; ++i) {
+    if (IsStateLine(lines[i])) {
+      ParseLine(lines[i], discard);
+      discard.clear();
+    }
+  }
+}
@@ -27,6 +27,8 @@ Copyright_License {
 
 #include "Factory.hpp"
 
+#include <vector>
+
 #include <tchar.h>
 
 class Waypoints;
@@ -35,6 +37,15 @@ class OperationEnvironment;
 
 class WaypointReaderBase 
 {
+  class ParserThread;
+
+  /**
+   * Files with fewer lines than this per CPU are parsed sequentially
+   * by ParseParallel(); below that, the thread overhead outweighs
+   * the gain.
+   */
+  static constexpr unsigned MIN_CHUNK_LINES = 2048;
+
 protected:
   const WaypointFactory factory;
 
@@ -53,16 +64,46 @@ public:
   void Parse(Waypoints &way_points, TLineReader &reader,
              OperationEnvironment &operation);
 
+  /**
+   * Parses a waypoint file into the given list, using several
+   * threads.  The file is read into memory, split into chunks of
+   * lines, and each chunk is parsed by a copy of this reader on its
+   * own thread.  Lines which change the reader state (see
+   * IsStateLine()) are applied sequentially first, so the result is
+   * the same as with a sequential parse, in the same order.
+   *
+   * @param waypoints the list the new waypoints are appended to
+   * @param max_threads the maximum number of threads; 0 means one
+   * per CPU, but only for files large enough to benefit from it
+   */
+  void ParseParallel(std::vector<Waypoint> &waypoints, TLineReader &reader,
+                     OperationEnvironment &operation,
+                     unsigned max_threads=0);
+
 protected:
+  /**
+   * Create a copy of this reader, including its current state.
+   */
+  virtual WaypointReaderBase *Clone() const = 0;
+
+  /**
+   * Does this line modify the reader state in a way which affects how
+   * the following lines are parsed (e.g. a header line which selects
+   * the coordinate format)?
+   */
+  virtual bool IsStateLine(const TCHAR *line) const {
+    return false;
+  }
+
   /**
    * Parse a file line
    * @param line The line to parse
-   * @param linenum The line number in the file
-   * @param way_points The waypoint list to fill
+   * @param waypoints The list new waypoints are appended to
    * @return True if the line was parsed correctly or ignored, False if
    * parsing error occured
    */
-  virtual bool ParseLine(const TCHAR* line, Waypoints &way_points) = 0;
+  virtual bool ParseLine(const TCHAR *line,
+                         std::vector<Waypoint> &waypoints) = 0;
 };
 
 #endif
@@ -22,10 +22,12 @@ Copyright_License {
 */
 
 #include "WaypointReaderCompeGPS.hpp"
-#include "Waypoint/Waypoints.hpp"
+#include "Util/StringCompare.hxx"
 #include "IO/LineReader.hpp"
 #include "Geo/UTM.hpp"
 
+#include <string.h>
+
 static bool
 ParseAngle(const TCHAR *&src, Angle &angle)
 {
@@ -139,7 +141,14 @@ ParseAltitude(const TCHAR *&src, double &dest)
 }
 
 bool
-WaypointReaderCompeGPS::ParseLine(const TCHAR *line, Waypoints &waypoints)
+WaypointReaderCompeGPS::IsStateLine(const TCHAR *line) const
+{
+  return StringStartsWith(line, _T("U  0"));
+}
+
+bool
+WaypointReaderCompeGPS::ParseLine(const TCHAR *line,
+                                  std::vector<Waypoint> &waypoints)
 {
   /*
    * G  WGS 84
@@ -226,7 +235,7 @@ WaypointReaderCompeGPS::ParseLine(const TCHAR *line, Waypoints &waypoints)
   // Parse waypoint name
   waypoint.comment.assign(line);
 
-  waypoints.Append(std::move(waypoint));
+  waypoints.push_back(std::move(waypoint));
   return true;
 }
 
@@ -37,7 +37,14 @@ public:
 
 protected:
   /* virtual methods from class WaypointReaderBase */
-  bool ParseLine(const TCHAR *line, Waypoints &way_points) override;
+  WaypointReaderBase *Clone() const override {
+    return new WaypointReaderCompeGPS(*this);
+  }
+
+  bool IsStateLine(const TCHAR *line) const override;
+
+  bool ParseLine(const TCHAR *line,
+                 std::vector<Waypoint> &way_points) override;
 };
 
 #endif
@@ -37,7 +37,16 @@ public:
 
 protected:
   /* virtual methods from class WaypointReaderBase */
-  bool ParseLine(const TCHAR *line, Waypoints &way_points) override;
+  WaypointReaderBase *Clone() const override {
+    return new WaypointReaderFS(*this);
+  }
+
+  bool IsStateLine(const TCHAR *line) const override {
+    return line[0] == _T('$');
+  }
+
+  bool ParseLine(const TCHAR *line,
+                 std::vector<Waypoint> &way_points) override;
 };
 
 #endif
@@ -22,13 +22,15 @@ Copyright_License {
 */
 
 #include "WaypointReaderOzi.hpp"
-#include "Waypoint/Waypoints.hpp"
+#include "Util/StringCompare.hxx"
+#include "Util/StringUtil.hpp"
 #include "IO/LineReader.hpp"
 #include "Units/System.hpp"
 #include "Util/Macros.hpp"
 #include "Util/ExtractParameters.hpp"
 
 #include <stdlib.h>
+#include <string.h>
 
 static bool
 ParseAngle(const TCHAR *src, Angle &angle)
@@ -67,7 +69,8 @@ ParseString(const TCHAR *src, tstring &dest)
 }
 
 bool
-WaypointReaderOzi::ParseLine(const TCHAR *line, Waypoints &way_points)
+WaypointReaderOzi::ParseLine(const TCHAR *line,
+                             std::vector<Waypoint> &way_points)
 {
   if (line[0] == '\0')
     return true;
@@ -121,7 +124,7 @@ WaypointReaderOzi::ParseLine(const TCHAR *line, Waypoints &way_points)
   // Description
   ParseString(params[10], new_waypoint.comment);
 
-  way_points.Append(std::move(new_waypoint));
+  way_points.push_back(std::move(new_waypoint));
   return true;
 }
 
@@ -39,7 +39,16 @@ public:
 
 protected:
   /* virtual methods from class WaypointReaderBase */
-  bool ParseLine(const TCHAR *line, Waypoints &way_points) override;
+  WaypointReaderBase *Clone() const override {
+    return new WaypointReaderOzi(*this);
+  }
+
+  bool IsStateLine(const TCHAR *line) const override {
+    return ignore_lines > 0;
+  }
+
+  bool ParseLine(const TCHAR *line,
+                 std::vector<Waypoint> &way_points) override;
 };
 
 #endif
@@ -22,8 +22,9 @@ Copyright_License {
 */
 
 #include "WaypointReaderSeeYou.hpp"
+#include "Util/StringAPI.hxx"
+#include "Util/StringCompare.hxx"
 #include "Units/System.hpp"
-#include "Waypoint/Waypoints.hpp"
 #include "Util/ExtractParameters.hpp"
 #include "Util/Macros.hpp"
 
@@ -160,7 +161,14 @@ ParseStyle(const TCHAR* src, Waypoint::Type &type)
 }
 
 bool
-WaypointReaderSeeYou::ParseLine(const TCHAR* line, Waypoints &waypoints)
+WaypointReaderSeeYou::IsStateLine(const TCHAR *line) const
+{
+  return first || StringStartsWith(line, _T("-----Related Tasks-----"));
+}
+
+bool
+WaypointReaderSeeYou::ParseLine(const TCHAR *line,
+                                std::vector<Waypoint> &waypoints)
 {
   enum {
     iName = 0,
@@ -280,6 +288,6 @@ WaypointReaderSeeYou::ParseLine(const TCHAR* line, Waypoints &waypoints)
     new_waypoint.comment = params[iDescription];
   }
 
-  waypoints.Append(std::move(new_waypoint));
+  waypoints.push_back(std::move(new_waypoint));
   return true;
 }
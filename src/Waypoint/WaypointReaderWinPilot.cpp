@@ -23,7 +23,6 @@ Copyright_License {
 
 #include "WaypointReaderWinPilot.hpp"
 #include "Units/System.hpp"
-#include "Waypoint/Waypoints.hpp"
 #include "Util/ExtractParameters.hpp"
 #include "Util/StringAPI.hxx"
 #include "Util/NumberParser.hpp"
@@ -188,7 +187,8 @@ ParseFlags(const TCHAR* src, Waypoint &dest)
 }
 
 bool
-WaypointReaderWinPilot::ParseLine(const TCHAR *line, Waypoints &waypoints)
+WaypointReaderWinPilot::ParseLine(const TCHAR *line,
+                                  std::vector<Waypoint> &waypoints)
 {
   TCHAR ctemp[4096];
   const TCHAR *params[20];
@@ -254,6 +254,6 @@ WaypointReaderWinPilot::ParseLine(const TCHAR *line, Waypoints &waypoints)
   // Waypoint Flags (e.g. AT)
   ParseFlags(params[4], new_waypoint);
 
-  waypoints.Append(std::move(new_waypoint));
+  waypoints.push_back(std::move(new_waypoint));
   return true;
 }
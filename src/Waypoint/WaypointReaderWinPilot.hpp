@@ -41,7 +41,16 @@ public:
 
 protected:
   /* virtual methods from class WaypointReaderBase */
-  bool ParseLine(const TCHAR *line, Waypoints &way_points) override;
+  WaypointReaderBase *Clone() const override {
+    return new WaypointReaderWinPilot(*this);
+  }
+
+  bool IsStateLine(const TCHAR *line) const override {
+    return first && line[0] == _T('*');
+  }
+
+  bool ParseLine(const TCHAR *line,
+                 std::vector<Waypoint> &way_points) override;
 };
 
 #endif
@@ -23,14 +23,11 @@ Copyright_License {
 
 #include "RaspCache.hpp"
 #include "RaspStore.hpp"
+#include "RaspPrefetcher.hpp"
 #include "Terrain/RasterMap.hpp"
-#include "Terrain/Loader.hpp"
 #include "Language/Language.hpp"
-#include "OS/Path.hpp"
-#include "IO/ZipArchive.hpp"
 
 #include <assert.h>
-#include <windef.h> // for MAX_PATH
 
 static inline constexpr unsigned
 ToHalfHours(BrokenTime t)
@@ -38,6 +35,10 @@ ToHalfHours(BrokenTime t)
   return t.hour * 2u + t.minute / 30;
 }
 
+RaspCache::RaspCache(RaspPrefetcher &_prefetcher, unsigned _parameter)
+  :prefetcher(_prefetcher), store(prefetcher.GetStore()),
+   parameter(_parameter) {}
+
 const TCHAR *
 RaspCache::GetMapName() const
 {
@@ -99,32 +100,11 @@ RaspCache::Reload(BrokenTime time_local, OperationEnvironment &operation)
   if (effective_time == RaspStore::MAX_WEATHER_TIMES)
     return;
 
-  Close();
-
-  auto archive = store.OpenArchive();
-  if (!archive)
-    return;
-
-  char new_name[MAX_PATH];
-  store.NarrowWeatherFilename(new_name, Path(store.GetItemInfo(parameter).name),
-                              effective_time);
-
-  RasterMap *new_map = new RasterMap();
-  if (!LoadTerrainOverview(archive->get(), new_name, nullptr,
-                           new_map->GetTileCache(),
-                           true, operation)) {
-    delete new_map;
-    return;
-  }
-
-  new_map->UpdateProjection();
-
-  map = new_map;
+  map = prefetcher.Get(parameter, effective_time, operation);
 }
 
 void
 RaspCache::Close()
 {
-  delete map;
-  map = nullptr;
+  map.reset();
 }
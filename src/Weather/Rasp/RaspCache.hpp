@@ -26,19 +26,25 @@ Copyright_License {
 
 #include "Compiler.h"
 
+#include <memory>
+
 #include <tchar.h>
 
 struct BrokenTime;
 struct GeoPoint;
 class RaspStore;
+class RaspPrefetcher;
 class RasterMap;
 class OperationEnvironment;
 
 /**
  * Class to manage the raster weather map, to be loaded/selected from
- * a #RaspStore instance.
+ * a #RaspStore instance.  The maps are decoded (and cached) by a
+ * #RaspPrefetcher.
  */
 class RaspCache {
+  RaspPrefetcher &prefetcher;
+
   const RaspStore &store;
 
   const unsigned parameter;
@@ -46,14 +52,10 @@ class RaspCache {
   unsigned time = 0;
   unsigned last_time = 0;
 
-  RasterMap *map = nullptr;
+  std::shared_ptr<const RasterMap> map;
 
 public:
-  /** 
-   * Default constructor
-   */
-  RaspCache(const RaspStore &_store, unsigned _parameter)
-    :store(_store), parameter(_parameter) {}
+  RaspCache(RaspPrefetcher &_prefetcher, unsigned _parameter);
 
   ~RaspCache() {
     Close();
@@ -65,7 +67,7 @@ public:
 
   gcc_pure
   const RasterMap *GetMap() const {
-    return map;
+    return map.get();
   }
 
   /**
@@ -0,0 +1,284 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "RaspPrefetcher.hpp"
+#include "RaspStore.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/Loader.hpp"
+#include "Thread/Thread.hpp"
+#include "Operation/Operation.hpp"
+#include "OS/Path.hpp"
+#include "IO/ZipArchive.hpp"
+#include "LogFile.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <assert.h>
+#include <windef.h> // for MAX_PATH
+
+class RaspPrefetcher::Worker final : public Thread {
+  RaspPrefetcher &prefetcher;
+
+public:
+  explicit Worker(RaspPrefetcher &_prefetcher)
+    :Thread("RaspPrefetch"), prefetcher(_prefetcher) {}
+
+protected:
+  /* virtual methods from class Thread */
+  void Run() override {
+    SetIdlePriority();
+    prefetcher.Run();
+  }
+};
+
+RaspPrefetcher::RaspPrefetcher(const RaspStore &_store, unsigned n_threads)
+  :store(_store)
+{
+  n_threads = std::min(n_threads, MAX_THREADS);
+  workers.reserve(n_threads);
+
+  for (unsigned i = 0; i < n_threads; ++i) {
+    workers.emplace_back(new Worker(*this));
+    if (!workers.back()->Start()) {
+      workers.pop_back();
+      break;
+    }
+  }
+}
+
+RaspPrefetcher::~RaspPrefetcher()
+{
+  {
+    const ScopeLock protect(mutex);
+    stop = true;
+    cond.broadcast();
+  }
+
+  for (auto &worker : workers)
+    worker->Join();
+}
+
+std::shared_ptr<const RasterMap>
+RaspPrefetcher::Load(const RaspStore &store,
+                     unsigned parameter, unsigned time,
+                     OperationEnvironment &operation)
+{
+  auto archive = store.OpenArchive();
+  if (!archive)
+    return nullptr;
+
+  char name[MAX_PATH];
+  store.NarrowWeatherFilename(name, Path(store.GetItemInfo(parameter).name),
+                              time);
+
+  std::shared_ptr<RasterMap> map = std::make_shared<RasterMap>();
+  if (!LoadTerrainOverview(*archive, name, nullptr,
+                           map->GetTileCache(),
+                           true, operation))
+    return nullptr;
+
+  map->UpdateProjection();
+  return map;
+}
+
+RaspPrefetcher::Item *
+RaspPrefetcher::Find(unsigned parameter, unsigned time)
+{
+  for (auto &item : items)
+    if (item.parameter == parameter && item.time == time)
+      return &item;
+
+  return nullptr;
+}
+
+bool
+RaspPrefetcher::Evict(const Item *keep)
+{
+  auto victim = items.end();
+  for (auto i = items.begin(); i != items.end(); ++i)
+    if (&*i != keep && i->IsEvictable() &&
+        (victim == items.end() || i->last_used < victim->last_used))
+      victim = i;
+
+  if (victim == items.end())
+    return false;
+
+  items.erase(victim);
+  return true;
+}
+
+void
+RaspPrefetcher::Enqueue(unsigned parameter, unsigned time, unsigned priority,
+                        const Item *keep)
+{
+  Item *item = Find(parameter, time);
+  if (item != nullptr) {
+    if (item->state == Item::State::QUEUED)
+      item->priority = std::max(item->priority, priority);
+    return;
+  }
+
+  if (items.size() >= MAX_ITEMS && !Evict(keep))
+    return;
+
+  items.emplace_back(parameter, time, priority);
+  cond.broadcast();
+}
+
+void
+RaspPrefetcher::EnqueueNeighbours(unsigned parameter, unsigned time,
+                                  const Item *keep)
+{
+  /* the next time slot first, because that's the most common
+     direction when stepping through a forecast */
+  const unsigned base = clock * 4;
+
+  for (unsigned t = time + 1; t < RaspStore::MAX_WEATHER_TIMES; ++t) {
+    if (store.IsTimeAvailable(parameter, t)) {
+      Enqueue(parameter, t, base + 3, keep);
+      break;
+    }
+  }
+
+  for (unsigned t = time; t-- > 0;) {
+    if (store.IsTimeAvailable(parameter, t)) {
+      Enqueue(parameter, t, base + 2, keep);
+      break;
+    }
+  }
+
+  const unsigned n_parameters = store.GetItemCount();
+  if (parameter + 1 < n_parameters &&
+      store.IsTimeAvailable(parameter + 1, time))
+    Enqueue(parameter + 1, time, base + 1, keep);
+
+  if (parameter > 0 && store.IsTimeAvailable(parameter - 1, time))
+    Enqueue(parameter - 1, time, base, keep);
+}
+
+RaspPrefetcher::Item *
+RaspPrefetcher::NextQueued()
+{
+  Item *next = nullptr;
+  for (auto &item : items)
+    if (item.state == Item::State::QUEUED &&
+        (next == nullptr || item.priority > next->priority))
+      next = &item;
+
+  return next;
+}
+
+void
+RaspPrefetcher::Decode(Item &item, OperationEnvironment &operation)
+{
+  assert(item.state == Item::State::DECODING);
+
+  std::shared_ptr<const RasterMap> map;
+
+  {
+    const ScopeUnlock unlock(mutex);
+
+    try {
+      map = Load(store, item.parameter, item.time, operation);
+    } catch (const std::runtime_error &e) {
+      /* e.g. the RASP file has disappeared; this must not escape
+         from a worker thread, and waiters must not block forever */
+      LogError("Failed to load RASP map", e);
+    }
+  }
+
+  item.map = std::move(map);
+  item.state = item.map
+    ? Item::State::READY
+    : Item::State::FAILED;
+  cond.broadcast();
+}
+
+std::shared_ptr<const RasterMap>
+RaspPrefetcher::Get(unsigned parameter, unsigned time,
+                    OperationEnvironment &operation)
+{
+  assert(parameter < store.GetItemCount());
+  assert(time < RaspStore::MAX_WEATHER_TIMES);
+
+  const ScopeLock protect(mutex);
+
+  ++clock;
+
+  Item *item = Find(parameter, time);
+  if (item == nullptr) {
+    if (items.size() >= MAX_ITEMS)
+      Evict(nullptr);
+
+    items.emplace_back(parameter, time, 0);
+    item = &items.back();
+  }
+
+  item->last_used = clock;
+
+  if (!workers.empty())
+    EnqueueNeighbours(parameter, time, item);
+
+  if (item->state == Item::State::QUEUED) {
+    /* nobody has started decoding this one yet; don't wait for a
+       worker (which may be busy prefetching something else), do it
+       right here */
+    item->state = Item::State::DECODING;
+    Decode(*item, operation);
+  } else {
+    ++item->waiters;
+    while (item->state == Item::State::DECODING)
+      cond.wait(mutex);
+    --item->waiters;
+  }
+
+  return item->map;
+}
+
+bool
+RaspPrefetcher::IsReady(unsigned parameter, unsigned time) const
+{
+  const ScopeLock protect(mutex);
+  const Item *item = Find(parameter, time);
+  return item != nullptr && item->state == Item::State::READY;
+}
+
+void
+RaspPrefetcher::Run()
+{
+  NullOperationEnvironment operation;
+
+  const ScopeLock protect(mutex);
+
+  while (!stop) {
+    Item *item = NextQueued();
+    if (item == nullptr) {
+      cond.wait(mutex);
+      continue;
+    }
+
+    item->state = Item::State::DECODING;
+    Decode(*item, operation);
+  }
+}
@@ -0,0 +1,231 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_WEATHER_RASP_PREFETCHER_HPP
+#define XCSOAR_WEATHER_RASP_PREFETCHER_HPP
+
+#include "Thread/Mutex.hpp"
+#include "Thread/Cond.hxx"
+#include "Compiler.h"
+
+#include <memory>
+#include <list>
+#include <vector>
+
+class RaspStore;
+class RasterMap;
+class OperationEnvironment;
+
+/**
+ * Decodes RASP maps and keeps the most recently used ones in a
+ * bounded cache.  After a map has been requested, its neighbours
+ * (the adjacent time slots of the same parameter, and the same time
+ * slot of the adjacent parameters) are decoded in advance on
+ * background threads, so stepping through a forecast does not have
+ * to wait for the JPEG2000 decoder.
+ *
+ * Decoded maps are immutable and shared with the caller, so evicting
+ * a map from the cache does not affect a renderer which still uses
+ * it.
+ */
+class RaspPrefetcher {
+public:
+  /**
+   * The maximum number of maps (decoded or pending) in the cache.
+   */
+  static constexpr unsigned MAX_ITEMS = 8;
+
+  /**
+   * The maximum number of background threads.
+   */
+  static constexpr unsigned MAX_THREADS = 2;
+
+private:
+  class Worker;
+
+  struct Item {
+    unsigned parameter, time;
+
+    enum class State {
+      QUEUED,
+      DECODING,
+      READY,
+      FAILED,
+    } state;
+
+    /**
+     * Items with a higher priority are decoded first.
+     */
+    unsigned priority;
+
+    /**
+     * The #RaspPrefetcher::clock value of the last request.
+     */
+    unsigned last_used;
+
+    /**
+     * The number of Get() calls waiting for this item to be decoded
+     * by a worker.  Such an item must not be evicted.
+     */
+    unsigned waiters;
+
+    std::shared_ptr<const RasterMap> map;
+
+    Item(unsigned _parameter, unsigned _time, unsigned _priority)
+      :parameter(_parameter), time(_time), state(State::QUEUED),
+       priority(_priority), last_used(0), waiters(0) {}
+
+    bool IsEvictable() const {
+      return state != State::DECODING && waiters == 0;
+    }
+  };
+
+  const RaspStore &store;
+
+  /**
+   * Protects all attributes below.
+   */
+  mutable Mutex mutex;
+
+  /**
+   * Signalled when a new item was queued, when an item was decoded
+   * and on shutdown.
+   */
+  Cond cond;
+
+  /**
+   * A std::list, because workers keep pointers to items they decode.
+   */
+  std::list<Item> items;
+
+  unsigned clock = 0;
+
+  bool stop = false;
+
+  std::vector<std::unique_ptr<Worker>> workers;
+
+public:
+  /**
+   * @param n_threads the number of background threads; 0 disables
+   * prefetching (all maps are decoded on demand)
+   */
+  RaspPrefetcher(const RaspStore &_store, unsigned n_threads);
+  ~RaspPrefetcher();
+
+  RaspPrefetcher(const RaspPrefetcher &) = delete;
+  RaspPrefetcher &operator=(const RaspPrefetcher &) = delete;
+
+  const RaspStore &GetStore() const {
+    return store;
+  }
+
+  /**
+   * Obtain the specified map, and schedule its neighbours for
+   * prefetching.  If the map has not been decoded yet, it is decoded
+   * by the calling thread (or, if a worker is already busy with it,
+   * this method waits for the worker).
+   *
+   * @param time an available time index, see
+   * RaspStore::GetNearestTime()
+   * @return the map or nullptr on error
+   */
+  std::shared_ptr<const RasterMap> Get(unsigned parameter, unsigned time,
+                                       OperationEnvironment &operation);
+
+  /**
+   * Is the specified map already decoded?  This does not block.
+   */
+  gcc_pure
+  bool IsReady(unsigned parameter, unsigned time) const;
+
+  /**
+   * Decode one map synchronously.
+   *
+   * Throws std::runtime_error if the RASP file cannot be opened.
+   *
+   * @return the map or nullptr on error
+   */
+  static std::shared_ptr<const RasterMap> Load(const RaspStore &store,
+                                               unsigned parameter,
+                                               unsigned time,
+                                               OperationEnvironment &operation);
+
+private:
+  gcc_pure
+  Item *Find(unsigned parameter, unsigned time);
+
+  gcc_pure
+  const Item *Find(unsigned parameter, unsigned time) const {
+    return const_cast<RaspPrefetcher *>(this)->Find(parameter, time);
+  }
+
+  /**
+   * Make room for a new item by discarding the least recently used
+   * one which is not in use and not #keep.
+   *
+   * Caller must lock the mutex.
+   *
+   * @return false if no item could be discarded
+   */
+  bool Evict(const Item *keep);
+
+  /**
+   * Queue a map for background decoding, unless it is already in the
+   * cache.
+   *
+   * Caller must lock the mutex.
+   */
+  void Enqueue(unsigned parameter, unsigned time, unsigned priority,
+               const Item *keep);
+
+  /**
+   * Queue the neighbours of the specified map.
+   *
+   * Caller must lock the mutex.
+   */
+  void EnqueueNeighbours(unsigned parameter, unsigned time,
+                         const Item *keep);
+
+  /**
+   * Find the queued item with the highest priority.
+   *
+   * Caller must lock the mutex.
+   */
+  gcc_pure
+  Item *NextQueued();
+
+  /**
+   * Decode the specified item, which must be in state DECODING.  The
+   * mutex is released while decoding.
+   *
+   * Caller must lock the mutex.
+   */
+  void Decode(Item &item, OperationEnvironment &operation);
+
+  /**
+   * The main loop of a #Worker.
+   */
+  void Run();
+};
+
+#endif
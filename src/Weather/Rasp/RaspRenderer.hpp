@@ -46,8 +46,8 @@ class RaspRenderer {
   const ColorRamp *last_color_ramp = nullptr;
 
 public:
-  RaspRenderer(const RaspStore &_store, unsigned parameter)
-    :cache(_store, parameter) {}
+  RaspRenderer(RaspPrefetcher &prefetcher, unsigned parameter)
+    :cache(prefetcher, parameter) {}
 
   /**
    * Flush the cache.
@@ -0,0 +1,155 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "DataNodeInSitu.hpp"
+#include "Util/StringAPI.hxx"
+
+class XMLInSituTree::Builder final : public XML::Handler {
+  std::vector<Element> &elements;
+  std::vector<XML::Attribute> &attributes;
+
+  const TCHAR *const root_name;
+
+  /**
+   * The open elements.
+   */
+  std::vector<unsigned> stack;
+
+  /**
+   * The most recently added element on each level.  It is 0 on the
+   * innermost level if the element has no children yet.
+   */
+  std::vector<unsigned> last;
+
+public:
+  Builder(XMLInSituTree &tree, const TCHAR *_root_name)
+    :elements(tree.elements), attributes(tree.attributes),
+     root_name(_root_name) {}
+
+  /* virtual methods from XML::Handler */
+  bool OnStartElement(const TCHAR *name,
+                      const XML::Attribute *_attributes,
+                      unsigned n_attributes) override {
+    const unsigned i = elements.size();
+
+    if (stack.empty()) {
+      if (i > 0)
+        /* ignore everything after the root element */
+        return true;
+
+      if (root_name != nullptr && !StringIsEqual(name, root_name))
+        return false;
+    } else {
+      Element &parent = elements[stack.back()];
+      if (last.back() == 0)
+        parent.first_child = i;
+      else
+        elements[last.back()].next_sibling = i;
+      last.back() = i;
+    }
+
+    elements.push_back({
+        name,
+        unsigned(attributes.size()), n_attributes,
+        0, 0,
+      });
+    attributes.insert(attributes.end(),
+                      _attributes, _attributes + n_attributes);
+
+    stack.push_back(i);
+    last.push_back(0);
+    return true;
+  }
+
+  void OnEndElement() override {
+    if (stack.empty())
+      /* after the root element */
+      return;
+
+    stack.pop_back();
+    last.pop_back();
+  }
+};
+
+bool
+XMLInSituTree::Parse(TCHAR *buffer, const TCHAR *root_name)
+{
+  elements.clear();
+  attributes.clear();
+
+  Builder builder(*this, root_name);
+  return XML::ParseInSitu(buffer, builder) && !elements.empty();
+}
+
+const TCHAR *
+XMLInSituTree::GetAttribute(const Element &element, const TCHAR *name) const
+{
+  for (unsigned i = element.n_attributes; i > 0; --i) {
+    const auto &a = attributes[element.first_attribute + i - 1];
+    if (StringIsEqualIgnoreCase(a.name, name))
+      return a.value;
+  }
+
+  return nullptr;
+}
+
+const TCHAR *
+ConstDataNodeInSitu::GetName() const
+{
+  return element.name;
+}
+
+ConstDataNode *
+ConstDataNodeInSitu::GetChildNamed(const TCHAR *name) const
+{
+  for (unsigned i = element.first_child; i != 0; i = tree[i].next_sibling)
+    if (StringIsEqualIgnoreCase(tree[i].name, name))
+      return new ConstDataNodeInSitu(tree, i);
+
+  return nullptr;
+}
+
+ConstDataNode::List
+ConstDataNodeInSitu::ListChildren() const
+{
+  List list;
+  for (unsigned i = element.first_child; i != 0; i = tree[i].next_sibling)
+    list.push_back(new ConstDataNodeInSitu(tree, i));
+  return list;
+}
+
+ConstDataNode::List
+ConstDataNodeInSitu::ListChildrenNamed(const TCHAR *name) const
+{
+  List list;
+  for (unsigned i = element.first_child; i != 0; i = tree[i].next_sibling)
+    if (StringIsEqualIgnoreCase(tree[i].name, name))
+      list.push_back(new ConstDataNodeInSitu(tree, i));
+  return list;
+}
+
+const TCHAR *
+ConstDataNodeInSitu::GetAttribute(const TCHAR *name) const
+{
+  return tree.GetAttribute(element, name);
+}
@@ -0,0 +1,109 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_DATANODE_IN_SITU_HPP
+#define XCSOAR_DATANODE_IN_SITU_HPP
+
+#include "DataNode.hpp"
+#include "StreamParser.hpp"
+
+#include <vector>
+
+#include <assert.h>
+
+/**
+ * A read-only XML element tree built with XML::ParseInSitu().  It
+ * consists of two flat arrays and does not copy any strings; they
+ * point into the parsed buffer, which must stay valid as long as
+ * this object is used.
+ */
+class XMLInSituTree {
+public:
+  struct Element {
+    const TCHAR *name;
+
+    unsigned first_attribute, n_attributes;
+
+    /**
+     * Index of the first child element and of the next sibling, or 0
+     * if there is none (element 0 is the root, which is neither a
+     * child nor a sibling).
+     */
+    unsigned first_child, next_sibling;
+  };
+
+private:
+  std::vector<Element> elements;
+  std::vector<XML::Attribute> attributes;
+
+  class Builder;
+
+public:
+  /**
+   * Parse the specified buffer in place.
+   *
+   * @param root_name if not nullptr, then parsing stops as soon as
+   * the root element turns out to have a different name
+   * @return false on error
+   */
+  bool Parse(TCHAR *buffer, const TCHAR *root_name=nullptr);
+
+  const Element &operator[](unsigned i) const {
+    assert(i < elements.size());
+
+    return elements[i];
+  }
+
+  /**
+   * Look up an attribute (case insensitive); if it occurs more than
+   * once, the last one wins.
+   */
+  gcc_pure
+  const TCHAR *GetAttribute(const Element &element,
+                            const TCHAR *name) const;
+};
+
+/**
+ * ConstDataNode implementation for #XMLInSituTree
+ */
+class ConstDataNodeInSitu final : public ConstDataNode {
+  const XMLInSituTree &tree;
+  const XMLInSituTree::Element &element;
+
+public:
+  /**
+   * Construct a node for an element of the tree; by default, the
+   * root element.
+   */
+  explicit ConstDataNodeInSitu(const XMLInSituTree &_tree, unsigned i=0)
+    :tree(_tree), element(tree[i]) {}
+
+  /* virtual methods from ConstDataNode */
+  const TCHAR *GetName() const override;
+  ConstDataNode *GetChildNamed(const TCHAR *name) const override;
+  List ListChildren() const override;
+  List ListChildrenNamed(const TCHAR *name) const override;
+  const TCHAR *GetAttribute(const TCHAR *name) const override;
+};
+
+#endif
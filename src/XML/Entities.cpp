@@ -0,0 +1,75 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Entities.hpp"
+#include "Util/StringAPI.hxx"
+#include "Util/NumberParser.hpp"
+
+TCHAR *
+XML::UnescapeInPlace(TCHAR *p, TCHAR *end)
+{
+  TCHAR *d = p;
+  while (p < end) {
+    if (*p != _T('&')) {
+      *d++ = *p++;
+      continue;
+    }
+
+    ++p;
+    if (StringIsEqualIgnoreCase(p, _T("lt;"), 3)) {
+      *d++ = _T('<');
+      p += 3;
+    } else if (StringIsEqualIgnoreCase(p, _T("gt;"), 3)) {
+      *d++ = _T('>');
+      p += 3;
+    } else if (StringIsEqualIgnoreCase(p, _T("amp;"), 4)) {
+      *d++ = _T('&');
+      p += 4;
+    } else if (StringIsEqualIgnoreCase(p, _T("apos;"), 5)) {
+      *d++ = _T('\'');
+      p += 5;
+    } else if (StringIsEqualIgnoreCase(p, _T("quot;"), 5)) {
+      *d++ = _T('"');
+      p += 5;
+    } else if (*p == _T('#')) {
+      /* number entity */
+      ++p;
+
+      TCHAR *endptr;
+      unsigned i = ParseUnsigned(p, &endptr, 10);
+      if (endptr == p || endptr >= end || *endptr != _T(';'))
+        return nullptr;
+
+      // XXX convert to UTF-8 if !_UNICODE
+      TCHAR ch = (TCHAR)i;
+      if (ch == 0)
+        ch = _T(' ');
+
+      *d++ = ch;
+      p = endptr + 1;
+    } else
+      return nullptr;
+  }
+
+  return d;
+}
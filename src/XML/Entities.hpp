@@ -0,0 +1,43 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_XML_ENTITIES_HPP
+#define XCSOAR_XML_ENTITIES_HPP
+
+#include <tchar.h>
+
+namespace XML {
+  /**
+   * Resolve the entities in the specified range in place.  The result
+   * is never longer than the input.  The range must be followed by a
+   * character which is not a digit (e.g. the null terminator or the
+   * '<' of the next tag).
+   *
+   * @return the new end of the string, or nullptr if an entity was
+   * malformed
+   */
+  TCHAR *
+  UnescapeInPlace(TCHAR *p, TCHAR *end);
+}
+
+#endif
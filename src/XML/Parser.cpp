@@ -28,15 +28,16 @@
 
 #include "Parser.hpp"
 #include "Node.hpp"
+#include "Entities.hpp"
 #include "Util/CharUtil.hpp"
 #include "Util/StringAPI.hxx"
 #include "Util/StringUtil.hpp"
-#include "Util/NumberParser.hpp"
 #include "IO/FileLineReader.hpp"
 
 #include <stdexcept>
 
 #include <assert.h>
+#include <string.h>
 
 namespace XML {
   /** Main structure used for parsing XML. */
@@ -112,65 +113,25 @@ FromXMLString(const TCHAR *ss, size_t lo)
 {
   assert(ss != nullptr);
 
-  const TCHAR *end = ss + lo;
-
   /* allocate a buffer with the size of the input string; we know for
      sure that this is enough, because resolving entities can only
      shrink the string, but never grows */
-  TCHAR *d = (TCHAR *)malloc((lo + 1) * sizeof(*d));
-  assert(d);
-  TCHAR *result = d;
-  while (ss < end && *ss) {
-    if (*ss == _T('&')) {
-      ss++;
-      if (StringIsEqualIgnoreCase(ss, _T("lt;" ), 3)) {
-        *(d++) = _T('<' );
-        ss += 3;
-      } else if (StringIsEqualIgnoreCase(ss, _T("gt;" ), 3)) {
-        *(d++) = _T('>' );
-        ss += 3;
-      } else if (StringIsEqualIgnoreCase(ss, _T("amp;" ), 4)) {
-        *(d++) = _T('&' );
-        ss += 4;
-      } else if (StringIsEqualIgnoreCase(ss, _T("apos;"), 5)) {
-        *(d++) = _T('\'');
-        ss += 5;
-      } else if (StringIsEqualIgnoreCase(ss, _T("quot;"), 5)) {
-        *(d++) = _T('"' );
-        ss += 5;
-      } else if (*ss == '#') {
-        /* number entity */
-
-        ++ss;
-
-        TCHAR *endptr;
-        unsigned i = ParseUnsigned(ss, &endptr, 10);
-        if (endptr == ss || endptr >= end || *endptr != ';') {
-          free(result);
-          return nullptr;
-        }
-
-        // XXX convert to UTF-8 if !_UNICODE
-        TCHAR ch = (TCHAR)i;
-        if (ch == 0)
-          ch = ' ';
-
-        *d++ = ch;
-        ss = endptr + 1;
-      } else {
-        free(result);
-        return nullptr;
-      }
-    } else {
-      *(d++) = *ss;
-      ss++;
-    }
+  TCHAR *result = (TCHAR *)malloc((lo + 1) * sizeof(*result));
+  assert(result);
+  memcpy(result, ss, lo * sizeof(*result));
+  result[lo] = 0;
+
+  TCHAR *end = XML::UnescapeInPlace(result, result + lo);
+  if (end == nullptr) {
+    free(result);
+    return nullptr;
   }
-  *d = 0;
+
+  *end = 0;
 
   /* shrink the memory allocation just in case we allocated too
      much */
-  d = (TCHAR *)realloc(result, (d + 1 - result) * sizeof(*d));
+  TCHAR *d = (TCHAR *)realloc(result, (end + 1 - result) * sizeof(*d));
   if (d != nullptr)
     result = d;
 
@@ -892,8 +853,8 @@ XML::ParseString(const TCHAR *xml_string, Results *pResults)
   return new XMLNode(std::move(xnode));
 }
 
-static bool
-ReadTextFile(Path path, tstring &buffer)
+bool
+XML::ReadFile(Path path, tstring &buffer)
 try {
   /* auto-detect the character encoding, to be able to parse XCSoar
      6.0 task files */
@@ -937,7 +898,7 @@ XML::ParseFile(Path filename, Results *pResults)
   tstring buffer;
 
   // If file can't be read
-  if (!ReadTextFile(filename, buffer)) {
+  if (!ReadFile(filename, buffer)) {
     // If XML::Results object exists
     if (pResults) {
       // -> Save the error type into it
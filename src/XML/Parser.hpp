@@ -29,6 +29,7 @@
 #ifndef XCSOAR_XML_PARSER_HPP
 #define XCSOAR_XML_PARSER_HPP
 
+#include "Util/tstring.hpp"
 #include "Compiler.h"
 
 #include <tchar.h>
@@ -61,6 +62,13 @@ namespace XML {
   XMLNode *ParseString(const TCHAR *xml_string, Results *pResults=nullptr);
   XMLNode *ParseFile(Path path, Results *pResults=nullptr);
 
+  /**
+   * Read a (small) XML file into a string, converting it to TCHAR.
+   *
+   * @return false on error or if the file is too large
+   */
+  bool ReadFile(Path path, tstring &buffer);
+
   /**
    * Parse XML errors into a user friendly string.
    */
@@ -0,0 +1,315 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "StreamParser.hpp"
+#include "Entities.hpp"
+#include "Util/CharUtil.hpp"
+#include "Util/StringAPI.hxx"
+#include "Util/StringCompare.hxx"
+#include "Util/StringUtil.hpp"
+
+#include <vector>
+#include <iterator>
+
+gcc_const
+static inline bool
+IsNameChar(TCHAR ch)
+{
+  return !IsWhitespaceOrNull(ch) && ch != _T('/') && ch != _T('>') &&
+    ch != _T('<') && ch != _T('=') && ch != _T('"') && ch != _T('\'');
+}
+
+static TCHAR *
+SkipWhitespace(TCHAR *p)
+{
+  while (IsWhitespaceNotNull(*p))
+    ++p;
+  return p;
+}
+
+/**
+ * A non-const wrapper for StringFind().
+ */
+static TCHAR *
+FindString(TCHAR *p, const TCHAR *needle)
+{
+  const TCHAR *q = StringFind(p, needle);
+  return q != nullptr
+    ? p + (q - p)
+    : nullptr;
+}
+
+/**
+ * Skip to the end of the given string.
+ *
+ * @return the position after the string, or nullptr if it was not
+ * found
+ */
+static TCHAR *
+SkipPast(TCHAR *p, const TCHAR *needle)
+{
+  p = FindString(p, needle);
+  return p != nullptr
+    ? p + StringLength(needle)
+    : nullptr;
+}
+
+namespace {
+  struct PendingAttribute {
+    TCHAR *name, *name_end, *value, *value_end;
+  };
+
+  class InSituParser {
+    XML::Handler &handler;
+
+    /**
+     * The names of all open elements.
+     */
+    std::vector<const TCHAR *> stack;
+
+    std::vector<PendingAttribute> pending;
+    std::vector<XML::Attribute> attributes;
+
+  public:
+    explicit InSituParser(XML::Handler &_handler):handler(_handler) {}
+
+    bool Parse(TCHAR *p);
+
+  private:
+    void Text(TCHAR *p, TCHAR *end);
+    TCHAR *StartTag(TCHAR *p);
+    TCHAR *EndTag(TCHAR *p);
+  };
+}
+
+inline void
+InSituParser::Text(TCHAR *p, TCHAR *end)
+{
+  if (stack.empty())
+    return;
+
+  p = SkipWhitespace(p);
+  end = p + StripRight(p, end - p);
+  if (p == end)
+    return;
+
+  end = XML::UnescapeInPlace(p, end);
+  if (end != nullptr)
+    handler.OnText(p, end - p);
+}
+
+/**
+ * Parse a start tag or an empty-element tag.
+ *
+ * @param p the position after the '<'
+ * @return the position after the tag, or nullptr on error
+ */
+inline TCHAR *
+InSituParser::StartTag(TCHAR *p)
+{
+  TCHAR *const name = p;
+  while (IsNameChar(*p))
+    ++p;
+
+  TCHAR *const name_end = p;
+  if (name_end == name)
+    return nullptr;
+
+  pending.clear();
+
+  bool empty_element;
+  while (true) {
+    p = SkipWhitespace(p);
+
+    if (*p == _T('>')) {
+      ++p;
+      empty_element = false;
+      break;
+    }
+
+    if (*p == _T('/') && p[1] == _T('>')) {
+      p += 2;
+      empty_element = true;
+      break;
+    }
+
+    PendingAttribute a;
+    a.name = p;
+    while (IsNameChar(*p))
+      ++p;
+
+    a.name_end = p;
+    if (a.name_end == a.name)
+      return nullptr;
+
+    p = SkipWhitespace(p);
+    if (*p != _T('=')) {
+      /* attribute without a value */
+      a.value = a.value_end = a.name_end;
+      pending.push_back(a);
+      continue;
+    }
+
+    p = SkipWhitespace(p + 1);
+
+    const TCHAR quote = *p;
+    if (quote == _T('"') || quote == _T('\'')) {
+      a.value = ++p;
+      while (*p != quote) {
+        if (*p == 0)
+          return nullptr;
+        ++p;
+      }
+
+      a.value_end = p++;
+    } else {
+      a.value = p;
+      while (IsNameChar(*p))
+        ++p;
+      a.value_end = p;
+    }
+
+    a.value_end = XML::UnescapeInPlace(a.value, a.value_end);
+    if (a.value_end == nullptr)
+      return nullptr;
+
+    pending.push_back(a);
+  }
+
+  /* all delimiters have been consumed; now the strings can be
+     terminated in place */
+
+  *name_end = 0;
+
+  attributes.clear();
+  for (const auto &a : pending) {
+    *a.name_end = 0;
+    *a.value_end = 0;
+    attributes.push_back({a.name, a.value});
+  }
+
+  if (!handler.OnStartElement(name, attributes.data(), attributes.size()))
+    return nullptr;
+
+  if (empty_element)
+    handler.OnEndElement();
+  else
+    stack.push_back(name);
+
+  return p;
+}
+
+/**
+ * Parse an end tag.
+ *
+ * @param p the position after the "</"
+ * @return the position after the tag, or nullptr on error
+ */
+inline TCHAR *
+InSituParser::EndTag(TCHAR *p)
+{
+  p = SkipWhitespace(p);
+
+  TCHAR *const name = p;
+  while (IsNameChar(*p))
+    ++p;
+
+  TCHAR *const name_end = p;
+  p = SkipWhitespace(p);
+  if (name_end == name || *p != _T('>'))
+    return nullptr;
+
+  *name_end = 0;
+
+  /* find the matching element; all elements opened after it are
+     closed implicitly */
+  auto i = stack.rbegin();
+  while (i != stack.rend() && !StringIsEqualIgnoreCase(*i, name))
+    ++i;
+
+  if (i == stack.rend())
+    return nullptr;
+
+  for (auto n = std::distance(stack.rbegin(), i) + 1; n > 0; --n) {
+    stack.pop_back();
+    handler.OnEndElement();
+  }
+
+  return p + 1;
+}
+
+bool
+InSituParser::Parse(TCHAR *p)
+{
+  while (*p != 0) {
+    if (*p != _T('<')) {
+      TCHAR *end = StringFind(p, _T('<'));
+      if (end == nullptr)
+        end = p + StringLength(p);
+
+      Text(p, end);
+      p = end;
+      continue;
+    }
+
+    ++p;
+    if (*p == _T('?'))
+      /* XML declaration or processing instruction */
+      p = SkipPast(p, _T("?>"));
+    else if (*p == _T('!')) {
+      if (StringStartsWith(p, _T("!--")))
+        p = SkipPast(p, _T("-->"));
+      else if (StringStartsWith(p, _T("![CDATA["))) {
+        p += 8;
+        TCHAR *end = FindString(p, _T("]]>"));
+        if (end == nullptr)
+          return false;
+
+        if (!stack.empty())
+          handler.OnText(p, end - p);
+        p = end + 3;
+      } else
+        /* DOCTYPE */
+        p = SkipPast(p, _T(">"));
+    } else if (*p == _T('/'))
+      p = EndTag(p + 1);
+    else
+      p = StartTag(p);
+
+    if (p == nullptr)
+      return false;
+  }
+
+  /* close the elements which are still open */
+  for (auto n = stack.size(); n > 0; --n)
+    handler.OnEndElement();
+
+  return true;
+}
+
+bool
+XML::ParseInSitu(TCHAR *buffer, Handler &handler)
+{
+  InSituParser parser(handler);
+  return parser.Parse(buffer);
+}
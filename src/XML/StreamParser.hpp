@@ -0,0 +1,81 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_XML_STREAM_PARSER_HPP
+#define XCSOAR_XML_STREAM_PARSER_HPP
+
+#include <stddef.h>
+#include <tchar.h>
+
+namespace XML {
+  struct Attribute {
+    const TCHAR *name, *value;
+  };
+
+  /**
+   * Receives the events from ParseInSitu().  All strings point into
+   * the parsed buffer.
+   */
+  class Handler {
+  public:
+    /**
+     * An element has been opened.
+     *
+     * @return false to stop parsing
+     */
+    virtual bool OnStartElement(const TCHAR *name,
+                                const Attribute *attributes,
+                                unsigned n_attributes) = 0;
+
+    /**
+     * The most recently opened element has been closed.  This is
+     * also called for empty-element tags ("<Foo/>").
+     */
+    virtual void OnEndElement() = 0;
+
+    /**
+     * Character data inside an element, with entities resolved.  It
+     * is not null-terminated.  The default implementation ignores
+     * it.
+     */
+    virtual void OnText(const TCHAR *text, size_t length) {}
+  };
+
+  /**
+   * A SAX-style XML parser which does not build a tree and does not
+   * copy strings: names and attribute values are null-terminated and
+   * unescaped in place, i.e. the buffer gets modified.
+   *
+   * Like the DOM parser, it is tolerant: unclosed elements are
+   * closed at the end of the input, and an end tag closes all
+   * elements up to the one with a matching name (case insensitive).
+   * Declarations, comments and DOCTYPE are skipped.
+   *
+   * @param buffer a null-terminated XML document
+   * @return false on syntax error or if the #Handler has stopped
+   * parsing
+   */
+  bool ParseInSitu(TCHAR *buffer, Handler &handler);
+}
+
+#endif
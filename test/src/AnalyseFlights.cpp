@@ -0,0 +1,349 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Batch version of AnalyseFlight: analyses all IGC files of one or
+ * more directories on a pool of worker threads and emits one JSON
+ * object per file and line ("JSON lines").
+ *
+ * Each worker owns at most one #FlightAnalysis at a time, so the
+ * memory footprint is bounded by the number of jobs and the trace
+ * sizes, not by the number of files.
+ */
+
+#include "FlightAnalysis.hpp"
+#include "DebugReplayIGC.hpp"
+#include "OS/Args.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "Thread/Thread.hpp"
+#include "Thread/Mutex.hpp"
+#include "IO/OutputStream.hxx"
+#include "IO/BufferedOutputStream.hxx"
+#include "JSON/Writer.hpp"
+#include "FlightPhaseJSON.hpp"
+#include "Util/StringCompare.hxx"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <exception>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * The contests solved for each flight, and the JSON names of their
+ * #ContestStatistics slots.
+ */
+static constexpr struct {
+  Contest contest;
+  const char *name;
+  const char *solutions[3];
+} contests[] = {
+  { Contest::OLC_SPRINT, "olc_sprint", { "sprint" } },
+  { Contest::OLC_FAI, "olc_fai", { "fai" } },
+  { Contest::OLC_CLASSIC, "olc_classic", { "classic" } },
+  { Contest::OLC_LEAGUE, "olc_league", { "league", "classic" } },
+  { Contest::OLC_PLUS, "olc_plus", { "classic", "triangle", "plus" } },
+  { Contest::XCONTEST, "xcontest", { "free", "triangle" } },
+  { Contest::DHV_XC, "dhv_xc", { "free", "triangle" } },
+  { Contest::SIS_AT, "sis_at", { "sis_at" } },
+  { Contest::NET_COUPE, "net_coupe", { "net_coupe" } },
+  { Contest::DMST, "dmst", { "quadrilateral" } },
+};
+
+static constexpr unsigned n_contests = sizeof(contests) / sizeof(contests[0]);
+
+struct Settings {
+  unsigned full_max_points = 512;
+  unsigned triangle_max_points = 1024;
+  unsigned sprint_max_points = 64;
+};
+
+/**
+ * An #OutputStream which appends to a std::string.  Used to render
+ * one complete JSON line before it is written to stdout atomically.
+ */
+class StringOutputStream final : public OutputStream {
+  std::string &value;
+
+public:
+  explicit StringOutputStream(std::string &_value):value(_value) {}
+
+  /* virtual methods from class OutputStream */
+  void Write(const void *data, size_t size) override {
+    value.append((const char *)data, size);
+  }
+};
+
+/**
+ * The list of files to be analysed, shared by all worker threads,
+ * and the lock which serialises writing to stdout.
+ */
+class FlightQueue {
+  Mutex mutex;
+  const std::vector<AllocatedPath> &files;
+  size_t next = 0;
+
+  Mutex output_mutex;
+
+public:
+  explicit FlightQueue(const std::vector<AllocatedPath> &_files)
+    :files(_files) {}
+
+  /**
+   * Claim the next file.
+   *
+   * @return nullptr when all files have been claimed
+   */
+  const AllocatedPath *Next() {
+    ScopeLock protect(mutex);
+    return next < files.size()
+      ? &files[next++]
+      : nullptr;
+  }
+
+  void Output(const std::string &line) {
+    ScopeLock protect(output_mutex);
+    fwrite(line.data(), 1, line.length(), stdout);
+    fputc('\n', stdout);
+  }
+};
+
+class IGCFileVisitor final : public File::Visitor {
+  std::vector<AllocatedPath> &files;
+
+public:
+  explicit IGCFileVisitor(std::vector<AllocatedPath> &_files)
+    :files(_files) {}
+
+  void Visit(Path path, Path filename) override {
+    files.emplace_back(path);
+  }
+};
+
+static void
+WriteContestStatistics(BufferedOutputStream &writer, unsigned i,
+                       const ContestStatistics &stats)
+{
+  JSON::ObjectWriter object(writer);
+
+  for (unsigned j = 0; j < 3 && contests[i].solutions[j] != nullptr; ++j)
+    object.WriteElement(contests[i].solutions[j], WriteContest,
+                        stats.result[j], stats.solution[j]);
+}
+
+static void
+WriteContests(BufferedOutputStream &writer, const ContestStatistics *stats)
+{
+  JSON::ObjectWriter object(writer);
+
+  for (unsigned i = 0; i < n_contests; ++i)
+    object.WriteElement(contests[i].name, WriteContestStatistics, i,
+                        stats[i]);
+}
+
+static void
+AnalyseFile(Path path, const Settings &settings, std::string &line)
+{
+  std::unique_ptr<DebugReplay> replay(DebugReplayIGC::Create(path));
+
+  std::unique_ptr<FlightAnalysis>
+    analysis(new FlightAnalysis(settings.full_max_points,
+                                settings.triangle_max_points,
+                                settings.sprint_max_points));
+  analysis->Run(*replay);
+  replay.reset();
+
+  ContestStatistics stats[n_contests];
+  for (unsigned i = 0; i < n_contests; ++i)
+    stats[i] = analysis->SolveContest(contests[i].contest);
+
+  StringOutputStream os(line);
+  BufferedOutputStream writer(os);
+
+  {
+    JSON::ObjectWriter root(writer);
+
+    root.WriteElement("file", JSON::WriteString, path.c_str());
+    root.WriteElement("events", WriteEvents, analysis->GetEvents());
+    root.WriteElement("phases", WritePhaseList, analysis->GetPhases());
+    root.WriteElement("performance", WritePerformanceStats,
+                      analysis->GetTotals());
+    root.WriteElement("contests", WriteContests, stats);
+  }
+
+  writer.Flush();
+}
+
+static void
+FormatError(Path path, const char *msg, std::string &line)
+{
+  StringOutputStream os(line);
+  BufferedOutputStream writer(os);
+
+  {
+    JSON::ObjectWriter root(writer);
+    root.WriteElement("file", JSON::WriteString, path.c_str());
+    root.WriteElement("error", JSON::WriteString, msg);
+  }
+
+  writer.Flush();
+}
+
+class AnalysisThread final : public Thread {
+  FlightQueue &queue;
+  const Settings &settings;
+
+public:
+  AnalysisThread(FlightQueue &_queue, const Settings &_settings)
+    :Thread("AnalyseFlights"), queue(_queue), settings(_settings) {}
+
+protected:
+  void Run() override {
+    const AllocatedPath *path;
+    while ((path = queue.Next()) != nullptr) {
+      std::string line;
+
+      try {
+        AnalyseFile(*path, settings, line);
+      } catch (const std::exception &e) {
+        line.clear();
+        FormatError(*path, e.what(), line);
+      }
+
+      queue.Output(line);
+    }
+  }
+};
+
+static bool
+ParseUnsigned(const char *value, unsigned &result)
+{
+  char *endptr;
+  unsigned long n = strtoul(value, &endptr, 10);
+  if (endptr == value || *endptr != 0 || n == 0)
+    return false;
+
+  result = n;
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  Settings settings;
+  unsigned n_jobs = 0;
+  bool recursive = false;
+
+  Args args(argc, argv,
+            "[options] PATH...\n"
+            "Analyses all IGC files in the given directories (or the given\n"
+            "files) in parallel and prints one JSON object per line.\n"
+            "Options:\n"
+            "  --jobs=N                 Number of worker threads (default = number of CPUs)\n"
+            "  --recursive              Scan sub-directories, too\n"
+            "  --full-points=512        Maximum number of full trace points (default = 512)\n"
+            "  --triangle-points=1024   Maximum number of triangle trace points (default = 1024)\n"
+            "  --sprint-points=64       Maximum number of sprint trace points (default = 64)");
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--jobs=")) != nullptr) {
+      if (!ParseUnsigned(value, n_jobs)) {
+        fputs("The jobs parameter could not be parsed correctly.\n", stderr);
+        args.UsageError();
+      }
+    } else if (StringIsEqual(arg, "--recursive")) {
+      recursive = true;
+    } else if ((value = StringAfterPrefix(arg, "--full-points=")) != nullptr) {
+      if (!ParseUnsigned(value, settings.full_max_points)) {
+        fputs("The full-points parameter could not be parsed correctly.\n", stderr);
+        args.UsageError();
+      }
+    } else if ((value = StringAfterPrefix(arg, "--triangle-points=")) != nullptr) {
+      if (!ParseUnsigned(value, settings.triangle_max_points)) {
+        fputs("The triangle-points parameter could not be parsed correctly.\n", stderr);
+        args.UsageError();
+      }
+    } else if ((value = StringAfterPrefix(arg, "--sprint-points=")) != nullptr) {
+      if (!ParseUnsigned(value, settings.sprint_max_points)) {
+        fputs("The sprint-points parameter could not be parsed correctly.\n", stderr);
+        args.UsageError();
+      }
+    } else {
+      args.UsageError();
+    }
+  }
+
+  if (args.IsEmpty())
+    args.UsageError();
+
+  std::vector<AllocatedPath> files;
+  IGCFileVisitor visitor(files);
+  while (!args.IsEmpty()) {
+    const Path path(args.GetNext());
+    if (Directory::Exists(path))
+      Directory::VisitSpecificFiles(path, "*.igc", visitor, recursive);
+    else
+      files.emplace_back(path);
+  }
+
+  std::sort(files.begin(), files.end(),
+            [](const AllocatedPath &a, const AllocatedPath &b){
+              return strcmp(a.c_str(), b.c_str()) < 0;
+            });
+
+  if (n_jobs == 0) {
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    n_jobs = n_cpus > 0 ? n_cpus : 1;
+  }
+
+  n_jobs = std::min<size_t>(n_jobs, std::max<size_t>(files.size(), 1));
+
+  FlightQueue queue(files);
+
+  std::vector<std::unique_ptr<AnalysisThread>> threads;
+  for (unsigned i = 0; i < n_jobs; ++i) {
+    threads.emplace_back(new AnalysisThread(queue, settings));
+    if (!threads.back()->Start()) {
+      threads.pop_back();
+      break;
+    }
+  }
+
+  if (threads.empty()) {
+    fputs("Failed to start worker threads\n", stderr);
+    return EXIT_FAILURE;
+  }
+
+  for (auto &thread : threads)
+    thread->Join();
+
+  return EXIT_SUCCESS;
+}
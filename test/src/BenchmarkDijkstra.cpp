@@ -0,0 +1,266 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Benchmark for the Dijkstra solvers: compare the edge map
+ * implementations on a synthetic stage graph, and measure the
+ * contest (OLC) and AAT min/max distance searches.
+ */
+
+#include "Engine/PathSolvers/Dijkstra.hpp"
+#include "Engine/PathSolvers/ScanTaskPointMap.hpp"
+#include "Engine/Task/PathSolvers/TaskDijkstraMin.hpp"
+#include "Engine/Task/PathSolvers/TaskDijkstraMax.hpp"
+#include "Engine/Trace/Trace.hpp"
+#include "Contest/ContestManager.hpp"
+#include "Geo/SearchPointVector.hpp"
+#include "Geo/GeoVector.hpp"
+#include "OS/Args.hpp"
+
+#include <vector>
+#include <chrono>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+class Stopwatch {
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
+public:
+  double Elapsed() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+};
+
+static void
+Report(const char *name, const char *operation, double ms,
+       unsigned long check)
+{
+  printf("%-9s %-12s %10.2f ms  (%lu)\n", name, operation, ms, check);
+}
+
+/**
+ * Solve a maximum-distance problem on a graph with #n_stages stages
+ * of #n_points points each, connecting each point to all points with
+ * an equal or higher index in the next stage (like
+ * ContestDijkstra::AddEdges()).
+ */
+template<typename Map>
+static unsigned
+SolveStageGraph(Dijkstra<ScanTaskPoint, Map> &dijkstra,
+                const std::vector<GeoPoint> &points, unsigned n_stages)
+{
+  const unsigned n_points = points.size();
+
+  dijkstra.Clear();
+  dijkstra.Reserve(n_points * n_stages);
+
+  for (unsigned i = 0; i < n_points; ++i) {
+    const ScanTaskPoint node(0, i);
+    dijkstra.Link(node, node, 0);
+  }
+
+  while (!dijkstra.IsEmpty()) {
+    const ScanTaskPoint node = dijkstra.Pop();
+    const unsigned stage = node.GetStageNumber();
+    if (stage + 1 == n_stages) {
+      /* walk back to the start to verify the solution */
+      unsigned length = 0;
+      for (ScanTaskPoint p = node; !p.IsFirst();) {
+        const ScanTaskPoint parent = dijkstra.GetPredecessor(p);
+        length += (unsigned)points[parent.GetPointIndex()]
+          .Distance(points[p.GetPointIndex()]);
+        p = parent;
+      }
+
+      return length;
+    }
+
+    const GeoPoint &from = points[node.GetPointIndex()];
+    for (unsigned j = node.GetPointIndex(); j < n_points; ++j) {
+      const unsigned distance = (unsigned)from.Distance(points[j]);
+      dijkstra.Link(ScanTaskPoint(stage + 1, j), node,
+                    DIJKSTRA_MINMAX_OFFSET - distance);
+    }
+  }
+
+  return 0;
+}
+
+template<typename Map>
+static void
+BenchmarkStageGraph(const char *name, const std::vector<GeoPoint> &points,
+                    unsigned n_stages, unsigned n_iterations)
+{
+  Dijkstra<ScanTaskPoint, Map> dijkstra;
+
+  Stopwatch sw;
+  unsigned long length = 0;
+  for (unsigned i = 0; i < n_iterations; ++i)
+    length = SolveStageGraph(dijkstra, points, n_stages);
+  Report(name, "stage graph", sw.Elapsed(), length);
+}
+
+/**
+ * Generate a pseudo-random cross country flight: straight legs
+ * between turn points, with some noise.
+ */
+static std::vector<GeoPoint>
+MakeFlight(unsigned n_points)
+{
+  std::vector<GeoPoint> points;
+  points.reserve(n_points);
+
+  GeoPoint location(Angle::Degrees(7.7), Angle::Degrees(51.0));
+  Angle bearing = Angle::Degrees(30);
+  for (unsigned i = 0; i < n_points; ++i) {
+    if (i % 64 == 0)
+      bearing = Angle::Degrees(rand() % 360);
+
+    location = GeoVector(200 + rand() % 400,
+                         bearing + Angle::Degrees(rand() % 40 - 20))
+      .EndPoint(location);
+    points.push_back(location);
+  }
+
+  return points;
+}
+
+static void
+BenchmarkContest(const char *name, Contest contest,
+                 const std::vector<GeoPoint> &points,
+                 unsigned n_iterations)
+{
+  Trace full_trace(0, Trace::null_time, points.size());
+  Trace triangle_trace(0, Trace::null_time, points.size());
+  Trace sprint_trace(0, 9000, 128);
+
+  unsigned t = 0;
+  for (const auto &p : points) {
+    const TracePoint point(p, t, 1000., 0., 256);
+    full_trace.push_back(point);
+    triangle_trace.push_back(point);
+    sprint_trace.push_back(point);
+    t += 4;
+  }
+
+  ContestManager manager(contest, full_trace, triangle_trace, sprint_trace);
+
+  Stopwatch sw;
+  for (unsigned i = 0; i < n_iterations; ++i) {
+    manager.Reset();
+    manager.SolveExhaustive();
+  }
+
+  Report(name, "exhaustive", sw.Elapsed(),
+         (unsigned long)manager.GetStats().GetResult().distance);
+}
+
+/**
+ * Generate the boundary of a circular AAT area.
+ */
+static SearchPointVector
+MakeArea(const GeoPoint &center, double radius, unsigned n_points)
+{
+  SearchPointVector v;
+  for (unsigned i = 0; i < n_points; ++i)
+    v.push_back(SearchPoint(GeoVector(radius, Angle::FullCircle() * i / n_points)
+                            .EndPoint(center)));
+  return v;
+}
+
+static void
+BenchmarkAAT(unsigned n_iterations)
+{
+  const GeoPoint start(Angle::Degrees(7.7), Angle::Degrees(51.0));
+
+  std::vector<SearchPointVector> boundaries;
+  boundaries.push_back(MakeArea(start, 1000, 32));
+  boundaries.push_back(MakeArea(GeoPoint(Angle::Degrees(8.5),
+                                         Angle::Degrees(51.6)),
+                                20000, 64));
+  boundaries.push_back(MakeArea(GeoPoint(Angle::Degrees(9.4),
+                                         Angle::Degrees(51.1)),
+                                30000, 64));
+  boundaries.push_back(MakeArea(GeoPoint(Angle::Degrees(8.6),
+                                         Angle::Degrees(50.5)),
+                                25000, 64));
+  boundaries.push_back(MakeArea(start, 1000, 32));
+
+  TaskDijkstraMax dijkstra_max;
+  dijkstra_max.SetTaskSize(boundaries.size());
+  for (unsigned i = 0; i < boundaries.size(); ++i)
+    dijkstra_max.SetBoundary(i, boundaries[i]);
+
+  {
+    Stopwatch sw;
+    unsigned long ok = 0;
+    for (unsigned i = 0; i < n_iterations; ++i)
+      ok += dijkstra_max.DistanceMax();
+    Report("AAT", "max distance", sw.Elapsed(), ok);
+  }
+
+  TaskDijkstraMin dijkstra_min;
+  dijkstra_min.SetTaskSize(boundaries.size());
+  for (unsigned i = 0; i < boundaries.size(); ++i)
+    dijkstra_min.SetBoundary(i, boundaries[i]);
+
+  const SearchPoint aircraft(GeoPoint(Angle::Degrees(7.8),
+                                      Angle::Degrees(51.1)));
+
+  {
+    Stopwatch sw;
+    unsigned long ok = 0;
+    for (unsigned i = 0; i < n_iterations; ++i)
+      ok += dijkstra_min.DistanceMin(aircraft);
+    Report("AAT", "min distance", sw.Elapsed(), ok);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "[NUM_POINTS [NUM_ITERATIONS]]");
+
+  unsigned n_points = 512, n_iterations = 10;
+  if (!args.IsEmpty())
+    n_points = args.ExpectNextInt();
+  if (!args.IsEmpty())
+    n_iterations = args.ExpectNextInt();
+  args.ExpectEnd();
+
+  srand(1);
+
+  const std::vector<GeoPoint> points = MakeFlight(n_points);
+
+  BenchmarkStageGraph<HashScanTaskPointMap>("hash", points, 7,
+                                            n_iterations);
+  BenchmarkStageGraph<DenseScanTaskPointMap<32>>("dense", points, 7,
+                                                 n_iterations);
+
+  BenchmarkContest("classic", Contest::OLC_CLASSIC, points, n_iterations);
+  BenchmarkContest("fai", Contest::OLC_FAI, points, n_iterations);
+
+  BenchmarkAAT(n_iterations * 10);
+
+  return EXIT_SUCCESS;
+}
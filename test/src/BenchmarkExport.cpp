@@ -0,0 +1,220 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measure the throughput of the frame buffer export kernels
+ * (Screen/Memory/Export.hpp, Dither.cpp): the portable per-pixel
+ * loops against the SIMD versions used on this CPU, on a screen
+ * sized greyscale/BGRA image.  The results of both are compared.
+ */
+
+#include "Screen/Memory/Export.hpp"
+#include "Screen/Memory/Dither.hpp"
+#include "OS/Args.hpp"
+
+#include <vector>
+#include <chrono>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+class Stopwatch {
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
+public:
+  double Elapsed() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+};
+
+static void
+Report(const char *kernel, const char *variant, double ms,
+       unsigned long n_pixels)
+{
+  printf("%-18s %-9s %10.2f ms  %8.1f Mpixel/s\n", kernel, variant, ms,
+         n_pixels / (ms * 1000.));
+}
+
+/**
+ * The original dithering loop with a branch per pixel, for
+ * comparison.
+ */
+static void
+BranchDitherGreyscale(const uint8_t *gcc_restrict src, unsigned src_pitch,
+                      uint8_t *gcc_restrict dest, unsigned dest_pitch,
+                      unsigned width, unsigned height)
+{
+  const unsigned width_2 = width + 2;
+  std::vector<int> error_dist_buffer(width_2 * 2u, 0);
+
+  for (; height; --height) {
+    int *gcc_restrict err_dist_l0 =
+      error_dist_buffer.data() + ((height & 1) ? width_2 : 0) + 1;
+    int *gcc_restrict err_dist_l1 =
+      error_dist_buffer.data() + ((height & 1) ? 0 : width_2);
+
+    int e0 = *err_dist_l0++;
+    int e1 = *err_dist_l1;
+
+    for (unsigned column = 0; column < width; ++column) {
+      int bwPix = e0 + src[column];
+
+      uint8_t color = 0;
+      if (bwPix >= 128) {
+        --color;
+        bwPix -= 255;
+      }
+
+      dest[column] = color;
+
+      bwPix >>= 1;
+
+      e0 = *err_dist_l0 + bwPix;
+      *err_dist_l0++ = e0;
+
+      bwPix >>= 1;
+
+      *err_dist_l1++ = e1 + bwPix;
+      e1 = bwPix;
+    }
+
+    *err_dist_l1 = e1;
+
+    src += src_pitch;
+    dest += dest_pitch;
+  }
+}
+
+template<typename F>
+static double
+Measure(unsigned n_frames, F &&f)
+{
+  Stopwatch sw;
+  for (unsigned i = 0; i < n_frames; ++i)
+    f();
+  return sw.Elapsed();
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "[WIDTH HEIGHT [FRAMES]]");
+
+  unsigned width = 800, height = 480, n_frames = 200;
+  if (!args.IsEmpty()) {
+    width = args.ExpectNextInt();
+    height = args.ExpectNextInt();
+  }
+  if (!args.IsEmpty())
+    n_frames = args.ExpectNextInt();
+  args.ExpectEnd();
+
+  const unsigned n = width * height;
+  const unsigned long n_total = (unsigned long)n * n_frames;
+
+#ifdef HAVE_OPTIMISED_EXPORT
+  const char *const optimised = "optimised";
+#else
+  const char *const optimised = "(none)";
+#endif
+
+  /* a map-like image: gradients with some noise */
+  srand(1);
+  std::vector<Luminosity8> grey(n);
+  std::vector<BGRA8Color> bgra(n);
+  for (unsigned y = 0; y < height; ++y) {
+    for (unsigned x = 0; x < width; ++x) {
+      const unsigned i = y * width + x;
+      const uint8_t noise = rand() & 0x1f;
+      grey[i] = Luminosity8(uint8_t((x + y) / 4 + noise));
+      bgra[i] = BGRA8Color(uint8_t(x + noise), uint8_t(y), uint8_t(x ^ y));
+    }
+  }
+
+  bool equal = true;
+
+  {
+    std::vector<uint32_t> a(n), b(n);
+    Report("grey->RGB8", "portable", Measure(n_frames, [&](){
+          PortableCopyGreyscaleToRGB8(a.data(), grey.data(), n);
+        }), n_total);
+    Report("grey->RGB8", optimised, Measure(n_frames, [&](){
+          CopyGreyscaleToRGB8(b.data(), grey.data(), n);
+        }), n_total);
+    equal &= a == b;
+  }
+
+  {
+    std::vector<RGB565Color> a(n), b(n);
+    Report("grey->RGB565", "portable", Measure(n_frames, [&](){
+          PortableCopyGreyscaleToRGB565(a.data(), grey.data(), n);
+        }), n_total);
+    Report("grey->RGB565", optimised, Measure(n_frames, [&](){
+          CopyGreyscaleToRGB565(b.data(), grey.data(), n);
+        }), n_total);
+    equal &= memcmp(a.data(), b.data(), n * sizeof(a.front())) == 0;
+  }
+
+  {
+    std::vector<RGB565Color> a(n), b(n);
+    Report("BGRA->RGB565", "portable", Measure(n_frames, [&](){
+          PortableBGRAToRGB565(a.data(), bgra.data(), n);
+        }), n_total);
+    Report("BGRA->RGB565", optimised, Measure(n_frames, [&](){
+          BGRAToRGB565(b.data(), bgra.data(), n);
+        }), n_total);
+    equal &= memcmp(a.data(), b.data(), n * sizeof(a.front())) == 0;
+  }
+
+  {
+    std::vector<uint8_t> a(n), b(n);
+    Dither dither;
+    Report("dither", "branch", Measure(n_frames, [&](){
+          BranchDitherGreyscale((const uint8_t *)grey.data(), width,
+                                a.data(), width, width, height);
+        }), n_total);
+    Report("dither", "mask", Measure(n_frames, [&](){
+          dither.DitherGreyscale((const uint8_t *)grey.data(), width,
+                                 b.data(), width, width, height);
+        }), n_total);
+    equal &= a == b;
+
+    /* expanding the dithered pixels to 32 bit in place */
+    std::vector<uint32_t> expanded(n), reference(n);
+    for (unsigned i = 0; i < n; ++i)
+      reference[i] = GreyscaleToRGB8(Luminosity8(b[i]));
+
+    Report("expand->RGB8", optimised, Measure(n_frames, [&](){
+          memcpy(expanded.data(), b.data(), n);
+          ExpandGreyscaleToRGB8(expanded.data(), n);
+        }), n_total);
+    equal &= expanded == reference;
+  }
+
+  if (!equal) {
+    fprintf(stderr, "Results differ\n");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
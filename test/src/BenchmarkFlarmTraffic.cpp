@@ -0,0 +1,181 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Feeds bursts of synthetic PFLAA sentences (one per target and
+ * second) through the NMEA parser, the #TrafficDatabase and the
+ * FlarmComputer, and prints how long each stage takes per burst.
+ * Each stage runs like in XCSoar: the parser writes into the
+ * database, DeviceBlackboard::Merge() copies the relevant targets
+ * into NMEAInfo, and the FlarmComputer processes that copy.
+ */
+
+#include "Device/Parser.hpp"
+#include "FLARM/FlarmComputer.hpp"
+#include "FLARM/FlarmDetails.hpp"
+#include "FLARM/Data.hpp"
+#include "NMEA/Info.hpp"
+#include "NMEA/Checksum.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "Compiler.h"
+
+#include <vector>
+#include <string>
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* the FLARMnet database is not needed here */
+const TCHAR *
+FlarmDetails::LookupCallsign(FlarmId id)
+{
+  return nullptr;
+}
+
+static std::string
+MakeSentence(const char *fmt, ...) gcc_printf(1, 2);
+
+static std::string
+MakeSentence(const char *fmt, ...)
+{
+  char buffer[128];
+
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(buffer, sizeof(buffer) - 4, fmt, ap);
+  va_end(ap);
+
+  AppendNMEAChecksum(buffer);
+  return buffer;
+}
+
+/**
+ * Generate one burst: a PFLAU status sentence and one PFLAA sentence
+ * per target.  The targets circle around the own aircraft at
+ * different distances.
+ */
+static void
+GenerateBurst(std::vector<std::string> &burst, unsigned n_targets,
+              unsigned second)
+{
+  burst.clear();
+  burst.push_back(MakeSentence("$PFLAU,%u,1,2,1,0,,0,,", n_targets));
+
+  for (unsigned i = 0; i < n_targets; ++i) {
+    const double radius = 200 + 50 * i;
+    const double angle = (second + i) * 0.05;
+    const int north = lround(radius * cos(angle));
+    const int east = lround(radius * sin(angle));
+    const int altitude = int(i % 20) * 10 - 100 + int(second % 30);
+    const unsigned track = unsigned(angle * 180 / M_PI + 90) % 360;
+
+    /* every fourth target is in stealth mode, which lets the
+       FlarmComputer calculate track, speed and climb rate */
+    if (i % 4 == 3)
+      burst.push_back(MakeSentence("$PFLAA,0,%d,%d,%d,2,%06X,,,,,1",
+                                   north, east, altitude, 0xDD0000 + i));
+    else
+      burst.push_back(MakeSentence("$PFLAA,0,%d,%d,%d,2,%06X,%u,5,28,1.0,1",
+                                   north, east, altitude, 0xDD0000 + i,
+                                   track));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "[TARGETS [SECONDS]]");
+  const unsigned n_targets = args.IsEmpty() ? 200 : args.ExpectNextInt();
+  const unsigned n_seconds = args.IsEmpty() ? 600 : args.ExpectNextInt();
+  args.ExpectEnd();
+
+  TrafficDatabase database;
+
+  NMEAParser parser;
+  parser.SetTrafficDatabase(&database);
+
+  FlarmComputer flarm_computer;
+
+  NMEAInfo basic;
+  basic.Reset();
+
+  FlarmData last_flarm;
+  last_flarm.Clear();
+
+  std::vector<std::string> burst;
+
+  /* the blackboard copies NMEAInfo on each merge */
+  NMEAInfo copy;
+
+  uint64_t parse_us = 0, merge_us = 0, compute_us = 0;
+
+  for (unsigned second = 1; second <= n_seconds; ++second) {
+    GenerateBurst(burst, n_targets, second);
+
+    basic.clock = second;
+    basic.time = second;
+    basic.time_available.Update(basic.clock);
+    basic.location = GeoPoint(Angle::Degrees(7.7), Angle::Degrees(51.2));
+    basic.location_available.Update(basic.clock);
+    basic.gps_altitude = 1000;
+    basic.gps_altitude_available.Update(basic.clock);
+    basic.Expire();
+
+    const uint64_t start = MonotonicClockUS();
+
+    for (const auto &line : burst)
+      parser.ParseLine(line.c_str(), basic);
+
+    const uint64_t parsed = MonotonicClockUS();
+
+    database.Expire(basic.clock);
+    database.CopyRelevant(basic.flarm.traffic);
+    copy = basic;
+
+    const uint64_t merged = MonotonicClockUS();
+
+    flarm_computer.Process(basic.flarm, last_flarm, basic);
+    last_flarm = basic.flarm;
+
+    compute_us += MonotonicClockUS() - merged;
+    merge_us += merged - parsed;
+    parse_us += parsed - start;
+  }
+
+  printf("targets:  %u (%u stored, %u in NMEAInfo)\n", n_targets,
+         database.GetActiveTrafficCount(),
+         basic.flarm.traffic.GetActiveTrafficCount());
+  printf("bursts:   %u\n", n_seconds);
+  printf("parser:   %.1f us per burst, %.2f us per sentence\n",
+         double(parse_us) / n_seconds,
+         double(parse_us) / n_seconds / (n_targets + 1));
+  printf("merge:    %.1f us per burst (NMEAInfo: %u bytes)\n",
+         double(merge_us) / n_seconds, unsigned(sizeof(copy)));
+  printf("computer: %.1f us per burst, %.2f us per target\n",
+         double(compute_us) / n_seconds,
+         double(compute_us) / n_seconds /
+         basic.flarm.traffic.GetActiveTrafficCount());
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compares the scalar geodesic functions with the batch kernels of
+ * #GeoPointBatch, and prints the time per location.
+ */
+
+#include "Geo/GeoBatch.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Geo/Math.hpp"
+#include "Geo/SimplifiedMath.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+
+#include <vector>
+
+#include <stdint.h>
+#include <stdio.h>
+
+static const GeoPoint center(Angle::Degrees(7.7), Angle::Degrees(51.05));
+
+static double result_sink;
+
+/**
+ * Run the given function #repeat times and print the time per
+ * location.
+ */
+template<typename F>
+static void
+Measure(const char *name, unsigned n, unsigned repeat, F &&f)
+{
+  const uint64_t start = MonotonicClockUS();
+
+  for (unsigned i = 0; i < repeat; ++i)
+    f();
+
+  const uint64_t duration = MonotonicClockUS() - start;
+  printf("%-28s %8.1f ns per location\n", name,
+         duration * 1000. / repeat / n);
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "[LOCATIONS [REPEAT]]");
+  const unsigned n = args.IsEmpty() ? 10000 : args.ExpectNextInt();
+  const unsigned repeat = args.IsEmpty() ? 100 : args.ExpectNextInt();
+  args.ExpectEnd();
+
+  std::vector<GeoPoint> points;
+  points.reserve(n);
+
+  GeoPointBatch batch;
+  batch.reserve(n);
+
+  unsigned seed = 42;
+  for (unsigned i = 0; i < n; ++i) {
+    seed = seed * 1103515245 + 12345;
+    const Angle bearing = Angle::Degrees((seed >> 8) % 3600 / 10.);
+    seed = seed * 1103515245 + 12345;
+    const double distance = 300000. * ((seed >> 8) % 1000) / 1000.;
+
+    points.push_back(FindLatitudeLongitudeS(center, bearing, distance));
+    batch.Append(points.back());
+  }
+
+  const GeoPoint origin = FindLatitudeLongitudeS(center, Angle::Degrees(33),
+                                                 12000);
+  const GeoPoint line_end = FindLatitudeLongitudeS(center, Angle::Degrees(210),
+                                                   80000);
+
+  std::vector<double> distances(n);
+  std::vector<Angle> bearings(n);
+
+  printf("locations: %u, repeat: %u\n\n", n, repeat);
+
+  Measure("DistanceBearing()", n, repeat, [&](){
+      for (unsigned i = 0; i < n; ++i)
+        DistanceBearing(origin, points[i], &distances[i], &bearings[i]);
+    });
+
+  Measure("DistanceBearingS()", n, repeat, [&](){
+      for (unsigned i = 0; i < n; ++i)
+        DistanceBearingS(origin, points[i], &distances[i], &bearings[i]);
+    });
+
+  Measure("batch WGS84", n, repeat, [&](){
+      batch.DistanceBearings(origin, distances.data(), bearings.data(),
+                             GeoPrecision::WGS84);
+    });
+
+  Measure("batch SPHERE", n, repeat, [&](){
+      batch.DistanceBearings(origin, distances.data(), bearings.data(),
+                             GeoPrecision::SPHERE);
+    });
+
+  Measure("batch SPHERE distance only", n, repeat, [&](){
+      batch.Distances(origin, distances.data(), GeoPrecision::SPHERE);
+    });
+
+  Measure("batch FLAT", n, repeat, [&](){
+      batch.DistanceBearings(origin, distances.data(), bearings.data(),
+                             GeoPrecision::FLAT);
+    });
+
+  putchar('\n');
+
+  Measure("ProjectedDistanceS()", n, repeat, [&](){
+      for (unsigned i = 0; i < n; ++i)
+        distances[i] = ProjectedDistanceS(origin, line_end, points[i]);
+    });
+
+  Measure("batch projected SPHERE", n, repeat, [&](){
+      batch.ProjectedDistances(origin, line_end, distances.data(),
+                               GeoPrecision::SPHERE);
+    });
+
+  Measure("batch projected FLAT", n, repeat, [&](){
+      batch.ProjectedDistances(origin, line_end, distances.data(),
+                               GeoPrecision::FLAT);
+    });
+
+  putchar('\n');
+
+  Measure("nearest, DistanceS() loop", n, repeat, [&](){
+      unsigned nearest = 0;
+      double nearest_distance = origin.DistanceS(points[0]);
+      for (unsigned i = 1; i < n; ++i) {
+        const double distance = origin.DistanceS(points[i]);
+        if (distance < nearest_distance) {
+          nearest = i;
+          nearest_distance = distance;
+        }
+      }
+
+      result_sink += nearest;
+    });
+
+  Measure("nearest, batch", n, repeat, [&](){
+      result_sink += batch.FindNearest(origin);
+    });
+
+  /* prevent the compiler from optimizing the loops away */
+  for (double d : distances)
+    result_sink += d;
+
+  return result_sink < 0;
+}
@@ -0,0 +1,419 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Renders the map with terrain, topography, airspace, waypoints and
+ * an optional IGC trail along a scripted pan/zoom/rotate path, and
+ * prints the frame rate and per-layer timings.  This needs no
+ * display: build with "make TARGET=UNIX VFB=y" to render into the
+ * memory canvas.
+ */
+
+#define ENABLE_RESOURCE_LOADER
+#define ENABLE_PROFILE
+#define ENABLE_SCREEN
+#define ENABLE_MAIN_WINDOW
+#define ENABLE_LOOK
+#define ENABLE_CMDLINE
+#define USAGE "[-WxH] [FRAMES [FILE.igc]]"
+#include "Main.hpp"
+#include "MapWindow/MapWindow.hpp"
+#include "MapWindow/RenderProfiler.hpp"
+#include "Renderer/TrailRenderer.hpp"
+#include "Computer/TraceComputer.hpp"
+#include "Terrain/RasterTerrain.hpp"
+#include "Profile/ProfileKeys.hpp"
+#include "Profile/ComputerProfile.hpp"
+#include "Profile/MapProfile.hpp"
+#include "Profile/Current.hpp"
+#include "Waypoint/WaypointGlue.hpp"
+#include "Topography/TopographyStore.hpp"
+#include "Topography/TopographyGlue.hpp"
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "IO/FileLineReader.hpp"
+#include "IO/ConfiguredFile.hpp"
+#include "IO/LineReader.hpp"
+#include "OS/Clock.hpp"
+#include "OS/Path.hpp"
+#include "Geo/Math.hpp"
+#include "Operation/Operation.hpp"
+#include "Thread/Debug.hpp"
+#include "Util/StaticArray.hxx"
+
+#include <algorithm>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ENABLE_OPENGL
+#error BenchmarkMapWindow renders offscreen and requires a build without OpenGL
+#endif
+
+void
+DeviceBlackboard::SetStartupLocation(const GeoPoint &loc, const double alt) {}
+
+#ifndef NDEBUG
+
+bool
+InDrawThread()
+{
+  return InMainThread();
+}
+
+#endif
+
+static unsigned n_frames = 1000;
+static AllocatedPath igc_path = nullptr;
+
+static Waypoints way_points;
+
+static Airspaces airspace_database;
+
+static TopographyStore *topography;
+static RasterTerrain *terrain;
+
+static TraceComputer trace_computer;
+static MoreData last_fix;
+
+class DrawThread {
+public:
+  static void UpdateAll(MapWindow &map) {
+    map.UpdateAll();
+  }
+};
+
+class BenchmarkMapWindow final : public MapWindow {
+public:
+  BenchmarkMapWindow(const MapLook &map_look,
+                     const TrafficLook &traffic_look)
+    :MapWindow(map_look, traffic_look) {}
+
+  void SetScreenAngle(Angle angle) {
+    visible_projection.SetScreenAngle(angle);
+  }
+
+protected:
+  /* virtual methods from class MapWindow */
+  void RenderTrail(Canvas &canvas, PixelPoint aircraft_pos) override {
+    /* there is no GlideComputer here; draw the complete trace
+       loaded from the IGC file */
+    trail_renderer.Draw(canvas, trace_computer, render_projection, 0,
+                        false, aircraft_pos,
+                        Basic(), Calculated(), GetMapSettings().trail);
+  }
+};
+
+void
+ParseCommandLine(Args &args)
+{
+  if (args.IsEmpty())
+    return;
+
+  const int n = args.ExpectNextInt();
+  if (n <= 0)
+    args.UsageError();
+
+  n_frames = n;
+
+  if (!args.IsEmpty())
+    igc_path = args.ExpectNextPath();
+}
+
+static void
+LoadFiles(PlacesOfInterestSettings &poi_settings,
+          TeamCodeSettings &team_code_settings)
+{
+  NullOperationEnvironment operation;
+
+  topography = new TopographyStore();
+  LoadConfiguredTopography(*topography, operation);
+
+  terrain = RasterTerrain::OpenTerrain(NULL, operation);
+
+  WaypointGlue::LoadWaypoints(way_points, terrain, nullptr, operation);
+  WaypointGlue::SetHome(way_points, terrain, poi_settings, team_code_settings,
+                        NULL, false);
+
+  auto reader = OpenConfiguredTextFile(ProfileKeys::AirspaceFile,
+                                       Charset::AUTO);
+  if (reader) {
+    AirspaceParser parser(airspace_database);
+    parser.Parse(*reader, operation);
+    airspace_database.Optimise();
+  }
+}
+
+/**
+ * Feed all fixes of the IGC file into #trace_computer.
+ *
+ * @return false if the file contains no valid fix
+ */
+static bool
+LoadTrace(Path path, const ComputerSettings &settings_computer)
+{
+  FileLineReaderA reader(path);
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  DerivedInfo calculated;
+  calculated.Reset();
+  calculated.flight.flying = true;
+
+  bool found = false;
+
+  char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    if (IGCParseExtensions(line, extensions))
+      continue;
+
+    IGCFix fix;
+    if (!IGCParseFix(line, extensions, fix) || !fix.gps_valid)
+      continue;
+
+    MoreData &basic = last_fix;
+    basic.Reset();
+    basic.clock = fix.time.GetSecondOfDay();
+    basic.time = fix.time.GetSecondOfDay();
+    basic.time_available.Update(basic.clock);
+    basic.location = fix.location;
+    basic.location_available.Update(basic.clock);
+    basic.gps_altitude = fix.gps_altitude;
+    basic.gps_altitude_available.Update(basic.clock);
+    basic.nav_altitude = fix.gps_altitude;
+
+    trace_computer.Update(settings_computer, basic, calculated);
+    found = true;
+  }
+
+  return found;
+}
+
+static void
+GenerateBlackboard(MapWindow &map, const ComputerSettings &settings_computer,
+                   const MapSettings &settings_map, bool have_trace)
+{
+  MoreData nmea_info;
+  DerivedInfo derived_info;
+
+  nmea_info.Reset();
+
+  if (have_trace) {
+    nmea_info.clock = last_fix.clock;
+    nmea_info.time = last_fix.time;
+    nmea_info.location = last_fix.location;
+    nmea_info.gps_altitude = last_fix.gps_altitude;
+  } else {
+    nmea_info.clock = 1;
+    nmea_info.time = 1297230000;
+    nmea_info.gps_altitude = 1500;
+
+    if (settings_computer.poi.home_location_available)
+      nmea_info.location = settings_computer.poi.home_location;
+    else if (terrain != nullptr)
+      nmea_info.location = terrain->GetTerrainCenter();
+    else {
+      nmea_info.location.latitude = Angle::Degrees(51.2);
+      nmea_info.location.longitude = Angle::Degrees(7.7);
+    }
+  }
+
+  nmea_info.alive.Update(nmea_info.clock);
+  nmea_info.time_available.Update(nmea_info.clock);
+  nmea_info.location_available.Update(nmea_info.clock);
+  nmea_info.track = Angle::Degrees(90);
+  nmea_info.track_available.Update(nmea_info.clock);
+  nmea_info.ground_speed = 50;
+  nmea_info.ground_speed_available.Update(nmea_info.clock);
+  nmea_info.gps_altitude_available.Update(nmea_info.clock);
+  nmea_info.nav_altitude = nmea_info.gps_altitude;
+
+  derived_info.Reset();
+  derived_info.terrain_valid = true;
+  derived_info.flight.flying = true;
+
+  if (terrain != nullptr)
+    while (terrain->UpdateTiles(nmea_info.location, 50000)) {}
+
+  map.ReadBlackboard(nmea_info, derived_info, settings_computer,
+                     settings_map);
+  map.SetLocation(nmea_info.location);
+  map.UpdateScreenBounds();
+}
+
+/**
+ * Accumulates #RenderProfiler::Statistics over more frames than the
+ * profiler's ring buffer holds.
+ */
+struct LayerTotal {
+  const char *name;
+  uint64_t duration, cpu;
+  unsigned maximum, n_frames;
+};
+
+static StaticArray<LayerTotal, RenderProfiler::MAX_LAYERS> layer_totals;
+static uint64_t total_render;
+static unsigned max_render, total_frames;
+
+static void
+Collect(RenderProfiler &profiler)
+{
+  const auto statistics = profiler.GetStatistics();
+  profiler.Clear();
+
+  if (statistics.n_frames == 0)
+    return;
+
+  total_render += uint64_t(statistics.average) * statistics.n_frames;
+  total_frames += statistics.n_frames;
+  if (statistics.maximum > max_render)
+    max_render = statistics.maximum;
+
+  for (const auto &layer : statistics.layers) {
+    auto i = std::find_if(layer_totals.begin(), layer_totals.end(),
+                          [&layer](const LayerTotal &t){
+                            return strcmp(t.name, layer.name) == 0;
+                          });
+    if (i == layer_totals.end()) {
+      if (layer_totals.full())
+        continue;
+
+      i = &layer_totals.append();
+      i->name = layer.name;
+      i->duration = i->cpu = 0;
+      i->maximum = i->n_frames = 0;
+    }
+
+    i->duration += uint64_t(layer.average) * statistics.n_frames;
+    i->cpu += uint64_t(layer.average_cpu) * statistics.n_frames;
+    i->n_frames += statistics.n_frames;
+    if (layer.maximum > i->maximum)
+      i->maximum = layer.maximum;
+  }
+}
+
+static void
+PrintResults(uint64_t elapsed_us, uint64_t update_us)
+{
+  if (total_frames == 0)
+    return;
+
+  printf("frames:   %u\n", total_frames);
+  printf("elapsed:  %.3f s (%.3f s loading terrain/topography)\n",
+         elapsed_us / 1000000., update_us / 1000000.);
+  printf("fps:      %.1f\n", total_frames * 1000000. / elapsed_us);
+  printf("render:   %.2f ms average, %.2f ms maximum\n",
+         total_render / 1000. / total_frames, max_render / 1000.);
+  printf("\n%-24s %10s %10s %10s\n",
+         "layer", "avg [ms]", "max [ms]", "cpu [ms]");
+
+  std::sort(layer_totals.begin(), layer_totals.end(),
+            [](const LayerTotal &a, const LayerTotal &b){
+              return a.duration > b.duration;
+            });
+
+  for (const auto &i : layer_totals)
+    printf("%-24s %10.3f %10.3f %10.3f\n", i.name,
+           i.duration / 1000. / i.n_frames, i.maximum / 1000.,
+           i.cpu / 1000. / i.n_frames);
+}
+
+static void
+Main()
+{
+  ComputerSettings settings_computer;
+  settings_computer.SetDefaults();
+  Profile::Load(Profile::map, settings_computer);
+
+  MapSettings settings_map;
+  settings_map.SetDefaults();
+  Profile::Load(Profile::map, settings_map);
+
+  LoadFiles(settings_computer.poi, settings_computer.team_code);
+
+  const bool have_trace = !igc_path.IsNull() &&
+    LoadTrace(igc_path, settings_computer);
+
+  BenchmarkMapWindow map(look->map, look->traffic);
+  map.SetWaypoints(&way_points);
+  map.SetAirspaces(&airspace_database);
+  map.SetTopography(topography);
+  map.SetTerrain(terrain);
+  map.Create(main_window, main_window.GetClientRect());
+  main_window.SetFullWindow(map);
+
+  GenerateBlackboard(map, settings_computer, settings_map, have_trace);
+  DrawThread::UpdateAll(map);
+
+  /* warm up caches which are filled by the first frame */
+  map.Repaint();
+
+  const GeoPoint center = map.GetLocation();
+
+  RenderProfiler &profiler = map.GetRenderProfiler();
+  profiler.SetEnabled(true);
+
+  uint64_t update_us = 0;
+  const uint64_t start = MonotonicClockUS();
+
+  for (unsigned i = 0; i < n_frames; ++i) {
+    /* circle around the start location once, zoom in and out twice
+       between 2 km and 50 km and rotate the map once */
+    const double t = double(i) / n_frames;
+    const Angle phase = Angle::FullCircle() * t;
+
+    map.SetLocation(FindLatitudeLongitude(center, phase, 10000));
+    map.SetMapScale(2000 * pow(25, (1 - (phase * 2).cos()) / 2));
+    map.SetScreenAngle(phase);
+    map.UpdateScreenBounds();
+
+    /* the DrawThread loads terrain tiles and topography between
+       frames; that is measured, but not as part of a frame */
+    const uint64_t update_start = MonotonicClockUS();
+    DrawThread::UpdateAll(map);
+    update_us += MonotonicClockUS() - update_start;
+
+    map.Repaint();
+
+    if ((i + 1) % RenderProfiler::MAX_FRAMES == 0)
+      Collect(profiler);
+  }
+
+  const uint64_t elapsed = MonotonicClockUS() - start;
+  Collect(profiler);
+
+  PrintResults(elapsed, update_us);
+
+  map.Destroy();
+
+  delete terrain;
+  delete topography;
+}
@@ -0,0 +1,136 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measures how long it takes to load a profile from the text file
+ * and from the binary copy, and how long it takes to save one
+ * modified value by rewriting the text file and by appending to the
+ * journal.
+ */
+
+#include "Profile/Map.hpp"
+#include "Profile/File.hpp"
+#include "Profile/BinaryFile.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "OS/Path.hpp"
+#include "Util/PrintException.hxx"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr unsigned ITERATIONS = 100;
+
+/**
+ * Generate a profile which looks like a real one: mostly small
+ * numbers, some strings and paths.
+ */
+static void
+Generate(ProfileMap &map, unsigned n)
+{
+  for (unsigned i = 0; i < n; ++i) {
+    char key[32], value[64];
+    sprintf(key, "Key%04u", i);
+    switch (i % 4) {
+    case 0:
+      sprintf(value, "/home/user/XCSoarData/file%u.cup", i);
+      map.Set(key, value);
+      break;
+
+    case 1:
+      map.Set(key, i * 0.25);
+      break;
+
+    default:
+      map.Set(key, int(i));
+      break;
+    }
+  }
+}
+
+template<typename F>
+static double
+Measure(F &&f)
+{
+  const uint64_t start = MonotonicClockUS();
+  for (unsigned i = 0; i < ITERATIONS; ++i)
+    f(i);
+  return double(MonotonicClockUS() - start) / ITERATIONS;
+}
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "[PROFILE.prf]");
+
+  ProfileMap map;
+  if (args.IsEmpty())
+    Generate(map, 500);
+  else
+    Profile::LoadFile(map, args.ExpectNextPath());
+  args.ExpectEnd();
+
+  const Path text_path(_T("output/BenchmarkProfile.prf"));
+  const Path binary_path(_T("output/BenchmarkProfile.prf.bin"));
+
+  Profile::SaveFile(map, text_path);
+  const auto stamp = Profile::StampFile(text_path);
+  Profile::SaveBinaryFile(map, binary_path, stamp);
+
+  printf("values:        %u\n", unsigned(map.size()));
+
+  printf("load text:     %.1f us\n", Measure([&](unsigned){
+        ProfileMap map2;
+        Profile::LoadFile(map2, text_path);
+      }));
+
+  printf("load binary:   %.1f us (including stamp)\n", Measure([&](unsigned){
+        ProfileMap map2;
+        Profile::LoadBinaryFile(map2, binary_path,
+                                Profile::StampFile(text_path));
+      }));
+
+  printf("save text:     %.1f us\n", Measure([&](unsigned i){
+        map.Set("Key0001", int(i));
+        Profile::SaveFile(map, text_path);
+      }));
+
+  Profile::SaveBinaryFile(map, binary_path, Profile::StampFile(text_path));
+  map.SetModified(false);
+
+  printf("append binary: %.1f us\n", Measure([&](unsigned i){
+        map.Set("Key0001", int(i));
+        Profile::AppendBinaryFile(map, map.GetModifiedKeys(), binary_path);
+        map.SetModified(false);
+      }));
+
+  printf("compact:       %.1f us\n", Measure([&](unsigned){
+        Profile::SaveFile(map, text_path);
+        Profile::SaveBinaryFile(map, binary_path,
+                                Profile::StampFile(text_path));
+      }));
+
+  return EXIT_SUCCESS;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,178 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compare #QuadTree and #GridIndex with a waypoint-like workload:
+ * bulk load, incremental inserts, range queries and nearest
+ * searches on a large number of randomly distributed points.
+ */
+
+#include "Util/QuadTree.hpp"
+#include "Util/GridIndex.hpp"
+#include "OS/Args.hpp"
+
+#include <vector>
+#include <chrono>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Item {
+  int x, y;
+};
+
+struct ItemAccessor {
+  int GetX(const Item *item) const {
+    return item->x;
+  }
+
+  int GetY(const Item *item) const {
+    return item->y;
+  }
+};
+
+typedef QuadTree<const Item *, ItemAccessor> ItemQuadTree;
+typedef GridIndex<const Item *, ItemAccessor> ItemGrid;
+
+struct CountVisitor {
+  unsigned long count = 0;
+
+  void operator()(const Item *) {
+    ++count;
+  }
+};
+
+/**
+ * Range of the generated coordinates; roughly the extent of a
+ * world-wide waypoint file in TaskProjection units.
+ */
+static constexpr int EXTENT = 1 << 20;
+
+class Stopwatch {
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
+public:
+  double Elapsed() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+};
+
+static void
+Report(const char *index, const char *operation, double ms,
+       unsigned long check)
+{
+  printf("%-9s %-12s %10.2f ms  (%lu)\n", index, operation, ms, check);
+}
+
+template<typename Index>
+static void
+Benchmark(const char *name, Index &index, const std::vector<Item> &items,
+          unsigned n_bulk, const std::vector<Item> &queries,
+          unsigned range)
+{
+  {
+    Stopwatch sw;
+    for (unsigned i = 0; i < n_bulk; ++i)
+      index.AddQuick(&items[i]);
+    index.Optimise();
+    Report(name, "bulk load", sw.Elapsed(), index.size());
+  }
+
+  {
+    /* incremental inserts, like Waypoints::Append() at runtime
+       (e.g. new markers) */
+    Stopwatch sw;
+    for (unsigned i = n_bulk; i < items.size(); ++i)
+      index.Add(&items[i]);
+    Report(name, "insert", sw.Elapsed(), index.size());
+  }
+
+  {
+    /* QuadTree needs this before it can be queried efficiently;
+       GridIndex rebuilds itself on demand */
+    Stopwatch sw;
+    index.Optimise();
+    Report(name, "optimise", sw.Elapsed(), index.size());
+  }
+
+  {
+    Stopwatch sw;
+    CountVisitor visitor;
+    for (const auto &q : queries)
+      index.VisitWithinRange(typename Index::Point(q.x, q.y), range,
+                             visitor);
+    Report(name, "range", sw.Elapsed(), visitor.count);
+  }
+
+  {
+    Stopwatch sw;
+    unsigned long found = 0;
+    for (const auto &q : queries)
+      if (index.FindNearest(typename Index::Point(q.x, q.y), range).first
+          != index.end())
+        ++found;
+    Report(name, "nearest", sw.Elapsed(), found);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "[NUM_POINTS [NUM_QUERIES [RANGE]]]");
+
+  unsigned n_points = 100000, n_queries = 10000, range = EXTENT / 200;
+  if (!args.IsEmpty())
+    n_points = args.ExpectNextInt();
+  if (!args.IsEmpty())
+    n_queries = args.ExpectNextInt();
+  if (!args.IsEmpty())
+    range = args.ExpectNextInt();
+  args.ExpectEnd();
+
+  srand(1);
+
+  /* clustered distribution: waypoint files are dense around
+     airfields and sparse elsewhere */
+  std::vector<Item> items(n_points);
+  for (auto &i : items) {
+    const int cx = (rand() % 64) * (EXTENT / 64);
+    const int cy = (rand() % 64) * (EXTENT / 64);
+    i.x = cx + rand() % (EXTENT / 64);
+    i.y = cy + rand() % (EXTENT / 64);
+  }
+
+  std::vector<Item> queries(n_queries);
+  for (auto &i : queries) {
+    i.x = rand() % EXTENT;
+    i.y = rand() % EXTENT;
+  }
+
+  const unsigned n_bulk = n_points - n_points / 10;
+
+  ItemQuadTree quad_tree;
+  Benchmark("QuadTree", quad_tree, items, n_bulk, queries, range);
+
+  ItemGrid grid;
+  Benchmark("GridIndex", grid, items, n_bulk, queries, range);
+
+  return EXIT_SUCCESS;
+}
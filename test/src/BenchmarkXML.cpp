@@ -0,0 +1,147 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+/*
+ * Compares the DOM parser (XML::ParseString() and ConstDataNodeXML)
+ * with the in-place parser (XMLInSituTree and ConstDataNodeInSitu),
+ * walking the resulting tree like the task deserialiser does.
+ */
+
+#include "XML/DataNodeInSitu.hpp"
+#include "XML/DataNodeXML.hpp"
+#include "XML/Node.hpp"
+#include "XML/Parser.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "OS/Path.hpp"
+#include "Util/tstring.hpp"
+
+#include <memory>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr unsigned ITERATIONS = 200;
+
+/**
+ * Generate a task file with the specified number of turn points.
+ */
+static void
+Generate(tstring &buffer, unsigned n)
+{
+  buffer = _T("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+              "<Task type=\"RT\" task_scored=\"1\" aat_min_time=\"10800\">\n");
+
+  TCHAR line[512];
+  for (unsigned i = 0; i < n; ++i) {
+    _stprintf(line,
+              _T("\t<Point type=\"%s\">\n"
+                 "\t\t<Waypoint name=\"Turn point &amp; %u\" id=\"%u\""
+                 " comment=\"Comment %u\" altitude=\"%u\">\n"
+                 "\t\t\t<Location longitude=\"%f\" latitude=\"%f\"/>\n"
+                 "\t\t</Waypoint>\n"
+                 "\t\t<ObservationZone type=\"Cylinder\" radius=\"%u\"/>\n"
+                 "\t</Point>\n"),
+              i == 0 ? _T("Start") : (i == n - 1 ? _T("Finish") : _T("Turn")),
+              i, i, i, 100 + i % 1000,
+              7 + i * 0.001, 51 - i * 0.001, 500 + i % 10 * 100);
+    buffer += line;
+  }
+
+  buffer += _T("</Task>\n");
+}
+
+/**
+ * Visit all nodes and look up some attributes.
+ */
+static unsigned
+Walk(const ConstDataNode &node)
+{
+  unsigned n = 1;
+  if (node.GetAttribute(_T("type")) != nullptr)
+    ++n;
+
+  double value;
+  if (node.GetAttribute(_T("latitude"), value))
+    ++n;
+
+  for (auto *child : node.ListChildren()) {
+    n += Walk(*child);
+    delete child;
+  }
+
+  return n;
+}
+
+template<typename F>
+static double
+Measure(F &&f)
+{
+  const uint64_t start = MonotonicClockUS();
+  for (unsigned i = 0; i < ITERATIONS; ++i)
+    f();
+  return double(MonotonicClockUS() - start) / ITERATIONS;
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "[FILE.tsk]");
+
+  tstring buffer;
+  if (args.IsEmpty())
+    Generate(buffer, 500);
+  else {
+    const auto path = args.ExpectNextPath();
+    if (!XML::ReadFile(path, buffer)) {
+      fprintf(stderr, "Failed to read file\n");
+      return EXIT_FAILURE;
+    }
+  }
+  args.ExpectEnd();
+
+  printf("size:   %u bytes\n", unsigned(buffer.length()));
+
+  unsigned n_dom = 0, n_in_situ = 0;
+
+  printf("DOM:    %.1f us\n", Measure([&](){
+        std::unique_ptr<XMLNode> node(XML::ParseString(buffer.c_str()));
+        if (node)
+          n_dom = Walk(ConstDataNodeXML(*node));
+      }));
+
+  printf("InSitu: %.1f us (including a copy of the buffer)\n",
+         Measure([&](){
+             tstring copy(buffer);
+             XMLInSituTree tree;
+             if (tree.Parse(&copy[0]))
+               n_in_situ = Walk(ConstDataNodeInSitu(tree));
+           }));
+
+  if (n_dom != n_in_situ) {
+    fprintf(stderr, "Mismatch: %u != %u\n", n_dom, n_in_situ);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,247 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "FlightAnalysis.hpp"
+#include "DebugReplay.hpp"
+#include "Contest/ContestManager.hpp"
+#include "Computer/Settings.hpp"
+#include "Formatter/TimeFormatter.hpp"
+#include "JSON/Writer.hpp"
+#include "JSON/GeoWriter.hpp"
+
+FlightAnalysis::FlightAnalysis(unsigned full_max_points,
+                               unsigned triangle_max_points,
+                               unsigned sprint_max_points)
+  :full_trace(0, Trace::null_time, full_max_points),
+   triangle_trace(0, Trace::null_time, triangle_max_points),
+   sprint_trace(0, 9000, sprint_max_points) {}
+
+static void
+Update(const MoreData &basic, const FlyingState &state,
+       FlightEvents &events)
+{
+  if (!basic.time_available || !basic.date_time_utc.IsDatePlausible())
+    return;
+
+  if (state.flying && !events.takeoff_time.IsPlausible()) {
+    events.takeoff_time = basic.GetDateTimeAt(state.takeoff_time);
+    events.takeoff_location = state.takeoff_location;
+  }
+
+  if (!state.flying && events.takeoff_time.IsPlausible() &&
+      !events.landing_time.IsPlausible()) {
+    events.landing_time = basic.GetDateTimeAt(state.landing_time);
+    events.landing_location = state.landing_location;
+  }
+
+  if (state.release_time >= 0 && !events.release_time.IsPlausible()) {
+    events.release_time = basic.GetDateTimeAt(state.release_time);
+    events.release_location = state.release_location;
+  }
+}
+
+static void
+Update(const MoreData &basic, const DerivedInfo &calculated,
+       FlightEvents &events)
+{
+  Update(basic, calculated.flight, events);
+}
+
+static void
+Finish(const MoreData &basic, const DerivedInfo &calculated,
+       FlightEvents &events)
+{
+  if (!basic.time_available || !basic.date_time_utc.IsDatePlausible())
+    return;
+
+  if (events.takeoff_time.IsPlausible() && !events.landing_time.IsPlausible()) {
+    events.landing_time = basic.date_time_utc;
+
+    if (basic.location_available)
+      events.landing_location = basic.location;
+  }
+}
+
+void
+FlightAnalysis::ComputeCircling(DebugReplay &replay,
+                                const CirclingSettings &circling_settings)
+{
+  circling_computer.TurnRate(replay.SetCalculated(),
+                             replay.Basic(),
+                             replay.Calculated().flight);
+  circling_computer.Turning(replay.SetCalculated(),
+                            replay.Basic(),
+                            replay.Calculated().flight,
+                            circling_settings);
+}
+
+void
+FlightAnalysis::Run(DebugReplay &replay)
+{
+  CirclingSettings circling_settings;
+  circling_settings.SetDefaults();
+
+  bool released = false;
+
+  GeoPoint last_location = GeoPoint::Invalid();
+  constexpr Angle max_longitude_change = Angle::Degrees(30);
+  constexpr Angle max_latitude_change = Angle::Degrees(1);
+
+  while (replay.Next()) {
+    ComputeCircling(replay, circling_settings);
+
+    const MoreData &basic = replay.Basic();
+
+    Update(basic, replay.Calculated(), events);
+    flight_phase_detector.Update(replay.Basic(), replay.Calculated());
+
+    if (!basic.time_available || !basic.location_available ||
+        !basic.NavAltitudeAvailable())
+      continue;
+
+    if (last_location.IsValid() &&
+        ((last_location.latitude - basic.location.latitude).Absolute() > max_latitude_change ||
+         (last_location.longitude - basic.location.longitude).Absolute() > max_longitude_change))
+      /* there was an implausible warp, which is usually triggered by
+         an invalid point declared "valid" by a bugged logger; if that
+         happens, we stop the analysis, because the IGC file is
+         obviously broken */
+      break;
+
+    last_location = basic.location;
+
+    if (!released && replay.Calculated().flight.release_time >= 0) {
+      released = true;
+
+      full_trace.EraseEarlierThan(replay.Calculated().flight.release_time);
+      triangle_trace.EraseEarlierThan(replay.Calculated().flight.release_time);
+      sprint_trace.EraseEarlierThan(replay.Calculated().flight.release_time);
+    }
+
+    if (released && !replay.Calculated().flight.flying)
+      /* the aircraft has landed, stop here */
+      /* TODO: at some point, we might want to emit the analysis of
+         all flights in this IGC file */
+      break;
+
+    const TracePoint point(basic);
+    full_trace.push_back(point);
+    triangle_trace.push_back(point);
+    sprint_trace.push_back(point);
+  }
+
+  Update(replay.Basic(), replay.Calculated(), events);
+  Finish(replay.Basic(), replay.Calculated(), events);
+  flight_phase_detector.Finish();
+}
+
+ContestStatistics
+FlightAnalysis::SolveContest(Contest contest)
+{
+  ContestManager manager(contest, full_trace, triangle_trace, sprint_trace);
+  manager.SolveExhaustive();
+  return manager.GetStats();
+}
+
+static void
+WriteEventAttributes(BufferedOutputStream &writer,
+                     const BrokenDateTime &time, const GeoPoint &location)
+{
+  JSON::ObjectWriter object(writer);
+
+  if (time.IsPlausible()) {
+    NarrowString<64> buffer;
+    FormatISO8601(buffer.buffer(), time);
+    object.WriteElement("time", JSON::WriteString, buffer);
+  }
+
+  if (location.IsValid())
+    JSON::WriteGeoPointAttributes(object, location);
+}
+
+static void
+WriteEvent(JSON::ObjectWriter &object, const char *name,
+           const BrokenDateTime &time, const GeoPoint &location)
+{
+  if (time.IsPlausible() || location.IsValid())
+    object.WriteElement(name, WriteEventAttributes, time, location);
+}
+
+void
+WriteEvents(BufferedOutputStream &writer, const FlightEvents &events)
+{
+  JSON::ObjectWriter object(writer);
+
+  WriteEvent(object, "takeoff", events.takeoff_time, events.takeoff_location);
+  WriteEvent(object, "release", events.release_time, events.release_location);
+  WriteEvent(object, "landing", events.landing_time, events.landing_location);
+}
+
+static void
+WritePoint(BufferedOutputStream &writer, const ContestTracePoint &point,
+           const ContestTracePoint *previous)
+{
+  JSON::ObjectWriter object(writer);
+
+  object.WriteElement("time", JSON::WriteLong, (long)point.GetTime());
+  JSON::WriteGeoPointAttributes(object, point.GetLocation());
+
+  if (previous != NULL) {
+    auto distance = point.DistanceTo(previous->GetLocation());
+    object.WriteElement("distance", JSON::WriteUnsigned, uround(distance));
+
+    unsigned duration =
+      std::max((int)point.GetTime() - (int)previous->GetTime(), 0);
+    object.WriteElement("duration", JSON::WriteUnsigned, duration);
+
+    if (duration > 0) {
+      auto speed = distance / duration;
+      object.WriteElement("speed", JSON::WriteDouble, speed);
+    }
+  }
+}
+
+static void
+WriteTrace(BufferedOutputStream &writer, const ContestTraceVector &trace)
+{
+  JSON::ArrayWriter array(writer);
+
+  const ContestTracePoint *previous = NULL;
+  for (auto i = trace.begin(), end = trace.end(); i != end; ++i) {
+    array.WriteElement(WritePoint, *i, previous);
+    previous = &*i;
+  }
+}
+
+void
+WriteContest(BufferedOutputStream &writer,
+             const ContestResult &result, const ContestTraceVector &trace)
+{
+  JSON::ObjectWriter object(writer);
+
+  object.WriteElement("score", JSON::WriteDouble, result.score);
+  object.WriteElement("distance", JSON::WriteDouble, result.distance);
+  object.WriteElement("duration", JSON::WriteUnsigned, (unsigned)result.time);
+  object.WriteElement("speed", JSON::WriteDouble, result.GetSpeed());
+
+  object.WriteElement("turnpoints", WriteTrace, trace);
+}
@@ -0,0 +1,119 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_FLIGHT_ANALYSIS_HPP
+#define XCSOAR_FLIGHT_ANALYSIS_HPP
+
+#include "Engine/Trace/Trace.hpp"
+#include "Contest/Settings.hpp"
+#include "Contest/ContestStatistics.hpp"
+#include "Computer/CirclingComputer.hpp"
+#include "FlightPhaseDetector.hpp"
+#include "Time/BrokenDateTime.hpp"
+#include "Geo/GeoPoint.hpp"
+
+class DebugReplay;
+class BufferedOutputStream;
+
+/**
+ * Takeoff, release and landing of a flight.
+ */
+struct FlightEvents {
+  BrokenDateTime takeoff_time, release_time, landing_time;
+  GeoPoint takeoff_location, release_location, landing_location;
+
+  FlightEvents() {
+    takeoff_time.Clear();
+    landing_time.Clear();
+    release_time.Clear();
+
+    takeoff_location.SetInvalid();
+    landing_location.SetInvalid();
+    release_location.SetInvalid();
+  }
+};
+
+/**
+ * Replays one flight and collects everything needed for a post-flight
+ * analysis: the flight events, the circling/cruise phases and the
+ * traces for the contest solvers.
+ *
+ * All state is owned by the instance, so several flights may be
+ * analysed concurrently with one instance per thread.
+ */
+class FlightAnalysis {
+  CirclingComputer circling_computer;
+  FlightPhaseDetector flight_phase_detector;
+
+  Trace full_trace, triangle_trace, sprint_trace;
+
+  FlightEvents events;
+
+public:
+  FlightAnalysis(unsigned full_max_points = 512,
+                 unsigned triangle_max_points = 1024,
+                 unsigned sprint_max_points = 64);
+
+  /**
+   * Consume the whole replay.  Stops after the first landing
+   * following a release, or at an implausible position warp.
+   */
+  void Run(DebugReplay &replay);
+
+  /**
+   * Run the exhaustive solver of the given contest on the traces
+   * collected by Run().
+   */
+  ContestStatistics SolveContest(Contest contest);
+
+  const FlightEvents &GetEvents() const {
+    return events;
+  }
+
+  const PhaseList &GetPhases() const {
+    return flight_phase_detector.GetPhases();
+  }
+
+  const PhaseTotals &GetTotals() const {
+    return flight_phase_detector.GetTotals();
+  }
+
+private:
+  void ComputeCircling(DebugReplay &replay,
+                       const CirclingSettings &circling_settings);
+};
+
+/**
+ * Write the takeoff/release/landing events as a JSON object.
+ */
+void
+WriteEvents(BufferedOutputStream &writer, const FlightEvents &events);
+
+/**
+ * Write one contest result including its turn points as a JSON
+ * object.
+ */
+void
+WriteContest(BufferedOutputStream &writer,
+             const ContestResult &result, const ContestTraceVector &trace);
+
+#endif
@@ -48,7 +48,7 @@ try {
 
   NullOperationEnvironment operation;
   RasterTileCache rtc;
-  if (!LoadTerrainOverview(archive.get(), rtc, operation)) {
+  if (!LoadTerrainOverview(archive, rtc, operation)) {
     fprintf(stderr, "LoadOverview failed\n");
     return EXIT_FAILURE;
   }
@@ -62,7 +62,7 @@ try {
 
   SharedMutex mutex;
   do {
-    UpdateTerrainTiles(archive.get(), rtc, mutex,
+    UpdateTerrainTiles(archive, rtc, mutex,
                        rtc.GetWidth() / 2, rtc.GetHeight() / 2, 1000);
   } while (rtc.IsDirty());
 
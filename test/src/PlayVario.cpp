@@ -65,8 +65,15 @@ private:
       return;
     }
 
+    /* the latency of the previous SetVario() call */
+    const auto latency = synthesiser.ReadLatency();
+
     auto vario = replay.Basic().brutto_vario;
-    printf("%2.1f\n", (double)vario);
+    printf("%2.1f", (double)vario);
+    if (latency.count > 0)
+      printf("  (latency %u us)", latency.max_us);
+    putchar('\n');
+
     synthesiser.SetVario(vario);
 
     timer.expires_from_now(std::chrono::seconds(1));
@@ -48,7 +48,7 @@ try {
   RasterMap map;
 
   NullOperationEnvironment operation;
-  if (!LoadTerrainOverview(archive.get(), map.GetTileCache(),
+  if (!LoadTerrainOverview(archive, map.GetTileCache(),
                            operation)) {
     fprintf(stderr, "failed to load map\n");
     return EXIT_FAILURE;
@@ -58,7 +58,7 @@ try {
 
   SharedMutex mutex;
   do {
-    UpdateTerrainTiles(archive.get(), map.GetTileCache(), mutex,
+    UpdateTerrainTiles(archive, map.GetTileCache(), mutex,
                        map.GetProjection(),
                        map.GetMapCenter(), 50000);
   } while (map.IsDirty());
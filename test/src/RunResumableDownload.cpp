@@ -0,0 +1,91 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Download a file with Net::ResumableDownload.  Run it again after
+ * interrupting it, and it resumes where it stopped.
+ */
+
+#include "Net/HTTP/ResumableDownload.hpp"
+#include "Net/HTTP/RateLimiter.hpp"
+#include "Net/HTTP/Session.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "OS/Sleep.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <stdio.h>
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "URL PATH [SEGMENTS [KBPS [MD5]]]");
+  const char *url = args.ExpectNext();
+  const auto path = args.ExpectNextPath();
+  const unsigned segments = args.IsEmpty()
+    ? Net::DownloadState::MAX_SEGMENTS
+    : args.ExpectNextInt();
+  const unsigned kbps = args.IsEmpty() ? 0 : args.ExpectNextInt();
+  const char *md5 = args.IsEmpty() ? nullptr : args.ExpectNext();
+  args.ExpectEnd();
+
+  Net::RateLimiter limiter;
+  limiter.SetRate(kbps * 1024, MonotonicClockMS());
+
+  Net::Session session;
+  Net::ResumableDownload download(session, url, path, md5,
+                                  std::max(segments, 1u));
+  download.Start();
+
+  const uint64_t start_time = MonotonicClockMS();
+
+  while (true) {
+    const unsigned delay = limiter.GetDelay(MonotonicClockMS());
+    if (delay > 0) {
+      Sleep(std::min(delay, 100u));
+      continue;
+    }
+
+    session.Select(10000);
+    session.Perform();
+
+    if (download.Poll())
+      break;
+
+    limiter.Consume(MonotonicClockMS(), download.TakeReceived());
+
+    fprintf(stderr, "\r%lld / %lld bytes",
+            (long long)download.GetPosition(),
+            (long long)download.GetSize());
+  }
+
+  const uint64_t duration = std::max<uint64_t>(MonotonicClockMS() - start_time,
+                                               1);
+  fprintf(stderr, "\r%lld bytes in %u ms\n",
+          (long long)download.GetPosition(), unsigned(duration));
+  return EXIT_SUCCESS;
+} catch (const std::exception &exception) {
+  fprintf(stderr, "\n%s\n", exception.what());
+  return EXIT_FAILURE;
+}
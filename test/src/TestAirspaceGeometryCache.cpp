@@ -0,0 +1,192 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Renderer/AirspaceGeometryCache.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+
+typedef AirspaceGeometryCache::Vertex Vertex;
+typedef std::vector<Vertex> VertexVector;
+
+static Vertex
+make_vertex(double longitude, double latitude)
+{
+  const GeoPoint location(Angle::Degrees(longitude),
+                          Angle::Degrees(latitude));
+  return Vertex{location, location.latitude.fastcosine()};
+}
+
+static bool
+equals(const VertexVector &a, const VertexVector &b)
+{
+  if (a.size() != b.size())
+    return false;
+
+  for (unsigned i = 0; i < a.size(); ++i)
+    if (!equals(a[i].location, b[i].location))
+      return false;
+
+  return true;
+}
+
+static void
+test_calculate_zoom()
+{
+  /* floor(log2(metres per pixel)) */
+  ok1(AirspaceGeometryCache::CalculateZoom(1) == 0);
+  ok1(AirspaceGeometryCache::CalculateZoom(0.5) == 1);
+  ok1(AirspaceGeometryCache::CalculateZoom(1. / 3) == 1);
+  ok1(AirspaceGeometryCache::CalculateZoom(1. / 1000) == 9);
+
+  /* very large scales are not simplified */
+  ok1(AirspaceGeometryCache::CalculateZoom(4) == -1);
+  ok1(AirspaceGeometryCache::CalculateZoom(1000) == -1);
+}
+
+static void
+test_simplify_degenerate()
+{
+  /* less than 3 points are left alone */
+  VertexVector empty;
+  AirspaceGeometryCache::Simplify(empty, 1000);
+  ok1(empty.empty());
+
+  const VertexVector one{make_vertex(7, 51)};
+  VertexVector v = one;
+  AirspaceGeometryCache::Simplify(v, 1000);
+  ok1(equals(v, one));
+
+  const VertexVector two{make_vertex(7, 51), make_vertex(7.1, 51)};
+  v = two;
+  AirspaceGeometryCache::Simplify(v, 1000);
+  ok1(equals(v, two));
+
+  /* a triangle can't be simplified, no matter how small it is */
+  const VertexVector triangle{
+    make_vertex(7, 51), make_vertex(7.0001, 51), make_vertex(7, 51.0001),
+  };
+  v = triangle;
+  AirspaceGeometryCache::Simplify(v, 100000);
+  ok1(equals(v, triangle));
+
+  /* a polygon whose vertices are on one line would collapse to less
+     than 3 points; it is left alone */
+  const VertexVector line{
+    make_vertex(7, 51), make_vertex(7.01, 51), make_vertex(7.02, 51),
+    make_vertex(7.03, 51),
+  };
+  v = line;
+  AirspaceGeometryCache::Simplify(v, 10);
+  ok1(equals(v, line));
+}
+
+static void
+test_simplify_ring()
+{
+  /* a square of roughly 1.1 km with redundant vertices on each edge;
+     the first vertex is not repeated at the end */
+  const VertexVector square{
+    make_vertex(0, 0), make_vertex(0.005, 0),
+    make_vertex(0.01, 0), make_vertex(0.01, 0.005),
+    make_vertex(0.01, 0.01), make_vertex(0.005, 0.01),
+    make_vertex(0, 0.01), make_vertex(0, 0.005),
+  };
+
+  const VertexVector corners{
+    make_vertex(0, 0), make_vertex(0.01, 0),
+    make_vertex(0.01, 0.01), make_vertex(0, 0.01),
+  };
+
+  VertexVector v = square;
+  AirspaceGeometryCache::Simplify(v, 1);
+  ok1(equals(v, corners));
+
+  /* the redundant vertex right before the first one (which closes
+     the ring) is removed, too */
+  ok1(!equals(v.back().location, square.back().location));
+
+  /* the result is stable */
+  AirspaceGeometryCache::Simplify(v, 1);
+  ok1(equals(v, corners));
+
+  /* the same square crossing the date line */
+  const VertexVector date_line{
+    make_vertex(179.995, 0), make_vertex(-180, 0),
+    make_vertex(-179.995, 0), make_vertex(-179.995, 0.005),
+    make_vertex(-179.995, 0.01), make_vertex(-180, 0.01),
+    make_vertex(179.995, 0.01), make_vertex(179.995, 0.005),
+  };
+
+  const VertexVector date_line_corners{
+    make_vertex(179.995, 0), make_vertex(-179.995, 0),
+    make_vertex(-179.995, 0.01), make_vertex(179.995, 0.01),
+  };
+
+  v = date_line;
+  AirspaceGeometryCache::Simplify(v, 1);
+  ok1(equals(v, date_line_corners));
+}
+
+static void
+test_simplify_tolerance()
+{
+  /* the middle vertex of the southern edge is about 11 m off the
+     line between the corners */
+  const VertexVector notch{
+    make_vertex(0, 0), make_vertex(0.005, 0.0001),
+    make_vertex(0.01, 0), make_vertex(0.01, 0.01),
+    make_vertex(0, 0.01),
+  };
+
+  const VertexVector corners{
+    make_vertex(0, 0), make_vertex(0.01, 0),
+    make_vertex(0.01, 0.01), make_vertex(0, 0.01),
+  };
+
+  /* below the tolerance: removed */
+  VertexVector v = notch;
+  AirspaceGeometryCache::Simplify(v, 20);
+  ok1(equals(v, corners));
+
+  /* above the tolerance: kept */
+  v = notch;
+  AirspaceGeometryCache::Simplify(v, 5);
+  ok1(equals(v, notch));
+
+  /* a huge tolerance never leaves less than 3 vertices */
+  v = notch;
+  AirspaceGeometryCache::Simplify(v, 100000);
+  ok1(v.size() >= 3);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(6 + 5 + 4 + 3);
+
+  test_calculate_zoom();
+  test_simplify_degenerate();
+  test_simplify_ring();
+  test_simplify_tolerance();
+
+  return exit_status();
+}
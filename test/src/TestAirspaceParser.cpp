@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/AbstractAirspace.hpp"
 #include "Engine/Airspace/AirspaceCircle.hpp"
 #include "Engine/Airspace/AirspacePolygon.hpp"
@@ -31,6 +32,8 @@ Copyright_License {
 #include "Util/StringAPI.hxx"
 #include "Util/PrintException.hxx"
 #include "IO/FileLineReader.hpp"
+#include "IO/FileCache.hpp"
+#include "OS/FileUtil.hpp"
 #include "Operation/Operation.hpp"
 #include "TestUtil.hpp"
 
@@ -273,13 +276,81 @@ TestTNP()
   }
 }
 
+static bool
+IsEqual(const AirspaceAltitude &a, const AirspaceAltitude &b)
+{
+  return a.reference == b.reference && a.altitude == b.altitude &&
+    a.flight_level == b.flight_level &&
+    a.altitude_above_terrain == b.altitude_above_terrain;
+}
+
+static bool
+IsEqual(const AbstractAirspace &a, const AbstractAirspace &b)
+{
+  if (a.GetShape() != b.GetShape() || a.GetType() != b.GetType() ||
+      !StringIsEqual(a.GetName(), b.GetName()) ||
+      a.GetRadioText() != b.GetRadioText() ||
+      !a.GetDays().equals(b.GetDays()) ||
+      !IsEqual(a.GetBase(), b.GetBase()) || !IsEqual(a.GetTop(), b.GetTop()))
+    return false;
+
+  if (a.GetShape() == AbstractAirspace::Shape::CIRCLE)
+    return a.GetCenter() == b.GetCenter() &&
+      ((const AirspaceCircle &)a).GetRadius() ==
+      ((const AirspaceCircle &)b).GetRadius();
+
+  const auto &pa = a.GetPoints(), &pb = b.GetPoints();
+  return pa.size() == pb.size() &&
+    std::equal(pa.begin(), pa.end(), pb.begin(),
+               [](const SearchPoint &x, const SearchPoint &y){
+                 return x.GetLocation() == y.GetLocation();
+               });
+}
+
+static void
+TestCache(Path path)
+{
+  const TCHAR *const name = _T("airspace");
+
+  Directory::Create(Path(_T("output/results")));
+  FileCache cache(AllocatedPath(_T("output/results")));
+  cache.Flush(name);
+
+  Airspaces parsed;
+  FileLineReader reader(path, Charset::AUTO);
+  NullOperationEnvironment operation;
+  ok1(AirspaceParser(parsed).Parse(reader, operation));
+
+  const auto &pending = parsed.GetPending();
+  const std::vector<const AbstractAirspace *> list(pending.begin(),
+                                                   pending.end());
+  ok1(!list.empty());
+
+  Airspaces cached;
+  ok1(!LoadAirspaceCache(cache, name, path, cached));
+  ok1(SaveAirspaceCache(cache, name, path, list));
+  ok1(LoadAirspaceCache(cache, name, path, cached));
+
+  const auto &loaded = cached.GetPending();
+  ok1(loaded.size() == list.size() &&
+      std::equal(list.begin(), list.end(), loaded.begin(),
+                 [](const AbstractAirspace *a, const AbstractAirspace *b){
+                   return IsEqual(*a, *b);
+                 }));
+
+  cache.Flush(name);
+}
+
 int main(int argc, char **argv)
 try {
-  plan_tests(102);
+  plan_tests(102 + 2 * 6);
 
   TestOpenAir();
   TestTNP();
 
+  TestCache(Path(_T("test/data/airspace/openair.txt")));
+  TestCache(Path(_T("test/data/airspace/tnp.sua")));
+
   return exit_status();
 } catch (const std::runtime_error &e) {
   PrintException(e);
@@ -0,0 +1,110 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Screen/Memory/DamageRegion.hpp"
+
+extern "C" {
+#include "tap.h"
+}
+
+#include <stdlib.h>
+
+/**
+ * Is the specified rectangle completely covered by one of the
+ * region's rectangles?
+ */
+static bool
+IsCovered(const DamageRegion &region, const PixelRect &rc)
+{
+  for (const auto &i : region)
+    if (i.Contains(rc))
+      return true;
+
+  return false;
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(15);
+
+  DamageRegion region;
+  ok1(region.IsEmpty());
+
+  /* empty rectangles are ignored */
+  region.Add(PixelRect(10, 10, 10, 20));
+  ok1(region.IsEmpty());
+
+  region.Add(PixelRect(0, 0, 10, 10));
+  ok1(region.size() == 1);
+  ok1(region.GetArea() == 100);
+
+  /* contained */
+  region.Add(PixelRect(2, 2, 5, 5));
+  ok1(region.size() == 1);
+  ok1(region.GetArea() == 100);
+
+  /* disjoint */
+  region.Add(PixelRect(100, 100, 110, 120));
+  ok1(region.size() == 2);
+  ok1(region.GetArea() == 300);
+
+  /* overlapping both: everything is merged */
+  region.Add(PixelRect(5, 5, 105, 105));
+  ok1(region.size() == 1);
+  ok1(region.GetArea() == 110 * 120);
+
+  region.Clear();
+  ok1(region.IsEmpty());
+
+  /* touching rectangles are merged */
+  region.Add(PixelRect(0, 0, 10, 10));
+  region.Add(PixelRect(10, 0, 20, 10));
+  ok1(region.size() == 1 && region.GetArea() == 200);
+
+  /* many small rectangles: the number is limited, and everything
+     remains covered */
+  region.Clear();
+  srand(1);
+  PixelRect rects[64];
+  for (auto &rc : rects) {
+    const int x = rand() % 1000, y = rand() % 1000;
+    rc = PixelRect(x, y, x + 1 + rand() % 20, y + 1 + rand() % 20);
+    region.Add(rc);
+  }
+
+  ok1(region.size() <= 8);
+
+  bool covered = true;
+  for (const auto &rc : rects)
+    covered &= IsCovered(region, rc);
+  ok1(covered);
+
+  /* the result doesn't overlap */
+  bool overlap = false;
+  for (auto i = region.begin(); i != region.end(); ++i)
+    for (auto j = std::next(i); j != region.end(); ++j)
+      overlap |= i->left < j->right && j->left < i->right &&
+        i->top < j->bottom && j->top < i->bottom;
+  ok1(!overlap);
+
+  return exit_status();
+}
@@ -0,0 +1,163 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Net/HTTP/DownloadState.hpp"
+#include "Net/HTTP/RateLimiter.hpp"
+#include "OS/Path.hpp"
+#include "OS/FileUtil.hpp"
+#include "TestUtil.hpp"
+
+#include <stdio.h>
+
+using namespace Net;
+
+static void
+TestPlan()
+{
+  DownloadState state;
+
+  /* small files are not split */
+  state.Plan(1000, 4);
+  ok1(state.segments.size() == 1);
+  ok1(state.segments[0].start == 0 && state.segments[0].end == 1000);
+  ok1(!state.IsComplete());
+
+  /* large files are split into equal segments */
+  const uint64_t size = 10 * DownloadState::MIN_SEGMENT_SIZE + 3;
+  state.Plan(size, 4);
+  ok1(state.segments.size() == 4);
+  ok1(state.segments[0].start == 0);
+  ok1(state.segments[3].end == size);
+
+  bool adjacent = true;
+  for (unsigned i = 1; i < state.segments.size(); ++i)
+    if (state.segments[i].start != state.segments[i - 1].end ||
+        state.segments[i].position != state.segments[i].start)
+      adjacent = false;
+  ok1(adjacent);
+
+  /* the number of segments is limited by the size */
+  state.Plan(2 * DownloadState::MIN_SEGMENT_SIZE, 4);
+  ok1(state.segments.size() == 2);
+}
+
+static void
+TestProgress()
+{
+  DownloadState state;
+  state.Plan(4 * DownloadState::MIN_SEGMENT_SIZE, 4);
+  ok1(state.segments.size() == 4);
+
+  ok1(state.GetPosition() == 0);
+  ok1(state.GetContiguous() == 0);
+
+  /* a later segment doesn't extend the contiguous beginning */
+  state.segments[1].position += 100;
+  ok1(state.GetPosition() == 100);
+  ok1(state.GetContiguous() == 0);
+
+  state.segments[0].position += 50;
+  ok1(state.GetContiguous() == 50);
+
+  state.segments[0].position = state.segments[0].end;
+  ok1(state.segments[0].IsComplete());
+  ok1(state.GetContiguous() == state.segments[1].start + 100);
+  ok1(state.GetPosition() == DownloadState::MIN_SEGMENT_SIZE + 100);
+
+  for (auto &s : state.segments)
+    s.position = s.end;
+  ok1(state.IsComplete());
+  ok1(state.GetContiguous() == state.size);
+  ok1(state.GetPosition() == state.size);
+}
+
+static void
+TestSaveLoad()
+{
+  const Path path(_T("output/TestDownloadState.state"));
+
+  DownloadState state;
+  state.Plan(3 * DownloadState::MIN_SEGMENT_SIZE + 7, 4);
+  state.segments[0].position = 1234;
+  state.segments[2].position = state.segments[2].end;
+  ok1(state.Save(path));
+
+  DownloadState loaded;
+  ok1(loaded.Load(path));
+  ok1(loaded.size == state.size);
+  ok1(loaded.segments.size() == state.segments.size());
+
+  bool equal = true;
+  for (unsigned i = 0; i < state.segments.size(); ++i)
+    if (loaded.segments[i].start != state.segments[i].start ||
+        loaded.segments[i].end != state.segments[i].end ||
+        loaded.segments[i].position != state.segments[i].position)
+      equal = false;
+  ok1(equal);
+
+  /* malformed files are rejected */
+  FILE *file = fopen("output/TestDownloadState.state", "w");
+  fputs("size 100 segments 2\n0 50 10\n60 100 60\n", file);
+  fclose(file);
+  ok1(!loaded.Load(path));
+  ok1(loaded.segments.empty());
+
+  File::Delete(path);
+  ok1(!loaded.Load(path));
+}
+
+static void
+TestRateLimiter()
+{
+  RateLimiter limiter;
+  ok1(!limiter.IsEnabled());
+  limiter.Consume(0, 1000000);
+  ok1(limiter.GetDelay(0) == 0);
+
+  /* 10 kB/s */
+  limiter.SetRate(10000, 1000);
+  ok1(limiter.IsEnabled());
+  ok1(limiter.GetDelay(1000) == 0);
+
+  /* 5 kB must be paid off in 500 ms */
+  limiter.Consume(1000, 5000);
+  ok1(limiter.GetDelay(1000) == 500);
+  ok1(limiter.GetDelay(1400) == 100);
+  ok1(limiter.GetDelay(1500) == 0);
+
+  /* an idle period allows only a limited burst */
+  limiter.Consume(10000, 5000);
+  ok1(limiter.GetDelay(10000) == 250);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(8 + 12 + 8 + 8);
+
+  TestPlan();
+  TestProgress();
+  TestSaveLoad();
+  TestRateLimiter();
+
+  return exit_status();
+}
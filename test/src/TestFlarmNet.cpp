@@ -27,9 +27,11 @@
 #include "OS/Path.hpp"
 #include "TestUtil.hpp"
 
+#include <stdio.h>
+
 int main(int argc, char **argv)
 {
-  plan_tests(15);
+  plan_tests(24);
 
   FlarmNetDatabase db;
   int count = FlarmNetReader::LoadFile(Path(_T("test/data/flarmnet/data.fln")),
@@ -78,5 +80,27 @@ int main(int argc, char **argv)
   ok1(foundDDA85C);
   ok1(foundDDA896);
 
+  ok1(db.FindIdsByCallSign(_T("TH"), ids, 1) == 1);
+
+  /* binary format, after a prefix like the FileCache header */
+  const Path path(_T("output/test/flarmnet.bin"));
+  FILE *file = _tfopen(path.c_str(), _T("wb"));
+  ok1(file != NULL && fwrite("XCSR", 4, 1, file) == 1 &&
+      db.SaveBinary(file) && fclose(file) == 0);
+
+  FlarmNetDatabase db2;
+  ok1(db2.LoadBinary(path, 4));
+  ok1(db2.size() == db.size());
+
+  record = db2.FindRecordById(id);
+  ok1(record != NULL && StringIsEqual(record->registration, _T("D-4449")));
+  ok1(db2.FindRecordById(FlarmId::Parse("123456", NULL)) == NULL);
+
+  record = db2.FindFirstRecordByCallSign(_T("TH"));
+  ok1(record != NULL && StringIsEqual(record->callsign, _T("TH")));
+  ok1(db2.FindIdsByCallSign(_T("TH"), ids, 3) == 2);
+
+  ok1(!db2.LoadBinary(path, 0));
+
   return exit_status();
 }
@@ -0,0 +1,225 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Geo/GeoBatch.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Geo/Math.hpp"
+#include "Geo/SimplifiedMath.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+
+#include <math.h>
+
+static const GeoPoint center(Angle::Degrees(7.7), Angle::Degrees(51.05));
+
+/**
+ * Fill the batch with a deterministic pseudo-random cloud of
+ * locations around #center.
+ */
+static void
+Fill(GeoPointBatch &batch, std::vector<GeoPoint> &points,
+     unsigned n, double radius)
+{
+  unsigned seed = 12345;
+  for (unsigned i = 0; i < n; ++i) {
+    seed = seed * 1103515245 + 12345;
+    const Angle bearing = Angle::Degrees((seed >> 8) % 3600 / 10.);
+    seed = seed * 1103515245 + 12345;
+    const double distance = 100 + radius * ((seed >> 8) % 1000) / 1000.;
+
+    const GeoPoint p = FindLatitudeLongitudeS(center, bearing, distance);
+    points.push_back(p);
+    batch.Append(p);
+  }
+}
+
+static bool
+AngleEquals(Angle a, Angle b, double tolerance_degrees)
+{
+  return fabs((a - b).AsDelta().Degrees()) < tolerance_degrees;
+}
+
+static void
+TestDistanceBearing()
+{
+  GeoPointBatch batch;
+  std::vector<GeoPoint> points;
+  Fill(batch, points, 1000, 300000);
+
+  ok1(batch.size() == points.size());
+  ok1(batch[7].Distance(points[7]) < 0.001);
+
+  std::vector<double> distances(batch.size());
+  std::vector<Angle> bearings(batch.size());
+
+  batch.DistanceBearings(center, distances.data(), bearings.data(),
+                         GeoPrecision::SPHERE);
+
+  bool distance_ok = true, bearing_ok = true;
+  for (unsigned i = 0; i < points.size(); ++i) {
+    double distance;
+    Angle bearing;
+    DistanceBearingS(center, points[i], &distance, &bearing);
+
+    if (fabs(distances[i] - distance) > 0.01)
+      distance_ok = false;
+    if (!AngleEquals(bearings[i], bearing, 1e-6))
+      bearing_ok = false;
+  }
+
+  ok1(distance_ok);
+  ok1(bearing_ok);
+
+  batch.DistanceBearings(center, distances.data(), bearings.data(),
+                         GeoPrecision::WGS84);
+
+  distance_ok = bearing_ok = true;
+  for (unsigned i = 0; i < points.size(); ++i) {
+    double distance;
+    Angle bearing;
+    DistanceBearing(center, batch[i], &distance, &bearing);
+
+    if (distances[i] != distance)
+      distance_ok = false;
+    if (bearings[i] != bearing)
+      bearing_ok = false;
+  }
+
+  ok1(distance_ok);
+  ok1(bearing_ok);
+}
+
+static void
+TestFlat()
+{
+  GeoPointBatch batch;
+  std::vector<GeoPoint> points;
+  Fill(batch, points, 500, 30000);
+
+  std::vector<double> distances(batch.size());
+  std::vector<Angle> bearings(batch.size());
+  batch.DistanceBearings(center, distances.data(), bearings.data(),
+                         GeoPrecision::FLAT);
+
+  bool distance_ok = true, bearing_ok = true;
+  for (unsigned i = 0; i < points.size(); ++i) {
+    double distance;
+    Angle bearing;
+    DistanceBearingS(center, points[i], &distance, &bearing);
+
+    if (fabs(distances[i] - distance) > distance * 0.005)
+      distance_ok = false;
+    if (!AngleEquals(bearings[i], bearing, 0.5))
+      bearing_ok = false;
+  }
+
+  ok1(distance_ok);
+  ok1(bearing_ok);
+
+  /* across the date line */
+  GeoPointBatch date_line;
+  date_line.Append(GeoPoint(Angle::Degrees(-179.99), Angle::Zero()));
+  double distance;
+  date_line.Distances(GeoPoint(Angle::Degrees(179.99), Angle::Zero()),
+                      &distance, GeoPrecision::FLAT);
+  ok1(distance < 3000);
+}
+
+static void
+TestProjectedDistance()
+{
+  GeoPointBatch batch;
+  std::vector<GeoPoint> points;
+  Fill(batch, points, 500, 50000);
+
+  const GeoPoint loc1 = FindLatitudeLongitudeS(center, Angle::Degrees(200),
+                                               20000);
+  const GeoPoint loc2 = FindLatitudeLongitudeS(center, Angle::Degrees(30),
+                                               40000);
+
+  std::vector<double> distances(batch.size());
+
+  batch.ProjectedDistances(loc1, loc2, distances.data(),
+                           GeoPrecision::SPHERE);
+  bool sphere_ok = true;
+  for (unsigned i = 0; i < points.size(); ++i)
+    if (fabs(distances[i] - ProjectedDistanceS(loc1, loc2, points[i])) > 0.1)
+      sphere_ok = false;
+  ok1(sphere_ok);
+
+  batch.ProjectedDistances(loc1, loc2, distances.data(),
+                           GeoPrecision::FLAT);
+  bool flat_ok = true;
+  for (unsigned i = 0; i < points.size(); ++i) {
+    const double expected = ProjectedDistanceS(loc1, loc2, points[i]);
+    /* the error of the flat approximation grows with the distance
+       from the tangent point */
+    if (fabs(distances[i] - expected) > loc1.DistanceS(points[i]) * 0.015)
+      flat_ok = false;
+  }
+  ok1(flat_ok);
+
+  /* no line: all zero */
+  batch.ProjectedDistances(loc1, loc1, distances.data(),
+                           GeoPrecision::SPHERE);
+  ok1(distances.front() == 0 && distances.back() == 0);
+}
+
+static void
+TestFindNearest()
+{
+  GeoPointBatch batch;
+  ok1(batch.FindNearest(center) == -1);
+
+  std::vector<GeoPoint> points;
+  Fill(batch, points, 1000, 100000);
+
+  const GeoPoint origin = FindLatitudeLongitudeS(center, Angle::Degrees(77),
+                                                 12345);
+
+  int expected = -1;
+  double expected_distance = 1e10;
+  for (unsigned i = 0; i < points.size(); ++i) {
+    const double distance = origin.DistanceS(points[i]);
+    if (distance < expected_distance) {
+      expected = i;
+      expected_distance = distance;
+    }
+  }
+
+  ok1(batch.FindNearest(origin) == expected);
+  ok1(batch.FindNearest(origin, expected_distance + 1) == expected);
+  ok1(batch.FindNearest(origin, expected_distance - 1) == -1);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(6 + 3 + 3 + 4);
+
+  TestDistanceBearing();
+  TestFlat();
+  TestProjectedDistance();
+  TestFindNearest();
+
+  return exit_status();
+}
@@ -0,0 +1,191 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Screen/FreeType/GlyphAtlas.hpp"
+
+extern "C" {
+#include "tap.h"
+}
+
+#include <string.h>
+
+static GlyphAtlas::Glyph
+MakeGlyph(unsigned index, unsigned width, unsigned height)
+{
+  GlyphAtlas::Glyph glyph;
+  glyph.index = index;
+  glyph.bearing_x = 1;
+  glyph.bearing_y = int(height);
+  glyph.width = int(width);
+  glyph.advance = int(width) + 2;
+  glyph.bitmap_width = width;
+  glyph.bitmap_height = height;
+  glyph.pixels = nullptr;
+  glyph.pitch = 0;
+  return glyph;
+}
+
+/**
+ * Fill a bitmap with a pattern which depends on the seed.
+ */
+static void
+FillPattern(uint8_t *p, unsigned width, unsigned height, unsigned seed)
+{
+  for (unsigned y = 0; y < height; ++y)
+    for (unsigned x = 0; x < width; ++x)
+      *p++ = uint8_t(seed * 7 + y * 13 + x);
+}
+
+static bool
+CheckPattern(const GlyphAtlas::Glyph &glyph, unsigned seed)
+{
+  const uint8_t *row = glyph.pixels;
+  for (unsigned y = 0; y < glyph.bitmap_height; ++y, row += glyph.pitch)
+    for (unsigned x = 0; x < glyph.bitmap_width; ++x)
+      if (row[x] != uint8_t(seed * 7 + y * 13 + x))
+        return false;
+
+  return true;
+}
+
+static void
+TestLookup()
+{
+  GlyphAtlas atlas;
+  const int font_a = 0, font_b = 0;
+
+  ok1(atlas.Lookup(&font_a, 'A') == nullptr);
+
+  uint8_t buffer[20 * 30];
+  FillPattern(buffer, 20, 30, 1);
+  const GlyphAtlas::Glyph *g =
+    atlas.Add(&font_a, 'A', MakeGlyph(36, 20, 30), buffer, 20, 100);
+  ok1(g != nullptr);
+  ok1(g->index == 36);
+  ok1(g->advance == 22);
+  ok1(g->pixels != nullptr);
+  ok1(CheckPattern(*g, 1));
+
+  /* an empty bitmap (e.g. space) */
+  g = atlas.Add(&font_a, ' ', MakeGlyph(3, 0, 0), nullptr, 0, 10);
+  ok1(g->pixels == nullptr);
+
+  /* a missing glyph */
+  g = atlas.Add(&font_a, 0x263a, MakeGlyph(0, 0, 0), nullptr, 0, 10);
+  ok1(g->index == 0);
+
+  /* same character, different font */
+  ok1(atlas.Lookup(&font_b, 'A') == nullptr);
+  FillPattern(buffer, 10, 12, 2);
+  atlas.Add(&font_b, 'A', MakeGlyph(37, 10, 12), buffer, 10);
+
+  g = atlas.Lookup(&font_a, 'A');
+  ok1(g != nullptr && g->index == 36 && CheckPattern(*g, 1));
+  g = atlas.Lookup(&font_b, 'A');
+  ok1(g != nullptr && g->index == 37 && CheckPattern(*g, 2));
+
+  auto s = atlas.GetStatistics();
+  ok1(s.hits == 2);
+  ok1(s.misses == 4);
+  ok1(s.rasterisation_us == 120);
+  ok1(s.glyphs == 4);
+  ok1(s.pages == 1);
+
+  atlas.Remove(&font_a);
+  ok1(atlas.Lookup(&font_a, 'A') == nullptr);
+  ok1(atlas.Lookup(&font_a, ' ') == nullptr);
+  g = atlas.Lookup(&font_b, 'A');
+  ok1(g != nullptr && CheckPattern(*g, 2));
+}
+
+static void
+TestFull()
+{
+  GlyphAtlas atlas;
+  const int font = 0;
+
+  /* each glyph occupies a quarter of a page */
+  constexpr unsigned W = GlyphAtlas::PAGE_WIDTH / 2;
+  constexpr unsigned H = GlyphAtlas::PAGE_HEIGHT / 2;
+  static uint8_t buffer[W * H];
+
+  bool valid = true;
+  for (unsigned i = 0; i < GlyphAtlas::MAX_PAGES * 4; ++i) {
+    FillPattern(buffer, W, H, i);
+    const auto *g = atlas.Add(&font, i, MakeGlyph(i + 1, W, H),
+                              buffer, W);
+    valid = valid && CheckPattern(*g, i);
+  }
+
+  ok1(valid);
+
+  auto s = atlas.GetStatistics();
+  ok1(s.pages == GlyphAtlas::MAX_PAGES);
+  ok1(s.flushes == 0);
+
+  /* all previously added glyphs must still be intact */
+  valid = true;
+  for (unsigned i = 0; i < GlyphAtlas::MAX_PAGES * 4; ++i) {
+    const auto *g = atlas.Lookup(&font, i);
+    valid = valid && g != nullptr && CheckPattern(*g, i);
+  }
+
+  ok1(valid);
+
+  /* one more: the atlas gets flushed */
+  FillPattern(buffer, W, H, 1000);
+  const auto *g = atlas.Add(&font, 1000, MakeGlyph(1000, W, H), buffer, W);
+  ok1(CheckPattern(*g, 1000));
+
+  s = atlas.GetStatistics();
+  ok1(s.flushes == 1);
+  ok1(s.pages == 1);
+  ok1(s.glyphs == 1);
+  ok1(atlas.Lookup(&font, 0) == nullptr);
+}
+
+static void
+TestOversized()
+{
+  GlyphAtlas atlas;
+  const int font = 0;
+
+  constexpr unsigned W = GlyphAtlas::PAGE_WIDTH + 10, H = 20;
+  static uint8_t buffer[W * H];
+  FillPattern(buffer, W, H, 3);
+
+  const auto *g = atlas.Add(&font, 'W', MakeGlyph(1, W, H), buffer, W);
+  ok1(g->pitch == W);
+  ok1(CheckPattern(*g, 3));
+  ok1(atlas.GetStatistics().pages == 0);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(31);
+
+  TestLookup();
+  TestFull();
+  TestOversized();
+
+  return exit_status();
+}
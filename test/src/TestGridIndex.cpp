@@ -0,0 +1,272 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Util/GridIndex.hpp"
+
+extern "C" {
+#include "tap.h"
+}
+
+#include <vector>
+#include <limits>
+#include <stdlib.h>
+
+struct Item {
+  int x, y;
+};
+
+struct ItemAccessor {
+  int GetX(const Item *item) const {
+    return item->x;
+  }
+
+  int GetY(const Item *item) const {
+    return item->y;
+  }
+};
+
+typedef GridIndex<const Item *, ItemAccessor> ItemGrid;
+
+static ItemGrid::distance_type
+SquareDistance(const Item &item, ItemGrid::Point p)
+{
+  return ItemGrid::GetPosition(&item).SquareDistanceTo(p);
+}
+
+struct CountVisitor {
+  unsigned count = 0;
+
+  void operator()(const Item *) {
+    ++count;
+  }
+};
+
+static unsigned
+CountWithinRange(const std::vector<Item> &items, const std::vector<bool> &erased,
+                 ItemGrid::Point p, unsigned range)
+{
+  unsigned count = 0;
+  for (unsigned i = 0; i < items.size(); ++i)
+    if (!erased[i] && SquareDistance(items[i], p) <= ItemGrid::Square(range))
+      ++count;
+  return count;
+}
+
+static ItemGrid::distance_type
+NearestSquareDistance(const std::vector<Item> &items,
+                      const std::vector<bool> &erased,
+                      ItemGrid::Point p, unsigned range)
+{
+  ItemGrid::distance_type nearest = ItemGrid::Square(range) + 1;
+  for (unsigned i = 0; i < items.size(); ++i)
+    if (!erased[i])
+      nearest = std::min(nearest, SquareDistance(items[i], p));
+  return nearest;
+}
+
+/**
+ * Compare range and nearest queries of the grid with a linear search
+ * at random locations.
+ */
+static bool
+CheckQueries(const ItemGrid &grid, const std::vector<Item> &items,
+             const std::vector<bool> &erased)
+{
+  for (unsigned i = 0; i < 200; ++i) {
+    const ItemGrid::Point p(rand() % 12000 - 1000, rand() % 12000 - 1000);
+    const unsigned range = rand() % 3000;
+
+    CountVisitor visitor;
+    grid.VisitWithinRange(p, range, visitor);
+    if (visitor.count != CountWithinRange(items, erased, p, range))
+      return false;
+
+    const auto expected = NearestSquareDistance(items, erased, p, range);
+    const auto found = grid.FindNearest(p, range);
+    if (expected > ItemGrid::Square(range)) {
+      if (found.first != grid.end())
+        return false;
+    } else if (found.first == grid.end() ||
+               SquareDistance(**found.first, p) != expected)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Square distances between coordinates beyond 16 bit do not fit into
+ * 32 bits.
+ */
+static void
+TestLargeCoordinates()
+{
+  ok1(ItemGrid::Point(0, 0).SquareDistanceTo(ItemGrid::Point(100000, 0)) ==
+      10000000000ull);
+  ok1(ItemGrid::Point(-100000, -100000).SquareDistanceTo(ItemGrid::Point(100000, 100000)) ==
+      80000000000ull);
+
+  /* the extreme values saturate instead of wrapping around */
+  const int min = std::numeric_limits<int>::min();
+  const int max = std::numeric_limits<int>::max();
+  ok1(ItemGrid::Point(min, min).SquareDistanceTo(ItemGrid::Point(max, max)) ==
+      std::numeric_limits<ItemGrid::distance_type>::max());
+
+  std::vector<Item> items(500);
+  for (auto &i : items) {
+    i.x = (rand() % 2000 - 1000) * 1000;
+    i.y = (rand() % 2000 - 1000) * 1000;
+  }
+
+  ItemGrid grid;
+  for (const auto &i : items)
+    grid.AddQuick(&i);
+  grid.Optimise();
+
+  const std::vector<bool> erased(items.size(), false);
+
+  bool correct = true;
+  for (unsigned i = 0; i < 100; ++i) {
+    const ItemGrid::Point p((rand() % 2400 - 1200) * 1000,
+                            (rand() % 2400 - 1200) * 1000);
+    const unsigned range = (rand() % 300) * 1000;
+
+    CountVisitor visitor;
+    grid.VisitWithinRange(p, range, visitor);
+    if (visitor.count != CountWithinRange(items, erased, p, range))
+      correct = false;
+
+    const auto expected = NearestSquareDistance(items, erased, p, range);
+    const auto found = grid.FindNearest(p, range);
+    if (expected > ItemGrid::Square(range)
+        ? found.first != grid.end()
+        : (found.first == grid.end() ||
+           SquareDistance(**found.first, p) != expected))
+      correct = false;
+  }
+
+  ok1(correct);
+}
+
+static void
+TestReplace()
+{
+  std::vector<Item> items(102);
+  for (unsigned i = 0; i < 100; ++i)
+    items[i] = {int(i), int(i)};
+
+  ItemGrid grid;
+  for (unsigned i = 0; i < 100; ++i)
+    grid.AddQuick(&items[i]);
+  grid.Optimise();
+
+  /* inside the same cell */
+  items[100] = {0, 1};
+  grid.Replace(grid.begin(), &items[100]);
+  ok1(grid.size() == 100);
+  auto found = grid.FindNearest(ItemGrid::Point(0, 1), 0);
+  ok1(found.first != grid.end() && *found.first == &items[100]);
+
+  /* outside of the grid bounds */
+  items[101] = {100000, 100000};
+  grid.Replace(grid.begin(), &items[101]);
+  ok1(grid.size() == 100);
+  found = grid.FindNearest(ItemGrid::Point(100000, 100000), 0);
+  ok1(found.first != grid.end() && *found.first == &items[101]);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(13 + 4 + 4);
+
+  srand(42);
+
+  std::vector<Item> items(4000);
+  /* the grid stores pointers; one more item is appended below */
+  items.reserve(items.size() + 1);
+  for (auto &i : items) {
+    i.x = rand() % 10000;
+    i.y = rand() % 10000;
+  }
+
+  std::vector<bool> erased(items.size(), false);
+
+  ItemGrid grid;
+  ok1(grid.IsEmpty());
+
+  CountVisitor visitor;
+  grid.VisitWithinRange(ItemGrid::Point(0, 0), 1000, visitor);
+  ok1(visitor.count == 0);
+  ok1(grid.FindNearest(ItemGrid::Point(0, 0), 1000).first == grid.end());
+
+  /* bulk load the first half */
+  for (unsigned i = 0; i < items.size() / 2; ++i)
+    grid.AddQuick(&items[i]);
+  grid.Optimise();
+  ok1(grid.size() == items.size() / 2);
+  ok1(grid.GetPendingSize() == 0);
+
+  std::vector<Item> first_half(items.begin(), items.begin() + items.size() / 2);
+  std::vector<bool> first_erased(first_half.size(), false);
+  ok1(CheckQueries(grid, first_half, first_erased));
+
+  /* add the second half incrementally, including points outside the
+     current bounds */
+  for (unsigned i = items.size() / 2; i < items.size(); ++i) {
+    if (i % 100 == 0) {
+      items[i].x = -500 + (int)(i % 7);
+      items[i].y = 10500;
+    }
+    grid.Add(&items[i]);
+  }
+
+  ok1(grid.size() == items.size());
+  ok1(CheckQueries(grid, items, erased));
+
+  /* some values are still pending */
+  grid.Add(&items[0]);
+  erased.push_back(false);
+  items.push_back(items[0]);
+  ok1(grid.GetPendingSize() > 0);
+  ok1(CheckQueries(grid, items, erased));
+
+  /* erase every third item */
+  grid.EraseIf([&items](const Item *item){
+      return (item - items.data()) % 3 == 0;
+    });
+  for (unsigned i = 0; i < items.size(); i += 3)
+    erased[i] = true;
+  erased.back() = true;
+
+  ok1(CheckQueries(grid, items, erased));
+
+  grid.Optimise();
+  ok1(CheckQueries(grid, items, erased));
+
+  grid.clear();
+  ok1(grid.IsEmpty());
+
+  TestLargeCoordinates();
+  TestReplace();
+
+  return exit_status();
+}
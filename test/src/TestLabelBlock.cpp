@@ -0,0 +1,142 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Renderer/LabelBlock.hpp"
+#include "Renderer/LabelPlacementHistory.hpp"
+#include "Renderer/WaypointLabelList.hpp"
+#include "TestUtil.hpp"
+
+static PixelRect
+MakeRect(int left, int top, int right, int bottom)
+{
+  PixelRect rc;
+  rc.left = left;
+  rc.top = top;
+  rc.right = right;
+  rc.bottom = bottom;
+  return rc;
+}
+
+static void
+TestLabelBlock()
+{
+  static LabelBlock block;
+  block.reset();
+
+  ok1(block.check(MakeRect(10, 10, 60, 25)));
+  /* overlapping */
+  ok1(!block.check(MakeRect(50, 20, 100, 35)));
+  /* adjacent, but not overlapping */
+  ok1(block.check(MakeRect(10, 26, 60, 40)));
+
+  /* crossing cell boundaries */
+  ok1(block.check(MakeRect(120, 120, 140, 135)));
+  ok1(!block.check(MakeRect(125, 100, 130, 121)));
+  ok1(!block.check(MakeRect(139, 134, 160, 150)));
+
+  /* negative coordinates (labels moved partially out of view) */
+  ok1(block.check(MakeRect(-30, -10, 5, 3)));
+  ok1(!block.check(MakeRect(-5, 0, 2, 8)));
+
+  /* far away, possibly in the same hash bucket */
+  ok1(block.check(MakeRect(3000, 2000, 3050, 2015)));
+  ok1(!block.check(MakeRect(3010, 2010, 3020, 2030)));
+
+  /* a huge rectangle */
+  ok1(!block.check(MakeRect(-5000, -5000, 5000, 5000)));
+
+  block.reset();
+  ok1(block.check(MakeRect(-5000, -5000, 5000, 5000)));
+  ok1(!block.check(MakeRect(10, 10, 60, 25)));
+}
+
+static void
+TestHistory()
+{
+  LabelPlacementHistory history;
+
+  ok1(!history.IsStable(1, PixelPoint(100, 100)));
+
+  history.Store(1, PixelPoint(100, 100), true);
+  history.Store(2, PixelPoint(200, 100), false);
+  history.Commit();
+
+  ok1(history.IsStable(1, PixelPoint(100, 100)));
+  ok1(history.IsStable(1, PixelPoint(110, 95)));
+  /* moved too far */
+  ok1(!history.IsStable(1, PixelPoint(150, 100)));
+  /* was not visible */
+  ok1(!history.IsStable(2, PixelPoint(200, 100)));
+
+  /* label 1 disappears in this frame */
+  history.Store(2, PixelPoint(200, 100), true);
+  history.Commit();
+
+  ok1(!history.IsStable(1, PixelPoint(100, 100)));
+  ok1(history.IsStable(2, PixelPoint(200, 100)));
+
+  history.Clear();
+  ok1(!history.IsStable(2, PixelPoint(200, 100)));
+}
+
+static void
+TestStableOrder()
+{
+  TextInBoxMode mode;
+
+  WaypointLabelList labels(1000, 1000);
+  labels.Add(1, _T("One"), 100, 100, mode, false, 0,
+             false, false, false, false);
+  labels.Add(2, _T("Two"), 110, 100, mode, false, 500,
+             false, false, false, false);
+  labels.Add(3, _T("Three"), 120, 100, mode, false, 0,
+             true, false, false, false);
+
+  LabelPlacementHistory history;
+  labels.UpdateStable(history);
+  labels.Sort();
+  ok1(labels.begin()[0].id == 3);
+  ok1(labels.begin()[1].id == 2);
+
+  /* label 1 was visible in the previous frame: it wins over label 2
+     of the same class, but not over label 3, which is in the task */
+  history.Store(1, PixelPoint(100, 100), true);
+  history.Store(2, PixelPoint(110, 100), false);
+  history.Commit();
+
+  labels.UpdateStable(history);
+  labels.Sort();
+  ok1(labels.begin()[0].id == 3);
+  ok1(labels.begin()[1].id == 1);
+  ok1(labels.begin()[1].stable);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(21 + 5);
+
+  TestLabelBlock();
+  TestHistory();
+  TestStableOrder();
+
+  return exit_status();
+}
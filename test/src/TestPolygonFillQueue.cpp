@@ -0,0 +1,206 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Screen/Memory/PolygonFillQueue.hpp"
+#include "Screen/Memory/PixelTraits.hpp"
+
+extern "C" {
+#include "tap.h"
+}
+
+#include <vector>
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef GreyscalePixelTraits Traits;
+
+static constexpr unsigned WIDTH = 317, HEIGHT = 241;
+
+/**
+ * An image buffer with additional rows above and below the visible
+ * area.
+ */
+struct TestImage {
+  unsigned margin;
+  std::vector<Luminosity8> pixels;
+  WritableImageBuffer<Traits> buffer;
+
+  explicit TestImage(unsigned _margin=0)
+    :margin(_margin),
+     pixels(WIDTH * (HEIGHT + 2 * margin), Luminosity8(0)) {
+    buffer.data = pixels.data();
+    buffer.pitch = WIDTH;
+    buffer.width = WIDTH;
+    buffer.height = HEIGHT + 2 * margin;
+  }
+
+  /**
+   * Returns the visible area, i.e. without the margins.
+   */
+  WritableImageBuffer<Traits> GetVisible() {
+    WritableImageBuffer<Traits> visible = buffer;
+    visible.data = buffer.At(0, margin);
+    visible.height = HEIGHT;
+    return visible;
+  }
+
+  bool IsVisibleEqual(const TestImage &other) const {
+    return memcmp(pixels.data() + WIDTH * margin,
+                  other.pixels.data() + WIDTH * other.margin,
+                  WIDTH * HEIGHT) == 0;
+  }
+
+  bool IsBlank() const {
+    for (const auto &i : pixels)
+      if (i.GetLuminosity() != 0)
+        return false;
+    return true;
+  }
+};
+
+static int
+Random(int min, int max)
+{
+  return min + rand() % (max - min + 1);
+}
+
+/**
+ * Fill the queue with random polygons, many of which are partially
+ * outside of the buffer.
+ */
+static void
+AddRandomPolygons(PolygonFillQueue<Traits> &queue, unsigned n,
+                  int y_offset=0)
+{
+  for (unsigned i = 0; i < n; ++i) {
+    const unsigned n_points = Random(3, 12);
+    PixelPoint points[12];
+    for (unsigned j = 0; j < n_points; ++j)
+      points[j] = PixelPoint(Random(-60, WIDTH + 60),
+                             Random(-60, HEIGHT + 60) + y_offset);
+
+    const uint8_t alpha = i % 3 == 0 ? Random(1, 254) : 0xff;
+    queue.Add(points, n_points, Luminosity8(Random(1, 255)), alpha);
+  }
+}
+
+static void
+TestClipping()
+{
+  /* draw once with the polygons clipped at the top of the buffer,
+     and once into a taller buffer where nothing is clipped; the
+     visible rows must be the same */
+
+  for (unsigned seed = 1; seed <= 5; ++seed) {
+    PolygonFillQueue<Traits> clipped, unclipped;
+
+    srand(seed);
+    AddRandomPolygons(clipped, 50);
+
+    srand(seed);
+    AddRandomPolygons(unclipped, 50, 100);
+
+    TestImage a, b(100);
+    clipped.Draw(a.buffer, nullptr);
+    unclipped.Draw(b.buffer, nullptr);
+
+    ok1(!a.IsBlank());
+    ok1(a.IsVisibleEqual(b));
+  }
+}
+
+static void
+TestBands()
+{
+  BandThreadPool pool(4);
+  ok1(pool.GetBandCount() == 4);
+
+  for (unsigned seed = 1; seed <= 5; ++seed) {
+    PolygonFillQueue<Traits> serial, parallel;
+
+    srand(seed);
+    AddRandomPolygons(serial, 200);
+
+    srand(seed);
+    AddRandomPolygons(parallel, 200);
+
+    ok1(parallel.EstimateArea(WIDTH, HEIGHT) >=
+        PolygonFillQueue<Traits>::PARALLEL_THRESHOLD);
+
+    TestImage a, b;
+    serial.Draw(a.buffer, nullptr);
+    parallel.Draw(b.buffer, &pool);
+
+    ok1(a.IsVisibleEqual(b));
+    ok1(parallel.IsEmpty());
+  }
+
+  /* bands which end exactly at polygon vertices */
+  PolygonFillQueue<Traits> serial, parallel;
+  const PixelPoint points[] = {
+    { 10, 0 }, { 300, 60 }, { 200, 120 }, { 250, 180 }, { 0, 240 },
+  };
+
+  serial.Add(points, 5, Luminosity8(0x80));
+  parallel.Add(points, 5, Luminosity8(0x80));
+
+  TestImage a, b;
+  serial.Draw(a.buffer, nullptr);
+
+  std::vector<PixelPoint> translated;
+  for (unsigned top = 0; top < HEIGHT; top += 60)
+    parallel.DrawBand(b.buffer, top, std::min(top + 60, HEIGHT), translated);
+
+  ok1(a.IsVisibleEqual(b));
+}
+
+static void
+TestPool()
+{
+  BandThreadPool pool(3);
+
+  /* each band must be processed exactly once per job */
+  bool valid = true;
+  for (unsigned i = 0; i < 100; ++i) {
+    unsigned counts[3] = { 0, 0, 0 };
+    pool.Run([&counts](unsigned band, unsigned n_bands){
+        if (band < 3 && n_bands == 3)
+          ++counts[band];
+      });
+
+    valid = valid && counts[0] == 1 && counts[1] == 1 && counts[2] == 1;
+  }
+
+  ok1(valid);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(10 + 17 + 1);
+
+  TestClipping();
+  TestBands();
+  TestPool();
+
+  return exit_status();
+}
@@ -21,8 +21,13 @@
 */
 
 #include "Profile/Profile.hpp"
+#include "Profile/Map.hpp"
+#include "Profile/File.hpp"
+#include "Profile/BinaryFile.hpp"
+#include "IO/FileOutputStream.hxx"
 #include "IO/FileLineReader.hpp"
 #include "OS/Path.hpp"
+#include "OS/FileUtil.hpp"
 #include "TestUtil.hpp"
 #include "Util/StringAPI.hxx"
 #include "Util/StaticString.hxx"
@@ -136,13 +141,178 @@ TestReader()
   }
 }
 
+static void
+TestBinary()
+{
+  const Path text_path(_T("output/TestProfileBinary.prf"));
+  const Path binary_path(_T("output/TestProfileBinary.prf.bin"));
+
+  ProfileMap map;
+  map.Set("key1", 4);
+  map.Set("key2", "value2");
+  Profile::SaveFile(map, text_path);
+
+  const auto stamp = Profile::StampFile(text_path);
+  Profile::SaveBinaryFile(map, binary_path, stamp);
+
+  {
+    ProfileMap map2;
+    ok1(Profile::LoadBinaryFile(map2, binary_path, stamp) == 0);
+    ok1(map2 == map);
+  }
+
+  /* append modified values to the journal */
+  map.SetModified(false);
+  map.Set("key1", 5);
+  map.Set("key3", "value3");
+  map.Set("key2", "value2");
+  ok1(map.GetModifiedKeys().size() == 2);
+  ok1(Profile::AppendBinaryFile(map, map.GetModifiedKeys(),
+                                binary_path) == 2);
+
+  {
+    ProfileMap map2;
+    ok1(Profile::LoadBinaryFile(map2, binary_path, stamp) == 2);
+    ok1(map2 == map);
+  }
+
+  /* a different text file invalidates the binary file */
+  {
+    ProfileMap map2;
+    bool failed = false;
+    try {
+      Profile::LoadBinaryFile(map2, binary_path,
+                              Profile::FileStamp{stamp.size + 1, stamp.crc});
+    } catch (const std::runtime_error &e) {
+      failed = true;
+    }
+
+    ok1(failed);
+    ok1(map2.empty());
+  }
+
+  /* a damaged record at the end is ignored */
+  {
+    FileOutputStream file(binary_path,
+                          FileOutputStream::Mode::APPEND_EXISTING);
+    file.Write("\x04\x00\x01\x00key", 7);
+    file.Commit();
+
+    ProfileMap map2;
+    ok1(Profile::LoadBinaryFile(map2, binary_path, stamp) == -1);
+    ok1(map2 == map);
+  }
+}
+
+static void
+TestJournal()
+{
+  const Path text_path(_T("output/TestProfileJournal.prf"));
+
+  Profile::SetFiles(text_path);
+  Profile::Clear();
+  Profile::Set("key1", 1);
+  Profile::Save();
+
+  /* this one goes to the journal only */
+  Profile::Set("key1", 2);
+  Profile::Save();
+  ok1(!Profile::IsModified());
+
+  {
+    /* the text file is outdated, but LoadFile() applies the
+       journal */
+    ProfileMap map;
+    Profile::LoadFile(map, text_path);
+    ok1(StringIsEqual(map.Get("key1", ""), "2"));
+  }
+
+  Profile::Clear();
+  Profile::Load();
+
+  int value;
+  ok1(Profile::Get("key1", value));
+  ok1(value == 2);
+
+  /* compaction updates the text file */
+  Profile::Compact();
+
+  {
+    ProfileMap map;
+    Profile::LoadFile(map, text_path);
+    ok1(StringIsEqual(map.Get("key1", ""), "2"));
+  }
+}
+
+/**
+ * The journal has not been compacted (the previous session has
+ * crashed), and somebody else rewrites the text file.
+ */
+static void
+TestCrash()
+{
+  const Path text_path(_T("output/TestProfileCrash.prf"));
+  const auto binary_path = Profile::GetBinaryPath(text_path);
+
+  Profile::SetFiles(text_path);
+  Profile::Clear();
+  Profile::Set("key1", 1);
+  Profile::Save();
+  Profile::Set("key1", 2);
+  Profile::Save();
+
+  /* like the "Password" button in the profile list dialog */
+  {
+    ProfileMap map;
+    Profile::LoadFile(map, text_path);
+    ok1(StringIsEqual(map.Get("key1", ""), "2"));
+    map.Set("key2", 7);
+    Profile::SaveFile(map, text_path);
+  }
+
+  /* the binary copy is outdated now */
+  ok1(!File::Exists(binary_path));
+
+  Profile::Clear();
+  Profile::Load();
+
+  int value;
+  ok1(Profile::Get("key1", value));
+  ok1(value == 2);
+  ok1(Profile::Get("key2", value));
+  ok1(value == 7);
+
+  /* crash again, with values in the journal */
+  Profile::Set("key1", 3);
+  Profile::Save();
+  Profile::Set("key1", 4);
+  Profile::Save();
+
+  /* the next start compacts, which updates the text file */
+  Profile::Clear();
+  Profile::Load();
+  ok1(File::Exists(binary_path));
+
+  File::Delete(binary_path);
+
+  {
+    ProfileMap map;
+    Profile::LoadFile(map, text_path);
+    ok1(StringIsEqual(map.Get("key1", ""), "4"));
+    ok1(StringIsEqual(map.Get("key2", ""), "7"));
+  }
+}
+
 int main(int argc, char **argv)
 try {
-  plan_tests(31);
+  plan_tests(31 + 10 + 5 + 9);
 
   TestMap();
   TestWriter();
   TestReader();
+  TestBinary();
+  TestJournal();
+  TestCrash();
 
   return exit_status();
 } catch (const std::runtime_error &e) {
@@ -46,12 +46,40 @@ test_simple()
                                     Angle::Zero()), 0, 0);
 }
 
+/**
+ * The overload with a precalculated cosine must be equivalent to the
+ * generic GeoToScreen().
+ */
+static void
+test_cos_latitude()
+{
+  Projection prj;
+  prj.SetGeoLocation(GeoPoint(Angle::Degrees(7.5), Angle::Degrees(51.2)));
+  prj.SetScreenOrigin(320, 240);
+  prj.SetScreenAngle(Angle::Degrees(33));
+  prj.SetScale(0.01);
+
+  const GeoPoint points[] = {
+    GeoPoint(Angle::Degrees(7.5), Angle::Degrees(51.2)),
+    GeoPoint(Angle::Degrees(7.41), Angle::Degrees(51.27)),
+    GeoPoint(Angle::Degrees(7.63), Angle::Degrees(51.02)),
+    GeoPoint(Angle::Degrees(6.9), Angle::Degrees(51.8)),
+  };
+
+  for (const auto &p : points) {
+    const auto a = prj.GeoToScreen(p);
+    const auto b = prj.GeoToScreen(p, p.latitude.fastcosine());
+    ok1(a.x == b.x && a.y == b.y);
+  }
+}
+
 int
 main(int argc, char **argv)
 {
-  plan_tests(4);
+  plan_tests(4 + 4);
 
   test_simple();
+  test_cos_latitude();
 
   return exit_status();
 }
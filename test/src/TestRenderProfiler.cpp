@@ -0,0 +1,136 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "MapWindow/RenderProfiler.hpp"
+#include "IO/OutputStream.hxx"
+#include "IO/BufferedOutputStream.hxx"
+#include "TestUtil.hpp"
+
+#include <string>
+
+#include <string.h>
+
+class StringOutputStream final : public OutputStream {
+public:
+  std::string value;
+
+  void Write(const void *data, size_t size) override {
+    value.append((const char *)data, size);
+  }
+};
+
+/**
+ * Record a frame with three layers.  All times are in microseconds;
+ * the CPU time is half the wall clock time.
+ */
+static void
+RecordFrame(RenderProfiler &profiler, uint64_t start,
+            unsigned terrain, unsigned airspace, unsigned waypoints)
+{
+  uint64_t t = start;
+  profiler.BeginFrame(t, t / 2);
+  profiler.Mark("Terrain", t, t / 2);
+  t += terrain;
+  profiler.Mark("Airspace", t, t / 2);
+  t += airspace;
+  profiler.Mark("Waypoints", t, t / 2);
+  t += waypoints;
+  profiler.EndFrame(t, t / 2);
+}
+
+static void
+TestStatistics()
+{
+  RenderProfiler profiler;
+  profiler.SetEnabled(true);
+
+  ok1(profiler.GetStatistics().n_frames == 0);
+
+  profiler.AddWaitTime(4000);
+  RecordFrame(profiler, 1000000, 5000, 2000, 1000);
+  RecordFrame(profiler, 1100000, 7000, 2000, 1000);
+
+  const auto s = profiler.GetStatistics();
+  ok1(s.n_frames == 2);
+  ok1(s.average == 9000);
+  ok1(s.maximum == 10000);
+  ok1(s.jitter == 2000);
+  ok1(s.average_wait == 2000);
+
+  ok1(s.layers.size() == 3);
+  ok1(strcmp(s.layers[0].name, "Terrain") == 0);
+  ok1(s.layers[0].average == 6000);
+  ok1(s.layers[0].maximum == 7000);
+  ok1(s.layers[0].average_cpu == 3000);
+  ok1(strcmp(s.layers[1].name, "Airspace") == 0);
+  ok1(strcmp(s.layers[2].name, "Waypoints") == 0);
+  ok1(s.layers[2].average == 1000);
+
+  /* the ring buffer keeps only the last frames */
+  for (unsigned i = 0; i < RenderProfiler::MAX_FRAMES + 10; ++i)
+    RecordFrame(profiler, 2000000 + i * 100000, 1000, 1000, 1000);
+
+  const auto s2 = profiler.GetStatistics();
+  ok1(s2.n_frames == RenderProfiler::MAX_FRAMES);
+  ok1(s2.average == 3000);
+  ok1(s2.jitter == 0);
+
+  /* enabling again discards old frames */
+  profiler.SetEnabled(false);
+  profiler.SetEnabled(true);
+  ok1(profiler.GetStatistics().n_frames == 0);
+}
+
+static void
+TestExport()
+{
+  RenderProfiler profiler;
+  profiler.SetEnabled(true);
+  profiler.AddWaitTime(500);
+  RecordFrame(profiler, 1000000, 5000, 2000, 1000);
+
+  StringOutputStream sos;
+  BufferedOutputStream os(sos);
+  profiler.ExportChromeTrace(os);
+  os.Flush();
+
+  const std::string &json = sos.value;
+  ok1(json.compare(0, 18, "{\"displayTimeUnit\"") == 0);
+  ok1(json.find("\"name\":\"Frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                "\"ts\":1000000,\"dur\":8000") != json.npos);
+  ok1(json.find("\"name\":\"Airspace\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                "\"ts\":1005000,\"dur\":2000,\"args\":{\"cpu_us\":1000}")
+      != json.npos);
+  ok1(json.find("\"name\":\"DrawThread wait\",\"ph\":\"X\",\"pid\":1,"
+                "\"tid\":1,\"ts\":999500,\"dur\":500") != json.npos);
+  ok1(json.compare(json.length() - 4, 4, "\n]}\n") == 0);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(23);
+
+  TestStatistics();
+  TestExport();
+
+  return exit_status();
+}
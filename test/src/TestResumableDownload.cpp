@@ -0,0 +1,608 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Runs Net::ResumableDownload against a small HTTP server on the
+ * loopback interface.
+ */
+
+#include "Net/HTTP/ResumableDownload.hpp"
+#include "Net/HTTP/Session.hpp"
+#include "Net/HTTP/Init.hpp"
+#include "Net/SocketDescriptor.hpp"
+#include "Net/IPv4Address.hxx"
+#include "Thread/Thread.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "OS/Clock.hpp"
+#include "Logger/MD5.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+using namespace Net;
+
+/**
+ * Large enough for DownloadState::MAX_SEGMENTS segments.
+ */
+static constexpr uint64_t SIZE =
+  DownloadState::MAX_SEGMENTS * DownloadState::MIN_SEGMENT_SIZE + 12345;
+
+static const Path path(_T("output/TestResumableDownload.dat"));
+static const Path part_path(_T("output/TestResumableDownload.dat.part"));
+static const Path state_path(_T("output/TestResumableDownload.dat.part.state"));
+
+static uint8_t
+ContentByte(uint64_t i)
+{
+  return uint8_t(i * 7 + (i >> 11));
+}
+
+static void
+GetContentDigest(uint64_t size, char *digest)
+{
+  MD5 md5;
+  md5.Initialise();
+  for (uint64_t i = 0; i < size; ++i)
+    md5.Append(ContentByte(i));
+  md5.Finalize();
+  md5.GetDigest(digest);
+}
+
+static bool
+CheckFile(Path p, uint64_t size)
+{
+  FILE *file = fopen(p.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+
+  uint64_t i = 0;
+  bool equal = true;
+  int ch;
+  while (equal && (ch = getc(file)) != EOF)
+    equal = uint8_t(ch) == ContentByte(i++);
+
+  fclose(file);
+  return equal && i == size;
+}
+
+/**
+ * A minimal HTTP server which serves the bytes generated by
+ * ContentByte().  It handles one connection at a time.
+ */
+class TestServer final : Thread {
+  struct Connection {
+    SocketDescriptor fd;
+    bool has_range;
+    uint64_t start;
+    int64_t end;
+  };
+
+  SocketDescriptor listener;
+  unsigned port;
+
+  std::atomic<bool> quit;
+
+public:
+  struct Range {
+    uint64_t start;
+    int64_t end;
+  };
+
+  /**
+   * The size of the file on the server.
+   */
+  uint64_t size = SIZE;
+
+  /**
+   * Does the server support range requests?  If not, the "Range"
+   * header is ignored.
+   */
+  bool ranges = true;
+
+  /**
+   * Send at most this number of bytes per response, and then close
+   * the connection.
+   */
+  uint64_t limit = UINT64_MAX;
+
+  /**
+   * Collect this number of requests and then respond to them in
+   * descending order of the range start, to make the segments
+   * arrive out of order.
+   */
+  unsigned batch = 1;
+
+  /**
+   * The ranges which were requested, in the order in which they
+   * were served; "end" is -1 for open-ended ranges.  Must not be
+   * accessed before Stop().
+   */
+  std::vector<Range> requests;
+
+  /**
+   * The number of body bytes which were sent.  Must not be accessed
+   * before Stop().
+   */
+  uint64_t sent = 0;
+
+  TestServer():Thread("TestServer"), quit(false) {
+    if (!listener.CreateTCP() ||
+        !listener.Bind(IPv4Address(127, 0, 0, 1, 0)) ||
+        listen(listener.Get(), 8) < 0)
+      throw std::runtime_error("Failed to create the listener");
+
+    struct sockaddr_in address;
+    socklen_t length = sizeof(address);
+    if (getsockname(listener.Get(), (struct sockaddr *)&address,
+                    &length) < 0)
+      throw std::runtime_error("getsockname() failed");
+
+    port = ntohs(address.sin_port);
+  }
+
+  ~TestServer() {
+    listener.Close();
+  }
+
+  void GetURI(char *buffer, size_t size) const {
+    snprintf(buffer, size, "http://127.0.0.1:%u/file", port);
+  }
+
+  using Thread::Start;
+
+  void Stop() {
+    quit = true;
+    Join();
+  }
+
+private:
+  bool ReceiveRequest(Connection &c);
+  void Serve(Connection &c);
+
+protected:
+  /* virtual methods from class Thread */
+  void Run() override;
+};
+
+bool
+TestServer::ReceiveRequest(Connection &c)
+{
+  char buffer[4096];
+  size_t fill = 0;
+
+  do {
+    if (fill >= sizeof(buffer) - 1 || c.fd.WaitReadable(1000) <= 0)
+      return false;
+
+    ssize_t nbytes = c.fd.Read(buffer + fill, sizeof(buffer) - 1 - fill);
+    if (nbytes <= 0)
+      return false;
+
+    fill += nbytes;
+    buffer[fill] = 0;
+  } while (strstr(buffer, "\r\n\r\n") == nullptr);
+
+  const char *range = strstr(buffer, "\r\nRange: bytes=");
+  c.has_range = range != nullptr;
+  c.start = 0;
+  c.end = -1;
+
+  if (c.has_range) {
+    char *p;
+    c.start = strtoull(range + 15, &p, 10);
+    if (*p == '-' && p[1] >= '0' && p[1] <= '9')
+      c.end = strtoll(p + 1, nullptr, 10);
+  }
+
+  return true;
+}
+
+void
+TestServer::Serve(Connection &c)
+{
+  requests.push_back({c.start, c.end});
+
+  uint64_t start = 0, end = size;
+  char header[256];
+
+  if (ranges && c.has_range) {
+    start = c.start;
+    if (c.end >= 0)
+      end = std::min<uint64_t>(c.end + 1, size);
+
+    snprintf(header, sizeof(header),
+             "HTTP/1.1 206 Partial Content\r\n"
+             "Content-Range: bytes %llu-%llu/%llu\r\n"
+             "Content-Length: %llu\r\n"
+             "Connection: close\r\n\r\n",
+             (unsigned long long)start, (unsigned long long)(end - 1),
+             (unsigned long long)size,
+             (unsigned long long)(end - start));
+  } else
+    snprintf(header, sizeof(header),
+             "HTTP/1.1 200 OK\r\n"
+             "Content-Length: %llu\r\n"
+             "Connection: close\r\n\r\n",
+             (unsigned long long)size);
+
+  if (c.fd.Write(header, strlen(header)) < 0)
+    return;
+
+  if (limit < end - start)
+    end = start + limit;
+
+  uint8_t buffer[16384];
+  for (uint64_t position = start; position < end && !quit;) {
+    const size_t n = std::min<uint64_t>(sizeof(buffer), end - position);
+    for (size_t i = 0; i < n; ++i)
+      buffer[i] = ContentByte(position + i);
+
+    const ssize_t nbytes = c.fd.Write(buffer, n);
+    if (nbytes <= 0)
+      /* the client has cancelled the request */
+      break;
+
+    position += nbytes;
+    sent += nbytes;
+  }
+}
+
+void
+TestServer::Run()
+{
+  std::vector<Connection> pending;
+
+  while (!quit) {
+    if (listener.WaitReadable(100) > 0) {
+      Connection c;
+      c.fd = listener.Accept();
+      if (!c.fd.IsDefined())
+        continue;
+
+      if (!ReceiveRequest(c)) {
+        c.fd.Close();
+        continue;
+      }
+
+      pending.push_back(c);
+      if (pending.size() < batch)
+        continue;
+    } else if (pending.empty())
+      continue;
+
+    /* no more requests within 100 ms, or the batch is complete */
+    std::sort(pending.begin(), pending.end(),
+              [](const Connection &a, const Connection &b){
+                return a.start > b.start;
+              });
+
+    for (auto &c : pending) {
+      Serve(c);
+      c.fd.Close();
+    }
+
+    pending.clear();
+  }
+
+  for (auto &c : pending)
+    c.fd.Close();
+}
+
+/**
+ * Drive the download until it is finished.
+ *
+ * @return false on timeout
+ */
+static bool
+Run(Session &session, ResumableDownload &download)
+{
+  const unsigned start_time = MonotonicClockMS();
+
+  do {
+    session.Select(1000);
+    session.Perform();
+
+    if (download.Poll())
+      return true;
+  } while (MonotonicClockMS() - start_time < 10000);
+
+  return false;
+}
+
+/**
+ * Run a download which is interrupted by the server, and leave the
+ * partial file behind.
+ *
+ * @return the number of bytes which were received
+ */
+static uint64_t
+Interrupt(const char *digest)
+{
+  TestServer server;
+  server.limit = 100000;
+  server.Start();
+
+  char uri[64];
+  server.GetURI(uri, sizeof(uri));
+
+  uint64_t position = 0;
+
+  {
+    Session session;
+    ResumableDownload download(session, uri, path, digest);
+    download.Start();
+
+    try {
+      Run(session, download);
+    } catch (const std::runtime_error &) {
+    }
+
+    position = download.GetPosition();
+  }
+
+  server.Stop();
+  return position;
+}
+
+static void
+TestRanges(const char *digest)
+{
+  TestServer server;
+  server.Start();
+
+  char uri[64];
+  server.GetURI(uri, sizeof(uri));
+
+  bool success;
+
+  {
+    Session session;
+    ResumableDownload download(session, uri, path, digest);
+    download.Start();
+    success = Run(session, download);
+    ok1(download.GetSize() == int64_t(SIZE));
+  }
+
+  server.Stop();
+
+  ok1(success);
+  ok1(CheckFile(path, SIZE));
+  ok1(!File::Exists(part_path));
+  ok1(!File::Exists(state_path));
+
+  /* the probe is open-ended; the remaining segments are requested
+     in parallel */
+  ok1(server.requests.size() == DownloadState::MAX_SEGMENTS);
+  ok1(server.requests.front().start == 0 &&
+      server.requests.front().end == -1);
+  ok1(std::all_of(server.requests.begin() + 1, server.requests.end(),
+                  [](const TestServer::Range &r){
+                    return r.start > 0 && r.end >= 0;
+                  }));
+
+  File::Delete(path);
+}
+
+static void
+TestNoRanges(const char *digest)
+{
+  TestServer server;
+  server.ranges = false;
+  server.Start();
+
+  char uri[64];
+  server.GetURI(uri, sizeof(uri));
+
+  bool success;
+
+  {
+    Session session;
+    ResumableDownload download(session, uri, path, digest);
+    download.Start();
+    success = Run(session, download);
+  }
+
+  server.Stop();
+
+  /* the whole file in one request */
+  ok1(success);
+  ok1(CheckFile(path, SIZE));
+  ok1(server.requests.size() == 1);
+  ok1(server.sent == SIZE);
+  File::Delete(path);
+
+  /* an interrupted download can't be resumed and is discarded */
+  TestServer server2;
+  server2.ranges = false;
+  server2.limit = 100000;
+  server2.Start();
+  server2.GetURI(uri, sizeof(uri));
+
+  {
+    Session session;
+    ResumableDownload download(session, uri, path, digest);
+    download.Start();
+
+    try {
+      Run(session, download);
+    } catch (const std::runtime_error &) {
+    }
+  }
+
+  server2.Stop();
+
+  ok1(!File::Exists(part_path));
+  ok1(!File::Exists(state_path));
+}
+
+static void
+TestResume(const char *digest)
+{
+  const uint64_t position = Interrupt(digest);
+  ok1(position > 0 && position < SIZE);
+  ok1(File::Exists(part_path));
+  ok1(File::Exists(state_path));
+
+  /* respond to the last segment first, so the MD5 has to catch up
+     with data which was written out of order */
+  TestServer server;
+  server.batch = DownloadState::MAX_SEGMENTS;
+  server.Start();
+
+  char uri[64];
+  server.GetURI(uri, sizeof(uri));
+
+  bool success;
+
+  {
+    Session session;
+    ResumableDownload download(session, uri, path, digest);
+    download.Start();
+    ok1(download.GetPosition() == int64_t(position));
+    success = Run(session, download);
+  }
+
+  server.Stop();
+
+  ok1(success);
+  ok1(CheckFile(path, SIZE));
+  ok1(!File::Exists(part_path));
+  ok1(!File::Exists(state_path));
+
+  /* only the missing data was requested */
+  ok1(server.sent == SIZE - position);
+  ok1(std::all_of(server.requests.begin(), server.requests.end(),
+                  [](const TestServer::Range &r){
+                    return r.start > 0 && r.end >= 0;
+                  }));
+  ok1(server.requests.size() > 1 &&
+      server.requests.front().start > server.requests.back().start);
+
+  File::Delete(path);
+}
+
+static void
+TestDigestMismatch()
+{
+  TestServer server;
+  server.Start();
+
+  char uri[64];
+  server.GetURI(uri, sizeof(uri));
+
+  bool mismatch = false;
+
+  {
+    Session session;
+    ResumableDownload download(session, uri, path,
+                               "00000000000000000000000000000000");
+    download.Start();
+
+    try {
+      Run(session, download);
+    } catch (const ResumableDownload::DigestMismatch &) {
+      mismatch = true;
+    }
+  }
+
+  server.Stop();
+
+  /* the file is deleted, not resumed */
+  ok1(mismatch);
+  ok1(!File::Exists(path));
+  ok1(!File::Exists(part_path));
+  ok1(!File::Exists(state_path));
+}
+
+static void
+TestModified(const char *digest)
+{
+  ok1(Interrupt(digest) > 0);
+  ok1(File::Exists(state_path));
+
+  /* the file on the server has shrunk since the download was
+     interrupted */
+  TestServer server;
+  server.size = SIZE - 100000;
+  server.Start();
+
+  char uri[64];
+  server.GetURI(uri, sizeof(uri));
+
+  std::string error;
+
+  {
+    Session session;
+    ResumableDownload download(session, uri, path, digest);
+    download.Start();
+
+    try {
+      Run(session, download);
+    } catch (const std::runtime_error &e) {
+      error = e.what();
+    }
+  }
+
+  server.Stop();
+
+  ok1(error == "Unexpected response length");
+
+  /* resuming is pointless; the partial file is deleted */
+  ok1(!File::Exists(path));
+  ok1(!File::Exists(part_path));
+  ok1(!File::Exists(state_path));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(8 + 6 + 11 + 4 + 6);
+
+  Net::Initialise();
+
+  char digest[MD5::DIGEST_LENGTH + 1];
+  GetContentDigest(SIZE, digest);
+
+  ResumableDownload::Discard(path);
+  File::Delete(path);
+
+  TestRanges(digest);
+  TestNoRanges(digest);
+  TestResume(digest);
+  TestDigestMismatch();
+  TestModified(digest);
+
+  Net::Deinitialise();
+
+  return exit_status();
+}
@@ -0,0 +1,167 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Engine/PathSolvers/ScanTaskPointMap.hpp"
+#include "Engine/PathSolvers/Dijkstra.hpp"
+
+extern "C" {
+#include "tap.h"
+}
+
+#include <map>
+#include <stdlib.h>
+
+typedef DenseScanTaskPointMap<8>::Bind<unsigned> DenseMap;
+
+/**
+ * Apply random inserts to #DenseMap and std::map, and check that
+ * both have the same contents.
+ */
+static bool
+CompareRandom(DenseMap &dense, unsigned n)
+{
+  std::map<uint32_t, unsigned> reference;
+
+  for (unsigned i = 0; i < n; ++i) {
+    const ScanTaskPoint key(rand() % 8, rand() % 300);
+    const unsigned value = rand();
+
+    const bool inserted = dense.insert(std::make_pair(key, value)).second;
+    if (inserted != reference.insert(std::make_pair(key.Key(), value)).second)
+      return false;
+  }
+
+  for (const auto &i : reference) {
+    const ScanTaskPoint key(i.first >> 16, i.first & 0xffff);
+    auto j = dense.find(key);
+    if (j == dense.end() || j->first != key || j->second != i.second)
+      return false;
+  }
+
+  unsigned count = 0;
+  for (const auto &i : dense) {
+    if (reference.find(i.first.Key()) == reference.end())
+      return false;
+    ++count;
+  }
+
+  return count == reference.size();
+}
+
+static void
+TestMap()
+{
+  DenseMap map;
+  ok1(map.begin() == map.end());
+  ok1(map.find(ScanTaskPoint(0, 0)) == map.end());
+
+  auto i = map.insert(std::make_pair(ScanTaskPoint(2, 5), 42u));
+  ok1(i.second);
+  ok1(i.first->first == ScanTaskPoint(2, 5));
+  ok1(i.first->second == 42);
+
+  /* duplicate insert doesn't overwrite */
+  i = map.insert(std::make_pair(ScanTaskPoint(2, 5), 43u));
+  ok1(!i.second);
+  ok1(i.first->second == 42);
+
+  /* iterators remain valid when a stage grows */
+  auto j = map.insert(std::make_pair(ScanTaskPoint(2, 1000), 7u)).first;
+  ok1(i.first->second == 42);
+  ok1(j->second == 7);
+  ok1(map.find(ScanTaskPoint(2, 999)) == map.end());
+
+  map.clear();
+  ok1(map.begin() == map.end());
+  ok1(map.find(ScanTaskPoint(2, 5)) == map.end());
+  ok1(map.insert(std::make_pair(ScanTaskPoint(2, 5), 1u)).second);
+
+  /* reuse after clear() */
+  bool success = true;
+  for (unsigned n = 0; n < 8; ++n) {
+    map.clear();
+    success &= CompareRandom(map, 500);
+  }
+  ok1(success);
+}
+
+/**
+ * Solve a random shortest path problem on a stage graph, and return
+ * the total value of the first final node.
+ */
+template<typename Map>
+static unsigned
+SolveRandom(unsigned seed)
+{
+  constexpr unsigned n_stages = 5, n_points = 40;
+
+  srand(seed);
+  unsigned weights[n_stages][n_points][n_points];
+  for (auto &a : weights)
+    for (auto &b : a)
+      for (auto &c : b)
+        c = rand() % 1000;
+
+  Dijkstra<ScanTaskPoint, Map> dijkstra;
+  dijkstra.Clear();
+  for (unsigned i = 0; i < n_points; ++i)
+    dijkstra.Link(ScanTaskPoint(0, i), ScanTaskPoint(0, i), rand() % 1000);
+
+  while (!dijkstra.IsEmpty()) {
+    const ScanTaskPoint node = dijkstra.Pop();
+    const unsigned stage = node.GetStageNumber();
+    if (stage + 1 == n_stages) {
+      unsigned total = 0;
+      for (ScanTaskPoint p = node; !p.IsFirst();) {
+        const ScanTaskPoint parent = dijkstra.GetPredecessor(p);
+        total += weights[stage][parent.GetPointIndex()][p.GetPointIndex()];
+        p = parent;
+      }
+
+      return total;
+    }
+
+    for (unsigned j = 0; j < n_points; ++j)
+      dijkstra.Link(ScanTaskPoint(stage + 1, j), node,
+                    weights[stage][node.GetPointIndex()][j]);
+  }
+
+  return 0;
+}
+
+static void
+TestDijkstra()
+{
+  for (unsigned seed = 1; seed <= 4; ++seed)
+    ok1(SolveRandom<DenseScanTaskPointMap<8>>(seed) ==
+        SolveRandom<HashScanTaskPointMap>(seed));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(18);
+
+  TestMap();
+  TestDijkstra();
+
+  return exit_status();
+}
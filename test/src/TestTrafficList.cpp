@@ -0,0 +1,216 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "FLARM/List.hpp"
+#include "FLARM/FlarmCalculations.hpp"
+#include "TestUtil.hpp"
+
+#include <stdio.h>
+
+static FlarmId
+MakeId(unsigned i)
+{
+  /* spread the ids like real FLARM ids, with many common prefixes */
+  char buffer[16];
+  sprintf(buffer, "DD%04X", (i * 37) & 0xffff);
+  return FlarmId::Parse(buffer, nullptr);
+}
+
+template<typename L>
+static void
+Fill(L &list, unsigned n)
+{
+  for (unsigned i = 0; i < n; ++i) {
+    FlarmTraffic *traffic = list.AllocateTraffic(MakeId(i));
+    traffic->valid.Update(i % 2 == 0 ? 10 : 5);
+    traffic->distance = (n - i) * 100;
+  }
+}
+
+static void
+TestFind()
+{
+  TrafficList list;
+  list.Clear();
+
+  ok1(list.FindTraffic(MakeId(0)) == nullptr);
+  ok1(list.FindNearest() == nullptr);
+
+  Fill(list, TrafficList::MAX_COUNT);
+  ok1(list.list.full());
+  ok1(list.AllocateTraffic(MakeId(TrafficList::MAX_COUNT)) == nullptr);
+
+  bool all_found = true;
+  for (unsigned i = 0; i < TrafficList::MAX_COUNT; ++i) {
+    const FlarmTraffic *traffic = list.FindTraffic(MakeId(i));
+    if (traffic == nullptr || !(traffic->id == MakeId(i)))
+      all_found = false;
+  }
+
+  ok1(all_found);
+  ok1(list.FindTraffic(MakeId(TrafficList::MAX_COUNT)) == nullptr);
+
+  /* expire the odd ones, which have moved to other positions in the
+     array */
+  list.Expire(10);
+  ok1(list.GetActiveTrafficCount() == (TrafficList::MAX_COUNT + 1) / 2);
+
+  bool correct = true;
+  for (unsigned i = 0; i < TrafficList::MAX_COUNT; ++i) {
+    const FlarmTraffic *traffic = list.FindTraffic(MakeId(i));
+    if ((traffic != nullptr) != (i % 2 == 0) ||
+        (traffic != nullptr && !(traffic->id == MakeId(i))))
+      correct = false;
+  }
+
+  ok1(correct);
+
+  /* the free slots can be used again */
+  ok1(list.AllocateTraffic(MakeId(1)) != nullptr);
+  ok1(list.FindTraffic(MakeId(1)) != nullptr);
+  ok1(list.FindTraffic(MakeId(0)) != nullptr);
+
+  list.Clear();
+  ok1(list.IsEmpty());
+  ok1(list.FindTraffic(MakeId(0)) == nullptr);
+}
+
+static void
+TestDistance()
+{
+  TrafficList list;
+  list.Clear();
+  Fill(list, 10);
+
+  /* without SortByDistance(), the fallbacks are used */
+  ok1(list.FindNearest() == list.FindTraffic(MakeId(9)));
+
+  unsigned n = 0;
+  list.VisitWithin(300, [&n](const FlarmTraffic &traffic){
+      ++n;
+    });
+  ok1(n == 3);
+
+  list.SortByDistance();
+  ok1(list.distance_order_valid);
+  ok1(list.FindNearest() == list.FindTraffic(MakeId(9)));
+
+  n = 0;
+  bool sorted = true;
+  double last = 0;
+  list.VisitWithin(450, [&](const FlarmTraffic &traffic){
+      ++n;
+      if (double(traffic.distance) < last)
+        sorted = false;
+      last = traffic.distance;
+    });
+  ok1(n == 4);
+  ok1(sorted);
+
+  /* modifications invalidate the order */
+  FlarmTraffic *traffic = list.AllocateTraffic(MakeId(10));
+  traffic->distance = 50;
+  ok1(!list.distance_order_valid);
+  ok1(list.FindNearest() == traffic);
+}
+
+static void
+TestCalculations()
+{
+  FlarmCalculations calculations;
+
+  for (unsigned t = 0; t <= 10; ++t) {
+    calculations.Average30s(MakeId(1), t, 1000 + t);
+    calculations.Average30s(MakeId(2), t, 1000 - 2 * t);
+  }
+
+  ok1(equals(calculations.Average30s(MakeId(1), 11, 1011), 1));
+  ok1(equals(calculations.Average30s(MakeId(2), 11, 978), -2));
+
+  /* after expiry, the history is gone */
+  calculations.CleanUp(100);
+  ok1(equals(calculations.Average30s(MakeId(1), 100, 2000), 0));
+  ok1(equals(calculations.Average30s(MakeId(1), 101, 2002), 2));
+}
+
+static void
+TestDatabase()
+{
+  TrafficDatabase database;
+  ok1(database.IsEmpty());
+
+  Fill(database, TrafficDatabase::MAX_COUNT);
+  ok1(database.GetActiveTrafficCount() == 256);
+  ok1(database.AllocateTraffic(MakeId(256)) == nullptr);
+
+  bool all_found = true;
+  for (unsigned i = 0; i < TrafficDatabase::MAX_COUNT; ++i) {
+    FlarmTraffic *traffic = database.FindTraffic(MakeId(i));
+    if (traffic == nullptr) {
+      all_found = false;
+      continue;
+    }
+
+    /* the last one is the nearest */
+    traffic->relative_north = (TrafficDatabase::MAX_COUNT - i) * 100;
+    traffic->relative_east = 0;
+    traffic->alarm_level = FlarmTraffic::AlarmType::NONE;
+  }
+
+  ok1(all_found);
+
+  /* the farthest one has an alarm */
+  database.FindTraffic(MakeId(0))->alarm_level =
+    FlarmTraffic::AlarmType::IMPORTANT;
+
+  TrafficList list;
+  list.Clear();
+  database.CopyRelevant(list);
+
+  ok1(list.list.full());
+  ok1(list.list[0].id == MakeId(0));
+  ok1(list.FindTraffic(MakeId(255)) != nullptr);
+  ok1(list.FindTraffic(MakeId(232)) != nullptr);
+  ok1(list.FindTraffic(MakeId(231)) == nullptr);
+
+  /* less traffic than fits into the list: copy everything */
+  database.Clear();
+  Fill(database, 10);
+  database.CopyRelevant(list);
+  ok1(list.GetActiveTrafficCount() == 10);
+
+  database.Clear();
+  database.CopyRelevant(list);
+  ok1(list.IsEmpty());
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(13 + 8 + 4 + 11);
+
+  TestFind();
+  TestDistance();
+  TestCalculations();
+  TestDatabase();
+
+  return exit_status();
+}
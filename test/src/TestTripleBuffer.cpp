@@ -0,0 +1,124 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Util/TripleBuffer.hpp"
+#include "Thread/Thread.hpp"
+#include "TestUtil.hpp"
+
+static void
+TestSequential()
+{
+  TripleBuffer<unsigned> buffer;
+
+  ok1(!buffer.Update());
+
+  buffer.GetWriteBuffer() = 1;
+  buffer.Publish();
+  ok1(buffer.Update());
+  ok1(buffer.GetReadBuffer() == 1);
+  ok1(!buffer.Update());
+  ok1(buffer.GetReadBuffer() == 1);
+
+  /* only the most recent value is seen */
+  buffer.GetWriteBuffer() = 2;
+  buffer.Publish();
+  buffer.GetWriteBuffer() = 3;
+  buffer.Publish();
+  ok1(buffer.GetReadBuffer() == 1);
+  ok1(buffer.Update());
+  ok1(buffer.GetReadBuffer() == 3);
+  ok1(!buffer.Update());
+
+  /* the consumer's buffer is never handed to the producer */
+  for (unsigned i = 4; i < 10; ++i) {
+    buffer.GetWriteBuffer() = i;
+    buffer.Publish();
+  }
+
+  ok1(buffer.GetReadBuffer() == 3);
+  ok1(buffer.Update());
+  ok1(buffer.GetReadBuffer() == 9);
+}
+
+struct Pair {
+  unsigned a, b;
+};
+
+static constexpr unsigned N_VALUES = 200000;
+
+class ProducerThread final : public Thread {
+  TripleBuffer<Pair> &buffer;
+
+public:
+  explicit ProducerThread(TripleBuffer<Pair> &_buffer)
+    :Thread("Producer"), buffer(_buffer) {}
+
+protected:
+  void Run() override {
+    for (unsigned i = 1; i <= N_VALUES; ++i) {
+      Pair &p = buffer.GetWriteBuffer();
+      p.a = i;
+      p.b = ~i;
+      buffer.Publish();
+    }
+  }
+};
+
+static void
+TestConcurrent()
+{
+  TripleBuffer<Pair> buffer;
+
+  ProducerThread producer(buffer);
+  producer.Start();
+
+  /* the consumer must never see a torn value, and the values must
+     never go backwards */
+  bool consistent = true, monotonic = true;
+  unsigned last = 0;
+  while (last < N_VALUES) {
+    if (!buffer.Update())
+      continue;
+
+    const Pair &p = buffer.GetReadBuffer();
+    if (p.b != ~p.a)
+      consistent = false;
+    if (p.a <= last)
+      monotonic = false;
+    last = p.a;
+  }
+
+  producer.Join();
+
+  ok1(consistent);
+  ok1(monotonic);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(12 + 2);
+
+  TestSequential();
+  TestConcurrent();
+
+  return exit_status();
+}
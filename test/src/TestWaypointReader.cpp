@@ -22,6 +22,10 @@
 
 #include "Waypoint/WaypointReader.hpp"
 #include "Waypoint/WaypointReaderBase.hpp"
+#include "Waypoint/WaypointFileType.hpp"
+#include "Waypoint/WaypointCache.hpp"
+#include "IO/FileCache.hpp"
+#include "OS/FileUtil.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 #include "Terrain/RasterMap.hpp"
 #include "Units/System.hpp"
@@ -426,6 +430,101 @@ TestCompeGPS_UTM(wp_vector org_wp)
   }
 }
 
+static bool
+IsEqual(const Waypoint &a, const Waypoint &b)
+{
+  return a.location == b.location &&
+    a.elevation == b.elevation &&
+    a.name == b.name && a.comment == b.comment && a.details == b.details &&
+    a.type == b.type && a.origin == b.origin &&
+    a.original_id == b.original_id &&
+    a.flags.turn_point == b.flags.turn_point &&
+    a.flags.home == b.flags.home &&
+    a.flags.start_point == b.flags.start_point &&
+    a.flags.finish_point == b.flags.finish_point &&
+    a.runway.IsDirectionDefined() == b.runway.IsDirectionDefined() &&
+    (!a.runway.IsDirectionDefined() ||
+     a.runway.GetDirectionDegrees() == b.runway.GetDirectionDegrees()) &&
+    a.runway.IsLengthDefined() == b.runway.IsLengthDefined() &&
+    (!a.runway.IsLengthDefined() ||
+     a.runway.GetLength() == b.runway.GetLength()) &&
+    a.radio_frequency.IsDefined() == b.radio_frequency.IsDefined() &&
+    (!a.radio_frequency.IsDefined() ||
+     a.radio_frequency.GetKiloHertz() == b.radio_frequency.GetKiloHertz()) &&
+    a.files_embed == b.files_embed;
+}
+
+static bool
+IsEqual(const wp_vector &a, const wp_vector &b)
+{
+  return a.size() == b.size() &&
+    std::equal(a.begin(), a.end(), b.begin(),
+               [](const Waypoint &x, const Waypoint &y){
+                 return IsEqual(x, y);
+               });
+}
+
+static void
+TestParallel(Path path, unsigned num_wps)
+{
+  NullOperationEnvironment operation;
+  const WaypointFactory factory(WaypointOrigin::NONE);
+  const WaypointFileType file_type = DetermineWaypointFileType(path);
+
+  wp_vector sequential;
+  ok1(ReadWaypointFile(path, file_type, sequential, factory, operation, 1));
+  ok1(sequential.size() == num_wps);
+
+  /* split into chunks of just a few lines, to have the reader state
+     (header lines, coordinate format) cross chunk boundaries */
+  for (unsigned max_threads : {2, 3, 64}) {
+    wp_vector parallel;
+    ok1(ReadWaypointFile(path, file_type, parallel, factory, operation,
+                         max_threads) &&
+        IsEqual(sequential, parallel));
+  }
+}
+
+static void
+TestCache()
+{
+  const Path path(_T("test/data/waypoints.cup"));
+  const TCHAR *const name = _T("waypoints");
+
+  Directory::Create(Path(_T("output/results")));
+  FileCache cache(AllocatedPath(_T("output/results")));
+  cache.Flush(name);
+
+  NullOperationEnvironment operation;
+  const WaypointFactory factory(WaypointOrigin::PRIMARY);
+
+  wp_vector original;
+  ok1(ReadWaypointFile(path, WaypointFileType::SEEYOU, original, factory,
+                       operation));
+  original.front().files_embed.push_front(_T("picture.jpg"));
+
+  wp_vector cached;
+  ok1(!LoadWaypointCache(cache, name, path, 0, cached));
+  ok1(SaveWaypointCache(cache, name, path, 0, original));
+  ok1(LoadWaypointCache(cache, name, path, 0, cached));
+  ok1(IsEqual(original, cached));
+
+  /* different terrain: the cached elevations are stale */
+  cached.clear();
+  ok1(!LoadWaypointCache(cache, name, path, 42, cached));
+  ok1(cached.empty());
+
+  /* the mismatch has deleted the entry */
+  ok1(!LoadWaypointCache(cache, name, path, 0, cached));
+
+  /* a different file with the same time stamp and size */
+  ok1(SaveWaypointCache(cache, name, path, 0, original));
+  ok1(!LoadWaypointCache(cache, name, Path(_T("test/data/../data/waypoints.cup")),
+                         0, cached));
+
+  cache.Flush(name);
+}
+
 static wp_vector
 CreateOriginalWaypoints()
 {
@@ -523,7 +622,7 @@ int main(int argc, char **argv)
 {
   wp_vector org_wp = CreateOriginalWaypoints();
 
-  plan_tests(307);
+  plan_tests(307 + 8 * 5 + 10);
 
   TestExtractParameters();
 
@@ -536,5 +635,16 @@ int main(int argc, char **argv)
   TestCompeGPS(org_wp);
   TestCompeGPS_UTM(org_wp);
 
+  TestParallel(Path(_T("test/data/waypoints.dat")), org_wp.size());
+  TestParallel(Path(_T("test/data/waypoints.cup")), org_wp.size());
+  TestParallel(Path(_T("test/data/waypoints.wpz")), org_wp.size());
+  TestParallel(Path(_T("test/data/waypoints_geo.wpt")), org_wp.size());
+  TestParallel(Path(_T("test/data/waypoints_utm.wpt")), org_wp.size());
+  TestParallel(Path(_T("test/data/waypoints_ozi.wpt")), org_wp.size());
+  TestParallel(Path(_T("test/data/waypoints_compe_geo.wpt")), org_wp.size());
+  TestParallel(Path(_T("test/data/waypoints_compe_utm.wpt")), org_wp.size());
+
+  TestCache();
+
   return exit_status();
 }
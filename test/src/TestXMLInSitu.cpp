@@ -0,0 +1,166 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "XML/DataNodeInSitu.hpp"
+#include "XML/DataNodeXML.hpp"
+#include "XML/Node.hpp"
+#include "XML/Parser.hpp"
+#include "OS/Path.hpp"
+#include "Util/StringAPI.hxx"
+#include "Util/tstring.hpp"
+#include "TestUtil.hpp"
+
+#include <memory>
+
+static bool
+Parse(XMLInSituTree &tree, tstring &buffer, const TCHAR *xml,
+      const TCHAR *root_name=nullptr)
+{
+  buffer = xml;
+  return tree.Parse(&buffer[0], root_name);
+}
+
+static void
+TestBasic()
+{
+  tstring buffer;
+  XMLInSituTree tree;
+
+  ok1(Parse(tree, buffer,
+            _T("<?xml version=\"1.0\"?>\n"
+               "<!-- comment <a> -->\n"
+               "<Root a=\"1\" B='x &amp; &lt;y&gt;' a=\"2\">\n"
+               "  <Child name=\"c1\"/>\n"
+               "  <Other>text</Other>\n"
+               "  <child name=\"c2\" flag></child>\n"
+               "</Root>\n")));
+
+  const ConstDataNodeInSitu root(tree);
+  ok1(StringIsEqual(root.GetName(), _T("Root")));
+  ok1(StringIsEqual(root.GetAttribute(_T("a")), _T("2")));
+  ok1(StringIsEqual(root.GetAttribute(_T("b")), _T("x & <y>")));
+  ok1(root.GetAttribute(_T("c")) == nullptr);
+
+  auto children = root.ListChildren();
+  ok1(children.size() == 3);
+  for (auto *i : children)
+    delete i;
+
+  children = root.ListChildrenNamed(_T("CHILD"));
+  ok1(children.size() == 2);
+  ok1(StringIsEqual(children.front()->GetAttribute(_T("name")), _T("c1")));
+  ok1(StringIsEqual(children.back()->GetAttribute(_T("name")), _T("c2")));
+  ok1(StringIsEqual(children.back()->GetAttribute(_T("flag")), _T("")));
+  for (auto *i : children)
+    delete i;
+
+  std::unique_ptr<ConstDataNode> other(root.GetChildNamed(_T("other")));
+  ok1(other && StringIsEqual(other->GetName(), _T("Other")));
+  ok1(other && other->ListChildren().empty());
+}
+
+static void
+TestErrors()
+{
+  tstring buffer;
+  XMLInSituTree tree;
+
+  /* the root name is checked before the rest is parsed */
+  ok1(!Parse(tree, buffer, _T("<Foo><Bar/></Foo>"), _T("Task")));
+  ok1(Parse(tree, buffer, _T("<Task><Bar/></Task>"), _T("Task")));
+
+  ok1(!Parse(tree, buffer, _T("")));
+  ok1(!Parse(tree, buffer, _T("<Task a=\"1></Task>")));
+  ok1(!Parse(tree, buffer, _T("<Task a=\"&foo;\"/>")));
+  ok1(!Parse(tree, buffer, _T("<Task></Bar>")));
+
+  /* unclosed elements are tolerated, like the DOM parser does */
+  ok1(Parse(tree, buffer, _T("<Task><A><B></A>")));
+  const ConstDataNodeInSitu root(tree);
+  std::unique_ptr<ConstDataNode> a(root.GetChildNamed(_T("A")));
+  ok1(a != nullptr);
+  std::unique_ptr<ConstDataNode> b(a ? a->GetChildNamed(_T("B")) : nullptr);
+  ok1(b != nullptr);
+}
+
+static const TCHAR *const attribute_names[] = {
+  _T("type"), _T("name"), _T("id"), _T("comment"), _T("altitude"),
+  _T("longitude"), _T("latitude"), _T("radius"), _T("aat_min_time"),
+  _T("fai_finish"), _T("is_closed"),
+};
+
+/**
+ * Compare two trees recursively.
+ */
+static bool
+Equals(const ConstDataNode &a, const ConstDataNode &b)
+{
+  if (!StringIsEqual(a.GetName(), b.GetName()))
+    return false;
+
+  for (const TCHAR *name : attribute_names) {
+    const TCHAR *va = a.GetAttribute(name), *vb = b.GetAttribute(name);
+    if ((va == nullptr) != (vb == nullptr) ||
+        (va != nullptr && !StringIsEqual(va, vb)))
+      return false;
+  }
+
+  auto la = a.ListChildren(), lb = b.ListChildren();
+  bool result = la.size() == lb.size();
+  for (auto i = la.begin(), j = lb.begin();
+       result && i != la.end(); ++i, ++j)
+    result = Equals(**i, **j);
+
+  for (auto *i : la)
+    delete i;
+  for (auto *i : lb)
+    delete i;
+  return result;
+}
+
+static void
+TestCompareDOM(Path path)
+{
+  std::unique_ptr<XMLNode> node(XML::ParseFile(path));
+  ok1(node != nullptr);
+
+  tstring buffer;
+  ok1(XML::ReadFile(path, buffer));
+
+  XMLInSituTree tree;
+  ok1(tree.Parse(&buffer[0]));
+
+  ok1(node != nullptr &&
+      Equals(ConstDataNodeXML(*node), ConstDataNodeInSitu(tree)));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(12 + 9 + 4);
+
+  TestBasic();
+  TestErrors();
+  TestCompareDOM(Path(_T("test/data/apf-bug554.tsk")));
+
+  return exit_status();
+}
@@ -28,15 +28,21 @@ class ZeroFinderTest: public ZeroFinder
   unsigned func;
 
 public:
+  unsigned calls = 0;
+
   ZeroFinderTest(double x_min, double x_max, unsigned _func = 0) :
     ZeroFinder(x_min, x_max, 0.0001), func(_func) {}
 
+  using ZeroFinder::SetHint;
+
   double f(const double x);
 };
 
 double
 ZeroFinderTest::f(const double x)
 {
+  ++calls;
+
   if (func == 0)
     return 2 * x * x - 3 * x - 5;
 
@@ -53,7 +59,7 @@ ZeroFinderTest::f(const double x)
 
 int main(int argc, char **argv)
 {
-  plan_tests(18);
+  plan_tests(26);
 
   ZeroFinderTest zf(-100, 100, 0);
   ok1(equals(zf.find_zero(-150), -1));
@@ -84,5 +90,32 @@ int main(int argc, char **argv)
   ok1(equals(zf4.find_min(1), M_PI));
   ok1(equals(zf4.find_min(140), M_PI));
 
+  /* a good hint finds the same zero with fewer evaluations */
+  ZeroFinderTest zf5(0, 10, 1);
+  ok1(equals(zf5.find_zero(1), 1.584963));
+  const unsigned full_calls = zf5.calls;
+  zf5.SetHint(1.6, 0.1);
+  zf5.calls = 0;
+  ok1(equals(zf5.find_zero(1), 1.584963));
+  ok1(zf5.calls > 0 && zf5.calls < full_calls);
+
+  /* a hint beyond the range is clipped */
+  ZeroFinderTest zf6(0, M_PI + 1, 2);
+  zf6.SetHint(M_PI, 2);
+  ok1(equals(zf6.find_zero(1), M_PI_2));
+
+  /* a wrong hint falls back to searching the whole range */
+  ZeroFinderTest zf7(0, 100, 0);
+  zf7.SetHint(50, 5);
+  ok1(equals(zf7.find_zero(0), 2.5));
+  zf7.SetHint(150, 10);
+  ok1(equals(zf7.find_zero(0), 2.5));
+
+  ZeroFinderTest zf8(-100, 100, 0);
+  zf8.SetHint(2.4, 0.5);
+  ok1(equals(zf8.find_zero(0), 2.5));
+  zf8.SetHint(-1.1, 0.5);
+  ok1(equals(zf8.find_zero(0), -1));
+
   return exit_status();
 }
@@ -0,0 +1,305 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "IO/ZipArchive.hpp"
+#include "IO/ZipReader.hpp"
+#include "OS/ByteOrder.hpp"
+#include "OS/Path.hpp"
+#include "TestUtil.hpp"
+
+#include <zlib.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+
+static constexpr char ZIP_PATH[] = "output/TestZipReader.zip";
+
+/* larger than ZipReader's window, to exercise refills and seeks
+   outside of it */
+static constexpr size_t DATA_SIZE = 300 * 1024;
+
+static std::string
+MakeData()
+{
+  std::string data;
+  data.reserve(DATA_SIZE);
+
+  /* compressible, but not trivially */
+  unsigned value = 1;
+  while (data.size() < DATA_SIZE) {
+    value = value * 1103515245 + 12345;
+    data.push_back('a' + (value >> 16) % 8);
+  }
+
+  return data;
+}
+
+static void
+Put16(std::string &dest, uint16_t value)
+{
+  value = ToLE16(value);
+  dest.append((const char *)&value, sizeof(value));
+}
+
+static void
+Put32(std::string &dest, uint32_t value)
+{
+  value = ToLE32(value);
+  dest.append((const char *)&value, sizeof(value));
+}
+
+static std::string
+Deflate(const std::string &src)
+{
+  z_stream z;
+  memset(&z, 0, sizeof(z));
+  deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8,
+               Z_DEFAULT_STRATEGY);
+
+  std::string dest(deflateBound(&z, src.size()), 0);
+  z.next_in = (Bytef *)const_cast<char *>(src.data());
+  z.avail_in = src.size();
+  z.next_out = (Bytef *)&dest[0];
+  z.avail_out = dest.size();
+  deflate(&z, Z_FINISH);
+  dest.resize(z.total_out);
+  deflateEnd(&z);
+  return dest;
+}
+
+/**
+ * Write a ZIP file with one stored and one deflated member.  The
+ * local header of the stored member has an "extra" field which is
+ * missing in the central directory.
+ */
+static bool
+WriteZip(const std::string &data)
+{
+  struct Member {
+    const char *name;
+    uint16_t method;
+    std::string contents;
+    uint16_t extra;
+    uint32_t offset;
+  } members[] = {
+    { "stored.bin", 0, data, 4, 0 },
+    { "dir/deflated.bin", 8, Deflate(data), 0, 0 },
+  };
+
+  const uint32_t crc = crc32(0, (const Bytef *)data.data(), data.size());
+
+  std::string zip;
+  for (auto &m : members) {
+    m.offset = zip.size();
+    Put32(zip, 0x04034b50);
+    Put16(zip, 20);
+    Put16(zip, 0);
+    Put16(zip, m.method);
+    Put32(zip, 0);
+    Put32(zip, crc);
+    Put32(zip, m.contents.size());
+    Put32(zip, data.size());
+    Put16(zip, strlen(m.name));
+    Put16(zip, m.extra);
+    zip.append(m.name);
+    if (m.extra > 0) {
+      /* an empty block with a private header id */
+      Put16(zip, 0xcafe);
+      Put16(zip, m.extra - 4);
+    }
+    zip.append(m.contents);
+  }
+
+  const uint32_t cd_offset = zip.size();
+  for (const auto &m : members) {
+    Put32(zip, 0x02014b50);
+    Put16(zip, 20);
+    Put16(zip, 20);
+    Put16(zip, 0);
+    Put16(zip, m.method);
+    Put32(zip, 0);
+    Put32(zip, crc);
+    Put32(zip, m.contents.size());
+    Put32(zip, data.size());
+    Put16(zip, strlen(m.name));
+    Put16(zip, 0);
+    Put16(zip, 0);
+    Put16(zip, 0);
+    Put16(zip, 0);
+    Put32(zip, 0);
+    Put32(zip, m.offset);
+    zip.append(m.name);
+  }
+
+  const uint32_t cd_size = zip.size() - cd_offset;
+  Put32(zip, 0x06054b50);
+  Put16(zip, 0);
+  Put16(zip, 0);
+  Put16(zip, 2);
+  Put16(zip, 2);
+  Put32(zip, cd_size);
+  Put32(zip, cd_offset);
+  Put16(zip, 0);
+
+  FILE *file = fopen(ZIP_PATH, "wb");
+  if (file == nullptr)
+    return false;
+
+  bool success = fwrite(zip.data(), zip.size(), 1, file) == 1;
+  return fclose(file) == 0 && success;
+}
+
+/**
+ * Read from the current position like libjasper does: in 8 kB
+ * chunks, accepting short reads.
+ */
+static bool
+ReadCompare(ZipReader &reader, const std::string &data, size_t length)
+{
+  const uint64_t start = reader.GetPosition();
+  std::vector<char> buffer(length);
+
+  size_t fill = 0;
+  while (fill < length) {
+    size_t nbytes = reader.Read(&buffer[fill],
+                                std::min<size_t>(length - fill, 8192));
+    if (nbytes == 0)
+      return false;
+
+    fill += nbytes;
+  }
+
+  return memcmp(buffer.data(), data.data() + start, length) == 0 &&
+    reader.GetPosition() == start + length;
+}
+
+static bool
+SeekCompare(ZipReader &reader, const std::string &data, uint64_t offset,
+            size_t length)
+{
+  reader.Seek(offset);
+  return ReadCompare(reader, data, length);
+}
+
+static void
+TestIndex(ZipArchive &archive, const std::string &data)
+{
+  ok1(archive.Exists("stored.bin"));
+  ok1(archive.Exists("dir/deflated.bin"));
+  ok1(!archive.Exists("deflated.bin"));
+  ok1(!archive.Exists("STORED.BIN"));
+
+  const auto *stored = archive.Find("stored.bin");
+  const auto *deflated = archive.Find("dir/deflated.bin");
+  ok1(stored != nullptr && stored->IsStored() &&
+      stored->size == DATA_SIZE);
+  ok1(deflated != nullptr && !deflated->IsStored() &&
+      deflated->size == DATA_SIZE && deflated->compressed_size < DATA_SIZE);
+
+  const auto mapped = archive.GetStoredData(*stored);
+  ok1(!mapped.IsNull() && mapped.size == DATA_SIZE &&
+      memcmp(mapped.data, data.data(), DATA_SIZE) == 0);
+  ok1(archive.GetStoredData(*deflated).IsNull());
+
+  std::vector<std::string> names;
+  std::string name;
+  while (!(name = archive.NextName()).empty())
+    names.push_back(name);
+  ok1(names.size() == 2 && names[0] == "stored.bin" &&
+      names[1] == "dir/deflated.bin");
+}
+
+static void
+TestRead(ZipReader &reader, const std::string &data)
+{
+  ok1(reader.GetSize() == DATA_SIZE);
+  ok1(ReadCompare(reader, data, 100000));
+
+  /* a short step back, like libjasper after a refill */
+  ok1(SeekCompare(reader, data, reader.GetPosition() - 5000, 10000));
+
+  /* forward, past the window */
+  ok1(SeekCompare(reader, data, 250000, 20000));
+
+  /* back to the beginning */
+  ok1(SeekCompare(reader, data, 0, 1000));
+
+  /* the end of the member */
+  ok1(SeekCompare(reader, data, DATA_SIZE - 10, 10));
+  char c;
+  ok1(reader.Read(&c, 1) == 0);
+
+  /* a large read bypassing the window */
+  reader.Seek(1000);
+  std::string buffer(200000, 0);
+  size_t fill = 0;
+  size_t nbytes;
+  while (fill < buffer.size() &&
+         (nbytes = reader.Read(&buffer[fill], buffer.size() - fill)) > 0)
+    fill += nbytes;
+  ok1(fill == buffer.size() && buffer == data.substr(1000, buffer.size()));
+
+  bool caught = false;
+  try {
+    reader.Seek(DATA_SIZE + 1);
+  } catch (const std::runtime_error &) {
+    caught = true;
+  }
+  ok1(caught);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(9 + 3 * 9 + 1);
+
+  const std::string data = MakeData();
+  if (!WriteZip(data))
+    return exit_status();
+
+  ZipArchive archive{Path(ZIP_PATH)};
+  TestIndex(archive, data);
+
+  ZipReader stored(archive, "stored.bin");
+  TestRead(stored, data);
+
+  ZipReader deflated(archive, "dir/deflated.bin");
+  TestRead(deflated, data);
+
+  /* without the index, the stored member is read by zziplib */
+  ZipReader unmapped(archive.get(), "stored.bin");
+  TestRead(unmapped, data);
+
+  bool caught = false;
+  try {
+    ZipReader missing(archive, "missing.bin");
+  } catch (const std::runtime_error &) {
+    caught = true;
+  }
+  ok1(caught);
+
+  return exit_status();
+}
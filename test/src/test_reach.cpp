@@ -35,8 +35,11 @@
 #include "Geo/SpeedVector.hpp"
 #include "Operation/Operation.hpp"
 #include "OS/FileUtil.hpp"
+#include "IO/ZipArchive.hpp"
+#include "OS/Path.hpp"
 
-#include <zzip/zzip.h>
+#include <memory>
+#include <stdexcept>
 
 #include <string.h>
 
@@ -110,8 +113,10 @@ int main(int argc, char** argv) {
     map_path = argv[1];
   }
 
-  ZZIP_DIR *dir = zzip_dir_open(map_path, nullptr);
-  if (dir == nullptr) {
+  std::unique_ptr<ZipArchive> archive;
+  try {
+    archive = std::make_unique<ZipArchive>(Path(map_path));
+  } catch (const std::runtime_error &e) {
     fprintf(stderr, "Failed to open %s\n", map_path);
     return EXIT_FAILURE;
   }
@@ -119,7 +124,7 @@ int main(int argc, char** argv) {
   RasterMap map;
 
   NullOperationEnvironment operation;
-  if (!LoadTerrainOverview(dir, map.GetTileCache(),
+  if (!LoadTerrainOverview(*archive, map.GetTileCache(),
                            operation)) {
     fprintf(stderr, "failed to load map\n");
     return EXIT_FAILURE;
@@ -129,11 +134,11 @@ int main(int argc, char** argv) {
 
   SharedMutex mutex;
   do {
-    UpdateTerrainTiles(dir, map.GetTileCache(), mutex,
+    UpdateTerrainTiles(*archive, map.GetTileCache(), mutex,
                        map.GetProjection(),
                        map.GetMapCenter(), 50000);
   } while (map.IsDirty());
-  zzip_dir_close(dir);
+  archive.reset();
 
   plan_tests(8);
   test_reach(map, 0, 0.1, 0);
@@ -36,9 +36,11 @@
 #include "Compatibility/path.h"
 #include "Operation/Operation.hpp"
 #include "test_debug.hpp"
+#include "IO/ZipArchive.hpp"
+#include "OS/Path.hpp"
 
-#include <zzip/zzip.h>
-
+#include <memory>
+#include <stdexcept>
 #include <fstream>
 
 #include <string.h>
@@ -182,8 +184,10 @@ main(int argc, char** argv)
 {
   static const char map_path[] = "tmp/map.xcm";
 
-  ZZIP_DIR *dir = zzip_dir_open(map_path, nullptr);
-  if (dir == nullptr) {
+  std::unique_ptr<ZipArchive> archive;
+  try {
+    archive = std::make_unique<ZipArchive>(Path(map_path));
+  } catch (const std::runtime_error &e) {
     fprintf(stderr, "Failed to open %s\n", map_path);
     return EXIT_FAILURE;
   }
@@ -191,9 +195,8 @@ main(int argc, char** argv)
   RasterMap map;
 
   NullOperationEnvironment operation;
-  if (!LoadTerrainOverview(dir, map.GetTileCache(), operation)) {
+  if (!LoadTerrainOverview(*archive, map.GetTileCache(), operation)) {
     fprintf(stderr, "failed to load map\n");
-    zzip_dir_close(dir);
     return EXIT_FAILURE;
   }
 
@@ -201,11 +204,11 @@ main(int argc, char** argv)
 
   SharedMutex mutex;
   do {
-    UpdateTerrainTiles(dir, map.GetTileCache(), mutex,
+    UpdateTerrainTiles(*archive, map.GetTileCache(), mutex,
                        map.GetProjection(),
                        map.GetMapCenter(), 100000);
   } while (map.IsDirty());
-  zzip_dir_close(dir);
+  archive.reset();
 
   plan_tests(4 + NUM_SOL);
   ok(test_route(28, map), "route 28", 0);